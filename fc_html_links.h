@@ -0,0 +1,660 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_HTML_LINKS_IMPLEMENTATION
+        #include "fc_html_links.h"
+
+        // Just include as usual in the others
+        #include "fc_html_links.h"
+    "
+
+Example:
+    fc_html_links* links = (fc_html_links*)malloc(sizeof(fc_html_links)); // ~6KB, don't copy it around
+    fc_html_links_begin(links, "https://example.com/dir/page.html");
+
+    while (int count = read(fd, chunk, sizeof(chunk)))
+    {
+        fc_html_links_feed(links, chunk, count);
+
+        fc_html_link link;
+        while (fc_html_links_next(links, &link))
+        {
+            // link.resolved is "https://example.com/dir/img.png" for <img src="img.png">
+        }
+    }
+
+Info:
+    Streaming scanner for the href and src attributes of HTML tags. It's a reduced version of the HTML
+    tokenizer (https://html.spec.whatwg.org/multipage/parsing.html#tokenization): it knows about comments,
+    declarations, end tags and the raw text of <script>, <style>, <textarea> and <title>, nothing else.
+    Attribute values can be quoted, unquoted and can contain character references, which are decoded.
+    A <base href> changes the base used to resolve the following links.
+
+    Values longer than FC_URI_MAX are skipped. Chunks can split the input anywhere, nothing is allocated.
+*/
+
+#ifndef FC_HTML_LINKS
+#define FC_HTML_LINKS
+
+#include "fc_uri_parse.h"
+
+#define FC_HTML_LINKS_NAME_MAX 16
+
+typedef struct
+{
+    fc_uri_str tag;       // Lowercase, "a", "img", ...
+    fc_uri_str attribute; // "href" or "src"
+    fc_uri_str value;     // With character references decoded and surrounding whitespace removed
+
+    fc_uri_view reference; // value parsed as a URI reference
+    fc_uri_str  resolved;  // Absolute URI, empty when there is no base or resolution failed
+} fc_html_link;
+
+typedef struct
+{
+    int state;
+
+    char tag[FC_HTML_LINKS_NAME_MAX];
+    int  tag_count;
+
+    char attribute[FC_HTML_LINKS_NAME_MAX];
+    int  attribute_count;
+
+    char quote;
+    int  match; // Progress in matching "<!--", "-->" or the end tag of raw text
+
+    char entity[12];
+    int  entity_count;
+
+    char value[FC_URI_MAX + 1];
+    int  value_count;
+    bool value_overflow;
+
+    char resolved[FC_URI_MAX + 1];
+
+    char base[FC_URI_MAX + 1];
+    fc_uri_view base_view;
+    bool has_base;
+
+    const char* chunk;
+    const char* chunk_end;
+} fc_html_links;
+
+// base can be NULL, links are not resolved until a <base href> shows up.
+void fc_html_links_begin(fc_html_links* links, const char* base);
+void fc_html_links_feed(fc_html_links* links, const char* chunk, int count);
+
+// Returns the next link in the current chunk. The views in link are valid until the next call.
+bool fc_html_links_next(fc_html_links* links, fc_html_link* link);
+
+#endif // FC_HTML_LINKS
+
+#ifdef FC_HTML_LINKS_IMPLEMENTATION
+
+#include <string.h> // memchr, strlen
+
+enum
+{
+    FC_HTML_TEXT,
+    FC_HTML_TAG_OPEN,
+    FC_HTML_TAG_NAME,
+    FC_HTML_BEFORE_ATTRIBUTE,
+    FC_HTML_ATTRIBUTE_NAME,
+    FC_HTML_AFTER_ATTRIBUTE_NAME,
+    FC_HTML_BEFORE_VALUE,
+    FC_HTML_VALUE,
+    FC_HTML_VALUE_ENTITY,
+    FC_HTML_DECLARATION, // <! that may become a comment
+    FC_HTML_COMMENT,
+    FC_HTML_BOGUS,       // Skipped up to the next '>'
+    FC_HTML_RAW_TEXT,
+};
+
+static bool fc_html_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+static bool fc_html_is_alpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static char fc_html_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static bool fc_html_name_is(const char* name, int count, const char* other)
+{
+    return count == (int)strlen(other) && memcmp(name, other, count) == 0;
+}
+
+static void fc_html_append_name(char* name, int* count, char c)
+{
+    // Longer names can't be anything we look for, make sure they don't match by keeping the count.
+    if (*count < FC_HTML_LINKS_NAME_MAX) name[*count] = fc_html_lower(c);
+    *count += 1;
+}
+
+static bool fc_html_wants_attribute(fc_html_links* links)
+{
+    return fc_html_name_is(links->attribute, links->attribute_count, "href") ||
+           fc_html_name_is(links->attribute, links->attribute_count, "src");
+}
+
+static void fc_html_append_value(fc_html_links* links, const char* str, int count)
+{
+    if (links->value_count + count > FC_URI_MAX)
+    {
+        links->value_overflow = true;
+        return;
+    }
+
+    memcpy(links->value + links->value_count, str, count);
+    links->value_count += count;
+}
+
+static void fc_html_append_code_point(fc_html_links* links, unsigned cp)
+{
+    if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) cp = 0xFFFD;
+
+    char utf8[4];
+    int count;
+
+    if (cp < 0x80)
+    {
+        utf8[0] = (char)cp;
+        count = 1;
+    }
+    else if (cp < 0x800)
+    {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F));
+        count = 2;
+    }
+    else if (cp < 0x10000)
+    {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F));
+        count = 3;
+    }
+    else {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F));
+        count = 4;
+    }
+
+    fc_html_append_value(links, utf8, count);
+}
+
+// Decodes the reference in links->entity ("amp", "#38", "#x26"). terminated tells whether it ended with ';'.
+static void fc_html_flush_entity(fc_html_links* links, bool terminated, char next)
+{
+    const char* e = links->entity;
+    int count = links->entity_count;
+
+    if (count > 1 && e[0] == '#')
+    {
+        bool hex = e[1] == 'x' || e[1] == 'X';
+        unsigned cp = 0;
+        bool digits = false;
+
+        for (int i = hex ? 2 : 1; i < count; ++i)
+        {
+            char c = e[i];
+            unsigned d;
+            if      (c >= '0' && c <= '9')        d = c - '0';
+            else if (hex && c >= 'a' && c <= 'f') d = c - 'a' + 10;
+            else if (hex && c >= 'A' && c <= 'F') d = c - 'A' + 10;
+            else break;
+
+            digits = true;
+            if (cp <= 0x10FFFF) cp = cp * (hex ? 16 : 10) + d;
+        }
+
+        if (digits)
+        {
+            fc_html_append_code_point(links, cp);
+            return;
+        }
+    }
+    else {
+        // Without ';' only the legacy names are decoded, and not when followed by what looks like a query.
+        bool legacy_ok = terminated || !((next >= '0' && next <= '9') || fc_html_is_alpha(next) || next == '=');
+
+        struct { const char* name; unsigned cp; bool legacy; } names[] = {
+            { "amp",  '&',    true  },
+            { "lt",   '<',    true  },
+            { "gt",   '>',    true  },
+            { "quot", '"',    true  },
+            { "apos", '\'',   false },
+            { "nbsp", 0xA0,   true  },
+        };
+
+        for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        {
+            if (fc_html_name_is(e, count, names[i].name) && (terminated || (names[i].legacy && legacy_ok)))
+            {
+                fc_html_append_code_point(links, names[i].cp);
+                return;
+            }
+        }
+    }
+
+    // Not a reference we know, keep it as it was
+    fc_html_append_value(links, "&", 1);
+    fc_html_append_value(links, e, count);
+    if (terminated) fc_html_append_value(links, ";", 1);
+}
+
+static void fc_html_set_base(fc_html_links* links, const char* base, int count)
+{
+    fc_uri_view view;
+
+    // Relative <base href> are resolved against the previous base
+    if (links->has_base)
+    {
+        char resolved[FC_URI_MAX + 1];
+
+        if (!fc_uri_parse_reference_view(base, count, &view)) return;
+
+        int resolved_count = fc_uri_resolve(&links->base_view, &view, resolved, sizeof(resolved));
+        if (resolved_count < 0) return;
+
+        memcpy(links->base, resolved, resolved_count + 1);
+        count = resolved_count;
+    }
+    else {
+        if (count > FC_URI_MAX) return;
+
+        memmove(links->base, base, count);
+        links->base[count] = '\0';
+    }
+
+    links->has_base = fc_uri_parse_view(links->base, count, &links->base_view);
+}
+
+void fc_html_links_begin(fc_html_links* links, const char* base)
+{
+    links->state = FC_HTML_TEXT;
+    links->has_base = false;
+    links->chunk = links->chunk_end = NULL;
+
+    if (base)
+    {
+        fc_html_set_base(links, base, (int)strlen(base));
+    }
+}
+
+void fc_html_links_feed(fc_html_links* links, const char* chunk, int count)
+{
+    links->chunk     = chunk;
+    links->chunk_end = chunk + count;
+}
+
+static void fc_html_begin_value(fc_html_links* links, char quote)
+{
+    links->state = FC_HTML_VALUE;
+    links->quote = quote;
+    links->value_count = 0;
+    links->value_overflow = false;
+}
+
+static void fc_html_end_tag(fc_html_links* links)
+{
+    bool raw_text = fc_html_name_is(links->tag, links->tag_count, "script")   ||
+                    fc_html_name_is(links->tag, links->tag_count, "style")    ||
+                    fc_html_name_is(links->tag, links->tag_count, "textarea") ||
+                    fc_html_name_is(links->tag, links->tag_count, "title");
+
+    links->state = raw_text ? FC_HTML_RAW_TEXT : FC_HTML_TEXT;
+    links->match = 0;
+}
+
+// Called when an attribute value is complete, returns true if it produced a link.
+static bool fc_html_end_value(fc_html_links* links, fc_html_link* link)
+{
+    if (!fc_html_wants_attribute(links) || links->value_overflow) return false;
+
+    const char* value = links->value;
+    int count = links->value_count;
+
+    while (count && fc_html_is_space(*value)) { value++; count--; }
+    while (count && fc_html_is_space(value[count - 1])) count--;
+
+    bool is_base = fc_html_name_is(links->tag, links->tag_count, "base");
+    if (is_base)
+    {
+        fc_html_set_base(links, value, count);
+    }
+
+    if (!fc_uri_parse_reference_view(value, count, &link->reference)) return false;
+
+    link->tag.data        = links->tag;
+    link->tag.count       = links->tag_count;
+    link->attribute.data  = links->attribute;
+    link->attribute.count = links->attribute_count;
+    link->value.data      = value;
+    link->value.count     = count;
+
+    link->resolved.data  = links->resolved;
+    link->resolved.count = 0;
+
+    if (is_base && links->has_base)
+    {
+        link->resolved.data  = links->base;
+        link->resolved.count = (int)strlen(links->base);
+    }
+    else if (links->has_base)
+    {
+        int resolved = fc_uri_resolve(&links->base_view, &link->reference, links->resolved, sizeof(links->resolved));
+        link->resolved.count = resolved > 0 ? resolved : 0;
+    }
+
+    return true;
+}
+
+bool fc_html_links_next(fc_html_links* links, fc_html_link* link)
+{
+    const char* c   = links->chunk;
+    const char* end = links->chunk_end;
+
+    bool found = false;
+
+    while (c != end && !found)
+    {
+        switch (links->state)
+        {
+            case FC_HTML_TEXT:
+            {
+                const char* open = (const char*)memchr(c, '<', end - c);
+                if (!open)
+                {
+                    c = end;
+                    break;
+                }
+
+                c = open + 1;
+                links->state = FC_HTML_TAG_OPEN;
+            } break;
+
+            case FC_HTML_TAG_OPEN:
+            {
+                if (fc_html_is_alpha(*c))
+                {
+                    links->tag_count = 0;
+                    links->state = FC_HTML_TAG_NAME;
+                }
+                else if (*c == '!')
+                {
+                    links->match = 0;
+                    links->state = FC_HTML_DECLARATION;
+                    c++;
+                }
+                else if (*c == '/' || *c == '?')
+                {
+                    links->state = FC_HTML_BOGUS;
+                    c++;
+                }
+                else {
+                    links->state = FC_HTML_TEXT;
+                }
+            } break;
+
+            case FC_HTML_TAG_NAME:
+            {
+                if (fc_html_is_space(*c) || *c == '/')
+                {
+                    links->state = FC_HTML_BEFORE_ATTRIBUTE;
+                }
+                else if (*c == '>')
+                {
+                    fc_html_end_tag(links);
+                }
+                else {
+                    fc_html_append_name(links->tag, &links->tag_count, *c);
+                }
+                c++;
+            } break;
+
+            case FC_HTML_BEFORE_ATTRIBUTE:
+            {
+                if (*c == '>')
+                {
+                    fc_html_end_tag(links);
+                    c++;
+                }
+                else if (fc_html_is_space(*c) || *c == '/')
+                {
+                    c++;
+                }
+                else {
+                    links->attribute_count = 0;
+                    fc_html_append_name(links->attribute, &links->attribute_count, *c++);
+                    links->state = FC_HTML_ATTRIBUTE_NAME;
+                }
+            } break;
+
+            case FC_HTML_ATTRIBUTE_NAME:
+            {
+                if (*c == '=')
+                {
+                    links->state = FC_HTML_BEFORE_VALUE;
+                    c++;
+                }
+                else if (fc_html_is_space(*c))
+                {
+                    links->state = FC_HTML_AFTER_ATTRIBUTE_NAME;
+                    c++;
+                }
+                else if (*c == '>' || *c == '/')
+                {
+                    links->state = FC_HTML_BEFORE_ATTRIBUTE;
+                }
+                else {
+                    fc_html_append_name(links->attribute, &links->attribute_count, *c++);
+                }
+            } break;
+
+            case FC_HTML_AFTER_ATTRIBUTE_NAME:
+            {
+                if (*c == '=')
+                {
+                    links->state = FC_HTML_BEFORE_VALUE;
+                    c++;
+                }
+                else if (fc_html_is_space(*c))
+                {
+                    c++;
+                }
+                else {
+                    links->state = FC_HTML_BEFORE_ATTRIBUTE;
+                }
+            } break;
+
+            case FC_HTML_BEFORE_VALUE:
+            {
+                if (fc_html_is_space(*c))
+                {
+                    c++;
+                }
+                else if (*c == '"' || *c == '\'')
+                {
+                    fc_html_begin_value(links, *c++);
+                }
+                else if (*c == '>')
+                {
+                    links->state = FC_HTML_BEFORE_ATTRIBUTE;
+                }
+                else {
+                    fc_html_begin_value(links, 0);
+                }
+            } break;
+
+            case FC_HTML_VALUE:
+            {
+                bool wanted = fc_html_wants_attribute(links);
+
+                const char* start = c;
+                if (links->quote)
+                {
+                    while (c != end && *c != links->quote && *c != '&') c++;
+                }
+                else {
+                    while (c != end && !fc_html_is_space(*c) && *c != '>' && *c != '&') c++;
+                }
+
+                if (wanted) fc_html_append_value(links, start, (int)(c - start));
+
+                if (c == end) break;
+
+                if (*c == '&')
+                {
+                    links->entity_count = 0;
+                    links->state = FC_HTML_VALUE_ENTITY;
+                    c++;
+                    break;
+                }
+
+                // End of the value, the closing quote is consumed, '>' and spaces are handled by the next state.
+                if (links->quote) c++;
+                links->state = FC_HTML_BEFORE_ATTRIBUTE;
+
+                found = fc_html_end_value(links, link);
+            } break;
+
+            case FC_HTML_VALUE_ENTITY:
+            {
+                char e = *c;
+                bool is_name_char = fc_html_is_alpha(e) || (e >= '0' && e <= '9') || (e == '#' && links->entity_count == 0);
+
+                if (is_name_char && links->entity_count < (int)sizeof(links->entity))
+                {
+                    links->entity[links->entity_count++] = e;
+                    c++;
+                    break;
+                }
+
+                bool terminated = e == ';';
+                if (fc_html_wants_attribute(links)) fc_html_flush_entity(links, terminated, e);
+                if (terminated) c++;
+
+                links->state = FC_HTML_VALUE;
+            } break;
+
+            case FC_HTML_DECLARATION:
+            {
+                // "<!--" starts a comment, anything else is skipped up to '>'
+                if (*c == '-' && links->match < 2)
+                {
+                    links->match++;
+                    c++;
+
+                    if (links->match == 2)
+                    {
+                        links->match = 0;
+                        links->state = FC_HTML_COMMENT;
+                    }
+                }
+                else {
+                    links->state = FC_HTML_BOGUS;
+                }
+            } break;
+
+            case FC_HTML_COMMENT:
+            {
+                // match counts the '-' right before the cursor
+                for (; c != end; ++c)
+                {
+                    if (*c == '>' && links->match >= 2)
+                    {
+                        links->state = FC_HTML_TEXT;
+                        c++;
+                        break;
+                    }
+
+                    links->match = *c == '-' ? links->match + 1 : 0;
+                }
+            } break;
+
+            case FC_HTML_BOGUS:
+            {
+                const char* close = (const char*)memchr(c, '>', end - c);
+                if (!close)
+                {
+                    c = end;
+                    break;
+                }
+
+                c = close + 1;
+                links->state = FC_HTML_TEXT;
+            } break;
+
+            case FC_HTML_RAW_TEXT:
+            {
+                // Looks for "</" followed by the tag name, match is how much of it has been seen.
+                for (; c != end; ++c)
+                {
+                    char expected = links->match == 0 ? '<' :
+                                    links->match == 1 ? '/' : links->tag[links->match - 2];
+
+                    if (fc_html_lower(*c) == expected)
+                    {
+                        links->match++;
+                        if (links->match == links->tag_count + 2)
+                        {
+                            links->state = FC_HTML_BOGUS;
+                            c++;
+                            break;
+                        }
+                    }
+                    else {
+                        links->match = *c == '<' ? 1 : 0;
+                    }
+                }
+            } break;
+        }
+    }
+
+    links->chunk = c;
+
+    return found;
+}
+
+#endif // FC_HTML_LINKS_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
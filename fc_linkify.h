@@ -0,0 +1,276 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_LINKIFY_IMPLEMENTATION
+        #include "fc_linkify.h"
+
+        // Just include as usual in the others
+        #include "fc_linkify.h"
+    "
+
+Example:
+    fc_linkify linkify;
+    fc_linkify_begin(&linkify, text, text_length);
+
+    fc_uri_str  match;
+    fc_uri_view uri;
+    while (fc_linkify_next(&linkify, &match, &uri))
+    {
+        // match is the URL as it appears in text, uri its components (scheme is empty for "www." links)
+    }
+
+Info:
+    Finds URLs in free text. Candidates are anchored on "://" and "www." and located 16 bytes at a time
+    with SSE2, define FC_URI_NO_SIMD to force the scalar fallback.
+    A match is extended over the URI character set (plus non-ASCII bytes, for IRIs) and then trailing
+    punctuation is trimmed: ".,:;!?'\"*" always, closing brackets only when they are unbalanced in the match.
+*/
+
+#ifndef FC_LINKIFY
+#define FC_LINKIFY
+
+#include "fc_uri_parse.h"
+
+typedef struct
+{
+    const char* begin;
+    const char* end;
+
+    const char* cursor;
+} fc_linkify;
+
+void fc_linkify_begin(fc_linkify* state, const char* text, int count);
+
+// Finds the next URL in the text. Returns false once the text is exhausted.
+bool fc_linkify_next(fc_linkify* state, fc_uri_str* match, fc_uri_view* uri);
+
+#endif // FC_LINKIFY
+
+#ifdef FC_LINKIFY_IMPLEMENTATION
+
+#ifdef FC_URI_SSE2
+#define FC_LINKIFY_SSE2
+#include <emmintrin.h>
+#endif
+
+#define FC_LINKIFY_SCHEME_MAX 32
+
+static bool fc_linkify_is_alpha(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool fc_linkify_is_alnum(char c)
+{
+    return fc_linkify_is_alpha(c) || (c >= '0' && c <= '9');
+}
+
+static bool fc_linkify_is_scheme_char(char c)
+{
+    return fc_linkify_is_alnum(c) || c == '+' || c == '-' || c == '.';
+}
+
+static bool fc_linkify_is_uri_char(char c)
+{
+    unsigned char u = (unsigned char)c;
+    if (u >= 0x80) return true;
+    if (u <= ' ' || u == 0x7F) return false;
+
+    switch (c)
+    {
+        case '<': case '>': case '"': case '`': case '{': case '}': case '|': case '\\': case '^':
+            return false;
+    }
+
+    return true;
+}
+
+static bool fc_linkify_is_www(const char* c)
+{
+    return (c[0] | 0x20) == 'w' && (c[1] | 0x20) == 'w' && (c[2] | 0x20) == 'w' && c[3] == '.';
+}
+
+void fc_linkify_begin(fc_linkify* state, const char* text, int count)
+{
+    state->begin  = text;
+    state->end    = text + count;
+    state->cursor = text;
+}
+
+// Returns the start of the URL for an anchor at c, or NULL if the anchor isn't one.
+static const char* fc_linkify_match_start(fc_linkify* state, const char* c)
+{
+    if (*c == ':')
+    {
+        // Scheme, scanning back from "://"
+        const char* start = c;
+        while (start != state->cursor && c - start < FC_LINKIFY_SCHEME_MAX && fc_linkify_is_scheme_char(start[-1])) start--;
+
+        while (start != c && !fc_linkify_is_alpha(*start)) start++;
+
+        if (start == c) return NULL;
+        if (start != state->cursor && fc_linkify_is_alnum(start[-1])) return NULL;
+
+        return start;
+    }
+
+    // "www.", which must not be part of a longer word or host
+    if (c != state->begin && (fc_linkify_is_alnum(c[-1]) || c[-1] == '.' || c[-1] == '/' || c[-1] == '@' || c[-1] == '-')) return NULL;
+
+    return c;
+}
+
+// Extends the URL starting at start and trims trailing punctuation, returns its end.
+static const char* fc_linkify_match_end(fc_linkify* state, const char* start)
+{
+    const char* end = start;
+    while (end != state->end && fc_linkify_is_uri_char(*end)) end++;
+
+    while (end != start)
+    {
+        char last = end[-1];
+
+        if (last == '.' || last == ',' || last == ':' || last == ';' || last == '!' || last == '?' ||
+            last == '\'' || last == '"' || last == '*')
+        {
+            end--;
+            continue;
+        }
+
+        char open = last == ')' ? '(' : last == ']' ? '[' : 0;
+        if (open)
+        {
+            int balance = 0;
+            for (const char* c = start; c != end; ++c)
+            {
+                if (*c == open) balance++;
+                if (*c == last) balance--;
+            }
+
+            if (balance < 0)
+            {
+                end--;
+                continue;
+            }
+        }
+
+        break;
+    }
+
+    return end;
+}
+
+// Returns the next "://" or "www." anchor at or after c, or NULL.
+static const char* fc_linkify_find_anchor(fc_linkify* state, const char* c)
+{
+#ifdef FC_LINKIFY_SSE2
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i w     = _mm_set1_epi8('w');
+    const __m128i dot   = _mm_set1_epi8('.');
+    const __m128i lower = _mm_set1_epi8(0x20);
+
+    // Each block compares the bytes at offsets 0..3, so 19 bytes have to be readable.
+    while (state->end - c >= 19)
+    {
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(c + 0));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(c + 1));
+        __m128i b2 = _mm_loadu_si128((const __m128i*)(c + 2));
+        __m128i b3 = _mm_loadu_si128((const __m128i*)(c + 3));
+
+        __m128i scheme_anchor = _mm_and_si128(_mm_cmpeq_epi8(b0, colon),
+                                _mm_and_si128(_mm_cmpeq_epi8(b1, slash), _mm_cmpeq_epi8(b2, slash)));
+
+        __m128i www_anchor = _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(b0, lower), w),
+                             _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(b1, lower), w),
+                             _mm_and_si128(_mm_cmpeq_epi8(_mm_or_si128(b2, lower), w), _mm_cmpeq_epi8(b3, dot))));
+
+        int mask = _mm_movemask_epi8(_mm_or_si128(scheme_anchor, www_anchor));
+        if (mask)
+        {
+            return c + fc_uri_ctz(mask);
+        }
+
+        c += 16;
+    }
+#endif
+
+    for (; state->end - c >= 4; ++c)
+    {
+        if ((c[0] == ':' && c[1] == '/' && c[2] == '/') || fc_linkify_is_www(c)) return c;
+    }
+
+    if (state->end - c == 3 && c[0] == ':' && c[1] == '/' && c[2] == '/') return c;
+
+    return NULL;
+}
+
+bool fc_linkify_next(fc_linkify* state, fc_uri_str* match, fc_uri_view* uri)
+{
+    const char* c = state->cursor;
+
+    while ((c = fc_linkify_find_anchor(state, c)))
+    {
+        const char* start = fc_linkify_match_start(state, c);
+        if (!start)
+        {
+            c += 1;
+            continue;
+        }
+
+        const char* end = fc_linkify_match_end(state, start);
+
+        bool is_www = start == c;
+        bool parsed = is_www ? fc_uri_parse_authority_view(start, (int)(end - start), uri)
+                             : fc_uri_parse_view(start, (int)(end - start), uri);
+
+        if (!parsed || uri->host.count == 0)
+        {
+            c += 1;
+            continue;
+        }
+
+        match->data  = start;
+        match->count = (int)(end - start);
+
+        state->cursor = end;
+        return true;
+    }
+
+    state->cursor = state->end;
+    return false;
+}
+
+#endif // FC_LINKIFY_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,736 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_BLOCKLIST_IMPLEMENTATION
+        #include "fc_uri_blocklist.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_blocklist.h"
+    "
+
+Example:
+    fc_blocklist list;
+    fc_blocklist_init(&list);
+
+    fc_blocklist_add_list(&list, easylist_text, easylist_length); // Rule ids are line numbers
+    fc_blocklist_add(&list, "||ads.example^", -1, 100000);
+    fc_blocklist_add(&list, "@@||ads.example/allowed.js", -1, 100001);
+    fc_blocklist_compile(&list);
+
+    // One scratch per thread, the list can be shared once it's compiled
+    fc_blocklist_scratch scratch = {};
+
+    uint32_t rule;
+    fc_blocklist_result result = fc_blocklist_match(&list, "https://ads.example/banner.png", -1, &scratch, &rule);
+    // FC_BLOCKLIST_BLOCK, rule = 100000
+
+    fc_blocklist_scratch_free(&scratch);
+    fc_blocklist_free(&list);
+
+Info:
+    Matches URLs against filter lists in the Adblock Plus syntax:
+        ||example.com^   anchored at the start of the host or after one of its dots
+        |https:          anchored at the start (or, at the end of a rule, at the end) of the URL
+        ^                a separator: anything but a letter, a digit, '_', '-', '.', '%', or the end of the URL
+        *                any run of characters
+        @@rule           exception, allows a URL that blocking rules match
+    Options after '$' are ignored, so are comments, element hiding rules and regular expression rules
+    (fc_blocklist_add returns false for them). Matching ignores case.
+
+    When the list is compiled, every rule is indexed by its rarest token, a run of letters, digits and '%' that
+    has to appear whole in the URLs the rule matches. A URL is split in the same tokens and only the rules of its
+    tokens are tried, so the cost depends on the URL length and on how many rules share its tokens, not on the
+    size of the list. Rules without a token are tried on every URL.
+    Where the token appears in the URL also fixes where the rule has to start matching, unless the rule has a '*'
+    before its token: those are matched in a single pass that lets the start float, as if they began with '*'.
+*/
+
+#ifndef FC_URI_BLOCKLIST
+#define FC_URI_BLOCKLIST
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+typedef enum
+{
+    FC_BLOCKLIST_NONE,
+    FC_BLOCKLIST_BLOCK,
+    FC_BLOCKLIST_ALLOW, // A blocking rule matched, and so did an exception rule
+} fc_blocklist_result;
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t pattern_offset;
+    uint32_t pattern_count;
+    uint32_t flags;
+    uint32_t token_offset; // Of the indexed token in the pattern, when no '*' comes before it
+    uint32_t next;         // Next rule with the same token
+} fc_blocklist_rule;
+
+typedef struct
+{
+    char* patterns;
+    uint32_t patterns_count;
+    uint32_t patterns_capacity;
+
+    fc_blocklist_rule* rules;
+    uint32_t rule_count;
+    uint32_t rule_capacity;
+
+    // Built by fc_blocklist_compile
+    uint64_t* token_keys; // 0 for empty slots
+    uint32_t* token_rules;
+    uint32_t token_mask;
+    uint32_t untokenized; // Rules without a token
+} fc_blocklist;
+
+typedef struct
+{
+    char* url;
+    int url_capacity;
+
+    uint32_t* rule_mark;
+    uint32_t rule_capacity;
+    uint32_t generation;
+} fc_blocklist_scratch;
+
+bool fc_blocklist_init(fc_blocklist* list);
+void fc_blocklist_free(fc_blocklist* list);
+
+// Returns false for lines that aren't URL rules (comments, element hiding, regular expressions) or when memory runs out.
+bool fc_blocklist_add(fc_blocklist* list, const char* rule, int count, uint32_t rule_id);
+
+// Adds every line, with its (zero based) line number as id. Returns the number of rules added.
+int fc_blocklist_add_list(fc_blocklist* list, const char* text, int count);
+
+// Builds the token index, call it after adding rules and before matching.
+bool fc_blocklist_compile(fc_blocklist* list);
+
+// rule_id receives the rule that decided the result: the blocking rule, or the exception that allowed it.
+fc_blocklist_result fc_blocklist_match(const fc_blocklist* list, const char* url, int count, fc_blocklist_scratch* scratch, uint32_t* rule_id);
+
+void fc_blocklist_scratch_free(fc_blocklist_scratch* scratch);
+
+#endif // FC_URI_BLOCKLIST
+
+#ifdef FC_URI_BLOCKLIST_IMPLEMENTATION
+
+#include <string.h> // memchr, memset, strlen
+
+#ifndef FC_URI_BLOCKLIST_REALLOC
+#include <stdlib.h>
+#define FC_URI_BLOCKLIST_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_BLOCKLIST_FREE
+#include <stdlib.h>
+#define FC_URI_BLOCKLIST_FREE(ptr)          free(ptr)
+#endif
+
+#define FC_BLOCKLIST_END 0xFFFFFFFFu
+
+enum
+{
+    FC_BLOCKLIST_HOST_ANCHOR  = 1 << 0, // ||
+    FC_BLOCKLIST_START_ANCHOR = 1 << 1, // |...
+    FC_BLOCKLIST_END_ANCHOR   = 1 << 2, // ...|
+    FC_BLOCKLIST_EXCEPTION    = 1 << 3, // @@
+};
+
+static bool fc_blocklist_grow(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity) return true;
+
+    uint32_t grown = *capacity ? *capacity : 64;
+    while (grown < needed) grown *= 2;
+
+    void* resized = FC_URI_BLOCKLIST_REALLOC(*array, (size_t)grown * element_size);
+    if (!resized) return false;
+
+    *array = resized;
+    *capacity = grown;
+
+    return true;
+}
+
+static char fc_blocklist_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static bool fc_blocklist_is_token(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '%';
+}
+
+static bool fc_blocklist_is_separator(char c)
+{
+    return !fc_blocklist_is_token(c) && c != '_' && c != '-' && c != '.';
+}
+
+bool fc_blocklist_init(fc_blocklist* list)
+{
+    memset(list, 0, sizeof(*list));
+    list->untokenized = FC_BLOCKLIST_END;
+
+    return true;
+}
+
+void fc_blocklist_free(fc_blocklist* list)
+{
+    FC_URI_BLOCKLIST_FREE(list->patterns);
+    FC_URI_BLOCKLIST_FREE(list->rules);
+    FC_URI_BLOCKLIST_FREE(list->token_keys);
+    FC_URI_BLOCKLIST_FREE(list->token_rules);
+
+    memset(list, 0, sizeof(*list));
+}
+
+bool fc_blocklist_add(fc_blocklist* list, const char* rule, int count, uint32_t rule_id)
+{
+    if (count < 0) count = (int)strlen(rule);
+
+    const char* begin = rule;
+    const char* end = rule + count;
+
+    while (begin < end && (*begin == ' ' || *begin == '\t')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) --end;
+
+    if (begin == end || *begin == '!' || *begin == '[') return false;
+
+    for (const char* p = begin; p + 1 < end; ++p)
+    {
+        if (p[0] == '#' && (p[1] == '#' || p[1] == '@' || p[1] == '?' || p[1] == '$')) return false;
+    }
+
+    uint32_t flags = 0;
+
+    if (end - begin >= 2 && begin[0] == '@' && begin[1] == '@')
+    {
+        flags |= FC_BLOCKLIST_EXCEPTION;
+        begin += 2;
+    }
+
+    // Options
+    for (const char* p = end; p > begin; --p)
+    {
+        if (p[-1] == '$')
+        {
+            end = p - 1;
+            break;
+        }
+    }
+
+    if (end - begin >= 2 && *begin == '/' && end[-1] == '/') return false;
+
+    if (end - begin >= 2 && begin[0] == '|' && begin[1] == '|') {
+        flags |= FC_BLOCKLIST_HOST_ANCHOR;
+        begin += 2;
+    } else if (begin < end && *begin == '|') {
+        flags |= FC_BLOCKLIST_START_ANCHOR;
+        begin += 1;
+    }
+
+    if (end > begin && end[-1] == '|')
+    {
+        flags |= FC_BLOCKLIST_END_ANCHOR;
+        end -= 1;
+    }
+
+    int pattern_count = (int)(end - begin);
+
+    if (!fc_blocklist_grow((void**)&list->patterns, &list->patterns_capacity, list->patterns_count + pattern_count, 1) ||
+        !fc_blocklist_grow((void**)&list->rules, &list->rule_capacity, list->rule_count + 1, sizeof(fc_blocklist_rule)))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < pattern_count; ++i)
+    {
+        list->patterns[list->patterns_count + i] = fc_blocklist_lower(begin[i]);
+    }
+
+    fc_blocklist_rule* added = &list->rules[list->rule_count++];
+    added->id = rule_id;
+    added->pattern_offset = list->patterns_count;
+    added->pattern_count = pattern_count;
+    added->flags = flags;
+    added->token_offset = FC_BLOCKLIST_END;
+    added->next = FC_BLOCKLIST_END;
+
+    list->patterns_count += pattern_count;
+
+    return true;
+}
+
+int fc_blocklist_add_list(fc_blocklist* list, const char* text, int count)
+{
+    if (count < 0) count = (int)strlen(text);
+
+    int added = 0;
+    uint32_t line = 0;
+
+    for (int begin = 0; begin < count; ++line)
+    {
+        int end = begin;
+        while (end < count && text[end] != '\n') ++end;
+
+        if (fc_blocklist_add(list, text + begin, end - begin, line)) ++added;
+
+        begin = end + 1;
+    }
+
+    return added;
+}
+
+// Next token of the pattern that has to match a whole token of the URL, false when there are no more.
+static bool fc_blocklist_next_token(const char* pattern, int count, uint32_t flags, int* cursor, uint64_t* token, int* length)
+{
+    for (int i = *cursor; i < count;)
+    {
+        if (!fc_blocklist_is_token(pattern[i]))
+        {
+            ++i;
+            continue;
+        }
+
+        int begin = i;
+        while (i < count && fc_blocklist_is_token(pattern[i])) ++i;
+
+        // The URL could have more token characters on a side left open by the pattern
+        bool left  = begin > 0 ? pattern[begin - 1] != '*' : (flags & (FC_BLOCKLIST_HOST_ANCHOR | FC_BLOCKLIST_START_ANCHOR)) != 0;
+        bool right = i < count ? pattern[i] != '*' : (flags & FC_BLOCKLIST_END_ANCHOR) != 0;
+
+        if (left && right)
+        {
+            *cursor = i;
+            *token  = fc_uri_hash(pattern + begin, i - begin, 0) | 1; // 0 marks empty slots
+            *length = i - begin;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool fc_blocklist_rehash(fc_blocklist* list, uint32_t slot_count)
+{
+    FC_URI_BLOCKLIST_FREE(list->token_keys);
+    FC_URI_BLOCKLIST_FREE(list->token_rules);
+
+    list->token_keys  = (uint64_t*)FC_URI_BLOCKLIST_REALLOC(NULL, slot_count * sizeof(uint64_t));
+    list->token_rules = (uint32_t*)FC_URI_BLOCKLIST_REALLOC(NULL, slot_count * sizeof(uint32_t));
+    list->token_mask  = slot_count - 1;
+
+    if (!list->token_keys || !list->token_rules) return false;
+
+    memset(list->token_keys, 0, slot_count * sizeof(uint64_t));
+
+    return true;
+}
+
+// Slot of the token, or of the empty slot where it would go. The table is kept at most half full,
+// the probe count is bounded anyway: callers check the key of the slot they get.
+static uint32_t fc_blocklist_slot(const fc_blocklist* list, uint64_t token)
+{
+    uint32_t slot = (uint32_t)(token >> 32) & list->token_mask;
+    for (uint32_t probes = 0; probes < list->token_mask && list->token_keys[slot] && list->token_keys[slot] != token; ++probes)
+    {
+        slot = (slot + 1) & list->token_mask;
+    }
+
+    return slot;
+}
+
+bool fc_blocklist_compile(fc_blocklist* list)
+{
+    // Every token of every rule can be distinct, size the table for all of them at load 1/2
+    uint64_t token_total = 0;
+
+    for (uint32_t r = 0; r < list->rule_count; ++r)
+    {
+        const fc_blocklist_rule* rule = &list->rules[r];
+
+        int cursor = 0;
+        uint64_t token;
+        int length;
+
+        while (fc_blocklist_next_token(list->patterns + rule->pattern_offset, rule->pattern_count, rule->flags, &cursor, &token, &length)) token_total++;
+    }
+
+    uint32_t slot_count = 64;
+    while (slot_count < token_total * 2 || slot_count < list->rule_count * 2)
+    {
+        if (slot_count >= 0x80000000u) return false;
+        slot_count *= 2;
+    }
+
+    // First count how many rules every token appears in, then index each rule by its least common token.
+    if (!fc_blocklist_rehash(list, slot_count)) return false;
+
+    for (uint32_t r = 0; r < list->rule_count; ++r)
+    {
+        fc_blocklist_rule* rule = &list->rules[r];
+
+        int cursor = 0;
+        uint64_t token;
+        int length;
+
+        while (fc_blocklist_next_token(list->patterns + rule->pattern_offset, rule->pattern_count, rule->flags, &cursor, &token, &length))
+        {
+            uint32_t slot = fc_blocklist_slot(list, token);
+
+            if (!list->token_keys[slot])
+            {
+                list->token_keys[slot] = token;
+                list->token_rules[slot] = 0;
+            }
+
+            if (list->token_keys[slot] == token) list->token_rules[slot]++;
+        }
+    }
+
+    uint64_t* best = (uint64_t*)FC_URI_BLOCKLIST_REALLOC(NULL, (list->rule_count + 1) * sizeof(uint64_t));
+    if (!best) return false;
+
+    for (uint32_t r = 0; r < list->rule_count; ++r)
+    {
+        fc_blocklist_rule* rule = &list->rules[r];
+
+        best[r] = 0;
+        uint32_t best_uses = 0xFFFFFFFFu;
+        int best_length = 0;
+        int best_end = 0;
+
+        int cursor = 0;
+        uint64_t token;
+        int length;
+
+        while (fc_blocklist_next_token(list->patterns + rule->pattern_offset, rule->pattern_count, rule->flags, &cursor, &token, &length))
+        {
+            uint32_t slot = fc_blocklist_slot(list, token);
+            uint32_t uses = list->token_keys[slot] == token ? list->token_rules[slot] : 0;
+
+            // Single characters are in too many URLs, only use them when there's nothing else
+            if (length == 1) uses += list->rule_count;
+
+            if (uses < best_uses || (uses == best_uses && length > best_length))
+            {
+                best[r] = token;
+                best_uses = uses;
+                best_length = length;
+                best_end = cursor;
+            }
+        }
+
+        const char* pattern = list->patterns + rule->pattern_offset;
+        int best_begin = best_end - best_length;
+
+        rule->token_offset = FC_BLOCKLIST_END;
+        if (best[r] && !memchr(pattern, '*', best_begin)) rule->token_offset = best_begin;
+    }
+
+    if (!fc_blocklist_rehash(list, slot_count))
+    {
+        FC_URI_BLOCKLIST_FREE(best);
+        return false;
+    }
+
+    list->untokenized = FC_BLOCKLIST_END;
+
+    // Backwards, so that every list ends up in the order the rules were added
+    for (uint32_t r = list->rule_count; r-- > 0;)
+    {
+        fc_blocklist_rule* rule = &list->rules[r];
+
+        if (!best[r])
+        {
+            rule->token_offset = FC_BLOCKLIST_END;
+            rule->next = list->untokenized;
+            list->untokenized = r;
+            continue;
+        }
+
+        uint32_t slot = fc_blocklist_slot(list, best[r]);
+
+        if (!list->token_keys[slot])
+        {
+            list->token_keys[slot] = best[r];
+            list->token_rules[slot] = FC_BLOCKLIST_END;
+        }
+
+        if (list->token_keys[slot] != best[r])
+        {
+            rule->token_offset = FC_BLOCKLIST_END;
+            rule->next = list->untokenized;
+            list->untokenized = r;
+            continue;
+        }
+
+        rule->next = list->token_rules[slot];
+        list->token_rules[slot] = r;
+    }
+
+    FC_URI_BLOCKLIST_FREE(best);
+
+    return true;
+}
+
+void fc_blocklist_scratch_free(fc_blocklist_scratch* scratch)
+{
+    FC_URI_BLOCKLIST_FREE(scratch->url);
+    FC_URI_BLOCKLIST_FREE(scratch->rule_mark);
+
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+// Matches the pattern at url[at], or anywhere from there when floating (as if the pattern began with '*').
+// '*' backtracks to its last occurrence only, which is enough for globs: a match costs O(pattern * URL) at most.
+// A failure that got past a '*' is a failure at every later position too, *settled tells when that's the case.
+static bool fc_blocklist_match_at(const char* pattern, int pattern_count, const char* url, int url_count, int at, bool anchored_end,
+                                  bool floating, bool* settled)
+{
+    int p = 0;
+    int u = at;
+
+    int star_p = floating ? 0 : -1;
+    int star_u = at;
+
+    for (;;)
+    {
+        if (p == pattern_count)
+        {
+            if (!anchored_end || u == url_count) return true;
+        } else if (pattern[p] == '*') {
+            star_p = ++p;
+            star_u = u;
+            continue;
+        } else if (pattern[p] == '^' && (u == url_count || fc_blocklist_is_separator(url[u]))) {
+            // The end of the URL counts as a separator
+            ++p;
+            if (u < url_count) ++u;
+            continue;
+        } else if (u < url_count && pattern[p] == url[u]) {
+            ++p;
+            ++u;
+            continue;
+        }
+
+        if (star_p < 0 || star_u >= url_count)
+        {
+            *settled = star_p >= 0;
+            return false;
+        }
+
+        p = star_p;
+        u = ++star_u;
+    }
+}
+
+// token_at is where the token the rule was found by starts in the URL, -1 for rules without one.
+// *settled is set when the result holds for the later occurrences of the token too.
+static bool fc_blocklist_rule_matches(const fc_blocklist* list, const fc_blocklist_rule* rule, const char* url, int count, fc_uri_str host,
+                                      int token_at, bool* settled)
+{
+    const char* pattern = list->patterns + rule->pattern_offset;
+    bool anchored_end = (rule->flags & FC_BLOCKLIST_END_ANCHOR) != 0;
+    bool ignored;
+
+    *settled = false;
+
+    // Without a '*' before it, the token is at a fixed distance from the start of the match
+    int start = -1;
+
+    if (token_at >= 0 && rule->token_offset != FC_BLOCKLIST_END)
+    {
+        start = token_at - (int)rule->token_offset;
+        if (start < 0) return false;
+    }
+
+    if (rule->flags & FC_BLOCKLIST_START_ANCHOR)
+    {
+        *settled = true;
+        return start <= 0 && fc_blocklist_match_at(pattern, rule->pattern_count, url, count, 0, anchored_end, false, &ignored);
+    }
+
+    if (rule->flags & FC_BLOCKLIST_HOST_ANCHOR)
+    {
+        int begin = host.data ? (int)(host.data - url) : 0;
+        int end = begin + host.count;
+
+        if (!host.data || start >= end)
+        {
+            *settled = true;
+            return false;
+        }
+
+        if (start >= 0)
+        {
+            if (start < begin || (start != begin && url[start - 1] != '.')) return false;
+            return fc_blocklist_match_at(pattern, rule->pattern_count, url, count, start, anchored_end, false, settled);
+        }
+
+        *settled = true;
+
+        for (int at = begin; at < end; ++at)
+        {
+            if (at != begin && url[at - 1] != '.') continue;
+            if (fc_blocklist_match_at(pattern, rule->pattern_count, url, count, at, anchored_end, false, &ignored)) return true;
+        }
+
+        return false;
+    }
+
+    if (start >= 0) return fc_blocklist_match_at(pattern, rule->pattern_count, url, count, start, anchored_end, false, settled);
+
+    *settled = true;
+    return fc_blocklist_match_at(pattern, rule->pattern_count, url, count, 0, anchored_end, true, &ignored);
+}
+
+static bool fc_blocklist_reserve(fc_blocklist_scratch* scratch, int url_count, uint32_t rule_count)
+{
+    if (url_count > scratch->url_capacity)
+    {
+        char* url = (char*)FC_URI_BLOCKLIST_REALLOC(scratch->url, url_count);
+        if (!url) return false;
+
+        scratch->url = url;
+        scratch->url_capacity = url_count;
+    }
+
+    if (rule_count > scratch->rule_capacity)
+    {
+        uint32_t* mark = (uint32_t*)FC_URI_BLOCKLIST_REALLOC(scratch->rule_mark, rule_count * sizeof(uint32_t));
+        if (!mark) return false;
+
+        memset(mark, 0, rule_count * sizeof(uint32_t));
+
+        scratch->rule_mark = mark;
+        scratch->rule_capacity = rule_count;
+        scratch->generation = 0;
+    }
+
+    if (++scratch->generation == 0)
+    {
+        memset(scratch->rule_mark, 0, scratch->rule_capacity * sizeof(uint32_t));
+        scratch->generation = 1;
+    }
+
+    return true;
+}
+
+fc_blocklist_result fc_blocklist_match(const fc_blocklist* list, const char* url, int count, fc_blocklist_scratch* scratch, uint32_t* rule_id)
+{
+    if (count < 0) count = (int)strlen(url);
+    if (!list->token_keys) return FC_BLOCKLIST_NONE;
+    if (!fc_blocklist_reserve(scratch, count, list->rule_count)) return FC_BLOCKLIST_NONE;
+
+    char* lower = scratch->url;
+    for (int i = 0; i < count; ++i) lower[i] = fc_blocklist_lower(url[i]);
+
+    fc_uri_view view;
+    fc_uri_str host = {};
+
+    if (fc_uri_parse_view(lower, count, &view)) host = view.host;
+
+    const fc_blocklist_rule* blocked_by = NULL;
+    const fc_blocklist_rule* allowed_by = NULL;
+
+    // Candidates from the URL tokens, then the rules without a token
+    for (int i = 0; i <= count;)
+    {
+        uint32_t r = FC_BLOCKLIST_END;
+        int token_at = -1;
+
+        if (i == count) {
+            r = list->untokenized;
+            ++i;
+        } else if (!fc_blocklist_is_token(lower[i])) {
+            ++i;
+            continue;
+        } else {
+            token_at = i;
+            while (i < count && fc_blocklist_is_token(lower[i])) ++i;
+
+            uint64_t token = fc_uri_hash(lower + token_at, i - token_at, 0) | 1;
+            uint32_t slot = fc_blocklist_slot(list, token);
+
+            if (list->token_keys[slot] == token) r = list->token_rules[slot];
+        }
+
+        for (; r != FC_BLOCKLIST_END; r = list->rules[r].next)
+        {
+            const fc_blocklist_rule* rule = &list->rules[r];
+
+            if (scratch->rule_mark[r] == scratch->generation) continue;
+
+            // One rule of each kind is enough
+            bool exception = (rule->flags & FC_BLOCKLIST_EXCEPTION) != 0;
+            if (exception ? allowed_by != NULL : blocked_by != NULL) continue;
+
+            // Rules anchored by their token are tried at every occurrence of it, until the result can't change
+            bool settled;
+            bool matches = fc_blocklist_rule_matches(list, rule, lower, count, host, token_at, &settled);
+
+            if (settled || matches) scratch->rule_mark[r] = scratch->generation;
+            if (!matches) continue;
+
+            if (exception) {
+                allowed_by = rule;
+            } else {
+                blocked_by = rule;
+            }
+
+            if (blocked_by && allowed_by) break;
+        }
+
+        if (blocked_by && allowed_by) break;
+    }
+
+    // Exceptions only matter for URLs that something blocks
+    if (!blocked_by) return FC_BLOCKLIST_NONE;
+
+    if (allowed_by)
+    {
+        if (rule_id) *rule_id = allowed_by->id;
+        return FC_BLOCKLIST_ALLOW;
+    }
+
+    if (rule_id) *rule_id = blocked_by->id;
+    return FC_BLOCKLIST_BLOCK;
+}
+
+#endif // FC_URI_BLOCKLIST_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,285 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_CACHE_IMPLEMENTATION
+        #include "fc_uri_cache.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_cache.h"
+    "
+
+Example:
+    fc_uri_cache cache;
+    fc_uri_cache_init(&cache, 4096);
+
+    // From any thread
+    fc_uri_view uri;
+    if (fc_uri_cache_parse(&cache, request_uri, request_uri_length, &uri))
+    {
+        // Same as fc_uri_parse_view, uri points into request_uri
+    }
+
+    fc_uri_cache_free(&cache);
+
+Info:
+    Cache of parse results in front of fc_uri_parse_view, keyed by the input bytes.
+
+    The cache is set associative: the hash of the input picks a set of FC_URI_CACHE_WAYS entries, each set
+    has its own lock and evicts with the CLOCK algorithm, so threads only contend when they hit the same set.
+    An entry stores the input (to compare it on lookup) and the component offsets, inputs longer than
+    FC_URI_CACHE_KEY_MAX are parsed without going through the cache.
+
+    Memory is allocated once in fc_uri_cache_init, lookups and inserts don't allocate.
+    Requires POSIX threads.
+*/
+
+#ifndef FC_URI_CACHE
+#define FC_URI_CACHE
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <pthread.h>
+
+#ifndef FC_URI_CACHE_KEY_MAX
+#define FC_URI_CACHE_KEY_MAX 128
+#endif
+
+#define FC_URI_CACHE_WAYS 8
+
+typedef struct
+{
+    uint64_t hash; // 0 for empty entries
+    uint16_t key_count;
+    uint8_t  flags;
+
+    uint16_t offset[FC_URI_COMPONENT_COUNT];
+    uint16_t count[FC_URI_COMPONENT_COUNT];
+
+    char key[FC_URI_CACHE_KEY_MAX];
+} fc_uri_cache_entry;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    int hand;
+
+    fc_uri_cache_entry entries[FC_URI_CACHE_WAYS];
+} fc_uri_cache_set;
+
+typedef struct
+{
+    fc_uri_cache_set* sets;
+    uint64_t set_mask;
+} fc_uri_cache;
+
+// capacity is rounded up to a power of two number of sets.
+bool fc_uri_cache_init(fc_uri_cache* cache, int capacity);
+void fc_uri_cache_free(fc_uri_cache* cache);
+
+// Same as fc_uri_parse_view, failures are cached too.
+bool fc_uri_cache_parse(fc_uri_cache* cache, const char* src, int count, fc_uri_view* view);
+
+#endif // FC_URI_CACHE
+
+#ifdef FC_URI_CACHE_IMPLEMENTATION
+
+#include <string.h> // memcmp, memcpy
+#include <stddef.h> // offsetof
+
+#ifndef FC_URI_CACHE_MALLOC
+#include <stdlib.h>
+#define FC_URI_CACHE_MALLOC(size) malloc(size)
+#endif
+#ifndef FC_URI_CACHE_FREE
+#include <stdlib.h>
+#define FC_URI_CACHE_FREE(ptr)    free(ptr)
+#endif
+
+#define FC_URI_CACHE_ABSENT 0xFFFF
+
+enum
+{
+    FC_URI_CACHE_PARSED     = 1 << 0,
+    FC_URI_CACHE_IPV6_HOST  = 1 << 1,
+    FC_URI_CACHE_REFERENCED = 1 << 2, // CLOCK bit
+};
+
+bool fc_uri_cache_init(fc_uri_cache* cache, int capacity)
+{
+    uint64_t set_count = 1;
+    while (set_count * FC_URI_CACHE_WAYS < (uint64_t)capacity) set_count *= 2;
+
+    cache->sets = (fc_uri_cache_set*)FC_URI_CACHE_MALLOC(set_count * sizeof(fc_uri_cache_set));
+    if (!cache->sets) return false;
+
+    cache->set_mask = set_count - 1;
+
+    for (uint64_t i = 0; i < set_count; ++i)
+    {
+        pthread_mutex_init(&cache->sets[i].lock, NULL);
+        cache->sets[i].hand = 0;
+
+        for (int way = 0; way < FC_URI_CACHE_WAYS; ++way)
+        {
+            cache->sets[i].entries[way].hash = 0;
+        }
+    }
+
+    return true;
+}
+
+void fc_uri_cache_free(fc_uri_cache* cache)
+{
+    if (!cache->sets) return;
+
+    for (uint64_t i = 0; i <= cache->set_mask; ++i)
+    {
+        pthread_mutex_destroy(&cache->sets[i].lock);
+    }
+
+    FC_URI_CACHE_FREE(cache->sets);
+    cache->sets = NULL;
+}
+
+static bool fc_uri_cache_expand(const fc_uri_cache_entry* entry, const char* src, fc_uri_view* view)
+{
+    *view = fc_uri_view{};
+
+    if (!(entry->flags & FC_URI_CACHE_PARSED)) return false;
+
+    fc_uri_str* components[FC_URI_COMPONENT_COUNT] = {
+        &view->scheme, &view->user, &view->access_info, &view->host,
+        &view->port, &view->path, &view->query, &view->fragment,
+    };
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        if (entry->count[c] == FC_URI_CACHE_ABSENT) continue;
+
+        components[c]->data  = src + entry->offset[c];
+        components[c]->count = entry->count[c];
+    }
+
+    view->ipv6_host = (entry->flags & FC_URI_CACHE_IPV6_HOST) != 0;
+
+    return true;
+}
+
+bool fc_uri_cache_parse(fc_uri_cache* cache, const char* src, int count, fc_uri_view* view)
+{
+    if (count < 0) count = (int)strlen(src);
+
+    if (count > FC_URI_CACHE_KEY_MAX)
+    {
+        return fc_uri_parse_view(src, count, view);
+    }
+
+    uint64_t hash = fc_uri_hash(src, count, 0);
+    if (hash == 0) hash = 1;
+
+    fc_uri_cache_set* set = &cache->sets[hash & cache->set_mask];
+
+    pthread_mutex_lock(&set->lock);
+
+    for (int way = 0; way < FC_URI_CACHE_WAYS; ++way)
+    {
+        fc_uri_cache_entry* entry = &set->entries[way];
+
+        if (entry->hash == hash && entry->key_count == count && memcmp(entry->key, src, count) == 0)
+        {
+            entry->flags |= FC_URI_CACHE_REFERENCED;
+            bool parsed = fc_uri_cache_expand(entry, src, view);
+
+            pthread_mutex_unlock(&set->lock);
+            return parsed;
+        }
+    }
+
+    pthread_mutex_unlock(&set->lock);
+
+    // Miss, parse outside of the lock
+    bool parsed = fc_uri_parse_view(src, count, view);
+
+    fc_uri_cache_entry fresh;
+    fresh.hash      = hash;
+    fresh.key_count = (uint16_t)count;
+    fresh.flags     = (parsed ? FC_URI_CACHE_PARSED : 0) | (view->ipv6_host ? FC_URI_CACHE_IPV6_HOST : 0);
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        fc_uri_str component = fc_uri_view_component(view, (fc_uri_component)c);
+
+        fresh.offset[c] = component.data ? (uint16_t)(component.data - src) : 0;
+        fresh.count[c]  = component.data ? (uint16_t)component.count : FC_URI_CACHE_ABSENT;
+    }
+
+    memcpy(fresh.key, src, count);
+
+    pthread_mutex_lock(&set->lock);
+
+    // Another thread may have inserted the same input in the meantime
+    for (int way = 0; way < FC_URI_CACHE_WAYS; ++way)
+    {
+        fc_uri_cache_entry* entry = &set->entries[way];
+
+        if (entry->hash == hash && entry->key_count == count && memcmp(entry->key, src, count) == 0)
+        {
+            pthread_mutex_unlock(&set->lock);
+            return parsed;
+        }
+    }
+
+    // CLOCK: skip (and clear) recently referenced entries, empty ones are taken right away.
+    for (;;)
+    {
+        fc_uri_cache_entry* entry = &set->entries[set->hand];
+        set->hand = (set->hand + 1) % FC_URI_CACHE_WAYS;
+
+        if (entry->hash == 0 || !(entry->flags & FC_URI_CACHE_REFERENCED))
+        {
+            memcpy(entry, &fresh, offsetof(fc_uri_cache_entry, key) + count);
+            break;
+        }
+
+        entry->flags &= ~FC_URI_CACHE_REFERENCED;
+    }
+
+    pthread_mutex_unlock(&set->lock);
+
+    return parsed;
+}
+
+#endif // FC_URI_CACHE_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,603 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_CANONICAL_IMPLEMENTATION
+        #include "fc_uri_canonical.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_canonical.h"
+    "
+
+Example:
+    fc_uri_view uri;
+    fc_uri_parse_view("https://store.local/bucket/my%20file.txt?uploads&prefix=a+b", -1, &uri);
+
+    fc_canonical_header headers[] = {
+        { { "Host", 4 },                  { "store.local", 11 } },
+        { { "X-Amz-Date", 10 },           { "20240101T000000Z", 16 } },
+        { { "X-Amz-Content-Sha256", 20 }, { payload_hash, 64 } },
+    };
+
+    fc_sha256 sha;
+    fc_sha256_begin(&sha);
+
+    if (!fc_canonical_request("PUT", &uri, headers, 3, payload_hash, fc_sha256_sink, &sha))
+    {
+        // Too many query parameters or headers
+    }
+
+    unsigned char digest[32];
+    fc_sha256_finish(&sha, digest); // Hash of the canonical request, goes into the string to sign
+
+Info:
+    Canonical request of AWS Signature Version 4 and the stores that copied it:
+
+        METHOD\n
+        /canonical/path\n
+        sorted=query&params=\n
+        lowercase-name:trimmed value\n ... \n
+        \n
+        signed;header;names\n
+        payload hash
+
+    Nothing is materialized, the pieces are encoded into a small buffer that is passed to a sink every time it
+    fills up, usually an incremental hash. fc_sha256 is provided for that.
+
+    Path segments and query keys and values are percent-decoded and then encoded again with the strict RFC 3986
+    rules: only ALPHA, DIGIT and "-._~" are left as they are, everything else becomes an uppercase %XX.
+    Encoding the decoded bytes makes already encoded and raw input give the same result. '+' is not a space.
+    The path is encoded once and dot segments are kept, like S3 does; an empty path is "/".
+
+    Query parameters are sorted by encoded key and then by encoded value, comparing the encoded forms on the fly.
+    A parameter without '=' has an empty value. Header names are lowercased, values are trimmed and runs of
+    spaces are collapsed, headers with the same name are joined with ','. At most FC_CANONICAL_MAX_PARAMS query
+    parameters and FC_CANONICAL_MAX_HEADERS headers are supported, nothing is allocated.
+*/
+
+#ifndef FC_URI_CANONICAL
+#define FC_URI_CANONICAL
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+#ifndef FC_CANONICAL_MAX_PARAMS
+#define FC_CANONICAL_MAX_PARAMS 256
+#endif
+
+#ifndef FC_CANONICAL_MAX_HEADERS
+#define FC_CANONICAL_MAX_HEADERS 64
+#endif
+
+typedef struct
+{
+    fc_uri_str name;
+    fc_uri_str value;
+} fc_canonical_header;
+
+// Receives the canonical request piece by piece, in order.
+typedef void fc_canonical_sink(void* context, const char* data, int count);
+
+// method and payload_hash are null-terminated. The headers are the ones to sign, in any order.
+// Returns false if there are too many query parameters or headers, the sink may have been called already.
+bool fc_canonical_request(const char* method, const fc_uri_view* uri, const fc_canonical_header* headers, int header_count,
+                          const char* payload_hash, fc_canonical_sink* sink, void* context);
+
+typedef struct
+{
+    uint32_t state[8];
+    uint64_t length;
+
+    unsigned char block[64];
+    int block_count;
+} fc_sha256;
+
+void fc_sha256_begin(fc_sha256* sha);
+void fc_sha256_update(fc_sha256* sha, const void* data, int count);
+void fc_sha256_finish(fc_sha256* sha, unsigned char digest[32]);
+
+// fc_canonical_sink that updates the fc_sha256 in context.
+void fc_sha256_sink(void* context, const char* data, int count);
+
+#endif // FC_URI_CANONICAL
+
+#ifdef FC_URI_CANONICAL_IMPLEMENTATION
+
+#include <string.h> // memcpy
+#include <stdlib.h> // qsort
+
+#define FC_CANON_BUFFER_SIZE 512
+
+typedef struct
+{
+    char buffer[FC_CANON_BUFFER_SIZE];
+    int count;
+
+    fc_canonical_sink* sink;
+    void* context;
+} fc_canon_writer;
+
+static void fc_canon_flush(fc_canon_writer* writer)
+{
+    if (writer->count) writer->sink(writer->context, writer->buffer, writer->count);
+    writer->count = 0;
+}
+
+static void fc_canon_write(fc_canon_writer* writer, const char* data, int count)
+{
+    if (writer->count + count > FC_CANON_BUFFER_SIZE)
+    {
+        fc_canon_flush(writer);
+
+        if (count > FC_CANON_BUFFER_SIZE)
+        {
+            writer->sink(writer->context, data, count);
+            return;
+        }
+    }
+
+    memcpy(writer->buffer + writer->count, data, count);
+    writer->count += count;
+}
+
+static void fc_canon_write_char(fc_canon_writer* writer, char c)
+{
+    if (writer->count == FC_CANON_BUFFER_SIZE) fc_canon_flush(writer);
+    writer->buffer[writer->count++] = c;
+}
+
+static bool fc_canon_is_unreserved(unsigned char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+static int fc_canon_hex_value(char c)
+{
+    if ((unsigned)(c - '0') < 10) return c - '0';
+    if ((unsigned)((c | 0x20) - 'a') < 6) return (c | 0x20) - 'a' + 10;
+    return -1;
+}
+
+// Encoded form of a decoded byte, returns its length.
+static int fc_canon_encode_byte(unsigned char c, char encoded[3])
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    if (fc_canon_is_unreserved(c))
+    {
+        encoded[0] = (char)c;
+        return 1;
+    }
+
+    encoded[0] = '%';
+    encoded[1] = hex[c >> 4];
+    encoded[2] = hex[c & 15];
+    return 3;
+}
+
+// Decodes the byte at *c, either raw or a %XX escape, and moves past it.
+static unsigned char fc_canon_next_byte(const char** c, const char* end)
+{
+    const char* at = *c;
+
+    if (*at == '%' && end - at >= 3 && fc_canon_hex_value(at[1]) >= 0 && fc_canon_hex_value(at[2]) >= 0)
+    {
+        *c = at + 3;
+        return (unsigned char)(fc_canon_hex_value(at[1]) * 16 + fc_canon_hex_value(at[2]));
+    }
+
+    *c = at + 1;
+    return (unsigned char)*at;
+}
+
+// Strict encoding of the decoded [data, data + count). Runs that need no change are written as they are.
+static void fc_canon_write_encoded(fc_canon_writer* writer, const char* data, int count)
+{
+    const char* c = data;
+    const char* end = data + count;
+
+    while (c != end)
+    {
+        const char* run = c;
+        while (c != end && fc_canon_is_unreserved((unsigned char)*c)) c++;
+
+        if (c != run) fc_canon_write(writer, run, (int)(c - run));
+        if (c == end) break;
+
+        char encoded[3];
+        int encoded_count = fc_canon_encode_byte(fc_canon_next_byte(&c, end), encoded);
+        fc_canon_write(writer, encoded, encoded_count);
+    }
+}
+
+// Walks the encoded form of a component one character at a time, for sorting.
+typedef struct
+{
+    const char* c;
+    const char* end;
+
+    char encoded[3];
+    int encoded_count;
+    int encoded_at;
+} fc_canon_cursor;
+
+static void fc_canon_cursor_begin(fc_canon_cursor* cursor, fc_uri_str str)
+{
+    cursor->c = str.data;
+    cursor->end = str.data + str.count;
+    cursor->encoded_count = 0;
+    cursor->encoded_at = 0;
+}
+
+// Next encoded character, -1 at the end.
+static int fc_canon_cursor_next(fc_canon_cursor* cursor)
+{
+    if (cursor->encoded_at == cursor->encoded_count)
+    {
+        if (cursor->c == cursor->end) return -1;
+
+        cursor->encoded_count = fc_canon_encode_byte(fc_canon_next_byte(&cursor->c, cursor->end), cursor->encoded);
+        cursor->encoded_at = 0;
+    }
+
+    return (unsigned char)cursor->encoded[cursor->encoded_at++];
+}
+
+static int fc_canon_compare_encoded(fc_uri_str a, fc_uri_str b)
+{
+    fc_canon_cursor cursor_a, cursor_b;
+    fc_canon_cursor_begin(&cursor_a, a);
+    fc_canon_cursor_begin(&cursor_b, b);
+
+    for (;;)
+    {
+        int ca = fc_canon_cursor_next(&cursor_a);
+        int cb = fc_canon_cursor_next(&cursor_b);
+
+        if (ca != cb) return ca < cb ? -1 : 1;
+        if (ca < 0) return 0;
+    }
+}
+
+typedef struct
+{
+    fc_uri_str key;
+    fc_uri_str value;
+} fc_canon_param;
+
+static int fc_canon_compare_params(const void* a, const void* b)
+{
+    const fc_canon_param* pa = (const fc_canon_param*)a;
+    const fc_canon_param* pb = (const fc_canon_param*)b;
+
+    int result = fc_canon_compare_encoded(pa->key, pb->key);
+    if (result) return result;
+
+    return fc_canon_compare_encoded(pa->value, pb->value);
+}
+
+static char fc_canon_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static int fc_canon_compare_names(fc_uri_str a, fc_uri_str b)
+{
+    int count = a.count < b.count ? a.count : b.count;
+
+    for (int i = 0; i < count; ++i)
+    {
+        char ca = fc_canon_lower(a.data[i]);
+        char cb = fc_canon_lower(b.data[i]);
+
+        if (ca != cb) return (unsigned char)ca < (unsigned char)cb ? -1 : 1;
+    }
+
+    return a.count - b.count;
+}
+
+static void fc_canon_write_lower(fc_canon_writer* writer, fc_uri_str str)
+{
+    for (int i = 0; i < str.count; ++i) fc_canon_write_char(writer, fc_canon_lower(str.data[i]));
+}
+
+// Trimmed, with every run of spaces and tabs written as a single space.
+static void fc_canon_write_trimmed(fc_canon_writer* writer, fc_uri_str str)
+{
+    const char* c = str.data;
+    const char* end = str.data + str.count;
+
+    while (c != end && (*c == ' ' || *c == '\t')) c++;
+    while (end != c && (end[-1] == ' ' || end[-1] == '\t')) end--;
+
+    while (c != end)
+    {
+        const char* run = c;
+        while (c != end && *c != ' ' && *c != '\t') c++;
+
+        fc_canon_write(writer, run, (int)(c - run));
+        if (c == end) break;
+
+        fc_canon_write_char(writer, ' ');
+        while (*c == ' ' || *c == '\t') c++;
+    }
+}
+
+bool fc_canonical_request(const char* method, const fc_uri_view* uri, const fc_canonical_header* headers, int header_count,
+                          const char* payload_hash, fc_canonical_sink* sink, void* context)
+{
+    if (header_count > FC_CANONICAL_MAX_HEADERS) return false;
+
+    fc_canon_param params[FC_CANONICAL_MAX_PARAMS];
+    int param_count = 0;
+
+    const char* c = uri->query.data;
+    const char* query_end = c + uri->query.count;
+
+    while (c && c < query_end)
+    {
+        const char* param_end = (const char*)memchr(c, '&', query_end - c);
+        if (!param_end) param_end = query_end;
+
+        if (param_end != c)
+        {
+            if (param_count == FC_CANONICAL_MAX_PARAMS) return false;
+
+            const char* equals = (const char*)memchr(c, '=', param_end - c);
+
+            fc_canon_param* param = &params[param_count++];
+            param->key.data  = c;
+            param->key.count = (int)((equals ? equals : param_end) - c);
+            param->value.data  = equals ? equals + 1 : param_end;
+            param->value.count = (int)(param_end - param->value.data);
+        }
+
+        c = param_end + 1;
+    }
+
+    qsort(params, param_count, sizeof(fc_canon_param), fc_canon_compare_params);
+
+    // Headers are few, insertion sort of their indices keeps equal names in the given order.
+    int order[FC_CANONICAL_MAX_HEADERS];
+    for (int i = 0; i < header_count; ++i)
+    {
+        int j = i;
+        while (j > 0 && fc_canon_compare_names(headers[order[j - 1]].name, headers[i].name) > 0)
+        {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    fc_canon_writer writer;
+    writer.count = 0;
+    writer.sink = sink;
+    writer.context = context;
+
+    fc_canon_write(&writer, method, (int)strlen(method));
+    fc_canon_write_char(&writer, '\n');
+
+    // Path, segment by segment so that '/' stays
+    if (uri->path.count == 0) {
+        fc_canon_write_char(&writer, '/');
+    } else {
+        const char* segment = uri->path.data;
+        const char* path_end = segment + uri->path.count;
+
+        for (;;)
+        {
+            const char* slash = (const char*)memchr(segment, '/', path_end - segment);
+            const char* segment_end = slash ? slash : path_end;
+
+            fc_canon_write_encoded(&writer, segment, (int)(segment_end - segment));
+            if (!slash) break;
+
+            fc_canon_write_char(&writer, '/');
+            segment = slash + 1;
+        }
+    }
+    fc_canon_write_char(&writer, '\n');
+
+    for (int i = 0; i < param_count; ++i)
+    {
+        if (i) fc_canon_write_char(&writer, '&');
+
+        fc_canon_write_encoded(&writer, params[i].key.data, params[i].key.count);
+        fc_canon_write_char(&writer, '=');
+        fc_canon_write_encoded(&writer, params[i].value.data, params[i].value.count);
+    }
+    fc_canon_write_char(&writer, '\n');
+
+    for (int i = 0; i < header_count; ++i)
+    {
+        const fc_canonical_header* header = &headers[order[i]];
+
+        if (i == 0 || fc_canon_compare_names(headers[order[i - 1]].name, header->name) != 0) {
+            fc_canon_write_lower(&writer, header->name);
+            fc_canon_write_char(&writer, ':');
+        } else {
+            fc_canon_write_char(&writer, ',');
+        }
+
+        fc_canon_write_trimmed(&writer, header->value);
+
+        if (i + 1 == header_count || fc_canon_compare_names(headers[order[i + 1]].name, header->name) != 0)
+        {
+            fc_canon_write_char(&writer, '\n');
+        }
+    }
+    fc_canon_write_char(&writer, '\n');
+
+    for (int i = 0; i < header_count; ++i)
+    {
+        if (i && fc_canon_compare_names(headers[order[i - 1]].name, headers[order[i]].name) == 0) continue;
+
+        if (i) fc_canon_write_char(&writer, ';');
+        fc_canon_write_lower(&writer, headers[order[i]].name);
+    }
+    fc_canon_write_char(&writer, '\n');
+
+    fc_canon_write(&writer, payload_hash, (int)strlen(payload_hash));
+
+    fc_canon_flush(&writer);
+
+    return true;
+}
+
+// SHA-256 (FIPS 180-4)
+
+static const uint32_t fc_sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static uint32_t fc_sha256_rotr(uint32_t x, int n)
+{
+    return (x >> n) | (x << (32 - n));
+}
+
+static void fc_sha256_block(fc_sha256* sha, const unsigned char* block)
+{
+    uint32_t w[64];
+
+    for (int i = 0; i < 16; ++i)
+    {
+        w[i] = ((uint32_t)block[i * 4] << 24) | ((uint32_t)block[i * 4 + 1] << 16) | ((uint32_t)block[i * 4 + 2] << 8) | block[i * 4 + 3];
+    }
+
+    for (int i = 16; i < 64; ++i)
+    {
+        uint32_t s0 = fc_sha256_rotr(w[i - 15], 7) ^ fc_sha256_rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = fc_sha256_rotr(w[i - 2], 17) ^ fc_sha256_rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = sha->state[0], b = sha->state[1], c = sha->state[2], d = sha->state[3];
+    uint32_t e = sha->state[4], f = sha->state[5], g = sha->state[6], h = sha->state[7];
+
+    for (int i = 0; i < 64; ++i)
+    {
+        uint32_t s1 = fc_sha256_rotr(e, 6) ^ fc_sha256_rotr(e, 11) ^ fc_sha256_rotr(e, 25);
+        uint32_t t1 = h + s1 + ((e & f) ^ (~e & g)) + fc_sha256_k[i] + w[i];
+        uint32_t s0 = fc_sha256_rotr(a, 2) ^ fc_sha256_rotr(a, 13) ^ fc_sha256_rotr(a, 22);
+        uint32_t t2 = s0 + ((a & b) ^ (a & c) ^ (b & c));
+
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    sha->state[0] += a; sha->state[1] += b; sha->state[2] += c; sha->state[3] += d;
+    sha->state[4] += e; sha->state[5] += f; sha->state[6] += g; sha->state[7] += h;
+}
+
+void fc_sha256_begin(fc_sha256* sha)
+{
+    static const uint32_t initial[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+    };
+
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length = 0;
+    sha->block_count = 0;
+}
+
+void fc_sha256_update(fc_sha256* sha, const void* data, int count)
+{
+    const unsigned char* c = (const unsigned char*)data;
+
+    sha->length += count;
+
+    if (sha->block_count)
+    {
+        int take = 64 - sha->block_count;
+        if (take > count) take = count;
+
+        memcpy(sha->block + sha->block_count, c, take);
+        sha->block_count += take;
+        c += take;
+        count -= take;
+
+        if (sha->block_count < 64) return;
+
+        fc_sha256_block(sha, sha->block);
+        sha->block_count = 0;
+    }
+
+    for (; count >= 64; c += 64, count -= 64) fc_sha256_block(sha, c);
+
+    memcpy(sha->block, c, count);
+    sha->block_count = count;
+}
+
+void fc_sha256_finish(fc_sha256* sha, unsigned char digest[32])
+{
+    uint64_t bit_length = sha->length * 8;
+
+    sha->block[sha->block_count++] = 0x80;
+
+    if (sha->block_count > 56)
+    {
+        memset(sha->block + sha->block_count, 0, 64 - sha->block_count);
+        fc_sha256_block(sha, sha->block);
+        sha->block_count = 0;
+    }
+
+    memset(sha->block + sha->block_count, 0, 56 - sha->block_count);
+    for (int i = 0; i < 8; ++i) sha->block[56 + i] = (unsigned char)(bit_length >> (56 - i * 8));
+
+    fc_sha256_block(sha, sha->block);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        digest[i * 4]     = (unsigned char)(sha->state[i] >> 24);
+        digest[i * 4 + 1] = (unsigned char)(sha->state[i] >> 16);
+        digest[i * 4 + 2] = (unsigned char)(sha->state[i] >> 8);
+        digest[i * 4 + 3] = (unsigned char)(sha->state[i]);
+    }
+}
+
+void fc_sha256_sink(void* context, const char* data, int count)
+{
+    fc_sha256_update((fc_sha256*)context, data, count);
+}
+
+#endif // FC_URI_CANONICAL_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
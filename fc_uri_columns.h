@@ -0,0 +1,807 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_COLUMNS_IMPLEMENTATION
+        #include "fc_uri_columns.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_columns.h"
+    "
+
+Example:
+    fc_uri_columns_writer* writer = (fc_uri_columns_writer*)malloc(sizeof(fc_uri_columns_writer)); // ~10KB
+    fc_uri_columns_writer_begin(writer, 1 << FC_URI_PATH); // Front code the paths
+
+    fc_uri_view uri;
+    while (next_uri(&uri))
+    {
+        fc_uri_columns_writer_add(writer, &uri);
+    }
+
+    fc_uri_columns_writer_write(writer, "uris.columns");
+    fc_uri_columns_writer_free(writer);
+
+    fc_uri_columns columns;
+    fc_uri_columns_map(&columns, "uris.columns");
+
+    char buffer[FC_URI_MAX + 1];
+    for (int64_t row = 0; row < columns.row_count; ++row)
+    {
+        fc_uri_str host = fc_uri_columns_get(&columns, row, FC_URI_HOST, buffer);
+        fc_uri_str path = fc_uri_columns_get(&columns, row, FC_URI_PATH, buffer);
+    }
+
+    // Or group by host without looking at the bytes
+    uint32_t code = fc_uri_columns_code(&columns, row, FC_URI_HOST);
+    fc_uri_str host = fc_uri_columns_entry(&columns, FC_URI_HOST, code);
+
+    fc_uri_columns_free(&columns);
+
+Info:
+    Column store of parsed URIs, one column per component.
+
+    Scheme, host and port are dictionary encoded: every distinct value is stored once and rows store its code,
+    in 1, 2 or 4 bytes depending on how many values there are. Code 0 means the component is absent.
+    The other components are stored as bytes with an offset per row and a bitmap telling which rows have them.
+    Columns chosen at fc_uri_columns_writer_begin are front coded instead: every value is stored as the length
+    of the prefix it shares with the previous row plus the rest of its bytes, with a full value every
+    FC_URI_COLUMNS_RESTART rows. That's worth it when the rows are sorted (paths of the same host next to each other).
+
+    A component is read without touching the other columns. Views point into the mapping, except for front coded
+    columns which are decoded into the buffer passed to fc_uri_columns_get.
+
+    File layout, integers in native byte order, every section starts at a multiple of 8:
+        "FCURITAB", uint64 row_count, uint32 column_count, uint32 front_coded, uint64 ipv6_bitmap,
+        fc_uri_columns_column columns[column_count], sections
+    Requires POSIX (mmap).
+*/
+
+#ifndef FC_URI_COLUMNS
+#define FC_URI_COLUMNS
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FC_URI_COLUMNS_RESTART 16
+
+typedef enum
+{
+    FC_URI_COLUMNS_DICTIONARY,
+    FC_URI_COLUMNS_BYTES,
+    FC_URI_COLUMNS_FRONT_CODED,
+} fc_uri_columns_kind;
+
+// As stored in the file, section positions are from the start of the file.
+typedef struct
+{
+    uint32_t kind;
+    uint32_t width;       // Bytes per code, dictionary columns only
+    uint64_t entry_count; // Dictionary entries, or rows
+    uint64_t codes;       // Codes, or presence bitmap
+    uint64_t offsets;     // uint64 per entry + 1, per row + 1, or per restart
+    uint64_t data;
+    uint64_t data_size;
+} fc_uri_columns_column;
+
+typedef struct
+{
+    uint8_t* data;
+    uint64_t count;
+    uint64_t capacity;
+} fc_uri_columns_buffer;
+
+typedef struct
+{
+    fc_uri_columns_buffer codes;   // uint32 per row, or presence bitmap
+    fc_uri_columns_buffer offsets; // uint64
+    fc_uri_columns_buffer data;
+
+    // Dictionary
+    fc_uri_columns_buffer hashes; // uint64 per entry
+    uint32_t* table;              // Entry index + 1, 0 for empty slots
+    uint32_t table_mask;
+    uint32_t entry_count;
+
+    // Front coding
+    char previous[FC_URI_MAX + 1];
+    int  previous_count;
+} fc_uri_columns_column_writer;
+
+typedef struct
+{
+    int64_t row_count;
+    uint32_t front_coded;
+    bool failed; // Out of memory, nothing will be written
+
+    fc_uri_columns_buffer ipv6;
+    fc_uri_columns_column_writer columns[FC_URI_COMPONENT_COUNT];
+} fc_uri_columns_writer;
+
+typedef struct
+{
+    int64_t row_count;
+
+    const fc_uri_columns_column* columns;
+    const uint8_t* ipv6;
+
+    // Internal
+    void*  image;
+    size_t image_size;
+} fc_uri_columns;
+
+// front_coded is a mask of (1 << component), only for the components that aren't dictionary encoded.
+void fc_uri_columns_writer_begin(fc_uri_columns_writer* writer, uint32_t front_coded);
+// Returns false if the row was not added: a front coded component is longer than FC_URI_MAX, or out of memory
+// (failed is set and nothing will be written).
+bool fc_uri_columns_writer_add(fc_uri_columns_writer* writer, const fc_uri_view* uri);
+bool fc_uri_columns_writer_write(const fc_uri_columns_writer* writer, const char* path);
+void fc_uri_columns_writer_free(fc_uri_columns_writer* writer);
+
+bool fc_uri_columns_map(fc_uri_columns* columns, const char* path);
+void fc_uri_columns_free(fc_uri_columns* columns);
+
+// buffer (FC_URI_MAX + 1 bytes) is only written for front coded columns. data is NULL for absent components.
+fc_uri_str fc_uri_columns_get(const fc_uri_columns* columns, int64_t row, fc_uri_component component, char* buffer);
+
+bool fc_uri_columns_ipv6_host(const fc_uri_columns* columns, int64_t row);
+
+// Dictionary columns only: the code of the row (0 when absent) and the value of a code.
+uint32_t   fc_uri_columns_code(const fc_uri_columns* columns, int64_t row, fc_uri_component component);
+fc_uri_str fc_uri_columns_entry(const fc_uri_columns* columns, fc_uri_component component, uint32_t code);
+
+#ifdef FC_URI_COLUMNS_IMPLEMENTATION
+
+#include <string.h>   // memcmp, memcpy, memset
+#include <stdio.h>    // FILE
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+
+#ifndef FC_URI_COLUMNS_REALLOC
+#include <stdlib.h>
+#define FC_URI_COLUMNS_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_COLUMNS_FREE
+#include <stdlib.h>
+#define FC_URI_COLUMNS_FREE(ptr)          free(ptr)
+#endif
+
+#define FC_URI_COLUMNS_HEADER_SIZE 32
+
+static const char fc_uri_columns_magic[8] = { 'F', 'C', 'U', 'R', 'I', 'T', 'A', 'B' };
+
+static fc_uri_columns_kind fc_uri_columns_kind_of(uint32_t front_coded, int component)
+{
+    if (component == FC_URI_SCHEME || component == FC_URI_HOST || component == FC_URI_PORT) return FC_URI_COLUMNS_DICTIONARY;
+
+    return (front_coded & (1u << component)) ? FC_URI_COLUMNS_FRONT_CODED : FC_URI_COLUMNS_BYTES;
+}
+
+static bool fc_uri_columns_append(fc_uri_columns_buffer* buffer, const void* data, uint64_t count)
+{
+    if (buffer->count + count > buffer->capacity)
+    {
+        uint64_t capacity = buffer->capacity ? buffer->capacity : 256;
+        while (capacity < buffer->count + count) capacity *= 2;
+
+        uint8_t* resized = (uint8_t*)FC_URI_COLUMNS_REALLOC(buffer->data, capacity);
+        if (!resized) return false;
+
+        buffer->data = resized;
+        buffer->capacity = capacity;
+    }
+
+    if (count) memcpy(buffer->data + buffer->count, data, count);
+    buffer->count += count;
+
+    return true;
+}
+
+static bool fc_uri_columns_append_u64(fc_uri_columns_buffer* buffer, uint64_t value)
+{
+    return fc_uri_columns_append(buffer, &value, 8);
+}
+
+static bool fc_uri_columns_append_varint(fc_uri_columns_buffer* buffer, uint64_t value)
+{
+    uint8_t bytes[10];
+    int count = 0;
+
+    while (value >= 0x80)
+    {
+        bytes[count++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[count++] = (uint8_t)value;
+
+    return fc_uri_columns_append(buffer, bytes, count);
+}
+
+// Returns false if the varint doesn't end before size or doesn't fit 64 bits.
+static bool fc_uri_columns_read_varint(const uint8_t* data, uint64_t size, uint64_t* position, uint64_t* value)
+{
+    *value = 0;
+
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (*position >= size) return false;
+
+        uint8_t byte = data[(*position)++];
+        *value |= (uint64_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) return true;
+    }
+
+    return false;
+}
+
+static bool fc_uri_columns_set_bit(fc_uri_columns_buffer* bitmap, int64_t index, bool value)
+{
+    if (index % 8 == 0)
+    {
+        uint8_t zero = 0;
+        if (!fc_uri_columns_append(bitmap, &zero, 1)) return false;
+    }
+
+    if (value) bitmap->data[index / 8] |= (uint8_t)(1 << (index % 8));
+
+    return true;
+}
+
+void fc_uri_columns_writer_begin(fc_uri_columns_writer* writer, uint32_t front_coded)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->front_coded = front_coded;
+}
+
+void fc_uri_columns_writer_free(fc_uri_columns_writer* writer)
+{
+    FC_URI_COLUMNS_FREE(writer->ipv6.data);
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        fc_uri_columns_column_writer* column = &writer->columns[c];
+
+        FC_URI_COLUMNS_FREE(column->codes.data);
+        FC_URI_COLUMNS_FREE(column->offsets.data);
+        FC_URI_COLUMNS_FREE(column->data.data);
+        FC_URI_COLUMNS_FREE(column->hashes.data);
+        FC_URI_COLUMNS_FREE(column->table);
+    }
+
+    memset(writer, 0, sizeof(*writer));
+}
+
+static bool fc_uri_columns_rehash(fc_uri_columns_column_writer* column)
+{
+    uint32_t slot_count = column->table ? (column->table_mask + 1) * 2 : 64;
+
+    uint32_t* table = (uint32_t*)FC_URI_COLUMNS_REALLOC(NULL, slot_count * sizeof(uint32_t));
+    if (!table) return false;
+
+    memset(table, 0, slot_count * sizeof(uint32_t));
+
+    const uint64_t* hashes = (const uint64_t*)column->hashes.data;
+
+    for (uint32_t i = 0; i < column->entry_count; ++i)
+    {
+        uint32_t slot = (uint32_t)hashes[i] & (slot_count - 1);
+        while (table[slot]) slot = (slot + 1) & (slot_count - 1);
+
+        table[slot] = i + 1;
+    }
+
+    FC_URI_COLUMNS_FREE(column->table);
+    column->table = table;
+    column->table_mask = slot_count - 1;
+
+    return true;
+}
+
+// Code of value in the dictionary, added if missing. 0 on failure.
+static uint32_t fc_uri_columns_intern(fc_uri_columns_column_writer* column, fc_uri_str value)
+{
+    uint64_t hash = fc_uri_hash(value.data, value.count, 0);
+
+    if (column->table)
+    {
+        const uint64_t* hashes  = (const uint64_t*)column->hashes.data;
+        const uint64_t* offsets = (const uint64_t*)column->offsets.data;
+
+        for (uint32_t slot = (uint32_t)hash & column->table_mask; column->table[slot]; slot = (slot + 1) & column->table_mask)
+        {
+            uint32_t entry = column->table[slot] - 1;
+
+            if (hashes[entry] == hash && offsets[entry + 1] - offsets[entry] == (uint64_t)value.count &&
+                memcmp(column->data.data + offsets[entry], value.data, value.count) == 0)
+            {
+                return entry + 1;
+            }
+        }
+    }
+
+    // Keep the table at most half full
+    if (!column->table || (column->entry_count + 1) * 2 > column->table_mask + 1)
+    {
+        if (!fc_uri_columns_rehash(column)) return 0;
+    }
+
+    if (column->offsets.count == 0 && !fc_uri_columns_append_u64(&column->offsets, 0)) return 0;
+
+    if (!fc_uri_columns_append(&column->data, value.data, value.count) ||
+        !fc_uri_columns_append_u64(&column->offsets, column->data.count) ||
+        !fc_uri_columns_append_u64(&column->hashes, hash))
+    {
+        return 0;
+    }
+
+    uint32_t slot = (uint32_t)hash & column->table_mask;
+    while (column->table[slot]) slot = (slot + 1) & column->table_mask;
+
+    column->table[slot] = ++column->entry_count;
+
+    return column->entry_count;
+}
+
+static bool fc_uri_columns_add_bytes(fc_uri_columns_column_writer* column, int64_t row, fc_uri_str value)
+{
+    if (!fc_uri_columns_set_bit(&column->codes, row, value.data != NULL)) return false;
+
+    if (row == 0 && !fc_uri_columns_append_u64(&column->offsets, 0)) return false;
+
+    return fc_uri_columns_append(&column->data, value.data, value.count) &&
+           fc_uri_columns_append_u64(&column->offsets, column->data.count);
+}
+
+static bool fc_uri_columns_add_front_coded(fc_uri_columns_column_writer* column, int64_t row, fc_uri_str value)
+{
+    if (!fc_uri_columns_set_bit(&column->codes, row, value.data != NULL)) return false;
+
+    int shared = 0;
+
+    if (row % FC_URI_COLUMNS_RESTART == 0) {
+        if (!fc_uri_columns_append_u64(&column->offsets, column->data.count)) return false;
+    } else {
+        while (shared < value.count && shared < column->previous_count && value.data[shared] == column->previous[shared]) shared++;
+    }
+
+    if (!fc_uri_columns_append_varint(&column->data, shared) ||
+        !fc_uri_columns_append_varint(&column->data, value.count - shared) ||
+        !fc_uri_columns_append(&column->data, value.data + shared, value.count - shared))
+    {
+        return false;
+    }
+
+    if (value.count) memcpy(column->previous, value.data, value.count);
+    column->previous_count = value.count;
+
+    return true;
+}
+
+bool fc_uri_columns_writer_add(fc_uri_columns_writer* writer, const fc_uri_view* uri)
+{
+    if (writer->failed) return false;
+
+    // Front coded values are decoded into a buffer of FC_URI_MAX + 1 bytes, check before touching any column
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        if (fc_uri_columns_kind_of(writer->front_coded, c) == FC_URI_COLUMNS_FRONT_CODED &&
+            fc_uri_view_component(uri, (fc_uri_component)c).count > FC_URI_MAX)
+        {
+            return false;
+        }
+    }
+
+    int64_t row = writer->row_count;
+    bool ok = fc_uri_columns_set_bit(&writer->ipv6, row, uri->ipv6_host);
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT && ok; ++c)
+    {
+        fc_uri_columns_column_writer* column = &writer->columns[c];
+        fc_uri_str value = fc_uri_view_component(uri, (fc_uri_component)c);
+
+        switch (fc_uri_columns_kind_of(writer->front_coded, c))
+        {
+            case FC_URI_COLUMNS_DICTIONARY:
+            {
+                uint32_t code = 0;
+
+                if (value.data)
+                {
+                    code = fc_uri_columns_intern(column, value);
+                    ok = code != 0;
+                }
+
+                ok = ok && fc_uri_columns_append(&column->codes, &code, 4);
+            } break;
+
+            case FC_URI_COLUMNS_BYTES:       ok = fc_uri_columns_add_bytes(column, row, value); break;
+            case FC_URI_COLUMNS_FRONT_CODED: ok = fc_uri_columns_add_front_coded(column, row, value); break;
+        }
+    }
+
+    if (ok) {
+        writer->row_count++;
+    } else {
+        writer->failed = true;
+    }
+
+    return ok;
+}
+
+static bool fc_uri_columns_write_section(FILE* out, uint64_t* position, const void* data, uint64_t count)
+{
+    static const uint8_t padding[8] = {};
+
+    if (count && fwrite(data, count, 1, out) != 1) return false;
+
+    uint64_t padded = (count + 7) & ~7ull;
+    if (padded != count && fwrite(padding, padded - count, 1, out) != 1) return false;
+
+    *position += padded;
+
+    return true;
+}
+
+static uint32_t fc_uri_columns_code_width(uint32_t entry_count)
+{
+    if (entry_count < 0x100) return 1;
+    if (entry_count < 0x10000) return 2;
+    return 4;
+}
+
+bool fc_uri_columns_writer_write(const fc_uri_columns_writer* writer, const char* path)
+{
+    if (writer->failed) return false;
+
+    uint64_t row_count = writer->row_count;
+    uint64_t bitmap_size = (row_count + 7) / 8;
+
+    // Lay out the sections first, the directory goes before them
+    fc_uri_columns_column directory[FC_URI_COMPONENT_COUNT];
+
+    uint64_t ipv6 = FC_URI_COLUMNS_HEADER_SIZE + sizeof(directory);
+    uint64_t position = ipv6 + ((bitmap_size + 7) & ~7ull);
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        const fc_uri_columns_column_writer* column = &writer->columns[c];
+        fc_uri_columns_column* entry = &directory[c];
+
+        memset(entry, 0, sizeof(*entry));
+        entry->kind = fc_uri_columns_kind_of(writer->front_coded, c);
+
+        uint64_t codes_size = bitmap_size;
+
+        if (entry->kind == FC_URI_COLUMNS_DICTIONARY) {
+            entry->width = fc_uri_columns_code_width(column->entry_count);
+            entry->entry_count = column->entry_count;
+            codes_size = row_count * entry->width;
+        } else {
+            entry->entry_count = row_count;
+        }
+
+        uint64_t offsets_size = column->offsets.count;
+        if (entry->kind == FC_URI_COLUMNS_DICTIONARY && column->entry_count == 0) offsets_size = 8; // Just the first 0
+
+        entry->codes = position;
+        position += (codes_size + 7) & ~7ull;
+
+        entry->offsets = position;
+        position += (offsets_size + 7) & ~7ull;
+
+        entry->data = position;
+        entry->data_size = column->data.count;
+        position += (column->data.count + 7) & ~7ull;
+    }
+
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+
+    uint8_t header[FC_URI_COLUMNS_HEADER_SIZE];
+    uint32_t column_count = FC_URI_COMPONENT_COUNT;
+
+    memcpy(header,      fc_uri_columns_magic,  8);
+    memcpy(header + 8,  &row_count,            8);
+    memcpy(header + 16, &column_count,         4);
+    memcpy(header + 20, &writer->front_coded,  4);
+    memcpy(header + 24, &ipv6,                 8);
+
+    position = 0;
+    bool ok = fc_uri_columns_write_section(out, &position, header, sizeof(header)) &&
+              fc_uri_columns_write_section(out, &position, directory, sizeof(directory)) &&
+              fc_uri_columns_write_section(out, &position, writer->ipv6.data, bitmap_size);
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT && ok; ++c)
+    {
+        const fc_uri_columns_column_writer* column = &writer->columns[c];
+        const fc_uri_columns_column* entry = &directory[c];
+
+        if (entry->kind == FC_URI_COLUMNS_DICTIONARY) {
+            // Narrow the codes, 64KB at a time
+            uint8_t narrow[1 << 16];
+            uint64_t per_pass = sizeof(narrow) / entry->width;
+
+            for (uint64_t first = 0; first < row_count && ok; first += per_pass)
+            {
+                uint64_t count = row_count - first < per_pass ? row_count - first : per_pass;
+
+                for (uint64_t i = 0; i < count; ++i)
+                {
+                    uint32_t code;
+                    memcpy(&code, column->codes.data + (first + i) * 4, 4);
+
+                    if      (entry->width == 1) narrow[i] = (uint8_t)code;
+                    else if (entry->width == 2) { uint16_t code16 = (uint16_t)code; memcpy(narrow + i * 2, &code16, 2); }
+                    else    memcpy(narrow + i * 4, &code, 4);
+                }
+
+                ok = fwrite(narrow, count * entry->width, 1, out) == 1;
+                position += count * entry->width;
+            }
+
+            static const uint8_t padding[8] = {};
+            uint64_t padded = (position + 7) & ~7ull;
+            if (ok && padded != position) ok = fwrite(padding, padded - position, 1, out) == 1;
+            position = padded;
+
+            uint64_t zero = 0;
+            ok = ok && (column->entry_count ? fc_uri_columns_write_section(out, &position, column->offsets.data, column->offsets.count)
+                                            : fc_uri_columns_write_section(out, &position, &zero, 8));
+        } else {
+            ok = fc_uri_columns_write_section(out, &position, column->codes.data, bitmap_size) &&
+                 fc_uri_columns_write_section(out, &position, column->offsets.data, column->offsets.count);
+        }
+
+        ok = ok && fc_uri_columns_write_section(out, &position, column->data.data, column->data.count);
+    }
+
+    return fclose(out) == 0 && ok;
+}
+
+static bool fc_uri_columns_within(const fc_uri_columns* columns, uint64_t offset, uint64_t size)
+{
+    return offset <= columns->image_size && size <= columns->image_size - offset;
+}
+
+// Offsets start at 0, never decrease, stay within the data and every value fits an int.
+static bool fc_uri_columns_valid_offsets(const fc_uri_columns* columns, const fc_uri_columns_column* column, uint64_t count)
+{
+    const uint64_t* offsets = (const uint64_t*)((const uint8_t*)columns->image + column->offsets);
+
+    if (count > 0 && offsets[0] != 0) return false;
+
+    for (uint64_t i = 1; i < count; ++i)
+    {
+        if (offsets[i] < offsets[i - 1] || offsets[i] - offsets[i - 1] > 0x7FFFFFFF) return false;
+    }
+
+    return count == 0 || offsets[count - 1] <= column->data_size;
+}
+
+bool fc_uri_columns_map(fc_uri_columns* columns, const char* path)
+{
+    memset(columns, 0, sizeof(*columns));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < FC_URI_COLUMNS_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) return false;
+
+    columns->image = mapping;
+    columns->image_size = info.st_size;
+
+    const uint8_t* image = (const uint8_t*)mapping;
+
+    uint64_t row_count, ipv6;
+    uint32_t column_count;
+
+    memcpy(&row_count,    image + 8,  8);
+    memcpy(&column_count, image + 16, 4);
+    memcpy(&ipv6,         image + 24, 8);
+
+    // Every size below is checked with a division before it's computed, the header can't make them overflow
+    bool valid = memcmp(image, fc_uri_columns_magic, 8) == 0 && column_count == FC_URI_COMPONENT_COUNT &&
+                 row_count / 8 < columns->image_size &&
+                 fc_uri_columns_within(columns, FC_URI_COLUMNS_HEADER_SIZE, column_count * sizeof(fc_uri_columns_column));
+
+    uint64_t bitmap_size = (row_count + 7) / 8;
+    valid = valid && fc_uri_columns_within(columns, ipv6, bitmap_size);
+
+    const fc_uri_columns_column* directory = (const fc_uri_columns_column*)(image + FC_URI_COLUMNS_HEADER_SIZE);
+
+    for (uint32_t c = 0; c < column_count && valid; ++c)
+    {
+        const fc_uri_columns_column* column = &directory[c];
+
+        uint64_t codes_size = bitmap_size;
+        uint64_t offsets_count = row_count + 1;
+
+        if (column->kind == FC_URI_COLUMNS_DICTIONARY) {
+            valid = (column->width == 1 || column->width == 2 || column->width == 4) &&
+                    row_count <= columns->image_size / column->width &&
+                    column->entry_count < columns->image_size / 8;
+            codes_size = row_count * column->width;
+            offsets_count = column->entry_count + 1;
+        } else if (column->kind == FC_URI_COLUMNS_FRONT_CODED) {
+            offsets_count = (row_count + FC_URI_COLUMNS_RESTART - 1) / FC_URI_COLUMNS_RESTART;
+        } else {
+            valid = column->kind == FC_URI_COLUMNS_BYTES;
+        }
+
+        valid = valid && column->offsets % 8 == 0 && offsets_count <= columns->image_size / 8 &&
+                fc_uri_columns_within(columns, column->codes, codes_size) &&
+                fc_uri_columns_within(columns, column->offsets, offsets_count * 8) &&
+                fc_uri_columns_within(columns, column->data, column->data_size) &&
+                fc_uri_columns_valid_offsets(columns, column, offsets_count);
+    }
+
+    if (!valid)
+    {
+        fc_uri_columns_free(columns);
+        return false;
+    }
+
+    columns->row_count = (int64_t)row_count;
+    columns->columns = directory;
+    columns->ipv6 = image + ipv6;
+
+    return true;
+}
+
+void fc_uri_columns_free(fc_uri_columns* columns)
+{
+    if (columns->image) munmap(columns->image, columns->image_size);
+    memset(columns, 0, sizeof(*columns));
+}
+
+static bool fc_uri_columns_bit(const uint8_t* bitmap, int64_t index)
+{
+    return (bitmap[index / 8] >> (index % 8)) & 1;
+}
+
+uint32_t fc_uri_columns_code(const fc_uri_columns* columns, int64_t row, fc_uri_component component)
+{
+    const fc_uri_columns_column* column = &columns->columns[component];
+    if (column->kind != FC_URI_COLUMNS_DICTIONARY || row < 0 || row >= columns->row_count) return 0;
+
+    const uint8_t* codes = (const uint8_t*)columns->image + column->codes;
+
+    if (column->width == 1) return codes[row];
+
+    if (column->width == 2)
+    {
+        uint16_t code;
+        memcpy(&code, codes + row * 2, 2);
+        return code;
+    }
+
+    uint32_t code;
+    memcpy(&code, codes + row * 4, 4);
+    return code;
+}
+
+fc_uri_str fc_uri_columns_entry(const fc_uri_columns* columns, fc_uri_component component, uint32_t code)
+{
+    fc_uri_str value = {};
+
+    const fc_uri_columns_column* column = &columns->columns[component];
+    if (column->kind != FC_URI_COLUMNS_DICTIONARY || code == 0 || code > column->entry_count) return value;
+
+    const uint64_t* offsets = (const uint64_t*)((const uint8_t*)columns->image + column->offsets);
+
+    value.data  = (const char*)columns->image + column->data + offsets[code - 1];
+    value.count = (int)(offsets[code] - offsets[code - 1]);
+
+    return value;
+}
+
+fc_uri_str fc_uri_columns_get(const fc_uri_columns* columns, int64_t row, fc_uri_component component, char* buffer)
+{
+    fc_uri_str value = {};
+
+    if (row < 0 || row >= columns->row_count) return value;
+
+    const fc_uri_columns_column* column = &columns->columns[component];
+    const uint8_t* image = (const uint8_t*)columns->image;
+
+    if (column->kind == FC_URI_COLUMNS_DICTIONARY)
+    {
+        return fc_uri_columns_entry(columns, component, fc_uri_columns_code(columns, row, component));
+    }
+
+    if (!fc_uri_columns_bit(image + column->codes, row)) return value;
+
+    const uint64_t* offsets = (const uint64_t*)(image + column->offsets);
+    const uint8_t* data = image + column->data;
+
+    if (column->kind == FC_URI_COLUMNS_BYTES)
+    {
+        value.data  = (const char*)data + offsets[row];
+        value.count = (int)(offsets[row + 1] - offsets[row]);
+        return value;
+    }
+
+    // Front coded, decode from the restart up to the row
+    uint64_t position = offsets[row / FC_URI_COLUMNS_RESTART];
+    int count = 0;
+
+    for (int64_t i = row - row % FC_URI_COLUMNS_RESTART; i <= row; ++i)
+    {
+        uint64_t shared, rest;
+
+        if (!fc_uri_columns_read_varint(data, column->data_size, &position, &shared) ||
+            !fc_uri_columns_read_varint(data, column->data_size, &position, &rest) ||
+            shared > (uint64_t)count || rest > FC_URI_MAX - shared || rest > column->data_size - position)
+        {
+            return value;
+        }
+
+        memcpy(buffer + shared, data + position, rest);
+        position += rest;
+        count = (int)(shared + rest);
+    }
+
+    buffer[count] = '\0';
+
+    value.data  = buffer;
+    value.count = count;
+
+    return value;
+}
+
+bool fc_uri_columns_ipv6_host(const fc_uri_columns* columns, int64_t row)
+{
+    if (row < 0 || row >= columns->row_count) return false;
+
+    return fc_uri_columns_bit(columns->ipv6, row);
+}
+
+#endif // FC_URI_COLUMNS_IMPLEMENTATION
+
+#endif // FC_URI_COLUMNS
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,869 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_COOKIE_IMPLEMENTATION
+        #include "fc_uri_cookie.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_cookie.h"
+    "
+
+Example:
+    fc_cookie_jar jar;
+    fc_cookie_jar_init(&jar);
+
+    fc_uri_view uri;
+    fc_uri_parse_view("https://www.example.com/shop/cart", -1, &uri);
+
+    // For every Set-Cookie header of the response
+    fc_cookie_jar_set(&jar, &uri, "id=42; Domain=example.com; Path=/shop; Max-Age=3600; Secure", -1, now);
+
+    // Before every request
+    char cookie_header[4096];
+    int cookie_header_length = fc_cookie_jar_header(&jar, &uri, now, cookie_header, sizeof(cookie_header));
+    if (cookie_header_length > 0)
+    {
+        // "Cookie: " + cookie_header ("id=42")
+    }
+
+    fc_cookie_jar_expire(&jar, now); // Every now and then
+
+    fc_cookie_jar_free(&jar);
+
+Info:
+    Cookie store following RFC 6265 (https://www.rfc-editor.org/rfc/rfc6265). Times are seconds since the Unix epoch.
+
+    Cookies are listed under their domain, the request host for host-only cookies. A lookup walks the domains
+    the host belongs to, "a.example.com" then "example.com" then "com", one hash probe each, and only looks at
+    the cookies listed there, so its cost doesn't depend on the size of the jar. Paths are matched as prefixes
+    on the path view of the URI (section 5.1.4), the header lists longer paths first and then older cookies.
+
+    Cookies with an expiry are also in a min-heap on it: fc_cookie_jar_expire removes the expired ones in
+    O(log n) each, lookups skip the ones that expired since then.
+
+    Expires is parsed with the lenient date algorithm of section 5.1.1, Max-Age takes precedence.
+    A Domain attribute must domain-match the request host and have at least one dot. The Public Suffix List is
+    not included, so "co.uk" and the like are not rejected. Secure cookies are only sent to https and wss URIs.
+    Not thread safe.
+*/
+
+#ifndef FC_URI_COOKIE
+#define FC_URI_COOKIE
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+#define FC_COOKIE_SESSION UINT64_MAX
+
+// Cookies in one header at most, the others are left out.
+#ifndef FC_COOKIE_HEADER_MAX
+#define FC_COOKIE_HEADER_MAX 180
+#endif
+
+typedef struct
+{
+    char* data; // name, value, domain (lowercase) and path, one after the other
+    int name_count;
+    int value_count;
+    int domain_count;
+    int path_count;
+
+    uint64_t expires; // FC_COOKIE_SESSION if it has no expiry
+    uint64_t creation;
+
+    int next;       // In the list of the domain, or in the free list
+    int previous;   // In the list of the domain, -1 for the first one
+    int heap_index; // -1 if not in the heap
+    int domain;     // Index of the domain
+
+    bool host_only;
+    bool secure;
+    bool http_only;
+} fc_cookie;
+
+typedef struct
+{
+    uint64_t hash;
+    uint32_t name_offset;
+    int name_count;
+    int first; // Cookie, -1 if none
+} fc_cookie_domain;
+
+typedef struct
+{
+    fc_cookie* cookies;
+    int cookie_capacity;
+    int cookie_high; // Slots used so far, live or free
+    int free_list;
+    int count;       // Live cookies
+
+    fc_cookie_domain* domains;
+    int domain_count;
+    int domain_capacity;
+
+    char* domain_names;
+    uint32_t domain_names_size;
+    uint32_t domain_names_capacity;
+
+    int* domain_table; // Domain index + 1, 0 for empty slots
+    int domain_table_mask;
+
+    int* heap; // Cookie indices, min-heap on expires
+    int heap_count;
+    int heap_capacity;
+
+    uint64_t next_creation;
+} fc_cookie_jar;
+
+void fc_cookie_jar_init(fc_cookie_jar* jar);
+void fc_cookie_jar_free(fc_cookie_jar* jar);
+
+// Stores the cookie of a Set-Cookie header received for uri, replacing the one with the same name, domain and path.
+// An expiry in the past deletes it. count can be -1. Returns false if the header was rejected or out of memory.
+bool fc_cookie_jar_set(fc_cookie_jar* jar, const fc_uri_view* uri, const char* header, int count, uint64_t now);
+
+// Writes the value of the Cookie header for uri ("a=b; c=d") into dst, null-terminated.
+// Returns its length, 0 if no cookie matches, or -1 if dst is too small.
+int fc_cookie_jar_header(const fc_cookie_jar* jar, const fc_uri_view* uri, uint64_t now, char* dst, int dst_size);
+
+// Removes the cookies that expired at now. Returns how many.
+int fc_cookie_jar_expire(fc_cookie_jar* jar, uint64_t now);
+
+// Parses a cookie date (RFC 6265 section 5.1.1), count can be -1. Returns false if it is not one.
+bool fc_cookie_parse_date(const char* date, int count, uint64_t* time);
+
+#endif // FC_URI_COOKIE
+
+#ifdef FC_URI_COOKIE_IMPLEMENTATION
+
+#include <string.h> // memcpy, memcmp, memset
+
+#ifndef FC_URI_COOKIE_REALLOC
+#include <stdlib.h>
+#define FC_URI_COOKIE_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_COOKIE_FREE
+#include <stdlib.h>
+#define FC_URI_COOKIE_FREE(ptr)          free(ptr)
+#endif
+
+static char fc_cookie_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+static bool fc_cookie_equals_lower(const char* str, int count, const char* lower)
+{
+    if ((int)strlen(lower) != count) return false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (fc_cookie_lower(str[i]) != lower[i]) return false;
+    }
+
+    return true;
+}
+
+static bool fc_cookie_grow(void** data, int* capacity, int needed, int size, int initial)
+{
+    if (needed <= *capacity) return true;
+
+    int new_capacity = *capacity ? *capacity * 2 : initial;
+    while (new_capacity < needed) new_capacity *= 2;
+
+    void* resized = FC_URI_COOKIE_REALLOC(*data, (size_t)new_capacity * size);
+    if (!resized) return false;
+
+    *data = resized;
+    *capacity = new_capacity;
+
+    return true;
+}
+
+void fc_cookie_jar_init(fc_cookie_jar* jar)
+{
+    memset(jar, 0, sizeof(*jar));
+    jar->free_list = -1;
+}
+
+void fc_cookie_jar_free(fc_cookie_jar* jar)
+{
+    for (int i = 0; i < jar->cookie_high; ++i) FC_URI_COOKIE_FREE(jar->cookies[i].data);
+
+    FC_URI_COOKIE_FREE(jar->cookies);
+    FC_URI_COOKIE_FREE(jar->domains);
+    FC_URI_COOKIE_FREE(jar->domain_names);
+    FC_URI_COOKIE_FREE(jar->domain_table);
+    FC_URI_COOKIE_FREE(jar->heap);
+
+    memset(jar, 0, sizeof(*jar));
+    jar->free_list = -1;
+}
+
+// Dates
+
+static bool fc_cookie_is_delimiter(char c)
+{
+    unsigned char u = (unsigned char)c;
+    return u == 0x09 || (u >= 0x20 && u <= 0x2F) || (u >= 0x3B && u <= 0x40) || (u >= 0x5B && u <= 0x60) || (u >= 0x7B && u <= 0x7E);
+}
+
+static bool fc_cookie_is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// 1 to max_digits digits at the start of token, followed by anything but a digit. Returns the digit count, or 0.
+static int fc_cookie_read_number(const char* token, int count, int min_digits, int max_digits, int* value)
+{
+    int digits = 0;
+    *value = 0;
+
+    while (digits < count && fc_cookie_is_digit(token[digits]))
+    {
+        if (digits == max_digits) return 0;
+        *value = *value * 10 + (token[digits] - '0');
+        digits++;
+    }
+
+    return digits >= min_digits ? digits : 0;
+}
+
+// Days from 1970-01-01 to a date of the proleptic Gregorian calendar.
+static int64_t fc_cookie_days_from_civil(int year, int month, int day)
+{
+    year -= month <= 2;
+
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t year_of_era = year - era * 400;
+    int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+    return era * 146097 + day_of_era - 719468;
+}
+
+bool fc_cookie_parse_date(const char* date, int count, uint64_t* time)
+{
+    static const char* months[12] = { "jan", "feb", "mar", "apr", "may", "jun", "jul", "aug", "sep", "oct", "nov", "dec" };
+
+    if (count < 0) count = (int)strlen(date);
+
+    bool found_time = false, found_day = false, found_month = false, found_year = false;
+    int hour = 0, minute = 0, second = 0, day = 0, month = 0, year = 0;
+
+    int i = 0;
+    while (i < count)
+    {
+        while (i < count && fc_cookie_is_delimiter(date[i])) i++;
+
+        int begin = i;
+        while (i < count && !fc_cookie_is_delimiter(date[i])) i++;
+
+        const char* token = date + begin;
+        int token_count = i - begin;
+        if (token_count == 0) break;
+
+        if (!found_time)
+        {
+            // hh:mm:ss, each one or two digits
+            int a, b, c;
+            int n1 = fc_cookie_read_number(token, token_count, 1, 2, &a);
+            if (n1 && n1 < token_count && token[n1] == ':')
+            {
+                int n2 = fc_cookie_read_number(token + n1 + 1, token_count - n1 - 1, 1, 2, &b);
+                int at = n1 + 1 + n2;
+                if (n2 && at < token_count && token[at] == ':' && fc_cookie_read_number(token + at + 1, token_count - at - 1, 1, 2, &c))
+                {
+                    found_time = true;
+                    hour = a;
+                    minute = b;
+                    second = c;
+                    continue;
+                }
+            }
+        }
+
+        int number;
+        if (!found_day && fc_cookie_read_number(token, token_count, 1, 2, &number))
+        {
+            found_day = true;
+            day = number;
+            continue;
+        }
+
+        if (!found_month && token_count >= 3)
+        {
+            for (int m = 0; m < 12; ++m)
+            {
+                if (fc_cookie_lower(token[0]) == months[m][0] && fc_cookie_lower(token[1]) == months[m][1] && fc_cookie_lower(token[2]) == months[m][2])
+                {
+                    found_month = true;
+                    month = m + 1;
+                    break;
+                }
+            }
+            if (found_month) continue;
+        }
+
+        if (!found_year && fc_cookie_read_number(token, token_count, 2, 4, &number))
+        {
+            found_year = true;
+            year = number;
+        }
+    }
+
+    if (!found_time || !found_day || !found_month || !found_year) return false;
+
+    if (year >= 70 && year <= 99) year += 1900;
+    if (year >= 0 && year <= 69) year += 2000;
+
+    if (day < 1 || day > 31 || year < 1601 || hour > 23 || minute > 59 || second > 59) return false;
+
+    // The date must exist, no 31st of April or 29th of February outside leap years
+    static const int month_days[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > month_days[month - 1] || (month == 2 && day == 29 && !leap)) return false;
+
+    int64_t seconds = fc_cookie_days_from_civil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    *time = seconds < 0 ? 0 : (uint64_t)seconds;
+
+    return true;
+}
+
+// Expiry heap
+
+static bool fc_cookie_heap_before(const fc_cookie_jar* jar, int a, int b)
+{
+    return jar->cookies[jar->heap[a]].expires < jar->cookies[jar->heap[b]].expires;
+}
+
+static void fc_cookie_heap_swap(fc_cookie_jar* jar, int a, int b)
+{
+    int cookie = jar->heap[a];
+    jar->heap[a] = jar->heap[b];
+    jar->heap[b] = cookie;
+
+    jar->cookies[jar->heap[a]].heap_index = a;
+    jar->cookies[jar->heap[b]].heap_index = b;
+}
+
+static void fc_cookie_heap_fix(fc_cookie_jar* jar, int i)
+{
+    while (i > 0 && fc_cookie_heap_before(jar, i, (i - 1) / 2))
+    {
+        fc_cookie_heap_swap(jar, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+
+    for (;;)
+    {
+        int first = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < jar->heap_count && fc_cookie_heap_before(jar, left, first)) first = left;
+        if (right < jar->heap_count && fc_cookie_heap_before(jar, right, first)) first = right;
+
+        if (first == i) return;
+
+        fc_cookie_heap_swap(jar, i, first);
+        i = first;
+    }
+}
+
+static void fc_cookie_heap_remove(fc_cookie_jar* jar, int cookie)
+{
+    int i = jar->cookies[cookie].heap_index;
+    if (i < 0) return;
+
+    jar->cookies[cookie].heap_index = -1;
+
+    jar->heap_count--;
+    if (i == jar->heap_count) return;
+
+    jar->heap[i] = jar->heap[jar->heap_count];
+    jar->cookies[jar->heap[i]].heap_index = i;
+    fc_cookie_heap_fix(jar, i);
+}
+
+// Domains
+
+static int fc_cookie_find_domain(const fc_cookie_jar* jar, const char* name, int count, uint64_t hash)
+{
+    if (!jar->domain_table) return -1;
+
+    for (int slot = (int)(hash & jar->domain_table_mask); jar->domain_table[slot]; slot = (slot + 1) & jar->domain_table_mask)
+    {
+        const fc_cookie_domain* domain = &jar->domains[jar->domain_table[slot] - 1];
+
+        if (domain->hash == hash && domain->name_count == count && memcmp(jar->domain_names + domain->name_offset, name, count) == 0)
+        {
+            return jar->domain_table[slot] - 1;
+        }
+    }
+
+    return -1;
+}
+
+// Domain of a lowercase name, added if new. -1 if out of memory.
+static int fc_cookie_domain_of(fc_cookie_jar* jar, const char* name, int count)
+{
+    uint64_t hash = fc_uri_hash(name, count, 0);
+
+    int index = fc_cookie_find_domain(jar, name, count, hash);
+    if (index >= 0) return index;
+
+    int names_capacity = (int)jar->domain_names_capacity;
+    if (!fc_cookie_grow((void**)&jar->domains, &jar->domain_capacity, jar->domain_count + 1, sizeof(fc_cookie_domain), 64) ||
+        !fc_cookie_grow((void**)&jar->domain_names, &names_capacity, (int)jar->domain_names_size + count, 1, 4096))
+    {
+        return -1;
+    }
+    jar->domain_names_capacity = (uint32_t)names_capacity;
+
+    // Load factor below 1/2
+    if (2 * (jar->domain_count + 1) > jar->domain_table_mask + 1 || !jar->domain_table)
+    {
+        int slot_count = jar->domain_table ? 2 * (jar->domain_table_mask + 1) : 128;
+
+        int* table = (int*)FC_URI_COOKIE_REALLOC(jar->domain_table, slot_count * sizeof(int));
+        if (!table) return -1;
+
+        memset(table, 0, slot_count * sizeof(int));
+        jar->domain_table = table;
+        jar->domain_table_mask = slot_count - 1;
+
+        for (int i = 0; i < jar->domain_count; ++i)
+        {
+            int slot = (int)(jar->domains[i].hash & jar->domain_table_mask);
+            while (jar->domain_table[slot]) slot = (slot + 1) & jar->domain_table_mask;
+            jar->domain_table[slot] = i + 1;
+        }
+    }
+
+    index = jar->domain_count++;
+
+    fc_cookie_domain* domain = &jar->domains[index];
+    domain->hash = hash;
+    domain->name_offset = jar->domain_names_size;
+    domain->name_count = count;
+    domain->first = -1;
+
+    memcpy(jar->domain_names + jar->domain_names_size, name, count);
+    jar->domain_names_size += count;
+
+    int slot = (int)(hash & jar->domain_table_mask);
+    while (jar->domain_table[slot]) slot = (slot + 1) & jar->domain_table_mask;
+    jar->domain_table[slot] = index + 1;
+
+    return index;
+}
+
+static void fc_cookie_remove(fc_cookie_jar* jar, int cookie)
+{
+    fc_cookie* removed = &jar->cookies[cookie];
+
+    if (removed->previous >= 0) {
+        jar->cookies[removed->previous].next = removed->next;
+    } else {
+        jar->domains[removed->domain].first = removed->next;
+    }
+
+    if (removed->next >= 0) jar->cookies[removed->next].previous = removed->previous;
+
+    fc_cookie_heap_remove(jar, cookie);
+
+    FC_URI_COOKIE_FREE(removed->data);
+    removed->data = NULL;
+
+    removed->next = jar->free_list;
+    jar->free_list = cookie;
+    jar->count--;
+}
+
+// Parsing
+
+static void fc_cookie_trim(const char** begin, const char** end)
+{
+    while (*begin < *end && (**begin == ' ' || **begin == '\t')) (*begin)++;
+    while (*end > *begin && ((*end)[-1] == ' ' || (*end)[-1] == '\t')) (*end)--;
+}
+
+// domain-match (section 5.1.3), domain is lowercase and host any case.
+static bool fc_cookie_domain_match(const char* host, int host_count, const char* domain, int domain_count)
+{
+    if (domain_count > host_count) return false;
+
+    const char* suffix = host + host_count - domain_count;
+    for (int i = 0; i < domain_count; ++i)
+    {
+        if (fc_cookie_lower(suffix[i]) != domain[i]) return false;
+    }
+
+    return domain_count == host_count || suffix[-1] == '.';
+}
+
+// path-match (section 5.1.4)
+static bool fc_cookie_path_match(const char* request, int request_count, const char* path, int path_count)
+{
+    if (path_count > request_count || memcmp(request, path, path_count) != 0) return false;
+
+    return path_count == request_count || path[path_count - 1] == '/' || request[path_count] == '/';
+}
+
+bool fc_cookie_jar_set(fc_cookie_jar* jar, const fc_uri_view* uri, const char* header, int count, uint64_t now)
+{
+    if (count < 0) count = (int)strlen(header);
+    if (!uri->host.data || uri->host.count == 0 || uri->host.count > FC_URI_HOST_MAX) return false;
+
+    const char* end = header + count;
+    const char* pair_end = (const char*)memchr(header, ';', count);
+    if (!pair_end) pair_end = end;
+
+    const char* equals = (const char*)memchr(header, '=', pair_end - header);
+    if (!equals) return false;
+
+    const char* name = header;
+    const char* name_end = equals;
+    const char* value = equals + 1;
+    const char* value_end = pair_end;
+    fc_cookie_trim(&name, &name_end);
+    fc_cookie_trim(&value, &value_end);
+
+    if (name == name_end) return false;
+
+    char domain[FC_URI_HOST_MAX + 1];
+    int domain_count = -1;
+
+    const char* path = NULL;
+    int path_count = 0;
+
+    bool has_max_age = false;
+    int64_t max_age = 0;
+    bool has_expires = false;
+    uint64_t expires = FC_COOKIE_SESSION;
+    bool secure = false;
+    bool http_only = false;
+
+    for (const char* c = pair_end; c < end;)
+    {
+        const char* attribute = c + 1;
+        const char* attribute_end = (const char*)memchr(attribute, ';', end - attribute);
+        if (!attribute_end) attribute_end = end;
+        c = attribute_end;
+
+        const char* attribute_equals = (const char*)memchr(attribute, '=', attribute_end - attribute);
+        const char* key = attribute;
+        const char* key_end = attribute_equals ? attribute_equals : attribute_end;
+        const char* argument = attribute_equals ? attribute_equals + 1 : attribute_end;
+        const char* argument_end = attribute_end;
+        fc_cookie_trim(&key, &key_end);
+        fc_cookie_trim(&argument, &argument_end);
+
+        int key_count = (int)(key_end - key);
+        int argument_count = (int)(argument_end - argument);
+
+        if (fc_cookie_equals_lower(key, key_count, "expires")) {
+            uint64_t time;
+            if (fc_cookie_parse_date(argument, argument_count, &time))
+            {
+                has_expires = true;
+                expires = time;
+            }
+        } else if (fc_cookie_equals_lower(key, key_count, "max-age")) {
+            const char* digit = argument;
+            bool negative = digit < argument_end && *digit == '-';
+            if (negative) digit++;
+
+            if (digit < argument_end)
+            {
+                int64_t seconds = 0;
+                for (; digit < argument_end && fc_cookie_is_digit(*digit); ++digit)
+                {
+                    if (seconds < INT64_MAX / 20) seconds = seconds * 10 + (*digit - '0');
+                }
+
+                if (digit == argument_end)
+                {
+                    has_max_age = true;
+                    max_age = negative ? -seconds : seconds;
+                }
+            }
+        } else if (fc_cookie_equals_lower(key, key_count, "domain")) {
+            if (argument_count > 0 && *argument == '.')
+            {
+                argument++;
+                argument_count--;
+            }
+
+            if (argument_count > 0 && argument_count <= FC_URI_HOST_MAX)
+            {
+                for (int i = 0; i < argument_count; ++i) domain[i] = fc_cookie_lower(argument[i]);
+                domain_count = argument_count;
+            }
+        } else if (fc_cookie_equals_lower(key, key_count, "path")) {
+            if (argument_count > 0 && *argument == '/')
+            {
+                path = argument;
+                path_count = argument_count;
+            }
+        } else if (fc_cookie_equals_lower(key, key_count, "secure")) {
+            secure = true;
+        } else if (fc_cookie_equals_lower(key, key_count, "httponly")) {
+            http_only = true;
+        }
+    }
+
+    if (has_max_age) {
+        expires = max_age <= 0 ? 0 : now + (uint64_t)max_age;
+    } else if (!has_expires) {
+        expires = FC_COOKIE_SESSION;
+    }
+
+    bool host_only = domain_count < 0;
+    if (host_only) {
+        domain_count = uri->host.count;
+        for (int i = 0; i < domain_count; ++i) domain[i] = fc_cookie_lower(uri->host.data[i]);
+    } else {
+        if (!fc_cookie_domain_match(uri->host.data, uri->host.count, domain, domain_count)) return false;
+        if (!memchr(domain, '.', domain_count)) return false; // Top level domain, without a suffix list at least these
+    }
+
+    // Default path (section 5.1.4), the directory of the request path
+    if (!path)
+    {
+        path = "/";
+        path_count = 1;
+
+        if (uri->path.count > 0 && uri->path.data[0] == '/')
+        {
+            const char* last_slash = uri->path.data + uri->path.count;
+            while (last_slash[-1] != '/') last_slash--;
+
+            if (last_slash - uri->path.data > 1)
+            {
+                path = uri->path.data;
+                path_count = (int)(last_slash - 1 - uri->path.data);
+            }
+        }
+    }
+
+    int name_count = (int)(name_end - name);
+    int value_count = (int)(value_end - value);
+
+    int domain_index = fc_cookie_domain_of(jar, domain, domain_count);
+    if (domain_index < 0) return false;
+
+    // The same name, domain and path is replaced, keeping its creation time
+    uint64_t creation = jar->next_creation++;
+
+    for (int cookie = jar->domains[domain_index].first; cookie >= 0; cookie = jar->cookies[cookie].next)
+    {
+        const fc_cookie* old = &jar->cookies[cookie];
+
+        if (old->name_count == name_count && memcmp(old->data, name, name_count) == 0 &&
+            old->path_count == path_count && memcmp(old->data + old->name_count + old->value_count + old->domain_count, path, path_count) == 0)
+        {
+            creation = old->creation;
+            fc_cookie_remove(jar, cookie);
+            break;
+        }
+    }
+
+    if (expires <= now) return true; // Deleted
+
+    int index;
+    if (jar->free_list >= 0) {
+        index = jar->free_list;
+        jar->free_list = jar->cookies[index].next;
+    } else {
+        if (!fc_cookie_grow((void**)&jar->cookies, &jar->cookie_capacity, jar->cookie_high + 1, sizeof(fc_cookie), 64)) return false;
+        index = jar->cookie_high++;
+    }
+
+    fc_cookie* cookie = &jar->cookies[index];
+
+    cookie->data = (char*)FC_URI_COOKIE_REALLOC(NULL, name_count + value_count + domain_count + path_count);
+    if (!cookie->data)
+    {
+        cookie->next = jar->free_list;
+        jar->free_list = index;
+        return false;
+    }
+
+    if (expires != FC_COOKIE_SESSION &&
+        !fc_cookie_grow((void**)&jar->heap, &jar->heap_capacity, jar->heap_count + 1, sizeof(int), 64))
+    {
+        FC_URI_COOKIE_FREE(cookie->data);
+        cookie->data = NULL;
+        cookie->next = jar->free_list;
+        jar->free_list = index;
+        return false;
+    }
+
+    char* data = cookie->data;
+    memcpy(data, name, name_count);
+    memcpy(data + name_count, value, value_count);
+    memcpy(data + name_count + value_count, domain, domain_count);
+    memcpy(data + name_count + value_count + domain_count, path, path_count);
+
+    cookie->name_count = name_count;
+    cookie->value_count = value_count;
+    cookie->domain_count = domain_count;
+    cookie->path_count = path_count;
+    cookie->expires = expires;
+    cookie->creation = creation;
+    cookie->domain = domain_index;
+    cookie->host_only = host_only;
+    cookie->secure = secure;
+    cookie->http_only = http_only;
+    cookie->heap_index = -1;
+
+    cookie->next = jar->domains[domain_index].first;
+    cookie->previous = -1;
+    if (cookie->next >= 0) jar->cookies[cookie->next].previous = index;
+    jar->domains[domain_index].first = index;
+    jar->count++;
+
+    if (expires != FC_COOKIE_SESSION)
+    {
+        cookie->heap_index = jar->heap_count;
+        jar->heap[jar->heap_count++] = index;
+        fc_cookie_heap_fix(jar, cookie->heap_index);
+    }
+
+    return true;
+}
+
+int fc_cookie_jar_header(const fc_cookie_jar* jar, const fc_uri_view* uri, uint64_t now, char* dst, int dst_size)
+{
+    if (dst_size > 0) dst[0] = '\0';
+    if (!uri->host.data || uri->host.count == 0 || uri->host.count > FC_URI_HOST_MAX) return 0;
+
+    char host[FC_URI_HOST_MAX];
+    int host_count = uri->host.count;
+    for (int i = 0; i < host_count; ++i) host[i] = fc_cookie_lower(uri->host.data[i]);
+
+    bool secure_uri = fc_cookie_equals_lower(uri->scheme.data, uri->scheme.count, "https") ||
+                      fc_cookie_equals_lower(uri->scheme.data, uri->scheme.count, "wss");
+
+    const char* request_path = uri->path.count ? uri->path.data : "/";
+    int request_path_count = uri->path.count ? uri->path.count : 1;
+
+    int matches[FC_COOKIE_HEADER_MAX];
+    int match_count = 0;
+
+    // The host and then every parent domain
+    for (int begin = 0; begin < host_count && match_count < FC_COOKIE_HEADER_MAX;)
+    {
+        const char* suffix = host + begin;
+        int suffix_count = host_count - begin;
+
+        int domain = fc_cookie_find_domain(jar, suffix, suffix_count, fc_uri_hash(suffix, suffix_count, 0));
+
+        for (int i = domain >= 0 ? jar->domains[domain].first : -1; i >= 0 && match_count < FC_COOKIE_HEADER_MAX; i = jar->cookies[i].next)
+        {
+            const fc_cookie* cookie = &jar->cookies[i];
+
+            if (cookie->expires <= now) continue;
+            if (cookie->host_only && begin != 0) continue;
+            if (cookie->secure && !secure_uri) continue;
+
+            const char* path = cookie->data + cookie->name_count + cookie->value_count + cookie->domain_count;
+            if (!fc_cookie_path_match(request_path, request_path_count, path, cookie->path_count)) continue;
+
+            // Longer paths first, then older cookies (section 5.4)
+            int j = match_count++;
+            while (j > 0)
+            {
+                const fc_cookie* other = &jar->cookies[matches[j - 1]];
+                bool after = other->path_count > cookie->path_count ||
+                             (other->path_count == cookie->path_count && other->creation < cookie->creation);
+                if (after) break;
+
+                matches[j] = matches[j - 1];
+                j--;
+            }
+            matches[j] = i;
+        }
+
+        const char* dot = (const char*)memchr(suffix, '.', suffix_count);
+        if (!dot) break;
+
+        begin = (int)(dot + 1 - host);
+    }
+
+    int written = 0;
+
+    for (int i = 0; i < match_count; ++i)
+    {
+        const fc_cookie* cookie = &jar->cookies[matches[i]];
+
+        int needed = (i ? 2 : 0) + cookie->name_count + 1 + cookie->value_count;
+        if (written + needed + 1 > dst_size) return -1;
+
+        if (i)
+        {
+            dst[written++] = ';';
+            dst[written++] = ' ';
+        }
+
+        memcpy(dst + written, cookie->data, cookie->name_count);
+        written += cookie->name_count;
+        dst[written++] = '=';
+        memcpy(dst + written, cookie->data + cookie->name_count, cookie->value_count);
+        written += cookie->value_count;
+    }
+
+    if (dst_size > 0) dst[written] = '\0';
+
+    return written;
+}
+
+int fc_cookie_jar_expire(fc_cookie_jar* jar, uint64_t now)
+{
+    int removed = 0;
+
+    while (jar->heap_count && jar->cookies[jar->heap[0]].expires <= now)
+    {
+        fc_cookie_remove(jar, jar->heap[0]);
+        removed++;
+    }
+
+    return removed;
+}
+
+#endif // FC_URI_COOKIE_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,468 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_COLUMNS_IMPLEMENTATION
+        #include "fc_uri_columns.h"
+
+        #define FC_URI_FILE_IMPLEMENTATION
+        #include "fc_uri_file.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_file.h"
+    "
+
+Example:
+    fc_uri_file file;
+    if (fc_uri_file_open(&file, "urls.txt", 8))
+    {
+        for (int64_t i = 0; i < file.line_count; ++i)
+        {
+            fc_uri_view uri;
+            if (fc_uri_file_line(&file, i, &uri))
+            {
+                // uri points into the mapped file
+            }
+        }
+
+        // Save the parsed lines, fc_uri_file_load maps them back without parsing again
+        fc_uri_file_write_columns(&file, "urls.columns");
+
+        fc_uri_file_close(&file);
+    }
+
+    fc_uri_file_load(&file, "urls.columns"); // Then fc_uri_file_line as above, the views point into urls.columns
+
+Info:
+    Parses files with one URI per line ('\n' or "\r\n"). The file is memory mapped and split in newline
+    aligned chunks, one per thread. Each thread first counts the lines of its chunk so that the columns can
+    be allocated once, then parses its lines into them.
+
+    Components are stored as columns of 16 bit offsets from the start of the line and 16 bit lengths,
+    lines longer than 65535 bytes are not parsed.
+
+    fc_uri_file_write_columns saves the lines in the format of fc_uri_columns.h, one row per line with every
+    component absent for the lines that didn't parse. fc_uri_file_load maps such a file without the source file,
+    it refuses front coded columns since their views would need a buffer.
+
+    Requires POSIX (mmap, pthreads).
+*/
+
+#ifndef FC_URI_FILE
+#define FC_URI_FILE
+
+#include "fc_uri_parse.h"
+#include "fc_uri_columns.h"
+
+#include <stdint.h>
+
+#define FC_URI_FILE_ABSENT 0xFFFF // In count, for components that are not present
+
+enum
+{
+    FC_URI_FILE_PARSED    = 1 << 0,
+    FC_URI_FILE_IPV6_HOST = 1 << 1,
+};
+
+typedef struct
+{
+    int64_t line_count;
+
+    // Only set by fc_uri_file_open
+    const char* data;
+    int64_t size;
+
+    int64_t*  line_begin;
+    uint16_t* offset[FC_URI_COMPONENT_COUNT];
+    uint16_t* count[FC_URI_COMPONENT_COUNT];
+    uint8_t*  flags;
+
+    // Only set by fc_uri_file_load
+    fc_uri_columns columns;
+} fc_uri_file;
+
+bool fc_uri_file_open(fc_uri_file* file, const char* path, int thread_count);
+bool fc_uri_file_load(fc_uri_file* file, const char* columns_path);
+void fc_uri_file_close(fc_uri_file* file);
+
+bool fc_uri_file_write_columns(const fc_uri_file* file, const char* columns_path);
+
+// Returns false if the line could not be parsed.
+bool fc_uri_file_line(const fc_uri_file* file, int64_t line, fc_uri_view* uri);
+
+#endif // FC_URI_FILE
+
+#ifdef FC_URI_FILE_IMPLEMENTATION
+
+#include <string.h>   // memchr
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <pthread.h>
+
+#ifndef FC_URI_FILE_MALLOC
+#include <stdlib.h>
+#define FC_URI_FILE_MALLOC(size) malloc(size)
+#endif
+#ifndef FC_URI_FILE_FREE
+#include <stdlib.h>
+#define FC_URI_FILE_FREE(ptr)    free(ptr)
+#endif
+
+#define FC_URI_FILE_MAX_THREADS 256
+
+typedef struct
+{
+    fc_uri_file* file;
+
+    const char* begin;
+    const char* end;
+
+    int64_t first_line;
+    int64_t line_count;
+} fc_uri_file_chunk;
+
+static int64_t fc_uri_file_padded(int64_t size)
+{
+    return (size + 7) & ~(int64_t)7;
+}
+
+static int64_t fc_uri_file_columns_size(int64_t line_count)
+{
+    return fc_uri_file_padded(line_count * sizeof(int64_t)) +
+           fc_uri_file_padded(line_count * sizeof(uint16_t)) * FC_URI_COMPONENT_COUNT * 2 +
+           fc_uri_file_padded(line_count);
+}
+
+// Points the columns at consecutive arrays in one allocation.
+static void fc_uri_file_assign_columns(fc_uri_file* file, char* memory)
+{
+    file->line_begin = (int64_t*)memory;
+    memory += fc_uri_file_padded(file->line_count * sizeof(int64_t));
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        file->offset[c] = (uint16_t*)memory;
+        memory += fc_uri_file_padded(file->line_count * sizeof(uint16_t));
+    }
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        file->count[c] = (uint16_t*)memory;
+        memory += fc_uri_file_padded(file->line_count * sizeof(uint16_t));
+    }
+
+    file->flags = (uint8_t*)memory;
+}
+
+static bool fc_uri_file_map(const char* path, const char** data, int64_t* size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    *size = info.st_size;
+    *data = NULL;
+
+    if (*size > 0)
+    {
+        void* mapping = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            close(fd);
+            return false;
+        }
+
+        madvise(mapping, *size, MADV_SEQUENTIAL);
+        *data = (const char*)mapping;
+    }
+
+    close(fd);
+    return true;
+}
+
+static int64_t fc_uri_file_count_lines(const char* begin, const char* end)
+{
+    int64_t count = 0;
+
+    while (begin != end)
+    {
+        const char* newline = (const char*)memchr(begin, '\n', end - begin);
+        count += 1;
+
+        if (!newline) break;
+        begin = newline + 1;
+    }
+
+    return count;
+}
+
+static void* fc_uri_file_count_thread(void* param)
+{
+    fc_uri_file_chunk* chunk = (fc_uri_file_chunk*)param;
+    chunk->line_count = fc_uri_file_count_lines(chunk->begin, chunk->end);
+    return NULL;
+}
+
+static void* fc_uri_file_parse_thread(void* param)
+{
+    fc_uri_file_chunk* chunk = (fc_uri_file_chunk*)param;
+    fc_uri_file* file = chunk->file;
+
+    const char* c = chunk->begin;
+
+    for (int64_t line = chunk->first_line; line < chunk->first_line + chunk->line_count; ++line)
+    {
+        const char* newline = (const char*)memchr(c, '\n', chunk->end - c);
+        const char* line_end = newline ? newline : chunk->end;
+        const char* next = newline ? newline + 1 : chunk->end;
+
+        if (line_end != c && line_end[-1] == '\r') line_end--;
+
+        int64_t count = line_end - c;
+
+        file->line_begin[line] = c - file->data;
+        file->flags[line] = 0;
+
+        fc_uri_view uri;
+        if (count > 0 && count < FC_URI_FILE_ABSENT && fc_uri_parse_view(c, (int)count, &uri))
+        {
+            file->flags[line] = FC_URI_FILE_PARSED | (uri.ipv6_host ? FC_URI_FILE_IPV6_HOST : 0);
+
+            for (int k = 0; k < FC_URI_COMPONENT_COUNT; ++k)
+            {
+                fc_uri_str component = fc_uri_view_component(&uri, (fc_uri_component)k);
+
+                file->offset[k][line] = component.data ? (uint16_t)(component.data - c) : 0;
+                file->count[k][line]  = component.data ? (uint16_t)component.count : FC_URI_FILE_ABSENT;
+            }
+        }
+        else {
+            for (int k = 0; k < FC_URI_COMPONENT_COUNT; ++k)
+            {
+                file->offset[k][line] = 0;
+                file->count[k][line]  = FC_URI_FILE_ABSENT;
+            }
+        }
+
+        c = next;
+    }
+
+    return NULL;
+}
+
+// Runs fn on every chunk, on the calling thread when there's only one.
+static void fc_uri_file_run(fc_uri_file_chunk* chunks, int chunk_count, void* (*fn)(void*))
+{
+    pthread_t threads[FC_URI_FILE_MAX_THREADS];
+    int started = 0;
+
+    for (int i = 1; i < chunk_count; ++i)
+    {
+        if (pthread_create(&threads[started], NULL, fn, &chunks[i]) != 0)
+        {
+            fn(&chunks[i]);
+            continue;
+        }
+        started++;
+    }
+
+    if (chunk_count > 0) fn(&chunks[0]);
+
+    for (int i = 0; i < started; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+bool fc_uri_file_open(fc_uri_file* file, const char* path, int thread_count)
+{
+    *file = fc_uri_file{};
+
+    if (!fc_uri_file_map(path, &file->data, &file->size)) return false;
+
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > FC_URI_FILE_MAX_THREADS) thread_count = FC_URI_FILE_MAX_THREADS;
+
+    // Newline aligned chunks, a chunk can be empty when a line spans more than one split point.
+    fc_uri_file_chunk chunks[FC_URI_FILE_MAX_THREADS];
+    const char* file_end = file->data + file->size;
+    const char* begin = file->data;
+
+    for (int i = 0; i < thread_count; ++i)
+    {
+        const char* end = i == thread_count - 1 ? file_end : file->data + file->size * (i + 1) / thread_count;
+        if (end < begin) end = begin;
+
+        if (end != file_end)
+        {
+            const char* newline = (const char*)memchr(end, '\n', file_end - end);
+            end = newline ? newline + 1 : file_end;
+        }
+
+        chunks[i].file  = file;
+        chunks[i].begin = begin;
+        chunks[i].end   = end;
+
+        begin = end;
+    }
+
+    fc_uri_file_run(chunks, thread_count, fc_uri_file_count_thread);
+
+    for (int i = 0; i < thread_count; ++i)
+    {
+        chunks[i].first_line = file->line_count;
+        file->line_count += chunks[i].line_count;
+    }
+
+    char* columns = (char*)FC_URI_FILE_MALLOC(fc_uri_file_columns_size(file->line_count) + 1);
+    if (!columns)
+    {
+        fc_uri_file_close(file);
+        return false;
+    }
+
+    fc_uri_file_assign_columns(file, columns);
+
+    fc_uri_file_run(chunks, thread_count, fc_uri_file_parse_thread);
+
+    return true;
+}
+
+bool fc_uri_file_load(fc_uri_file* file, const char* columns_path)
+{
+    *file = fc_uri_file{};
+
+    if (!fc_uri_columns_map(&file->columns, columns_path)) return false;
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        if (file->columns.columns[c].kind == FC_URI_COLUMNS_FRONT_CODED)
+        {
+            fc_uri_file_close(file);
+            return false;
+        }
+    }
+
+    file->line_count = file->columns.row_count;
+
+    return true;
+}
+
+void fc_uri_file_close(fc_uri_file* file)
+{
+    if (file->data) munmap((void*)file->data, file->size);
+    if (file->line_begin) FC_URI_FILE_FREE(file->line_begin);
+
+    fc_uri_columns_free(&file->columns);
+
+    *file = fc_uri_file{};
+}
+
+bool fc_uri_file_write_columns(const fc_uri_file* file, const char* columns_path)
+{
+    fc_uri_columns_writer* writer = (fc_uri_columns_writer*)FC_URI_FILE_MALLOC(sizeof(fc_uri_columns_writer));
+    if (!writer) return false;
+
+    fc_uri_columns_writer_begin(writer, 0);
+
+    bool ok = true;
+
+    for (int64_t line = 0; line < file->line_count && ok; ++line)
+    {
+        fc_uri_view uri;
+        fc_uri_file_line(file, line, &uri); // All absent when the line didn't parse
+
+        ok = fc_uri_columns_writer_add(writer, &uri);
+    }
+
+    ok = ok && fc_uri_columns_writer_write(writer, columns_path);
+
+    fc_uri_columns_writer_free(writer);
+    FC_URI_FILE_FREE(writer);
+
+    return ok;
+}
+
+bool fc_uri_file_line(const fc_uri_file* file, int64_t line, fc_uri_view* uri)
+{
+    *uri = fc_uri_view{};
+
+    if (line < 0 || line >= file->line_count) return false;
+
+    fc_uri_str* components[FC_URI_COMPONENT_COUNT] = {
+        &uri->scheme, &uri->user, &uri->access_info, &uri->host,
+        &uri->port, &uri->path, &uri->query, &uri->fragment,
+    };
+
+    if (file->columns.image)
+    {
+        // Parsed lines always have a scheme, even if empty
+        if (fc_uri_columns_code(&file->columns, line, FC_URI_SCHEME) == 0) return false;
+
+        for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+        {
+            *components[c] = fc_uri_columns_get(&file->columns, line, (fc_uri_component)c, NULL);
+        }
+
+        uri->ipv6_host = fc_uri_columns_ipv6_host(&file->columns, line);
+
+        return true;
+    }
+
+    if (!(file->flags[line] & FC_URI_FILE_PARSED)) return false;
+
+    const char* begin = file->data + file->line_begin[line];
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        if (file->count[c][line] == FC_URI_FILE_ABSENT) continue;
+
+        components[c]->data  = begin + file->offset[c][line];
+        components[c]->count = file->count[c][line];
+    }
+
+    uri->ipv6_host = (file->flags[line] & FC_URI_FILE_IPV6_HOST) != 0;
+
+    return true;
+}
+
+#endif // FC_URI_FILE_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
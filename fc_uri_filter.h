@@ -0,0 +1,749 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_FILTER_IMPLEMENTATION
+        #include "fc_uri_filter.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_filter.h"
+    "
+
+Example:
+    fc_bloom_filter seen;
+    fc_bloom_init(&seen, 1000000000, 0.01);
+
+    fc_uri_view uri;
+    fc_uri_parse_view(url, url_length, &uri);
+
+    uint64_t key = fc_uri_filter_key(&uri);
+    if (!fc_bloom_contains(&seen, key))
+    {
+        fc_bloom_insert(&seen, key); // Safe to call from many threads at once
+        // enqueue url
+    }
+
+    fc_bloom_write(&seen, "seen.bloom");
+    fc_bloom_free(&seen);
+
+    // Later, or in another process. Inserts go straight to the file when mapped writable.
+    fc_bloom_map(&seen, "seen.bloom", true);
+
+Info:
+    Probabilistic sets of URIs, keyed by the hash of their normalized form (see fc_uri_normalize).
+
+    fc_bloom_filter is a split block Bloom filter: a key sets one bit in each of the eight 32 bit words of a
+    single 32 byte block, so every operation touches one cache line. The eight bit positions come from
+    multiplying the key by eight odd constants, which is done with AVX2 when available.
+
+    fc_cuckoo_filter stores 16 bit fingerprints in buckets of four (one uint64_t per bucket) with partial-key
+    cuckoo hashing. It supports removal and has a lower false positive rate than a Bloom filter of the same
+    size at high occupancy.
+
+    Inserts into both filters are lock-free (atomic OR for the Bloom filter, compare-and-swap of whole buckets
+    for the cuckoo filter), except for cuckoo inserts that have to relocate fingerprints: those take turns, so
+    that no evicted fingerprint gets lost. A lookup can miss the fingerprint being moved for that brief moment.
+    The fingerprint left over when the cuckoo filter fills up is parked in a victim slot. Every remove that frees
+    a slot tries to move it back into the buckets, relocating fingerprints like an insert does.
+
+    The batch functions compute all the positions first and prefetch them, which hides most of the memory latency.
+
+    Filters live in page aligned memory, in the same layout as their files, so they can be memory mapped.
+    Requires POSIX (mmap).
+*/
+
+#ifndef FC_URI_FILTER
+#define FC_URI_FILTER
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct
+{
+    uint32_t* blocks; // 8 words per block
+    uint64_t block_count;
+
+    // Internal
+    void*  image;
+    size_t image_size;
+} fc_bloom_filter;
+
+typedef struct
+{
+    uint64_t* buckets;
+    uint64_t bucket_mask;
+
+    uint64_t* victim; // Fingerprint that didn't fit, in the image so that it's saved too
+
+    // Internal
+    void*  image;
+    size_t image_size;
+} fc_cuckoo_filter;
+
+// Hash of the normalized URI.
+uint64_t fc_uri_filter_key(const fc_uri_view* uri);
+
+bool fc_bloom_init(fc_bloom_filter* filter, uint64_t expected_items, double false_positive_rate);
+void fc_bloom_free(fc_bloom_filter* filter);
+
+void fc_bloom_insert(fc_bloom_filter* filter, uint64_t key);
+bool fc_bloom_contains(const fc_bloom_filter* filter, uint64_t key);
+
+void fc_bloom_insert_batch(fc_bloom_filter* filter, const uint64_t* keys, int count);
+void fc_bloom_contains_batch(const fc_bloom_filter* filter, const uint64_t* keys, int count, bool* results);
+
+bool fc_bloom_write(const fc_bloom_filter* filter, const char* path);
+bool fc_bloom_map(fc_bloom_filter* filter, const char* path, bool writable);
+
+bool fc_cuckoo_init(fc_cuckoo_filter* filter, uint64_t expected_items);
+void fc_cuckoo_free(fc_cuckoo_filter* filter);
+
+// Returns false when the filter is full, nothing is evicted then. fc_cuckoo_contains can miss a fingerprint
+// while a concurrent insert is relocating it.
+bool fc_cuckoo_insert(fc_cuckoo_filter* filter, uint64_t key);
+bool fc_cuckoo_contains(const fc_cuckoo_filter* filter, uint64_t key);
+bool fc_cuckoo_remove(fc_cuckoo_filter* filter, uint64_t key);
+
+// results[i] is what fc_cuckoo_insert or fc_cuckoo_contains would return for keys[i].
+void fc_cuckoo_insert_batch(fc_cuckoo_filter* filter, const uint64_t* keys, int count, bool* results);
+void fc_cuckoo_contains_batch(const fc_cuckoo_filter* filter, const uint64_t* keys, int count, bool* results);
+
+bool fc_cuckoo_write(const fc_cuckoo_filter* filter, const char* path);
+bool fc_cuckoo_map(fc_cuckoo_filter* filter, const char* path, bool writable);
+
+#endif // FC_URI_FILTER
+
+#ifdef FC_URI_FILTER_IMPLEMENTATION
+
+#include <math.h>     // log
+#include <string.h>   // memcmp
+#include <stdio.h>    // FILE
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+
+#if !defined(FC_URI_NO_SIMD) && defined(__AVX2__)
+#define FC_URI_FILTER_AVX2
+#include <immintrin.h>
+#endif
+
+#define FC_URI_FILTER_HEADER_SIZE 64 // Keeps the data cache line aligned
+#define FC_URI_FILTER_BATCH 16
+#define FC_URI_FILTER_MAX_KICKS 500
+
+// Victim value while an insert is relocating fingerprints, its index is past every bucket so it never matches
+#define FC_URI_FILTER_KICKING UINT64_MAX
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // _mm_pause
+#define FC_URI_FILTER_PAUSE() _mm_pause()
+#else
+#define FC_URI_FILTER_PAUSE()
+#endif
+
+static const char fc_bloom_magic[8]  = { 'F', 'C', 'B', 'L', 'O', 'O', 'M', '1' };
+static const char fc_cuckoo_magic[8] = { 'F', 'C', 'C', 'U', 'C', 'K', 'O', '1' };
+
+uint64_t fc_uri_filter_key(const fc_uri_view* uri)
+{
+    char normalized[FC_URI_MAX + 1];
+    int count = fc_uri_normalize(uri, normalized, sizeof(normalized));
+
+    if (count >= 0) return fc_uri_hash(normalized, count, 0);
+
+    // Too long to normalize, hash the components as they are
+    uint64_t hash = 0;
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        fc_uri_str component = fc_uri_view_component(uri, (fc_uri_component)c);
+        hash = fc_uri_hash(component.data, component.count, hash + c);
+    }
+
+    return hash;
+}
+
+// Image: magic, uint64 count (blocks or buckets), padding up to FC_URI_FILTER_HEADER_SIZE, data.
+
+static void* fc_uri_filter_allocate(const char magic[8], uint64_t count, size_t data_size, size_t* image_size)
+{
+    *image_size = FC_URI_FILTER_HEADER_SIZE + data_size;
+
+    // Anonymous mappings are page aligned and zeroed
+    void* image = mmap(NULL, *image_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (image == MAP_FAILED) return NULL;
+
+    memcpy(image, magic, 8);
+    memcpy((char*)image + 8, &count, 8);
+
+    return image;
+}
+
+static bool fc_uri_filter_write(const void* image, size_t image_size, const char* path)
+{
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+
+    bool ok = fwrite(image, image_size, 1, out) == 1;
+
+    return fclose(out) == 0 && ok;
+}
+
+static void* fc_uri_filter_map(const char magic[8], const char* path, bool writable, uint64_t* count, size_t* image_size)
+{
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < FC_URI_FILTER_HEADER_SIZE)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    void* image = mmap(NULL, info.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (image == MAP_FAILED) return NULL;
+
+    *image_size = info.st_size;
+    memcpy(count, (char*)image + 8, 8);
+
+    if (memcmp(image, magic, 8) != 0)
+    {
+        munmap(image, *image_size);
+        return NULL;
+    }
+
+    return image;
+}
+
+// Bloom filter
+
+static const uint32_t fc_bloom_salt[8] = {
+    0x47B6137Bu, 0x44974D91u, 0x8824AD5Bu, 0xA2B7289Du, 0x705495C7u, 0x2DF1424Bu, 0x9EFC4947u, 0x5C6BFB31u,
+};
+
+static uint64_t fc_bloom_block(const fc_bloom_filter* filter, uint64_t key)
+{
+    // Multiply-shift instead of modulo, the high bits pick the block and the low ones the bits in it.
+    return (uint64_t)(((key >> 32) * filter->block_count) >> 32);
+}
+
+#ifdef FC_URI_FILTER_AVX2
+static __m256i fc_bloom_masks_avx2(uint64_t key)
+{
+    __m256i salt = _mm256_loadu_si256((const __m256i*)fc_bloom_salt);
+    __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_set1_epi32((int)(uint32_t)key), salt), 27);
+
+    return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+}
+
+// Word by word with relaxed atomic loads, inserts from other threads can be writing to the block.
+static __m256i fc_bloom_load_block(const uint32_t* block)
+{
+    return _mm256_setr_epi32((int)__atomic_load_n(&block[0], __ATOMIC_RELAXED), (int)__atomic_load_n(&block[1], __ATOMIC_RELAXED),
+                             (int)__atomic_load_n(&block[2], __ATOMIC_RELAXED), (int)__atomic_load_n(&block[3], __ATOMIC_RELAXED),
+                             (int)__atomic_load_n(&block[4], __ATOMIC_RELAXED), (int)__atomic_load_n(&block[5], __ATOMIC_RELAXED),
+                             (int)__atomic_load_n(&block[6], __ATOMIC_RELAXED), (int)__atomic_load_n(&block[7], __ATOMIC_RELAXED));
+}
+#else
+static void fc_bloom_masks(uint64_t key, uint32_t masks[8])
+{
+    uint32_t low = (uint32_t)key;
+
+    for (int i = 0; i < 8; ++i)
+    {
+        masks[i] = 1u << ((low * fc_bloom_salt[i]) >> 27);
+    }
+}
+#endif
+
+bool fc_bloom_init(fc_bloom_filter* filter, uint64_t expected_items, double false_positive_rate)
+{
+    *filter = fc_bloom_filter{};
+
+    if (expected_items == 0) expected_items = 1;
+    if (false_positive_rate <= 0 || false_positive_rate >= 1) false_positive_rate = 0.01;
+
+    // Optimal size for a classic Bloom filter, plus some room for the unevenness of the blocks.
+    double bits = -(double)expected_items * log(false_positive_rate) / (log(2.0) * log(2.0)) * 1.2;
+    uint64_t block_count = (uint64_t)(bits / 256) + 1;
+
+    // The block index comes from 32 bits of the key
+    if (block_count > 0xFFFFFFFFull) block_count = 0xFFFFFFFFull;
+
+    filter->image = fc_uri_filter_allocate(fc_bloom_magic, block_count, block_count * 32, &filter->image_size);
+    if (!filter->image) return false;
+
+    filter->blocks = (uint32_t*)((char*)filter->image + FC_URI_FILTER_HEADER_SIZE);
+    filter->block_count = block_count;
+
+    return true;
+}
+
+void fc_bloom_free(fc_bloom_filter* filter)
+{
+    if (filter->image) munmap(filter->image, filter->image_size);
+    *filter = fc_bloom_filter{};
+}
+
+static void fc_bloom_insert_block(uint32_t* block, uint64_t key)
+{
+    uint32_t masks[8];
+
+#ifdef FC_URI_FILTER_AVX2
+    // Find the words missing bits with one compare, only those get an atomic OR. A word read as missing a bit
+    // that another thread sets right after just gets a redundant OR.
+    __m256i vector  = fc_bloom_masks_avx2(key);
+    __m256i missing = _mm256_andnot_si256(fc_bloom_load_block(block), vector);
+    __m256i present = _mm256_cmpeq_epi32(missing, _mm256_setzero_si256());
+
+    uint32_t words = ~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(present)) & 0xFF;
+    if (!words) return;
+
+    _mm256_storeu_si256((__m256i*)masks, vector);
+
+    while (words)
+    {
+        int word = fc_uri_ctz(words);
+        __atomic_fetch_or(&block[word], masks[word], __ATOMIC_RELAXED);
+        words &= words - 1;
+    }
+#else
+    fc_bloom_masks(key, masks);
+
+    for (int i = 0; i < 8; ++i)
+    {
+        // Reading first keeps the cache line shared when the bit is already there
+        if ((__atomic_load_n(&block[i], __ATOMIC_RELAXED) & masks[i]) != masks[i])
+        {
+            __atomic_fetch_or(&block[i], masks[i], __ATOMIC_RELAXED);
+        }
+    }
+#endif
+}
+
+static bool fc_bloom_contains_block(const uint32_t* block, uint64_t key)
+{
+#ifdef FC_URI_FILTER_AVX2
+    return _mm256_testc_si256(fc_bloom_load_block(block), fc_bloom_masks_avx2(key));
+#else
+    uint32_t masks[8];
+    fc_bloom_masks(key, masks);
+
+    uint32_t missing = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        missing |= masks[i] & ~__atomic_load_n(&block[i], __ATOMIC_RELAXED);
+    }
+
+    return missing == 0;
+#endif
+}
+
+void fc_bloom_insert(fc_bloom_filter* filter, uint64_t key)
+{
+    fc_bloom_insert_block(filter->blocks + fc_bloom_block(filter, key) * 8, key);
+}
+
+bool fc_bloom_contains(const fc_bloom_filter* filter, uint64_t key)
+{
+    return fc_bloom_contains_block(filter->blocks + fc_bloom_block(filter, key) * 8, key);
+}
+
+void fc_bloom_insert_batch(fc_bloom_filter* filter, const uint64_t* keys, int count)
+{
+    uint32_t* blocks[FC_URI_FILTER_BATCH];
+
+    for (int base = 0; base < count; base += FC_URI_FILTER_BATCH)
+    {
+        int n = count - base < FC_URI_FILTER_BATCH ? count - base : FC_URI_FILTER_BATCH;
+
+        for (int i = 0; i < n; ++i)
+        {
+            blocks[i] = filter->blocks + fc_bloom_block(filter, keys[base + i]) * 8;
+            __builtin_prefetch(blocks[i], 1);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            fc_bloom_insert_block(blocks[i], keys[base + i]);
+        }
+    }
+}
+
+void fc_bloom_contains_batch(const fc_bloom_filter* filter, const uint64_t* keys, int count, bool* results)
+{
+    const uint32_t* blocks[FC_URI_FILTER_BATCH];
+
+    for (int base = 0; base < count; base += FC_URI_FILTER_BATCH)
+    {
+        int n = count - base < FC_URI_FILTER_BATCH ? count - base : FC_URI_FILTER_BATCH;
+
+        for (int i = 0; i < n; ++i)
+        {
+            blocks[i] = filter->blocks + fc_bloom_block(filter, keys[base + i]) * 8;
+            __builtin_prefetch(blocks[i], 0);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            results[base + i] = fc_bloom_contains_block(blocks[i], keys[base + i]);
+        }
+    }
+}
+
+bool fc_bloom_write(const fc_bloom_filter* filter, const char* path)
+{
+    return fc_uri_filter_write(filter->image, filter->image_size, path);
+}
+
+bool fc_bloom_map(fc_bloom_filter* filter, const char* path, bool writable)
+{
+    *filter = fc_bloom_filter{};
+
+    uint64_t block_count;
+    filter->image = fc_uri_filter_map(fc_bloom_magic, path, writable, &block_count, &filter->image_size);
+    if (!filter->image) return false;
+
+    if (block_count == 0 || FC_URI_FILTER_HEADER_SIZE + block_count * 32 > filter->image_size)
+    {
+        fc_bloom_free(filter);
+        return false;
+    }
+
+    filter->blocks = (uint32_t*)((char*)filter->image + FC_URI_FILTER_HEADER_SIZE);
+    filter->block_count = block_count;
+
+    return true;
+}
+
+// Cuckoo filter
+
+#define FC_CUCKOO_LANES 0x0001000100010001ull
+#define FC_CUCKOO_HIGHS 0x8000800080008000ull
+
+static uint16_t fc_cuckoo_fingerprint(uint64_t key)
+{
+    uint16_t fingerprint = (uint16_t)(key >> 48);
+    return fingerprint ? fingerprint : 1; // 0 marks empty slots
+}
+
+static uint64_t fc_cuckoo_alternate(const fc_cuckoo_filter* filter, uint64_t index, uint16_t fingerprint)
+{
+    // Symmetric, applying it twice gives back the first index
+    return (index ^ (fingerprint * 0x5BD1E995ull)) & filter->bucket_mask;
+}
+
+// Mask with the high bit of every 16 bit lane of bucket that is equal to fingerprint.
+static uint64_t fc_cuckoo_match(uint64_t bucket, uint16_t fingerprint)
+{
+    uint64_t x = bucket ^ (fingerprint * FC_CUCKOO_LANES);
+    return (x - FC_CUCKOO_LANES) & ~x & FC_CUCKOO_HIGHS;
+}
+
+bool fc_cuckoo_init(fc_cuckoo_filter* filter, uint64_t expected_items)
+{
+    *filter = fc_cuckoo_filter{};
+
+    // Buckets of four fingerprints stay under ~95% load
+    uint64_t bucket_count = 1;
+    while (bucket_count * 4 * 95 / 100 < expected_items) bucket_count *= 2;
+
+    // One extra uint64_t for the victim
+    filter->image = fc_uri_filter_allocate(fc_cuckoo_magic, bucket_count, (bucket_count + 1) * 8, &filter->image_size);
+    if (!filter->image) return false;
+
+    filter->buckets = (uint64_t*)((char*)filter->image + FC_URI_FILTER_HEADER_SIZE);
+    filter->bucket_mask = bucket_count - 1;
+    filter->victim = filter->buckets + bucket_count;
+
+    return true;
+}
+
+void fc_cuckoo_free(fc_cuckoo_filter* filter)
+{
+    if (filter->image) munmap(filter->image, filter->image_size);
+    *filter = fc_cuckoo_filter{};
+}
+
+// Puts fingerprint in an empty slot of the bucket, false if there's none.
+static bool fc_cuckoo_try_insert(uint64_t* bucket, uint16_t fingerprint)
+{
+    uint64_t current = __atomic_load_n(bucket, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        uint64_t empty = fc_cuckoo_match(current, 0);
+        if (!empty) return false;
+
+        int shift = fc_uri_ctz64(empty) - 15;
+        uint64_t updated = current | ((uint64_t)fingerprint << shift);
+
+        if (__atomic_compare_exchange_n(bucket, &current, updated, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) return true;
+    }
+}
+
+// Called with the victim slot taken. Swaps fingerprint into the full buckets starting at index until an evicted
+// fingerprint finds an empty slot, then gives the victim slot back with whatever fingerprint is left over.
+static void fc_cuckoo_relocate(fc_cuckoo_filter* filter, uint64_t index, uint16_t fingerprint)
+{
+    for (int kick = 0; kick < FC_URI_FILTER_MAX_KICKS; ++kick)
+    {
+        // Swap fingerprint with one of the bucket, then find a place for the one that came out
+        uint64_t* bucket = &filter->buckets[index];
+        uint64_t current = __atomic_load_n(bucket, __ATOMIC_RELAXED);
+
+        int shift = (kick & 3) * 16;
+        uint16_t evicted = (uint16_t)(current >> shift);
+        uint64_t updated = (current & ~(0xFFFFull << shift)) | ((uint64_t)fingerprint << shift);
+
+        if (!__atomic_compare_exchange_n(bucket, &current, updated, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) continue;
+
+        if (!evicted) // The slot got freed in the meantime
+        {
+            fingerprint = 0;
+            break;
+        }
+
+        fingerprint = evicted;
+        index = fc_cuckoo_alternate(filter, index, fingerprint);
+
+        if (fc_cuckoo_try_insert(&filter->buckets[index], fingerprint))
+        {
+            fingerprint = 0;
+            break;
+        }
+    }
+
+    // Full, keep the last fingerprint aside so that it can still be found
+    __atomic_store_n(filter->victim, fingerprint ? (index << 16) | fingerprint : 0, __ATOMIC_RELEASE);
+}
+
+bool fc_cuckoo_insert(fc_cuckoo_filter* filter, uint64_t key)
+{
+    uint16_t fingerprint = fc_cuckoo_fingerprint(key);
+    uint64_t index = key & filter->bucket_mask;
+    uint64_t alternate = fc_cuckoo_alternate(filter, index, fingerprint);
+
+    // Relocations are serialized by taking the victim slot: one evicted fingerprint in hand at a time, and the
+    // slot is free to keep it if it can't be placed. Plain inserts keep going in the meantime.
+    for (;;)
+    {
+        if (fc_cuckoo_try_insert(&filter->buckets[index], fingerprint)) return true;
+        if (fc_cuckoo_try_insert(&filter->buckets[alternate], fingerprint)) return true;
+
+        uint64_t expected = 0;
+        if (__atomic_compare_exchange_n(filter->victim, &expected, FC_URI_FILTER_KICKING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) break;
+
+        // Full, nothing was evicted
+        if (expected != FC_URI_FILTER_KICKING) return false;
+
+        FC_URI_FILTER_PAUSE();
+    }
+
+    fc_cuckoo_relocate(filter, alternate, fingerprint);
+
+    return true;
+}
+
+static bool fc_cuckoo_victim_matches(const fc_cuckoo_filter* filter, uint64_t i1, uint64_t i2, uint16_t fingerprint)
+{
+    uint64_t victim = __atomic_load_n(filter->victim, __ATOMIC_ACQUIRE);
+    if (!victim || (uint16_t)victim != fingerprint) return false;
+
+    uint64_t index = victim >> 16;
+    return index == i1 || index == i2;
+}
+
+bool fc_cuckoo_contains(const fc_cuckoo_filter* filter, uint64_t key)
+{
+    uint16_t fingerprint = fc_cuckoo_fingerprint(key);
+    uint64_t i1 = key & filter->bucket_mask;
+    uint64_t i2 = fc_cuckoo_alternate(filter, i1, fingerprint);
+
+    uint64_t b1 = __atomic_load_n(&filter->buckets[i1], __ATOMIC_ACQUIRE);
+    uint64_t b2 = __atomic_load_n(&filter->buckets[i2], __ATOMIC_ACQUIRE);
+
+    return fc_cuckoo_match(b1, fingerprint) || fc_cuckoo_match(b2, fingerprint) ||
+           fc_cuckoo_victim_matches(filter, i1, i2, fingerprint);
+}
+
+// Tries to move the parked victim back into the buckets, once a remove has made room somewhere.
+static void fc_cuckoo_place_victim(fc_cuckoo_filter* filter)
+{
+    uint64_t victim = __atomic_load_n(filter->victim, __ATOMIC_RELAXED);
+    if (!victim || victim == FC_URI_FILTER_KICKING) return;
+
+    // Taken like an insert that relocates, the victim stays parked if it doesn't get through
+    if (!__atomic_compare_exchange_n(filter->victim, &victim, FC_URI_FILTER_KICKING, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return;
+
+    uint16_t fingerprint = (uint16_t)victim;
+    uint64_t index = (victim >> 16) & filter->bucket_mask;
+    uint64_t alternate = fc_cuckoo_alternate(filter, index, fingerprint);
+
+    if (fc_cuckoo_try_insert(&filter->buckets[index], fingerprint) || fc_cuckoo_try_insert(&filter->buckets[alternate], fingerprint))
+    {
+        __atomic_store_n(filter->victim, 0, __ATOMIC_RELEASE);
+        return;
+    }
+
+    fc_cuckoo_relocate(filter, alternate, fingerprint);
+}
+
+bool fc_cuckoo_remove(fc_cuckoo_filter* filter, uint64_t key)
+{
+    uint16_t fingerprint = fc_cuckoo_fingerprint(key);
+    uint64_t i1 = key & filter->bucket_mask;
+    uint64_t i2 = fc_cuckoo_alternate(filter, i1, fingerprint);
+
+    if (fc_cuckoo_victim_matches(filter, i1, i2, fingerprint))
+    {
+        __atomic_store_n(filter->victim, 0, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    uint64_t indices[2] = { i1, i2 };
+    for (int i = 0; i < 2; ++i)
+    {
+        uint64_t* bucket = &filter->buckets[indices[i]];
+        uint64_t current = __atomic_load_n(bucket, __ATOMIC_RELAXED);
+
+        for (;;)
+        {
+            uint64_t match = fc_cuckoo_match(current, fingerprint);
+            if (!match) break;
+
+            int shift = fc_uri_ctz64(match) - 15;
+            uint64_t updated = current & ~(0xFFFFull << shift);
+
+            if (__atomic_compare_exchange_n(bucket, &current, updated, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            {
+                fc_cuckoo_place_victim(filter);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void fc_cuckoo_insert_batch(fc_cuckoo_filter* filter, const uint64_t* keys, int count, bool* results)
+{
+    for (int base = 0; base < count; base += FC_URI_FILTER_BATCH)
+    {
+        int n = count - base < FC_URI_FILTER_BATCH ? count - base : FC_URI_FILTER_BATCH;
+
+        for (int i = 0; i < n; ++i)
+        {
+            uint64_t index = keys[base + i] & filter->bucket_mask;
+
+            __builtin_prefetch(&filter->buckets[index], 1);
+            __builtin_prefetch(&filter->buckets[fc_cuckoo_alternate(filter, index, fc_cuckoo_fingerprint(keys[base + i]))], 1);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            results[base + i] = fc_cuckoo_insert(filter, keys[base + i]);
+        }
+    }
+}
+
+void fc_cuckoo_contains_batch(const fc_cuckoo_filter* filter, const uint64_t* keys, int count, bool* results)
+{
+    uint64_t i1[FC_URI_FILTER_BATCH];
+    uint64_t i2[FC_URI_FILTER_BATCH];
+
+    for (int base = 0; base < count; base += FC_URI_FILTER_BATCH)
+    {
+        int n = count - base < FC_URI_FILTER_BATCH ? count - base : FC_URI_FILTER_BATCH;
+
+        for (int i = 0; i < n; ++i)
+        {
+            uint16_t fingerprint = fc_cuckoo_fingerprint(keys[base + i]);
+
+            i1[i] = keys[base + i] & filter->bucket_mask;
+            i2[i] = fc_cuckoo_alternate(filter, i1[i], fingerprint);
+
+            __builtin_prefetch(&filter->buckets[i1[i]], 0);
+            __builtin_prefetch(&filter->buckets[i2[i]], 0);
+        }
+
+        for (int i = 0; i < n; ++i)
+        {
+            uint16_t fingerprint = fc_cuckoo_fingerprint(keys[base + i]);
+
+            uint64_t b1 = __atomic_load_n(&filter->buckets[i1[i]], __ATOMIC_ACQUIRE);
+            uint64_t b2 = __atomic_load_n(&filter->buckets[i2[i]], __ATOMIC_ACQUIRE);
+
+            results[base + i] = fc_cuckoo_match(b1, fingerprint) || fc_cuckoo_match(b2, fingerprint) ||
+                                fc_cuckoo_victim_matches(filter, i1[i], i2[i], fingerprint);
+        }
+    }
+}
+
+bool fc_cuckoo_write(const fc_cuckoo_filter* filter, const char* path)
+{
+    return fc_uri_filter_write(filter->image, filter->image_size, path);
+}
+
+bool fc_cuckoo_map(fc_cuckoo_filter* filter, const char* path, bool writable)
+{
+    *filter = fc_cuckoo_filter{};
+
+    uint64_t bucket_count;
+    filter->image = fc_uri_filter_map(fc_cuckoo_magic, path, writable, &bucket_count, &filter->image_size);
+    if (!filter->image) return false;
+
+    bool power_of_two = bucket_count && (bucket_count & (bucket_count - 1)) == 0;
+    if (!power_of_two || FC_URI_FILTER_HEADER_SIZE + (bucket_count + 1) * 8 > filter->image_size)
+    {
+        fc_cuckoo_free(filter);
+        return false;
+    }
+
+    filter->buckets = (uint64_t*)((char*)filter->image + FC_URI_FILTER_HEADER_SIZE);
+    filter->bucket_mask = bucket_count - 1;
+    filter->victim = filter->buckets + bucket_count;
+
+    // Written in the middle of a relocation, don't block the ones to come
+    if (writable && *filter->victim == FC_URI_FILTER_KICKING) *filter->victim = 0;
+
+    return true;
+}
+
+#endif // FC_URI_FILTER_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
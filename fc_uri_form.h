@@ -0,0 +1,483 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_FORM_IMPLEMENTATION
+        #include "fc_uri_form.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_form.h"
+    "
+
+Example:
+    fc_form* form = (fc_form*)malloc(sizeof(fc_form)); // ~5KB, don't copy it around
+    fc_form_begin(form);
+
+    fc_form_pair pair;
+
+    while (int count = read(fd, chunk, sizeof(chunk)))
+    {
+        fc_form_feed(form, chunk, count); // chunk is decoded in place
+
+        while (fc_form_next(form, &pair))
+        {
+            // "a=b+c%21" gives pair.key "a" and pair.value "b c!"
+            // pair.partial is set when more of the same value comes in the next pairs
+        }
+    }
+
+    fc_form_finish(form); // The last pair has no '&' after it
+    while (fc_form_next(form, &pair)) {}
+
+Info:
+    Streaming decoder of application/x-www-form-urlencoded bodies
+    (https://url.spec.whatwg.org/#application/x-www-form-urlencoded).
+
+    Pairs that are entirely inside a chunk are decoded in place and returned as views into it, nothing is copied
+    until the first '+' or '%XX'. The search for '&', '=', '%' and '+' is vectorized with SSE2, define FC_URI_NO_SIMD
+    to force the scalar fallback. Only the pairs that cross the end of a chunk are copied into the decoder.
+
+    The memory used is fixed: keys longer than FC_FORM_KEY_MAX skip their pair (counted in skipped) and values
+    longer than FC_FORM_VALUE_MAX come in pieces, each one returned with the same key and partial set
+    but the last. A value that is split by the end of a chunk can also come in two pieces when it doesn't fit.
+    Bytes are not checked to be UTF-8. A value is not present (data is NULL) when the pair has no '='.
+*/
+
+#ifndef FC_URI_FORM
+#define FC_URI_FORM
+
+#include "fc_uri_parse.h"
+
+#ifndef FC_FORM_KEY_MAX
+#define FC_FORM_KEY_MAX 1024
+#endif
+
+#ifndef FC_FORM_VALUE_MAX
+#define FC_FORM_VALUE_MAX 4096
+#endif
+
+typedef struct
+{
+    fc_uri_str key;
+    fc_uri_str value;
+
+    bool partial; // More of value follows
+} fc_form_pair;
+
+typedef struct
+{
+    char* chunk;
+    char* chunk_end;
+
+    // Pair continuing from an earlier chunk
+    bool carry;
+    bool in_value;
+    bool skipping; // Key too long, dropped up to the next '&'
+    bool finished;
+
+    char escape[2]; // '%' and maybe a hex digit, cut by the end of a chunk
+    int  escape_count;
+
+    char key[FC_FORM_KEY_MAX];
+    int  key_count;
+
+    char value[FC_FORM_VALUE_MAX + 2]; // Room for an escape past the limit
+    int  value_count;
+
+    int skipped;
+} fc_form;
+
+void fc_form_begin(fc_form* form);
+
+// chunk is modified, decoded pairs are written over it.
+void fc_form_feed(fc_form* form, char* chunk, int count);
+
+// The body is over, fc_form_next returns what is left of the last pair.
+void fc_form_finish(fc_form* form);
+
+// Returns the next pair of the current chunk. The views in pair are valid until the next call or the next chunk.
+bool fc_form_next(fc_form* form, fc_form_pair* pair);
+
+#endif // FC_URI_FORM
+
+#ifdef FC_URI_FORM_IMPLEMENTATION
+
+#include <string.h> // memchr, memcpy, memmove
+
+#ifdef FC_URI_SSE2
+#define FC_FORM_SSE2
+#include <emmintrin.h>
+#endif
+
+void fc_form_begin(fc_form* form)
+{
+    form->chunk = NULL;
+    form->chunk_end = NULL;
+
+    form->carry = false;
+    form->in_value = false;
+    form->skipping = false;
+    form->finished = false;
+
+    form->escape_count = 0;
+    form->key_count = 0;
+    form->value_count = 0;
+
+    form->skipped = 0;
+}
+
+void fc_form_feed(fc_form* form, char* chunk, int count)
+{
+    form->chunk = chunk;
+    form->chunk_end = chunk + count;
+}
+
+void fc_form_finish(fc_form* form)
+{
+    form->chunk = form->chunk_end;
+    form->finished = true;
+}
+
+static int fc_form_hex_value(char c)
+{
+    if ((unsigned)(c - '0') < 10) return c - '0';
+    if ((unsigned)((c | 0x20) - 'a') < 6) return (c | 0x20) - 'a' + 10;
+    return -1;
+}
+
+// First '&', '=', '%' or '+' of [c, end), or end.
+static char* fc_form_scan(char* c, char* end)
+{
+#ifdef FC_FORM_SSE2
+    while (end - c >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)c);
+
+        __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('&')), _mm_cmpeq_epi8(block, _mm_set1_epi8('='))),
+                                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('%')), _mm_cmpeq_epi8(block, _mm_set1_epi8('+'))));
+
+        int found_mask = _mm_movemask_epi8(found);
+        if (found_mask) return c + fc_uri_ctz(found_mask);
+
+        c += 16;
+    }
+#endif
+
+    while (c != end && *c != '&' && *c != '=' && *c != '%' && *c != '+') c++;
+
+    return c;
+}
+
+// Decodes [*cursor, end) into out until '&', '=' for keys, the end of the chunk or out_max bytes.
+// out can be the input itself, it never gets ahead of the cursor. An escape cut by the end of the chunk
+// is kept in form->escape. Returns the number of bytes written, *cursor is left on the stop.
+static int fc_form_decode(fc_form* form, char** cursor, char* end, char* out, int out_max, bool key)
+{
+    char* c = *cursor;
+    int written = 0;
+
+    while (c != end && written < out_max)
+    {
+        char* special = fc_form_scan(c, end);
+
+        int run = (int)(special - c);
+        if (run > out_max - written) run = out_max - written;
+
+        if (out + written != c) memmove(out + written, c, run);
+        written += run;
+        c += run;
+
+        if (c != special || c == end || written == out_max) break;
+
+        if (*c == '&' || (key && *c == '=')) break;
+
+        if (*c == '=') {
+            out[written++] = '=';
+            c += 1;
+        } else if (*c == '+') {
+            out[written++] = ' ';
+            c += 1;
+        } else if (end - c >= 3 && fc_form_hex_value(c[1]) >= 0 && fc_form_hex_value(c[2]) >= 0) {
+            out[written++] = (char)(fc_form_hex_value(c[1]) * 16 + fc_form_hex_value(c[2]));
+            c += 3;
+        } else if (end - c < 3 && (end - c == 1 || fc_form_hex_value(c[1]) >= 0)) {
+            // Might be an escape, the rest is in the next chunk
+            form->escape_count = (int)(end - c);
+            memcpy(form->escape, c, form->escape_count);
+            c = end;
+        } else {
+            out[written++] = '%';
+            c += 1;
+        }
+    }
+
+    *cursor = c;
+
+    return written;
+}
+
+// Appends decoded bytes to the pair being carried over.
+static void fc_form_carry(fc_form* form, const char* data, int count)
+{
+    if (form->skipping) return;
+
+    if (!form->in_value) {
+        if (form->key_count + count > FC_FORM_KEY_MAX)
+        {
+            form->skipping = true;
+            return;
+        }
+
+        memcpy(form->key + form->key_count, data, count);
+        form->key_count += count;
+    } else {
+        memcpy(form->value + form->value_count, data, count);
+        form->value_count += count;
+    }
+}
+
+static void fc_form_drop_carry(fc_form* form)
+{
+    form->carry = false;
+    form->in_value = false;
+    form->skipping = false;
+    form->key_count = 0;
+    form->value_count = 0;
+}
+
+static void fc_form_pair_from_carry(fc_form* form, fc_form_pair* pair, bool partial)
+{
+    pair->key.data  = form->key;
+    pair->key.count = form->key_count;
+
+    pair->value.data  = form->in_value ? form->value : NULL;
+    pair->value.count = form->value_count;
+
+    pair->partial = partial;
+
+    form->value_count = 0;
+
+    if (!partial) fc_form_drop_carry(form);
+}
+
+// Finishes an escape cut by the end of the previous chunk. Returns false if the chunk is not enough.
+static bool fc_form_finish_escape(fc_form* form)
+{
+    char digits[2];
+    int digit_count = 0;
+
+    // escape holds '%' and at most one digit
+    if (form->escape_count == 2) digits[digit_count++] = form->escape[1];
+
+    char* c = form->chunk;
+    while (digit_count < 2 && c != form->chunk_end && fc_form_hex_value(*c) >= 0) digits[digit_count++] = *c++;
+
+    if (digit_count < 2 && c == form->chunk_end && !form->finished)
+    {
+        // Still cut, the chunk was empty or a single hex digit
+        if (digit_count) form->escape[1] = digits[0];
+        form->escape_count = 1 + digit_count;
+        form->chunk = c;
+        return false;
+    }
+
+    if (digit_count == 2) {
+        char byte = (char)(fc_form_hex_value(digits[0]) * 16 + fc_form_hex_value(digits[1]));
+        fc_form_carry(form, &byte, 1);
+    } else {
+        fc_form_carry(form, "%", 1);
+        fc_form_carry(form, digits, digit_count);
+    }
+
+    form->escape_count = 0;
+    form->chunk = c;
+
+    return true;
+}
+
+bool fc_form_next(fc_form* form, fc_form_pair* pair)
+{
+    for (;;)
+    {
+        char* end = form->chunk_end;
+
+        if (form->escape_count && !fc_form_finish_escape(form)) return false;
+
+        if (form->chunk == end)
+        {
+            if (!form->finished || !form->carry) return false;
+
+            // The last pair of the body
+            if (form->skipping) form->skipped++;
+
+            if (form->skipping || (form->key_count == 0 && !form->in_value))
+            {
+                fc_form_drop_carry(form);
+                return false;
+            }
+
+            fc_form_pair_from_carry(form, pair, false);
+            return true;
+        }
+
+        if (!form->carry)
+        {
+            // Decoded in place
+            char* c = form->chunk;
+            char* key = c;
+
+            int key_count = fc_form_decode(form, &c, end, key, (int)(end - c), true);
+
+            char* value = NULL;
+            int value_count = 0;
+
+            if (c != end && *c == '=')
+            {
+                c++;
+                value = key + key_count;
+                value_count = fc_form_decode(form, &c, end, value, (int)(end - c), false);
+            }
+
+            if (c != end)
+            {
+                // On the '&'
+                form->chunk = c + 1;
+
+                if (key_count == 0 && !value) continue;
+
+                if (key_count > FC_FORM_KEY_MAX)
+                {
+                    form->skipped++;
+                    continue;
+                }
+
+                pair->key.data    = key;
+                pair->key.count   = key_count;
+                pair->value.data  = value;
+                pair->value.count = value_count;
+                pair->partial = false;
+
+                return true;
+            }
+
+            // Cut by the end of the chunk, what was decoded moves into the decoder
+            form->chunk = end;
+            form->carry = true;
+
+            fc_form_carry(form, key, key_count);
+
+            if (value)
+            {
+                form->in_value = true;
+
+                if (value_count > FC_FORM_VALUE_MAX && !form->skipping)
+                {
+                    pair->key.data    = form->key;
+                    pair->key.count   = form->key_count;
+                    pair->value.data  = value;
+                    pair->value.count = value_count;
+                    pair->partial = true;
+
+                    return true;
+                }
+
+                fc_form_carry(form, value, value_count);
+            }
+
+            continue;
+        }
+
+        char* c = form->chunk;
+
+        if (form->skipping)
+        {
+            c = (char*)memchr(c, '&', end - c);
+            if (!c)
+            {
+                form->chunk = end;
+                continue;
+            }
+
+            form->chunk = c + 1;
+            form->skipped++;
+            fc_form_drop_carry(form);
+            continue;
+        }
+
+        if (!form->in_value)
+        {
+            form->key_count += fc_form_decode(form, &c, end, form->key + form->key_count, FC_FORM_KEY_MAX - form->key_count, true);
+
+            if (c != end && *c == '=') {
+                form->in_value = true;
+                c++;
+            } else if (c != end && *c != '&') {
+                // The key doesn't fit
+                form->skipping = true;
+                form->chunk = c;
+                continue;
+            }
+        }
+
+        if (form->in_value)
+        {
+            if (form->value_count >= FC_FORM_VALUE_MAX)
+            {
+                form->chunk = c;
+                fc_form_pair_from_carry(form, pair, true);
+                return true;
+            }
+
+            form->value_count += fc_form_decode(form, &c, end, form->value + form->value_count, FC_FORM_VALUE_MAX - form->value_count, false);
+        }
+
+        form->chunk = c;
+
+        if (c != end && *c == '&')
+        {
+            form->chunk = c + 1;
+
+            if (form->key_count == 0 && !form->in_value)
+            {
+                fc_form_drop_carry(form);
+                continue;
+            }
+
+            fc_form_pair_from_carry(form, pair, false);
+            return true;
+        }
+    }
+}
+
+#endif // FC_URI_FORM_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
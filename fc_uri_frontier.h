@@ -0,0 +1,595 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_FRONTIER_IMPLEMENTATION
+        #include "fc_uri_frontier.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_frontier.h"
+    "
+
+Example:
+    fc_frontier frontier;
+    fc_frontier_init(&frontier, 16, 1000, 10, now_ms()); // 16 shards, 1s between fetches per host, 10ms ticks
+
+    // Producers
+    fc_uri_view uri;
+    if (fc_uri_parse_view(url, url_length, &uri))
+    {
+        fc_frontier_enqueue(&frontier, &uri, url_index, now_ms());
+    }
+
+    // Fetchers, each one with its own shard hint
+    fc_frontier_item item;
+    while (fc_frontier_dequeue(&frontier, now_ms(), thread_index, &item))
+    {
+        fetch(urls[item.reference]);
+    }
+
+    fc_frontier_free(&frontier);
+
+Info:
+    Crawl frontier that hands out URIs in FIFO order per host, but never the same host twice within its delay.
+
+    Hosts are interned (lowercased) to 32 bit ids, the frontier only stores the 64 bit reference the caller
+    gives with each URI (an index, a file offset, ...) so queued URIs take 16 bytes each.
+    Hosts waiting for their delay to pass sit in a timing wheel with FC_FRONTIER_WHEEL_SLOTS slots of tick_ms,
+    hosts that can be fetched sit in a ready list, so enqueue and dequeue are O(1) (amortized, the wheel is
+    advanced lazily by dequeue). Delays are rounded up to the tick, hosts are never handed out early.
+
+    The delay is counted from the moment a URI is dequeued. Hosts are spread over shards by hash, each shard
+    has its own lock; dequeue starts from shard_hint and moves on to the next shard when one has nothing ready.
+
+    Times are in milliseconds from any clock the caller likes, as long as it doesn't go backwards.
+    Requires POSIX threads.
+*/
+
+#ifndef FC_URI_FRONTIER
+#define FC_URI_FRONTIER
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define FC_FRONTIER_NONE 0xFFFFFFFFu
+
+#ifndef FC_FRONTIER_WHEEL_SLOTS
+#define FC_FRONTIER_WHEEL_SLOTS 1024 // Power of two
+#endif
+
+typedef struct
+{
+    uint32_t host_id;
+    uint64_t reference;
+} fc_frontier_item;
+
+typedef struct
+{
+    uint64_t hash;
+    uint32_t name_offset;
+    uint32_t name_count;
+
+    uint32_t head; // Queue of nodes
+    uint32_t tail;
+    uint32_t link; // Next host in the same wheel slot or in the ready list
+    uint32_t state;
+
+    uint64_t next_fetch;
+    uint32_t delay;
+} fc_frontier_host;
+
+typedef struct
+{
+    uint64_t reference;
+    uint32_t next;
+} fc_frontier_node;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+
+    fc_frontier_host* hosts;
+    uint32_t host_count;
+    uint32_t host_capacity;
+
+    uint32_t* table; // Host index + 1, 0 for empty slots
+    uint32_t table_mask;
+
+    char* names;
+    uint32_t names_count;
+    uint32_t names_capacity;
+
+    fc_frontier_node* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+    uint32_t free_node;
+
+    uint32_t wheel[FC_FRONTIER_WHEEL_SLOTS];
+    uint64_t wheel_tick; // Every slot up to this tick has been processed
+
+    uint32_t ready_head;
+    uint32_t ready_tail;
+} fc_frontier_shard;
+
+typedef struct
+{
+    fc_frontier_shard* shards;
+    uint32_t shard_count;
+
+    uint32_t delay;
+    uint32_t tick;
+} fc_frontier;
+
+bool fc_frontier_init(fc_frontier* frontier, int shard_count, uint32_t delay_ms, uint32_t tick_ms, uint64_t now);
+void fc_frontier_free(fc_frontier* frontier);
+
+// Returns FC_FRONTIER_NONE if the host is empty, too long, or memory runs out.
+uint32_t fc_frontier_host_id(fc_frontier* frontier, const char* host, int count);
+
+// Overrides the frontier delay for one host (e.g. from a robots.txt Crawl-delay).
+void fc_frontier_set_delay(fc_frontier* frontier, uint32_t host_id, uint32_t delay_ms);
+
+// Copies the (lowercased) host name, returns its length or -1 if dst is too small.
+int fc_frontier_host_name(fc_frontier* frontier, uint32_t host_id, char* dst, int dst_size);
+
+bool fc_frontier_enqueue(fc_frontier* frontier, const fc_uri_view* uri, uint64_t reference, uint64_t now);
+bool fc_frontier_enqueue_host(fc_frontier* frontier, uint32_t host_id, uint64_t reference, uint64_t now);
+
+// Returns false when no host is ready at time now.
+bool fc_frontier_dequeue(fc_frontier* frontier, uint64_t now, int shard_hint, fc_frontier_item* item);
+
+#endif // FC_URI_FRONTIER
+
+#ifdef FC_URI_FRONTIER_IMPLEMENTATION
+
+#include <string.h> // memcmp, memcpy
+
+#ifndef FC_URI_FRONTIER_REALLOC
+#include <stdlib.h>
+#define FC_URI_FRONTIER_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_FRONTIER_FREE
+#include <stdlib.h>
+#define FC_URI_FRONTIER_FREE(ptr)          free(ptr)
+#endif
+
+enum
+{
+    FC_FRONTIER_IDLE,    // Empty queue
+    FC_FRONTIER_WAITING, // In the wheel
+    FC_FRONTIER_READY,   // In the ready list
+};
+
+static bool fc_frontier_grow(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity) return true;
+
+    uint32_t grown = *capacity ? *capacity : 16;
+    while (grown < needed) grown *= 2;
+
+    void* resized = FC_URI_FRONTIER_REALLOC(*array, (size_t)grown * element_size);
+    if (!resized) return false;
+
+    *array = resized;
+    *capacity = grown;
+
+    return true;
+}
+
+bool fc_frontier_init(fc_frontier* frontier, int shard_count, uint32_t delay_ms, uint32_t tick_ms, uint64_t now)
+{
+    if (shard_count < 1) shard_count = 1;
+    if (tick_ms < 1) tick_ms = 1;
+
+    frontier->shards = (fc_frontier_shard*)FC_URI_FRONTIER_REALLOC(NULL, shard_count * sizeof(fc_frontier_shard));
+    if (!frontier->shards) return false;
+
+    frontier->shard_count = shard_count;
+    frontier->delay = delay_ms;
+    frontier->tick = tick_ms;
+
+    for (int i = 0; i < shard_count; ++i)
+    {
+        fc_frontier_shard* shard = &frontier->shards[i];
+        memset(shard, 0, sizeof(*shard));
+
+        pthread_mutex_init(&shard->lock, NULL);
+
+        shard->free_node = FC_FRONTIER_NONE;
+        shard->ready_head = FC_FRONTIER_NONE;
+        shard->ready_tail = FC_FRONTIER_NONE;
+        shard->wheel_tick = now / tick_ms;
+
+        for (int slot = 0; slot < FC_FRONTIER_WHEEL_SLOTS; ++slot)
+        {
+            shard->wheel[slot] = FC_FRONTIER_NONE;
+        }
+    }
+
+    return true;
+}
+
+void fc_frontier_free(fc_frontier* frontier)
+{
+    if (!frontier->shards) return;
+
+    for (uint32_t i = 0; i < frontier->shard_count; ++i)
+    {
+        fc_frontier_shard* shard = &frontier->shards[i];
+
+        pthread_mutex_destroy(&shard->lock);
+
+        FC_URI_FRONTIER_FREE(shard->hosts);
+        FC_URI_FRONTIER_FREE(shard->table);
+        FC_URI_FRONTIER_FREE(shard->names);
+        FC_URI_FRONTIER_FREE(shard->nodes);
+    }
+
+    FC_URI_FRONTIER_FREE(frontier->shards);
+    frontier->shards = NULL;
+}
+
+static bool fc_frontier_rehash(fc_frontier_shard* shard)
+{
+    uint32_t slot_count = shard->table ? (shard->table_mask + 1) * 2 : 64;
+
+    uint32_t* table = (uint32_t*)FC_URI_FRONTIER_REALLOC(NULL, slot_count * sizeof(uint32_t));
+    if (!table) return false;
+
+    memset(table, 0, slot_count * sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < shard->host_count; ++i)
+    {
+        uint32_t slot = (uint32_t)shard->hosts[i].hash & (slot_count - 1);
+        while (table[slot]) slot = (slot + 1) & (slot_count - 1);
+
+        table[slot] = i + 1;
+    }
+
+    FC_URI_FRONTIER_FREE(shard->table);
+    shard->table = table;
+    shard->table_mask = slot_count - 1;
+
+    return true;
+}
+
+// Index of the host in the shard, added if missing. Expects the shard to be locked.
+static uint32_t fc_frontier_intern(fc_frontier* frontier, fc_frontier_shard* shard, const char* name, int count, uint64_t hash)
+{
+    if (shard->table)
+    {
+        uint32_t slot = (uint32_t)hash & shard->table_mask;
+
+        for (; shard->table[slot]; slot = (slot + 1) & shard->table_mask)
+        {
+            fc_frontier_host* host = &shard->hosts[shard->table[slot] - 1];
+
+            if (host->hash == hash && host->name_count == (uint32_t)count &&
+                memcmp(shard->names + host->name_offset, name, count) == 0)
+            {
+                return shard->table[slot] - 1;
+            }
+        }
+    }
+
+    // Keep the table at most half full
+    if (!shard->table || (shard->host_count + 1) * 2 > shard->table_mask + 1)
+    {
+        if (!fc_frontier_rehash(shard)) return FC_FRONTIER_NONE;
+    }
+
+    if (!fc_frontier_grow((void**)&shard->hosts, &shard->host_capacity, shard->host_count + 1, sizeof(fc_frontier_host)) ||
+        !fc_frontier_grow((void**)&shard->names, &shard->names_capacity, shard->names_count + count, 1))
+    {
+        return FC_FRONTIER_NONE;
+    }
+
+    uint32_t index = shard->host_count++;
+
+    fc_frontier_host* host = &shard->hosts[index];
+    host->hash = hash;
+    host->name_offset = shard->names_count;
+    host->name_count = count;
+    host->head = FC_FRONTIER_NONE;
+    host->tail = FC_FRONTIER_NONE;
+    host->link = FC_FRONTIER_NONE;
+    host->state = FC_FRONTIER_IDLE;
+    host->next_fetch = 0;
+    host->delay = frontier->delay;
+
+    memcpy(shard->names + shard->names_count, name, count);
+    shard->names_count += count;
+
+    uint32_t slot = (uint32_t)hash & shard->table_mask;
+    while (shard->table[slot]) slot = (slot + 1) & shard->table_mask;
+
+    shard->table[slot] = index + 1;
+
+    return index;
+}
+
+uint32_t fc_frontier_host_id(fc_frontier* frontier, const char* host, int count)
+{
+    if (count < 0) count = (int)strlen(host);
+    if (count == 0 || count > FC_URI_HOST_MAX) return FC_FRONTIER_NONE;
+
+    char name[FC_URI_HOST_MAX];
+    for (int i = 0; i < count; ++i)
+    {
+        char c = host[i];
+        name[i] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    }
+
+    uint64_t hash = fc_uri_hash(name, count, 0);
+
+    // The high bits pick the shard, the low ones the table slot
+    uint32_t shard_index = (uint32_t)(((hash >> 32) * frontier->shard_count) >> 32);
+    fc_frontier_shard* shard = &frontier->shards[shard_index];
+
+    pthread_mutex_lock(&shard->lock);
+    uint32_t index = fc_frontier_intern(frontier, shard, name, count, hash);
+    pthread_mutex_unlock(&shard->lock);
+
+    if (index == FC_FRONTIER_NONE) return FC_FRONTIER_NONE;
+
+    return index * frontier->shard_count + shard_index;
+}
+
+static fc_frontier_shard* fc_frontier_host_shard(fc_frontier* frontier, uint32_t host_id, uint32_t* index)
+{
+    *index = host_id / frontier->shard_count;
+    return &frontier->shards[host_id % frontier->shard_count];
+}
+
+void fc_frontier_set_delay(fc_frontier* frontier, uint32_t host_id, uint32_t delay_ms)
+{
+    uint32_t index;
+    fc_frontier_shard* shard = fc_frontier_host_shard(frontier, host_id, &index);
+
+    pthread_mutex_lock(&shard->lock);
+    if (index < shard->host_count) shard->hosts[index].delay = delay_ms;
+    pthread_mutex_unlock(&shard->lock);
+}
+
+int fc_frontier_host_name(fc_frontier* frontier, uint32_t host_id, char* dst, int dst_size)
+{
+    uint32_t index;
+    fc_frontier_shard* shard = fc_frontier_host_shard(frontier, host_id, &index);
+
+    int count = -1;
+
+    pthread_mutex_lock(&shard->lock);
+
+    if (index < shard->host_count && shard->hosts[index].name_count < (uint32_t)dst_size)
+    {
+        count = shard->hosts[index].name_count;
+
+        memcpy(dst, shard->names + shard->hosts[index].name_offset, count);
+        dst[count] = 0;
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return count;
+}
+
+static void fc_frontier_push_ready(fc_frontier_shard* shard, uint32_t index)
+{
+    shard->hosts[index].state = FC_FRONTIER_READY;
+    shard->hosts[index].link = FC_FRONTIER_NONE;
+
+    if (shard->ready_tail == FC_FRONTIER_NONE) {
+        shard->ready_head = index;
+    } else {
+        shard->hosts[shard->ready_tail].link = index;
+    }
+
+    shard->ready_tail = index;
+}
+
+// Puts a host with a non empty queue in the wheel, or straight in the ready list if its time has come.
+static void fc_frontier_schedule(fc_frontier* frontier, fc_frontier_shard* shard, uint32_t index)
+{
+    fc_frontier_host* host = &shard->hosts[index];
+
+    // Rounded up so that the host is never ready before next_fetch
+    uint64_t due = (host->next_fetch + frontier->tick - 1) / frontier->tick;
+
+    if (due <= shard->wheel_tick)
+    {
+        fc_frontier_push_ready(shard, index);
+        return;
+    }
+
+    uint32_t slot = (uint32_t)due & (FC_FRONTIER_WHEEL_SLOTS - 1);
+
+    host->state = FC_FRONTIER_WAITING;
+    host->link = shard->wheel[slot];
+    shard->wheel[slot] = index;
+}
+
+static void fc_frontier_advance(fc_frontier* frontier, fc_frontier_shard* shard, uint64_t now)
+{
+    uint64_t target = now / frontier->tick;
+
+    // After a full turn every slot has been looked at, later ticks would only repeat the same work
+    uint64_t steps = target > shard->wheel_tick ? target - shard->wheel_tick : 0;
+    if (steps > FC_FRONTIER_WHEEL_SLOTS) steps = FC_FRONTIER_WHEEL_SLOTS;
+
+    for (uint64_t step = 1; step <= steps; ++step)
+    {
+        uint32_t slot = (uint32_t)(shard->wheel_tick + step) & (FC_FRONTIER_WHEEL_SLOTS - 1);
+
+        uint32_t index = shard->wheel[slot];
+        shard->wheel[slot] = FC_FRONTIER_NONE;
+
+        while (index != FC_FRONTIER_NONE)
+        {
+            fc_frontier_host* host = &shard->hosts[index];
+            uint32_t next = host->link;
+
+            uint64_t due = (host->next_fetch + frontier->tick - 1) / frontier->tick;
+
+            if (due <= target) {
+                fc_frontier_push_ready(shard, index);
+            } else {
+                // Due in a later turn of the wheel
+                host->link = shard->wheel[slot];
+                shard->wheel[slot] = index;
+            }
+
+            index = next;
+        }
+    }
+
+    if (target > shard->wheel_tick) shard->wheel_tick = target;
+}
+
+bool fc_frontier_enqueue_host(fc_frontier* frontier, uint32_t host_id, uint64_t reference, uint64_t now)
+{
+    uint32_t index;
+    fc_frontier_shard* shard = fc_frontier_host_shard(frontier, host_id, &index);
+
+    pthread_mutex_lock(&shard->lock);
+
+    if (index >= shard->host_count)
+    {
+        pthread_mutex_unlock(&shard->lock);
+        return false;
+    }
+
+    uint32_t node = shard->free_node;
+
+    if (node != FC_FRONTIER_NONE) {
+        shard->free_node = shard->nodes[node].next;
+    } else {
+        if (!fc_frontier_grow((void**)&shard->nodes, &shard->node_capacity, shard->node_count + 1, sizeof(fc_frontier_node)))
+        {
+            pthread_mutex_unlock(&shard->lock);
+            return false;
+        }
+
+        node = shard->node_count++;
+    }
+
+    shard->nodes[node].reference = reference;
+    shard->nodes[node].next = FC_FRONTIER_NONE;
+
+    fc_frontier_host* host = &shard->hosts[index];
+
+    if (host->tail == FC_FRONTIER_NONE) {
+        host->head = node;
+    } else {
+        shard->nodes[host->tail].next = node;
+    }
+
+    host->tail = node;
+
+    if (host->state == FC_FRONTIER_IDLE)
+    {
+        fc_frontier_advance(frontier, shard, now);
+        fc_frontier_schedule(frontier, shard, index);
+    }
+
+    pthread_mutex_unlock(&shard->lock);
+
+    return true;
+}
+
+bool fc_frontier_enqueue(fc_frontier* frontier, const fc_uri_view* uri, uint64_t reference, uint64_t now)
+{
+    if (!uri->host.data) return false;
+
+    uint32_t host_id = fc_frontier_host_id(frontier, uri->host.data, uri->host.count);
+    if (host_id == FC_FRONTIER_NONE) return false;
+
+    return fc_frontier_enqueue_host(frontier, host_id, reference, now);
+}
+
+bool fc_frontier_dequeue(fc_frontier* frontier, uint64_t now, int shard_hint, fc_frontier_item* item)
+{
+    uint32_t first = (uint32_t)shard_hint % frontier->shard_count;
+
+    for (uint32_t i = 0; i < frontier->shard_count; ++i)
+    {
+        uint32_t shard_index = (first + i) % frontier->shard_count;
+        fc_frontier_shard* shard = &frontier->shards[shard_index];
+
+        pthread_mutex_lock(&shard->lock);
+
+        fc_frontier_advance(frontier, shard, now);
+
+        uint32_t index = shard->ready_head;
+
+        if (index == FC_FRONTIER_NONE)
+        {
+            pthread_mutex_unlock(&shard->lock);
+            continue;
+        }
+
+        fc_frontier_host* host = &shard->hosts[index];
+
+        shard->ready_head = host->link;
+        if (shard->ready_head == FC_FRONTIER_NONE) shard->ready_tail = FC_FRONTIER_NONE;
+
+        uint32_t node = host->head;
+
+        host->head = shard->nodes[node].next;
+        if (host->head == FC_FRONTIER_NONE) host->tail = FC_FRONTIER_NONE;
+
+        item->host_id = index * frontier->shard_count + shard_index;
+        item->reference = shard->nodes[node].reference;
+
+        shard->nodes[node].next = shard->free_node;
+        shard->free_node = node;
+
+        host->next_fetch = now + host->delay;
+
+        if (host->head == FC_FRONTIER_NONE) {
+            host->state = FC_FRONTIER_IDLE;
+        } else {
+            fc_frontier_schedule(frontier, shard, index);
+        }
+
+        pthread_mutex_unlock(&shard->lock);
+
+        return true;
+    }
+
+    return false;
+}
+
+#endif // FC_URI_FRONTIER_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,524 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_GRAPH_LAYOUT_IMPLEMENTATION
+        #include "fc_graph_layout.h"
+
+        #define FC_URI_LINK_GRAPH_IMPLEMENTATION
+        #include "fc_uri_link_graph.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_link_graph.h"
+    "
+
+Example:
+    fc_link_graph links;
+    fc_link_graph_init(&links, FC_LINK_GRAPH_DOMAINS, 10000, 100000);
+
+    fc_uri_view page, link;
+    while (next_link(&page_url, &page_url_length, &link_url, &link_url_length))
+    {
+        if (!fc_uri_parse_view(page_url, page_url_length, &page)) continue;
+        if (!fc_uri_parse_view(link_url, link_url_length, &link)) continue;
+
+        fc_link_graph_add(&links, &page, &link);
+    }
+
+    fc_graph graph = fc_link_graph_get(&links, true);
+    fc_layout_graph(graph, fc_layout_info_default);
+
+    for (int i = 0; i < graph.node_count; ++i)
+    {
+        // (const char*)graph.nodes[i].user_data is the host, graph.nodes[i].position where to draw it
+    }
+
+    fc_link_graph_free(&links);
+
+Info:
+    Turns (source, target) URI pairs into a graph of hosts for fc_graph_layout.h. Hosts are lowercased and
+    interned to dense node ids in the order they are first seen, links between the same two nodes are merged
+    into one edge that counts them. Links inside a node are counted in self_links and don't make edges.
+
+    FC_LINK_GRAPH_DOMAINS merges the hosts of the same domain: the last two labels, or three when the top
+    level domain has two letters and the second level is a generic one like "co" or "com" ("bbc.co.uk").
+    This is an approximation of the registrable domain, the Public Suffix List is not included.
+    IP addresses are always kept whole.
+
+    Memory is bounded by max_nodes and max_edges, not by the input: links that would need one more node or edge
+    than that are dropped and counted in dropped, so the first hosts seen win. Nothing else grows.
+
+    fc_link_graph_get returns views into the builder, valid until the next fc_link_graph_add. Nodes that don't
+    have a position yet are put on a spiral around the origin, edge weights are the link counts or, since the
+    layout pulls linearly with the weight, 1 + ln(count) with log_weights.
+*/
+
+#ifndef FC_URI_LINK_GRAPH
+#define FC_URI_LINK_GRAPH
+
+#include "fc_uri_parse.h"
+
+// The implementation part of fc_graph_layout.h is outside of its include guard
+#ifndef FC_GRAPH_LAYOUT
+#include "fc_graph_layout.h"
+#endif
+
+#include <stdint.h>
+
+typedef enum
+{
+    FC_LINK_GRAPH_HOSTS,
+    FC_LINK_GRAPH_DOMAINS,
+} fc_link_graph_mode;
+
+typedef struct
+{
+    fc_link_graph_mode mode;
+    int max_nodes;
+    int max_edges;
+
+    fc_node* nodes;
+    uint64_t* node_hashes;
+    uint32_t* name_offsets; // Into names, per node
+    int node_count;
+    int node_capacity;
+    int positioned_count;
+
+    char* names; // Null-terminated
+    uint32_t names_size;
+    uint32_t names_capacity;
+
+    fc_edge* edges;
+    uint32_t* edge_counts;
+    int edge_count;
+    int edge_capacity;
+
+    int* node_table; // Node index + 1 by hash, 0 for empty slots
+    int node_table_mask;
+
+    int* edge_table; // Edge index + 1
+    int edge_table_mask;
+
+    uint64_t links;
+    uint64_t self_links;
+    uint64_t dropped;
+    bool failed; // Out of memory
+} fc_link_graph;
+
+bool fc_link_graph_init(fc_link_graph* graph, fc_link_graph_mode mode, int max_nodes, int max_edges);
+void fc_link_graph_free(fc_link_graph* graph);
+
+// Returns false if the link was dropped or one of the URIs has no host.
+bool fc_link_graph_add(fc_link_graph* graph, const fc_uri_view* source, const fc_uri_view* target);
+
+// Node id of a host (or of its domain), -1 if it was never seen.
+int fc_link_graph_find(const fc_link_graph* graph, const char* host, int count);
+
+// user_i64 of the nodes is their id and user_data their name.
+fc_graph fc_link_graph_get(fc_link_graph* graph, bool log_weights);
+
+#endif // FC_URI_LINK_GRAPH
+
+#ifdef FC_URI_LINK_GRAPH_IMPLEMENTATION
+
+#include <string.h> // memcpy, memset
+#include <math.h>   // cosf, sinf, sqrtf, logf
+
+#ifndef FC_URI_LINK_GRAPH_REALLOC
+#include <stdlib.h>
+#define FC_URI_LINK_GRAPH_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_LINK_GRAPH_FREE
+#include <stdlib.h>
+#define FC_URI_LINK_GRAPH_FREE(ptr)          free(ptr)
+#endif
+
+bool fc_link_graph_init(fc_link_graph* graph, fc_link_graph_mode mode, int max_nodes, int max_edges)
+{
+    memset(graph, 0, sizeof(*graph));
+
+    graph->mode = mode;
+    graph->max_nodes = max_nodes;
+    graph->max_edges = max_edges;
+
+    return true;
+}
+
+void fc_link_graph_free(fc_link_graph* graph)
+{
+    FC_URI_LINK_GRAPH_FREE(graph->nodes);
+    FC_URI_LINK_GRAPH_FREE(graph->node_hashes);
+    FC_URI_LINK_GRAPH_FREE(graph->name_offsets);
+    FC_URI_LINK_GRAPH_FREE(graph->names);
+    FC_URI_LINK_GRAPH_FREE(graph->edges);
+    FC_URI_LINK_GRAPH_FREE(graph->edge_counts);
+    FC_URI_LINK_GRAPH_FREE(graph->node_table);
+    FC_URI_LINK_GRAPH_FREE(graph->edge_table);
+
+    memset(graph, 0, sizeof(*graph));
+}
+
+static bool fc_link_graph_resize(void** data, size_t capacity, size_t size)
+{
+    void* resized = FC_URI_LINK_GRAPH_REALLOC(*data, capacity * size);
+    if (!resized) return false;
+
+    *data = resized;
+
+    return true;
+}
+
+static bool fc_link_graph_is_generic_label(const char* label, int count)
+{
+    static const char* generic[] = { "co", "com", "net", "org", "gov", "edu", "ac", "or", "ne", "go", "gob", "nic" };
+
+    for (int i = 0; i < (int)(sizeof(generic) / sizeof(generic[0])); ++i)
+    {
+        if ((int)strlen(generic[i]) == count && memcmp(generic[i], label, count) == 0) return true;
+    }
+
+    return false;
+}
+
+// Start of the domain that a lowercase host belongs to.
+static int fc_link_graph_domain(const char* host, int count, bool ipv6)
+{
+    if (ipv6) return 0;
+
+    bool ipv4 = true;
+    for (int i = 0; i < count && ipv4; ++i) ipv4 = (host[i] >= '0' && host[i] <= '9') || host[i] == '.';
+    if (ipv4) return 0;
+
+    int dots[3];
+    int dot_count = 0;
+
+    for (int i = count - 1; i >= 0 && dot_count < 3; --i)
+    {
+        if (host[i] == '.') dots[dot_count++] = i;
+    }
+
+    if (dot_count < 2) return 0;
+
+    int labels = 2;
+
+    // "example.co.uk"
+    int top_count = count - dots[0] - 1;
+    if (top_count == 2 && fc_link_graph_is_generic_label(host + dots[1] + 1, dots[0] - dots[1] - 1)) labels = 3;
+
+    if (labels > dot_count) return 0;
+
+    return dots[labels - 1] + 1;
+}
+
+static uint64_t fc_link_graph_edge_hash(int first, int second)
+{
+    return fc_uri_hash((const char*)&first, sizeof(first), (uint64_t)second);
+}
+
+// Rebuilds a table with room for twice the entries, hashes are recomputed for edges.
+static bool fc_link_graph_rehash(fc_link_graph* graph, bool edges)
+{
+    int** table = edges ? &graph->edge_table : &graph->node_table;
+    int* mask = edges ? &graph->edge_table_mask : &graph->node_table_mask;
+    int count = edges ? graph->edge_count : graph->node_count;
+
+    int slot_count = 64;
+    while (slot_count < 2 * (count + 1)) slot_count *= 2;
+
+    if (*table && slot_count <= *mask + 1) return true;
+
+    int* resized = (int*)FC_URI_LINK_GRAPH_REALLOC(*table, (size_t)slot_count * sizeof(int));
+    if (!resized) return false;
+
+    memset(resized, 0, (size_t)slot_count * sizeof(int));
+    *table = resized;
+    *mask = slot_count - 1;
+
+    for (int i = 0; i < count; ++i)
+    {
+        uint64_t hash = edges ? fc_link_graph_edge_hash(graph->edges[i].first, graph->edges[i].second) : graph->node_hashes[i];
+
+        int slot = (int)(hash & *mask);
+        while ((*table)[slot]) slot = (slot + 1) & *mask;
+        (*table)[slot] = i + 1;
+    }
+
+    return true;
+}
+
+// Node of a lowercase name, added if there is room. -1 if dropped.
+static int fc_link_graph_node(fc_link_graph* graph, const char* name, int count)
+{
+    uint64_t hash = fc_uri_hash(name, count, 0);
+
+    if (graph->node_table)
+    {
+        for (int slot = (int)(hash & graph->node_table_mask); graph->node_table[slot]; slot = (slot + 1) & graph->node_table_mask)
+        {
+            int node = graph->node_table[slot] - 1;
+            const char* other = graph->names + graph->name_offsets[node];
+
+            if (graph->node_hashes[node] == hash && memcmp(other, name, count) == 0 && other[count] == '\0') return node;
+        }
+    }
+
+    if (graph->node_count >= graph->max_nodes) return -1;
+
+    if (graph->node_count == graph->node_capacity)
+    {
+        int capacity = graph->node_capacity ? graph->node_capacity * 2 : 64;
+
+        if (!fc_link_graph_resize((void**)&graph->nodes, capacity, sizeof(fc_node)) ||
+            !fc_link_graph_resize((void**)&graph->node_hashes, capacity, sizeof(uint64_t)) ||
+            !fc_link_graph_resize((void**)&graph->name_offsets, capacity, sizeof(uint32_t)))
+        {
+            graph->failed = true;
+            return -1;
+        }
+
+        graph->node_capacity = capacity;
+    }
+
+    if (graph->names_size + count + 1 > graph->names_capacity)
+    {
+        uint32_t capacity = graph->names_capacity ? graph->names_capacity * 2 : 4096;
+        while (capacity < graph->names_size + count + 1) capacity *= 2;
+
+        if (!fc_link_graph_resize((void**)&graph->names, capacity, 1))
+        {
+            graph->failed = true;
+            return -1;
+        }
+
+        graph->names_capacity = capacity;
+    }
+
+    int node = graph->node_count++;
+
+    graph->nodes[node] = fc_node{};
+    graph->nodes[node].user_i64 = node;
+    graph->node_hashes[node] = hash;
+    graph->name_offsets[node] = graph->names_size;
+
+    memcpy(graph->names + graph->names_size, name, count);
+    graph->names[graph->names_size + count] = '\0';
+    graph->names_size += count + 1;
+
+    int mask_before = graph->node_table ? graph->node_table_mask : -1;
+
+    if (!fc_link_graph_rehash(graph, false))
+    {
+        graph->failed = true;
+        graph->node_count--;
+        return -1;
+    }
+
+    if (graph->node_table_mask != mask_before) return node; // The rehash placed it already
+
+    int slot = (int)(hash & graph->node_table_mask);
+    while (graph->node_table[slot]) slot = (slot + 1) & graph->node_table_mask;
+    graph->node_table[slot] = node + 1;
+
+    return node;
+}
+
+// Lowercase name of the node of a URI into name, returns its length or -1.
+static int fc_link_graph_name(const fc_link_graph* graph, const fc_uri_view* uri, char* name)
+{
+    int count = uri->host.count;
+    if (!uri->host.data || count == 0 || count > FC_URI_HOST_MAX) return -1;
+
+    for (int i = 0; i < count; ++i)
+    {
+        char c = uri->host.data[i];
+        name[i] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+    }
+
+    if (name[count - 1] == '.') count--; // "example.com."
+
+    if (graph->mode == FC_LINK_GRAPH_DOMAINS)
+    {
+        int start = fc_link_graph_domain(name, count, uri->ipv6_host);
+
+        memmove(name, name + start, count - start);
+        count -= start;
+    }
+
+    return count;
+}
+
+bool fc_link_graph_add(fc_link_graph* graph, const fc_uri_view* source, const fc_uri_view* target)
+{
+    char source_name[FC_URI_HOST_MAX + 1];
+    char target_name[FC_URI_HOST_MAX + 1];
+
+    int source_count = fc_link_graph_name(graph, source, source_name);
+    int target_count = fc_link_graph_name(graph, target, target_name);
+
+    if (source_count <= 0 || target_count <= 0) return false;
+
+    graph->links++;
+
+    int first = fc_link_graph_node(graph, source_name, source_count);
+    int second = first >= 0 ? fc_link_graph_node(graph, target_name, target_count) : -1;
+
+    if (second < 0)
+    {
+        graph->dropped++;
+        return false;
+    }
+
+    if (first == second)
+    {
+        graph->self_links++;
+        return true;
+    }
+
+    uint64_t hash = fc_link_graph_edge_hash(first, second);
+
+    int slot = -1;
+    if (graph->edge_table)
+    {
+        for (slot = (int)(hash & graph->edge_table_mask); graph->edge_table[slot]; slot = (slot + 1) & graph->edge_table_mask)
+        {
+            int edge = graph->edge_table[slot] - 1;
+
+            if (graph->edges[edge].first == first && graph->edges[edge].second == second)
+            {
+                graph->edge_counts[edge]++;
+                return true;
+            }
+        }
+    }
+
+    if (graph->edge_count >= graph->max_edges)
+    {
+        graph->dropped++;
+        return false;
+    }
+
+    if (graph->edge_count == graph->edge_capacity)
+    {
+        int capacity = graph->edge_capacity ? graph->edge_capacity * 2 : 64;
+
+        if (!fc_link_graph_resize((void**)&graph->edges, capacity, sizeof(fc_edge)) ||
+            !fc_link_graph_resize((void**)&graph->edge_counts, capacity, sizeof(uint32_t)))
+        {
+            graph->failed = true;
+            graph->dropped++;
+            return false;
+        }
+
+        graph->edge_capacity = capacity;
+    }
+
+    int edge = graph->edge_count++;
+
+    graph->edges[edge] = fc_edge_default;
+    graph->edges[edge].first = first;
+    graph->edges[edge].second = second;
+    graph->edge_counts[edge] = 1;
+
+    int mask_before = graph->edge_table ? graph->edge_table_mask : -1;
+
+    if (!fc_link_graph_rehash(graph, true))
+    {
+        graph->failed = true;
+        graph->edge_count--;
+        graph->dropped++;
+        return false;
+    }
+
+    if (graph->edge_table_mask != mask_before) return true; // The rehash placed it already
+
+    graph->edge_table[slot] = edge + 1;
+
+    return true;
+}
+
+int fc_link_graph_find(const fc_link_graph* graph, const char* host, int count)
+{
+    char name[FC_URI_HOST_MAX + 1];
+
+    fc_uri_view uri = {};
+    uri.host.data = host;
+    uri.host.count = count;
+    uri.ipv6_host = count > 0 && memchr(host, ':', count) != NULL;
+
+    count = fc_link_graph_name(graph, &uri, name);
+    if (count <= 0 || !graph->node_table) return -1;
+
+    uint64_t hash = fc_uri_hash(name, count, 0);
+
+    for (int slot = (int)(hash & graph->node_table_mask); graph->node_table[slot]; slot = (slot + 1) & graph->node_table_mask)
+    {
+        int node = graph->node_table[slot] - 1;
+        const char* other = graph->names + graph->name_offsets[node];
+
+        if (graph->node_hashes[node] == hash && memcmp(other, name, count) == 0 && other[count] == '\0') return node;
+    }
+
+    return -1;
+}
+
+fc_graph fc_link_graph_get(fc_link_graph* graph, bool log_weights)
+{
+    // Golden angle spiral, evenly spread and never two nodes on the same spot
+    for (int i = graph->positioned_count; i < graph->node_count; ++i)
+    {
+        float radius = 16.f * sqrtf((float)i + 0.5f);
+        float angle = 2.39996323f * (float)i;
+
+        graph->nodes[i].position = fc_v2f{ radius * cosf(angle), radius * sinf(angle) };
+    }
+    graph->positioned_count = graph->node_count;
+
+    for (int i = 0; i < graph->node_count; ++i) graph->nodes[i].user_data = graph->names + graph->name_offsets[i];
+
+    for (int i = 0; i < graph->edge_count; ++i)
+    {
+        float count = (float)graph->edge_counts[i];
+        graph->edges[i].weight = log_weights ? 1.f + logf(count) : count;
+    }
+
+    fc_graph result;
+    result.nodes = graph->nodes;
+    result.node_count = graph->node_count;
+    result.edges = graph->edges;
+    result.edge_count = graph->edge_count;
+
+    return result;
+}
+
+#endif // FC_URI_LINK_GRAPH_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
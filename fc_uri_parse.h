@@ -20,20 +20,113 @@ Example:
 
     // use repository_uri
 
+    // Only the host, the rest is neither copied nor scanned past the authority
+    fc_uri_view host_only;
+    fc_uri_parse_view_partial("https://github.com/filippocrocchini/fc_utils", -1, 1u << FC_URI_HOST, &host_only);
+
+    // IRIs (RFC3987) may contain raw UTF-8, fc_iri_parse validates it while scanning.
+    fc_uri iri;
+    if (!fc_iri_parse("https://example.com/b\xc3\xbccher?q=\xc3\xa9", &iri))
+    {
+        // Not valid UTF-8, or not an absolute IRI
+    }
+
+    // Percent-encode the non-ASCII bytes to get a plain URI (https://example.com/b%C3%BCcher?q=%C3%A9)
+    char uri_buf[FC_URI_MAX + 1];
+    int uri_len = fc_iri_to_uri("https://example.com/b\xc3\xbccher?q=\xc3\xa9", uri_buf, sizeof(uri_buf));
+
+    // Hosts go through IDNA, ASCII hosts are returned as they are without copying.
+    char host_buf[FC_URI_HOST_MAX + 1];
+    const char* ascii_host;
+    int ascii_host_len = fc_uri_host_to_ascii(iri.host, strlen(iri.host), host_buf, sizeof(host_buf), &ascii_host);
+    // ascii_host is "xn--bcher-kva.example" for "b\xc3\xbccher.example"
+
 Info:
     Parser for URIs according to RFC3986 (https://www.rfc-editor.org/rfc/rfc3986)
-    It does NOT implement relative URIs
+    Relative references are parsed by fc_uri_parse_reference_view and resolved with fc_uri_resolve (section 5).
+    fc_uri_parse and fc_uri_parse_view only accept absolute URIs.
+
+    IRIs are handled according to RFC3987 (https://www.rfc-editor.org/rfc/rfc3987).
+    UTF-8 validation uses the lookup algorithm from "Validating UTF-8 In Less Than One Instruction Per Byte",
+    John Keiser and Daniel Lemire, 2021. It is vectorized when SSSE3 is available, define FC_URI_NO_SIMD to
+    force the scalar fallback.
+
+    Internationalized hosts are converted label by label with Punycode (RFC3492, https://www.rfc-editor.org/rfc/rfc3492).
+    Only the IDNA encoding step is implemented, labels are NOT mapped or normalized (no UTS46/NFC tables).
+
+    Define FC_URI_STATS (in every file) to count what fc_uri_parse, fc_uri_parse_view and fc_iri_parse see: inputs by outcome
+    and a log2 histogram of the length of each component. Every thread has its own counters, a parse only does
+    plain increments on them. fc_uri_stats_snapshot sums the counters of all the threads, the ones that exited too.
+    Without FC_URI_STATS nothing is compiled in. With it the header needs C++11 (thread_local) and the GCC/Clang
+    __atomic builtins, MSVC is not supported.
+
+    fc_uri_parse leaves every component NULL for inputs longer than FC_URI_MAX, they don't fit in fc_uri.
 */
 
 #ifndef FC_URI_PARSE
 #define FC_URI_PARSE
 
 #define FC_URI_MAX 2083
+#define FC_URI_HOST_MAX 253
 
 #ifndef __cplusplus
 #include <stdbool.h>
 #endif
 
+#include <string.h> // strlen, memcpy
+#include <stdint.h>
+
+// SSE2 paths of the fc_uri headers, define FC_URI_NO_SIMD to turn them off.
+#if !defined(FC_URI_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#define FC_URI_SSE2
+#endif
+
+// Bit scans for the SIMD paths, mask must not be 0.
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+
+static inline int fc_uri_ctz(uint32_t mask)
+{
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+}
+
+static inline int fc_uri_ctz64(uint64_t mask)
+{
+#if defined(_M_X64) || defined(_M_ARM64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int)index;
+#else
+    return (uint32_t)mask ? fc_uri_ctz((uint32_t)mask) : 32 + fc_uri_ctz((uint32_t)(mask >> 32));
+#endif
+}
+
+static inline int fc_uri_clz(uint32_t mask)
+{
+    unsigned long index;
+    _BitScanReverse(&index, mask);
+    return 31 - (int)index;
+}
+
+static inline int fc_uri_clz64(uint64_t mask)
+{
+#if defined(_M_X64) || defined(_M_ARM64)
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return 63 - (int)index;
+#else
+    return (mask >> 32) ? fc_uri_clz((uint32_t)(mask >> 32)) : 32 + fc_uri_clz((uint32_t)mask);
+#endif
+}
+#else
+static inline int fc_uri_ctz(uint32_t mask)   { return __builtin_ctz(mask); }
+static inline int fc_uri_ctz64(uint64_t mask) { return __builtin_ctzll(mask); }
+static inline int fc_uri_clz(uint32_t mask)   { return __builtin_clz(mask); }
+static inline int fc_uri_clz64(uint64_t mask) { return __builtin_clzll(mask); }
+#endif
+
 typedef struct
 {
     char* scheme;
@@ -53,22 +146,156 @@ typedef struct
     char buf[FC_URI_MAX + 8]; // Eight '\0' to null-terminate all possible fields. Some characters are ignored so, these are probably too many.
 } fc_uri;
 
+// Non null-terminated view into the parsed string. data is NULL when the component is not present,
+// so "http://host?" has an empty query while "http://host" has none.
+typedef struct
+{
+    const char* data;
+    int  count;
+} fc_uri_str;
+
+typedef struct
+{
+    fc_uri_str scheme;
+
+    // Authority
+    fc_uri_str user;
+    fc_uri_str access_info;
+    fc_uri_str host;
+    fc_uri_str port;
+
+    fc_uri_str path;
+    fc_uri_str query;
+    fc_uri_str fragment;
+
+    bool ipv6_host;
+} fc_uri_view;
+
+typedef enum
+{
+    FC_URI_SCHEME,
+    FC_URI_USER,
+    FC_URI_ACCESS_INFO,
+    FC_URI_HOST,
+    FC_URI_PORT,
+    FC_URI_PATH,
+    FC_URI_QUERY,
+    FC_URI_FRAGMENT,
+
+    FC_URI_COMPONENT_COUNT,
+} fc_uri_component;
+
+// Masks of (1u << fc_uri_component) bits, for the partial parsers.
+#define FC_URI_ALL_COMPONENTS ((1u << FC_URI_COMPONENT_COUNT) - 1)
+
+fc_uri_str fc_uri_view_component(const fc_uri_view* view, fc_uri_component component);
+
+// Fast non-cryptographic hash, 8 bytes per step. Meant for tables keyed by URIs or their components.
+// data can be NULL if count is 0, like the components that are not present in a view.
+uint64_t fc_uri_hash(const char* data, int count, uint64_t seed);
+
 void fc_uri_parse(const char* src, fc_uri* uri);
 
-#ifdef FC_URI_PARSE_IMPLEMENTATION
+// Zero-copy version of fc_uri_parse, the components point into src. count can be -1 for null-terminated strings.
+// Returns false if src is not an absolute URI.
+bool fc_uri_parse_view(const char* src, int count, fc_uri_view* view);
 
-typedef struct 
+// Same as fc_uri_parse and fc_uri_parse_view, but only the components in the mask are extracted (and copied), the
+// others are left empty. Scanning stops after the last one that is needed, so "http://host/path?query" only gets
+// scanned up to the end of the authority for (1u << FC_URI_HOST). Errors in the part that is skipped are not reported.
+bool fc_uri_parse_partial(const char* src, unsigned components, fc_uri* uri);
+bool fc_uri_parse_view_partial(const char* src, int count, unsigned components, fc_uri_view* view);
+
+// Parses "host[:port][/path][?query][#fragment]" with no scheme, like "www." links.
+bool fc_uri_parse_authority_view(const char* src, int count, fc_uri_view* view);
+
+// Parses a URI reference, either an absolute URI or a relative one ("//host/path", "/path", "path", "?query", "#fragment").
+bool fc_uri_parse_reference_view(const char* src, int count, fc_uri_view* view);
+
+// Forms of the request-target of an HTTP request (RFC9112 section 3.2).
+typedef enum
 {
-    char* data;
-    int  count;
-} fc_urip_str;
+    FC_URI_TARGET_INVALID,
+    FC_URI_TARGET_ORIGIN,    // "/path?query"
+    FC_URI_TARGET_ABSOLUTE,  // "http://host/path?query", sent to proxies
+    FC_URI_TARGET_AUTHORITY, // "host:port", CONNECT only
+    FC_URI_TARGET_ASTERISK,  // "*", server-wide OPTIONS
+} fc_uri_target_form;
+
+// Detects the form from the first bytes and parses the components that form has.
+fc_uri_target_form fc_uri_parse_request_target(const char* src, int count, fc_uri_view* uri);
+
+// Origin-form of an absolute-form target, for forwarding it to the origin server. Nothing is copied: parts
+// point into the target, except for the "/" that replaces an empty path. Returns the number of parts (1 or 2).
+int fc_uri_origin_form(const fc_uri_view* uri, fc_uri_str parts[2]);
+
+// Resolves ref against the absolute URI base (RFC3986 section 5.2) and writes the target URI into dst.
+// Returns its length (without the '\0'), or -1 if dst is too small.
+int fc_uri_resolve(const fc_uri_view* base, const fc_uri_view* ref, char* dst, int dst_size);
+
+// Writes the normalized form of uri into dst (RFC3986 section 6.2.2 and 6.2.3): lowercase scheme and host,
+// uppercase percent-encodings, decoded unreserved characters, no dot segments, no default port and "/" for an
+// empty path with an authority. Returns its length (without the '\0'), or -1 if dst is too small.
+int fc_uri_normalize(const fc_uri_view* uri, char* dst, int dst_size);
+
+// Same as fc_uri_parse but accepts raw UTF-8 (RFC3987). Returns false if src is not valid UTF-8,
+// is longer than FC_URI_MAX or is not an absolute IRI.
+bool fc_iri_parse(const char* src, fc_uri* uri);
+
+// Writes the URI mapping of an IRI into dst, percent-encoding every non-ASCII byte outside the host
+// and converting the host with fc_uri_host_to_ascii.
+// Returns the length of the result (without the '\0'), or -1 if iri is not valid UTF-8 or dst is too small.
+int fc_iri_to_uri(const char* iri, char* dst, int dst_size);
+
+// Punycode of a single label, without the "xn--" prefix. src is UTF-8 for encode, ASCII for decode.
+// Both return the length written to dst (without the '\0'), or -1 on invalid input or if dst is too small.
+int fc_punycode_encode(const char* src, int count, char* dst, int dst_size);
+int fc_punycode_decode(const char* src, int count, char* dst, int dst_size);
+
+// IDNA conversion of a host, label by label. *result points to host itself when nothing has to change,
+// otherwise to buf. Returns the length of *result, or -1 on invalid input or if buf is too small.
+int fc_uri_host_to_ascii(const char* host, int count, char* buf, int buf_size, const char** result);
+int fc_uri_host_to_unicode(const char* host, int count, char* buf, int buf_size, const char** result);
+
+#ifdef FC_URI_STATS
+
+typedef enum
+{
+    FC_URI_OUTCOME_OK,
+    FC_URI_OUTCOME_NO_SCHEME,
+    FC_URI_OUTCOME_BAD_IPV6,  // '[' with no ']'
+    FC_URI_OUTCOME_TOO_LONG,  // Longer than FC_URI_MAX: rejected by fc_uri_parse and fc_iri_parse, fine for views
+
+    FC_URI_OUTCOME_COUNT,
+} fc_uri_outcome;
+
+// Bucket 0 counts empty components, bucket i lengths in [2^(i-1), 2^i). The last one takes everything longer.
+#define FC_URI_STATS_BUCKETS 16
+
+typedef struct
+{
+    uint64_t outcomes[FC_URI_OUTCOME_COUNT];
+
+    // Only for the components that are present in parsed inputs
+    uint64_t lengths[FC_URI_COMPONENT_COUNT][FC_URI_STATS_BUCKETS];
+} fc_uri_stats;
+
+// Counters can be a little behind for threads that are parsing while this runs.
+void fc_uri_stats_snapshot(fc_uri_stats* snapshot);
+
+#endif // FC_URI_STATS
+
+#ifdef FC_URI_PARSE_IMPLEMENTATION
 
 typedef struct
 {
-    char* in_buffer;
-    char* in_buffer_end;
+    const char* in_buffer;
+    const char* in_buffer_end;
+
+    const char* cursor;
 
-    char* cursor;
+    bool validate_utf8; // Requires in_buffer_end, see fc_urip_read_until_utf8
+    bool invalid_utf8;
 } fc_urip_lexer_state;
 
 static bool fc_urip_accept_char(fc_urip_lexer_state* state, char c)
@@ -83,8 +310,12 @@ static bool fc_urip_accept_char(fc_urip_lexer_state* state, char c)
 
 static bool fc_urip_accept_str(fc_urip_lexer_state* state, const char* str)
 {
-    char* c = state->cursor;
-    while (c != state->in_buffer_end && *str && *c++ == *str++);
+    const char* c = state->cursor;
+    while (c != state->in_buffer_end && *str && *c == *str)
+    {
+        c++;
+        str++;
+    }
     
     if (*str == '\0')
     {
@@ -95,12 +326,265 @@ static bool fc_urip_accept_str(fc_urip_lexer_state* state, const char* str)
     return false;
 }
 
-static fc_urip_str fc_urip_read_until(fc_urip_lexer_state* state, const char* stop_at)
+#ifdef FC_URI_SSE2
+#define FC_URIP_SSE2 // Delimiter scan
+#include <emmintrin.h>
+#endif
+
+// UTF-8 validation, see "Validating UTF-8 In Less Than One Instruction Per Byte", Keiser and Lemire.
+
+#if !defined(FC_URI_NO_SIMD) && (defined(__SSSE3__) || defined(__AVX__))
+#define FC_URIP_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#ifdef FC_URIP_SSSE3
+
+typedef struct
+{
+    __m128i prev;
+    __m128i error;
+} fc_urip_utf8_state;
+
+// Bytes 0..15 are kept, 16..31 are cleared. Loading at (16 - n) keeps the first n bytes of a block.
+static const unsigned char fc_urip_keep_mask[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static void fc_urip_utf8_begin(fc_urip_utf8_state* state)
+{
+    state->prev  = _mm_setzero_si128();
+    state->error = _mm_setzero_si128();
+}
+
+static __m128i fc_urip_high_nibbles(__m128i v)
+{
+    return _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+}
+
+// Checks a block of 16 bytes following the previous one. Trailing zeroes act as ASCII, so a
+// block padded with zeroes also reports sequences that were cut short.
+static void fc_urip_utf8_block(fc_urip_utf8_state* state, __m128i input)
+{
+    const char TOO_SHORT      = 1 << 0;
+    const char TOO_LONG       = 1 << 1;
+    const char OVERLONG_3     = 1 << 2;
+    const char TOO_LARGE      = 1 << 3;
+    const char SURROGATE      = 1 << 4;
+    const char OVERLONG_2     = 1 << 5;
+    const char TOO_LARGE_1000 = 1 << 6;
+    const char OVERLONG_4     = 1 << 6;
+    const char TWO_CONTS      = (char)(1 << 7);
+    const char CARRY          = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+    const __m128i byte_1_high_table = _mm_setr_epi8(
+        TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+        TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+        TOO_SHORT | OVERLONG_2,
+        TOO_SHORT,
+        TOO_SHORT | OVERLONG_3 | SURROGATE,
+        TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+
+    const __m128i byte_1_low_table = _mm_setr_epi8(
+        CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+        CARRY | OVERLONG_2,
+        CARRY,
+        CARRY,
+        CARRY | TOO_LARGE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+        CARRY | TOO_LARGE | TOO_LARGE_1000,
+        CARRY | TOO_LARGE | TOO_LARGE_1000);
+
+    const __m128i byte_2_high_table = _mm_setr_epi8(
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE,
+        TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE  | TOO_LARGE,
+        TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+    __m128i prev1 = _mm_alignr_epi8(input, state->prev, 15);
+
+    __m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, fc_urip_high_nibbles(prev1));
+    __m128i byte_1_low  = _mm_shuffle_epi8(byte_1_low_table,  _mm_and_si128(prev1, _mm_set1_epi8(0x0F)));
+    __m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, fc_urip_high_nibbles(input));
+
+    __m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+    // Third and fourth bytes of a sequence must be continuations, the tables only see pairs.
+    __m128i prev2 = _mm_alignr_epi8(input, state->prev, 14);
+    __m128i prev3 = _mm_alignr_epi8(input, state->prev, 13);
+    __m128i is_third_byte  = _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xE0 - 0x80)));
+    __m128i is_fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xF0 - 0x80)));
+    __m128i must_be_continuation = _mm_and_si128(_mm_or_si128(is_third_byte, is_fourth_byte), _mm_set1_epi8((char)0x80));
+
+    state->error = _mm_or_si128(state->error, _mm_xor_si128(must_be_continuation, special_cases));
+    state->prev  = input;
+}
+
+static bool fc_urip_utf8_end(fc_urip_utf8_state* state)
+{
+    fc_urip_utf8_block(state, _mm_setzero_si128());
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(state->error, _mm_setzero_si128())) == 0xFFFF;
+}
+
+#else
+
+typedef struct
+{
+    int need; // Continuation bytes still expected
+    unsigned char lo;
+    unsigned char hi;
+    bool error;
+} fc_urip_utf8_state;
+
+static void fc_urip_utf8_begin(fc_urip_utf8_state* state)
+{
+    state->need  = 0;
+    state->lo    = 0x80;
+    state->hi    = 0xBF;
+    state->error = false;
+}
+
+static void fc_urip_utf8_byte(fc_urip_utf8_state* state, unsigned char c)
+{
+    if (state->need)
+    {
+        if (c < state->lo || c > state->hi) state->error = true;
+
+        state->need -= 1;
+        state->lo = 0x80;
+        state->hi = 0xBF;
+        return;
+    }
+
+    if (c < 0x80) return;
+
+    if      (c >= 0xC2 && c <= 0xDF) { state->need = 1; }
+    else if (c == 0xE0)              { state->need = 2; state->lo = 0xA0; }
+    else if (c == 0xED)              { state->need = 2; state->hi = 0x9F; }
+    else if (c >= 0xE1 && c <= 0xEF) { state->need = 2; }
+    else if (c == 0xF0)              { state->need = 3; state->lo = 0x90; }
+    else if (c >= 0xF1 && c <= 0xF3) { state->need = 3; }
+    else if (c == 0xF4)              { state->need = 3; state->hi = 0x8F; }
+    else state->error = true;
+}
+
+static bool fc_urip_utf8_end(fc_urip_utf8_state* state)
+{
+    return !state->error && state->need == 0;
+}
+
+#endif // FC_URIP_SSSE3
+
+// Delimiter scan that validates the UTF-8 of the returned span in the same pass.
+static fc_uri_str fc_urip_read_until_utf8(fc_urip_lexer_state* state, const char* stop_at)
+{
+    fc_uri_str result = {};
+    result.data = state->cursor;
+
+    fc_urip_utf8_state utf8;
+    fc_urip_utf8_begin(&utf8);
+
+#ifdef FC_URIP_SSSE3
+    for (;;)
+    {
+        int remaining = (int)(state->in_buffer_end - state->cursor);
+        int n = remaining < 16 ? remaining : 16;
+
+        __m128i block;
+        if (n == 16)
+        {
+            block = _mm_loadu_si128((const __m128i*)state->cursor);
+        }
+        else {
+            char tail[16] = {};
+            memcpy(tail, state->cursor, n);
+            block = _mm_loadu_si128((const __m128i*)tail);
+        }
+
+        __m128i stops = _mm_cmpeq_epi8(block, _mm_setzero_si128());
+        for (const char* s = stop_at; *s; ++s)
+        {
+            stops = _mm_or_si128(stops, _mm_cmpeq_epi8(block, _mm_set1_epi8(*s)));
+        }
+
+        int stop_mask = _mm_movemask_epi8(stops) & ((1 << n) - 1);
+        if (stop_mask)
+        {
+            n = fc_uri_ctz(stop_mask);
+        }
+
+        if (n < 16)
+        {
+            block = _mm_and_si128(block, _mm_loadu_si128((const __m128i*)(fc_urip_keep_mask + 16 - n)));
+        }
+
+        fc_urip_utf8_block(&utf8, block);
+        state->cursor += n;
+
+        if (n < 16) break;
+    }
+#else
+    while (state->cursor != state->in_buffer_end && *state->cursor && !strchr(stop_at, *state->cursor))
+    {
+        fc_urip_utf8_byte(&utf8, (unsigned char)*state->cursor++);
+    }
+#endif
+
+    if (!fc_urip_utf8_end(&utf8))
+    {
+        state->invalid_utf8 = true;
+    }
+
+    result.count = state->cursor - result.data;
+
+    return result;
+}
+
+static fc_uri_str fc_urip_read_until(fc_urip_lexer_state* state, const char* stop_at)
 {
-    fc_urip_str result = {0};
+    if (state->validate_utf8)
+    {
+        return fc_urip_read_until_utf8(state, stop_at);
+    }
+
+    fc_uri_str result = {0};
 
     result.data  = state->cursor;
 
+#ifdef FC_URIP_SSE2
+    // 16 bytes at a time while they are known to be readable, the scalar loop finishes the tail.
+    while (state->in_buffer_end && state->in_buffer_end - state->cursor >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)state->cursor);
+
+        __m128i stops = _mm_cmpeq_epi8(block, _mm_setzero_si128());
+        for (const char* s = stop_at; *s; ++s)
+        {
+            stops = _mm_or_si128(stops, _mm_cmpeq_epi8(block, _mm_set1_epi8(*s)));
+        }
+
+        int stop_mask = _mm_movemask_epi8(stops);
+        if (stop_mask)
+        {
+            state->cursor += fc_uri_ctz(stop_mask);
+            result.count = state->cursor - result.data;
+            return result;
+        }
+
+        state->cursor += 16;
+    }
+#endif
+
     bool not_found = true;
     while (state->cursor != state->in_buffer_end && *state->cursor && not_found)
     {
@@ -141,128 +625,1359 @@ static char* fc_urip_copy_string(const char* str, int count, char* target_buffer
 
 static void fc_urip_init_parser_state(fc_urip_lexer_state* state, const char* input, int input_size = -1)
 {
-    state->in_buffer = (char*)input;
-    state->in_buffer_end = input_size > 0 ? (char*)input + input_size : NULL;
+    state->in_buffer = input;
+    state->in_buffer_end = input_size >= 0 ? input + input_size : NULL;
     state->cursor = state->in_buffer;
 }
 
-void fc_uri_parse(const char* src, fc_uri* uri)
-{
-    fc_urip_lexer_state parser = {};
-
-    fc_urip_init_parser_state(&parser, src);
-
-    uri->ipv6_host = false;
+#define FC_URIP_USERINFO_COMPONENTS ((1u << FC_URI_USER) | (1u << FC_URI_ACCESS_INFO))
+#define FC_URIP_HOSTPORT_COMPONENTS ((1u << FC_URI_HOST) | (1u << FC_URI_PORT))
+#define FC_URIP_AFTER_AUTHORITY_COMPONENTS ((1u << FC_URI_PATH) | (1u << FC_URI_QUERY) | (1u << FC_URI_FRAGMENT))
 
-    fc_urip_str scheme = fc_urip_read_until(&parser, ":");
+// Cursor right after "//", reads up to the end of the authority.
+static bool fc_urip_parse_authority(fc_urip_lexer_state* parser, fc_uri_view* view, unsigned components = FC_URI_ALL_COMPONENTS)
+{
+    fc_uri_str authority = fc_urip_read_until(parser, "/?#");
 
-    fc_urip_str authority = {};
-    fc_urip_str user = {};
-    fc_urip_str access_info = {};
-    fc_urip_str host = {};
-    fc_urip_str port = {};
+    if (!(components & (FC_URIP_USERINFO_COMPONENTS | FC_URIP_HOSTPORT_COMPONENTS))) return true;
 
-    fc_urip_str path = {};
-    fc_urip_str query = {};
-    fc_urip_str fragment = {};
+    const char* authority_end = authority.data + authority.count;
 
-    if (!fc_urip_accept_char(&parser, ':'))
+    // user:pwd@ ends at the last '@', unescaped '@' in the userinfo are common enough.
+    const char* host_begin = authority.data;
+    for (const char* c = authority_end; c != authority.data; --c)
     {
-        // No scheme, likely a relative resource. Which we don't support. (yet?)
-        return;
+        if (c[-1] == '@')
+        {
+            host_begin = c;
+            break;
+        }
     }
 
-    if (fc_urip_accept_str(&parser, "//"))
+    if (host_begin != authority.data && (components & FC_URIP_USERINFO_COMPONENTS))
     {
-        authority = fc_urip_read_until(&parser, "/");
+        fc_urip_lexer_state userinfo_parser = {};
+        fc_urip_init_parser_state(&userinfo_parser, authority.data, (int)(host_begin - 1 - authority.data));
 
-        fc_urip_lexer_state authority_parser = {};
-        fc_urip_init_parser_state(&authority_parser, authority.data, authority.count);
+        fc_uri_str user = fc_urip_read_until(&userinfo_parser, ":");
+        if (components & (1u << FC_URI_USER)) view->user = user;
 
-        if (fc_urip_accept_char(&authority_parser, '['))
+        if ((components & (1u << FC_URI_ACCESS_INFO)) && fc_urip_accept_char(&userinfo_parser, ':'))
         {
-            uri->ipv6_host = true;
-            // [host]:port/
-            host = fc_urip_read_until(&authority_parser, "]");
-            if (!fc_urip_accept_char(&authority_parser, ']'))
-            {
-                // Missing closed bracket
-                return;
-            }
+            view->access_info = fc_urip_read_until(&userinfo_parser, "");
+        }
+    }
 
-            if (fc_urip_accept_char(&authority_parser, ':'))
-            {
-                port = fc_urip_read_until(&authority_parser, "/");
-            }
+    if (!(components & FC_URIP_HOSTPORT_COMPONENTS)) return true;
+
+    fc_urip_lexer_state host_parser = {};
+    fc_urip_init_parser_state(&host_parser, host_begin, (int)(authority_end - host_begin));
+
+    if (fc_urip_accept_char(&host_parser, '['))
+    {
+        view->ipv6_host = true;
+        // [host]:port
+        view->host = fc_urip_read_until(&host_parser, "]");
+        if (!fc_urip_accept_char(&host_parser, ']'))
+        {
+            // Missing closed bracket
+            return false;
         }
-        else {
-            // host:port/
-            // user:pwd@[host]:port/
+    }
+    else {
+        // host:port
+        view->host = fc_urip_read_until(&host_parser, ":");
+    }
 
-            fc_urip_str host_ot_user = fc_urip_read_until(&authority_parser, ":/");
-            
-            fc_urip_accept_char(&authority_parser, ':');
-            
-            fc_urip_str access_info_or_port = fc_urip_read_until(&authority_parser, "@/");
+    if (!(components & (1u << FC_URI_HOST)))
+    {
+        view->host = fc_uri_str{};
+        view->ipv6_host = false;
+    }
 
-            if (fc_urip_accept_char(&authority_parser, '@'))
-            {
-                user = host_ot_user;
-                access_info = access_info_or_port;
+    if ((components & (1u << FC_URI_PORT)) && fc_urip_accept_char(&host_parser, ':'))
+    {
+        view->port = fc_urip_read_until(&host_parser, "");
+    }
 
-                // @[host]:port
-                // @host:port
+    return true;
+}
 
-                if (fc_urip_accept_char(&authority_parser, '['))
-                {
-                    uri->ipv6_host = true;
-
-                    host = fc_urip_read_until(&authority_parser, "]");
-                    if (!fc_urip_accept_char(&authority_parser, ']'))
-                    {
-                        // Missing closed bracket
-                        return;
-                    }
-                }
-                else {
-                    host = fc_urip_read_until(&authority_parser, ":/");
-                }
+static void fc_urip_parse_path(fc_urip_lexer_state* parser, fc_uri_view* view, unsigned components = FC_URI_ALL_COMPONENTS)
+{
+    if (!(components & FC_URIP_AFTER_AUTHORITY_COMPONENTS)) return;
 
-                if (fc_urip_accept_char(&authority_parser, ':'))
-                {
-                    port = fc_urip_read_until(&authority_parser, "/");
-                }
-            }
-            else {
-                host = host_ot_user;
-                port = access_info_or_port;
-            }
+    if (components & ((1u << FC_URI_PATH) | (1u << FC_URI_QUERY))) {
+        fc_uri_str path = fc_urip_read_until(parser, "?#");
+        if (components & (1u << FC_URI_PATH)) view->path = path;
+
+        if (!(components & ((1u << FC_URI_QUERY) | (1u << FC_URI_FRAGMENT)))) return;
+
+        if (fc_urip_accept_char(parser, '?'))
+        {
+            fc_uri_str query = fc_urip_read_until(parser, "#");
+            if (components & (1u << FC_URI_QUERY)) view->query = query;
         }
 
+        if (!(components & (1u << FC_URI_FRAGMENT))) return;
+    } else {
+        // Only the fragment, '#' can't be in the path or the query
+        fc_urip_read_until(parser, "#");
+    }
+
+    if (fc_urip_accept_char(parser, '#'))
+    {
+        view->fragment = fc_urip_read_until(parser, "");
     }
+}
+
+static bool fc_urip_parse_view(fc_urip_lexer_state* parser, fc_uri_view* view, unsigned components = FC_URI_ALL_COMPONENTS)
+{
+    *view = fc_uri_view{};
 
-    path = fc_urip_read_until(&parser, "?");
+    fc_uri_str scheme = fc_urip_read_until(parser, ":");
 
-    if (fc_urip_accept_char(&parser, '?'))
+    if (!fc_urip_accept_char(parser, ':'))
     {
-        query = fc_urip_read_until(&parser, "#");
+        // No scheme, likely a relative resource. Which we don't support. (yet?)
+        return false;
     }
 
-    if (fc_urip_accept_char(&parser, '#'))
+    if (components & (1u << FC_URI_SCHEME)) view->scheme = scheme;
+
+    if (!(components & ~(1u << FC_URI_SCHEME))) return true;
+
+    if (fc_urip_accept_str(parser, "//"))
     {
-        fragment = fc_urip_read_until(&parser, "");
+        if (!fc_urip_parse_authority(parser, view, components)) return false;
     }
 
-    int offset = 0;
+    fc_urip_parse_path(parser, view, components);
+
+    return true;
+}
+
+#ifdef FC_URI_STATS
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#error "FC_URI_STATS needs the GCC/Clang __atomic builtins"
+#endif
+
+#ifndef FC_URI_STATS_MALLOC
+#include <stdlib.h>
+#define FC_URI_STATS_MALLOC(size) malloc(size)
+#endif
+
+typedef struct fc_urip_stats_block
+{
+    fc_uri_stats stats; // Written only by the owner thread
+    struct fc_urip_stats_block* next;
+} fc_urip_stats_block;
+
+// Blocks are pushed once per thread and never freed, so counts of exited threads are not lost.
+static fc_urip_stats_block* fc_urip_stats_blocks = NULL;
+static thread_local fc_urip_stats_block* fc_urip_stats_local = NULL;
+
+static fc_urip_stats_block* fc_urip_stats_thread_block()
+{
+    if (fc_urip_stats_local) return fc_urip_stats_local;
+
+    fc_urip_stats_block* block = (fc_urip_stats_block*)FC_URI_STATS_MALLOC(sizeof(fc_urip_stats_block));
+    if (!block) return NULL;
+
+    memset(&block->stats, 0, sizeof(block->stats));
+
+    block->next = __atomic_load_n(&fc_urip_stats_blocks, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&fc_urip_stats_blocks, &block->next, block, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {}
+
+    fc_urip_stats_local = block;
+
+    return block;
+}
+
+// Only the owner writes, a relaxed load and store is enough for snapshots to read a whole value (no lock prefix).
+static void fc_urip_stats_increment(uint64_t* counter)
+{
+    __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + 1, __ATOMIC_RELAXED);
+}
+
+static int fc_urip_stats_bucket(int length)
+{
+    if (length == 0) return 0;
+
+    int bucket = 32 - fc_uri_clz((uint32_t)length);
+
+    return bucket < FC_URI_STATS_BUCKETS ? bucket : FC_URI_STATS_BUCKETS - 1;
+}
+
+static void fc_urip_stats_record(const fc_urip_lexer_state* parser, bool parsed, const fc_uri_view* view)
+{
+    fc_urip_stats_block* block = fc_urip_stats_thread_block();
+    if (!block) return;
+
+    fc_uri_outcome outcome;
+    if (!parsed) {
+        // The bracket is the only way to fail after the scheme
+        outcome = view->ipv6_host ? FC_URI_OUTCOME_BAD_IPV6 : FC_URI_OUTCOME_NO_SCHEME;
+    } else if (parser->cursor - parser->in_buffer > FC_URI_MAX) {
+        outcome = FC_URI_OUTCOME_TOO_LONG;
+    } else {
+        outcome = FC_URI_OUTCOME_OK;
+    }
+
+    fc_urip_stats_increment(&block->stats.outcomes[outcome]);
+
+    if (!parsed) return;
+
+    for (int i = 0; i < FC_URI_COMPONENT_COUNT; ++i)
+    {
+        fc_uri_str component = fc_uri_view_component(view, (fc_uri_component)i);
+        if (!component.data) continue;
+
+        fc_urip_stats_increment(&block->stats.lengths[i][fc_urip_stats_bucket(component.count)]);
+    }
+}
+
+void fc_uri_stats_snapshot(fc_uri_stats* snapshot)
+{
+    memset(snapshot, 0, sizeof(*snapshot));
+
+    uint64_t* sums = (uint64_t*)snapshot;
+    int counter_count = (int)(sizeof(fc_uri_stats) / sizeof(uint64_t));
+
+    fc_urip_stats_block* block = __atomic_load_n(&fc_urip_stats_blocks, __ATOMIC_ACQUIRE);
+    for (; block; block = block->next)
+    {
+        const uint64_t* counters = (const uint64_t*)&block->stats;
+
+        for (int i = 0; i < counter_count; ++i)
+        {
+            sums[i] += __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+#endif // FC_URI_STATS
+
+static bool fc_urip_parse(fc_urip_lexer_state* parser, fc_uri* uri, unsigned components = FC_URI_ALL_COMPONENTS)
+{
+    fc_uri_view view;
+
+    uri->ipv6_host = false;
+
+    bool parsed = fc_urip_parse_view(parser, &view, components);
+
+#ifdef FC_URI_STATS
+    // Partial parses would skew the length histograms
+    if (components == FC_URI_ALL_COMPONENTS) fc_urip_stats_record(parser, parsed, &view);
+#endif
+
+    // buf only has room for FC_URI_MAX characters
+    if (!parsed || parser->cursor - parser->in_buffer > FC_URI_MAX)
+    {
+        uri->scheme = uri->user = uri->access_info = uri->host = uri->port = NULL;
+        uri->path = uri->query = uri->fragment = NULL;
+        return false;
+    }
+
+    uri->ipv6_host = view.ipv6_host;
+
+    int offset = 0;
+
+    uri->scheme   = fc_urip_copy_string(view.scheme.data,    view.scheme.count,    uri->buf, &offset);
+    uri->user     = fc_urip_copy_string(view.user.data,      view.user.count,      uri->buf, &offset);
+    uri->access_info = fc_urip_copy_string(view.access_info.data, view.access_info.count, uri->buf, &offset);
+    uri->host     = fc_urip_copy_string(view.host.data,      view.host.count,      uri->buf, &offset);
+    uri->port     = fc_urip_copy_string(view.port.data,      view.port.count,      uri->buf, &offset);
+    uri->path     = fc_urip_copy_string(view.path.data,      view.path.count,      uri->buf, &offset);
+    uri->query    = fc_urip_copy_string(view.query.data,     view.query.count,     uri->buf, &offset);
+    uri->fragment = fc_urip_copy_string(view.fragment.data,  view.fragment.count,  uri->buf, &offset);
+
+    return true;
+}
+
+void fc_uri_parse(const char* src, fc_uri* uri)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src);
+
+    fc_urip_parse(&parser, uri);
+}
+
+bool fc_uri_parse_view(const char* src, int count, fc_uri_view* view)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src, count);
+
+    bool parsed = fc_urip_parse_view(&parser, view);
+
+#ifdef FC_URI_STATS
+    fc_urip_stats_record(&parser, parsed, view);
+#endif
+
+    return parsed;
+}
+
+bool fc_uri_parse_partial(const char* src, unsigned components, fc_uri* uri)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src);
+
+    return fc_urip_parse(&parser, uri, components);
+}
+
+bool fc_uri_parse_view_partial(const char* src, int count, unsigned components, fc_uri_view* view)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src, count);
+
+    return fc_urip_parse_view(&parser, view, components);
+}
+
+fc_uri_str fc_uri_view_component(const fc_uri_view* view, fc_uri_component component)
+{
+    switch (component)
+    {
+        case FC_URI_SCHEME:      return view->scheme;
+        case FC_URI_USER:        return view->user;
+        case FC_URI_ACCESS_INFO: return view->access_info;
+        case FC_URI_HOST:        return view->host;
+        case FC_URI_PORT:        return view->port;
+        case FC_URI_PATH:        return view->path;
+        case FC_URI_QUERY:       return view->query;
+        case FC_URI_FRAGMENT:    return view->fragment;
+        default:                 return fc_uri_str{};
+    }
+}
+
+static uint64_t fc_urip_mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t fc_uri_hash(const char* data, int count, uint64_t seed)
+{
+    uint64_t h = seed ^ ((uint64_t)count * 0x9E3779B97F4A7C15ull);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+
+        h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+        h ^= h >> 32;
+    }
+
+    uint64_t tail = 0;
+    if (i < count) memcpy(&tail, data + i, count - i); // data can be NULL when count is 0
+
+    return fc_urip_mix(h ^ (tail * 0x2545F4914F6CDD1Dull));
+}
+
+bool fc_uri_parse_authority_view(const char* src, int count, fc_uri_view* view)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src, count);
+
+    *view = fc_uri_view{};
+
+    if (!fc_urip_parse_authority(&parser, view)) return false;
+
+    fc_urip_parse_path(&parser, view);
+
+    return true;
+}
+
+bool fc_uri_parse_reference_view(const char* src, int count, fc_uri_view* view)
+{
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src, count);
+
+    // scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ), otherwise the first ':' belongs to the path.
+    const char* c = parser.cursor;
+    bool has_scheme = c != parser.in_buffer_end && ((*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z'));
+    while (has_scheme && c != parser.in_buffer_end && *c != ':')
+    {
+        has_scheme = (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || (*c >= '0' && *c <= '9') || *c == '+' || *c == '-' || *c == '.';
+        c++;
+    }
+    has_scheme = has_scheme && c != parser.in_buffer_end && *c == ':';
+
+    if (has_scheme)
+    {
+        return fc_urip_parse_view(&parser, view);
+    }
+
+    *view = fc_uri_view{};
+
+    if (fc_urip_accept_str(&parser, "//"))
+    {
+        if (!fc_urip_parse_authority(&parser, view)) return false;
+    }
+
+    fc_urip_parse_path(&parser, view);
+
+    return true;
+}
+
+fc_uri_target_form fc_uri_parse_request_target(const char* src, int count, fc_uri_view* uri)
+{
+    *uri = fc_uri_view{};
+
+    if (count < 0) count = (int)strlen(src);
+    if (count == 0) return FC_URI_TARGET_INVALID;
+
+    fc_urip_lexer_state parser = {};
+    fc_urip_init_parser_state(&parser, src, count);
+
+    if (src[0] == '/')
+    {
+        fc_urip_parse_path(&parser, uri);
+        return uri->fragment.data ? FC_URI_TARGET_INVALID : FC_URI_TARGET_ORIGIN;
+    }
+
+    if (src[0] == '*')
+    {
+        return count == 1 ? FC_URI_TARGET_ASTERISK : FC_URI_TARGET_INVALID;
+    }
+
+    // "host:port" and "[v6]:port" are authority-form, a scheme is never followed by digits only.
+    bool authority = src[0] == '[';
+    if (!authority)
+    {
+        const char* colon = (const char*)memchr(src, ':', count);
+        if (!colon) return FC_URI_TARGET_INVALID;
+
+        const char* c = colon + 1;
+        while (c != src + count && *c >= '0' && *c <= '9') c++;
+
+        authority = c == src + count;
+    }
+
+    if (authority)
+    {
+        if (!fc_urip_parse_authority(&parser, uri) || parser.cursor != parser.in_buffer_end) return FC_URI_TARGET_INVALID;
+        if (uri->user.data || uri->port.count == 0 || uri->host.count == 0) return FC_URI_TARGET_INVALID;
+
+        for (int i = 0; i < uri->port.count; ++i)
+        {
+            if (uri->port.data[i] < '0' || uri->port.data[i] > '9') return FC_URI_TARGET_INVALID;
+        }
+
+        return FC_URI_TARGET_AUTHORITY;
+    }
+
+    if (!fc_urip_parse_view(&parser, uri) || uri->fragment.data) return FC_URI_TARGET_INVALID;
+
+    return FC_URI_TARGET_ABSOLUTE;
+}
+
+int fc_uri_origin_form(const fc_uri_view* uri, fc_uri_str parts[2])
+{
+    // path and query are contiguous in the target, "?" included
+    const char* end = uri->query.data ? uri->query.data + uri->query.count : uri->path.data + uri->path.count;
+
+    if (uri->path.count)
+    {
+        parts[0].data  = uri->path.data;
+        parts[0].count = (int)(end - uri->path.data);
+        return 1;
+    }
+
+    parts[0].data  = "/";
+    parts[0].count = 1;
+
+    if (!uri->query.data) return 1;
+
+    parts[1].data  = uri->query.data - 1;
+    parts[1].count = uri->query.count + 1;
+    return 2;
+}
+
+static bool fc_urip_append(char* dst, int dst_size, int* written, const char* str, int count)
+{
+    if (*written + count >= dst_size) return false;
+
+    memcpy(dst + *written, str, count);
+    *written += count;
+
+    return true;
+}
+
+static bool fc_urip_starts_with(const char* str, int count, const char* prefix)
+{
+    int i = 0;
+    for (; prefix[i]; ++i)
+    {
+        if (i == count || str[i] != prefix[i]) return false;
+    }
+    return true;
+}
+
+static bool fc_urip_equals(const char* str, int count, const char* other)
+{
+    return fc_urip_starts_with(str, count, other) && (int)strlen(other) == count;
+}
+
+// RFC3986 section 5.2.4, in is modified.
+static bool fc_urip_remove_dot_segments(char* in, int count, char* dst, int dst_size, int* written)
+{
+    int begin = *written;
+    int i = 0;
+
+    while (i < count)
+    {
+        char* rest = in + i;
+        int rest_count = count - i;
+
+        if (fc_urip_starts_with(rest, rest_count, "../"))
+        {
+            i += 3;
+        }
+        else if (fc_urip_starts_with(rest, rest_count, "./") || fc_urip_starts_with(rest, rest_count, "/./"))
+        {
+            i += 2;
+        }
+        else if (fc_urip_equals(rest, rest_count, "/."))
+        {
+            i += 1;
+            in[i] = '/';
+        }
+        else if (fc_urip_starts_with(rest, rest_count, "/../") || fc_urip_equals(rest, rest_count, "/.."))
+        {
+            i += rest_count == 3 ? 2 : 3;
+            in[i] = '/';
+
+            // Drop the last segment of the output together with its '/'
+            while (*written > begin && dst[*written - 1] != '/') *written -= 1;
+            if (*written > begin) *written -= 1;
+        }
+        else if (fc_urip_equals(rest, rest_count, ".") || fc_urip_equals(rest, rest_count, ".."))
+        {
+            i = count;
+        }
+        else {
+            int end = i + 1;
+            while (end < count && in[end] != '/') end++;
+
+            if (!fc_urip_append(dst, dst_size, written, in + i, end - i)) return false;
+            i = end;
+        }
+    }
+
+    return true;
+}
+
+int fc_uri_resolve(const fc_uri_view* base, const fc_uri_view* ref, char* dst, int dst_size)
+{
+    // The target takes the components of ref from the first one it defines, the rest come from base.
+    const fc_uri_view* scheme    = ref->scheme.data ? ref : base;
+    const fc_uri_view* authority = ref->scheme.data || ref->host.data ? ref : base;
+
+    bool ref_path  = ref->scheme.data || ref->host.data || ref->path.count;
+    bool ref_query = ref_path || ref->query.data;
+
+    fc_uri_str query = ref_query ? ref->query : base->query;
+
+    int written = 0;
+    bool ok = true;
+
+    ok = ok && fc_urip_append(dst, dst_size, &written, scheme->scheme.data, scheme->scheme.count);
+    ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+
+    if (authority->host.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "//", 2);
+
+        if (authority->user.data)
+        {
+            ok = ok && fc_urip_append(dst, dst_size, &written, authority->user.data, authority->user.count);
+            if (authority->access_info.data)
+            {
+                ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+                ok = ok && fc_urip_append(dst, dst_size, &written, authority->access_info.data, authority->access_info.count);
+            }
+            ok = ok && fc_urip_append(dst, dst_size, &written, "@", 1);
+        }
+
+        if (authority->ipv6_host) ok = ok && fc_urip_append(dst, dst_size, &written, "[", 1);
+        ok = ok && fc_urip_append(dst, dst_size, &written, authority->host.data, authority->host.count);
+        if (authority->ipv6_host) ok = ok && fc_urip_append(dst, dst_size, &written, "]", 1);
+
+        if (authority->port.data)
+        {
+            ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+            ok = ok && fc_urip_append(dst, dst_size, &written, authority->port.data, authority->port.count);
+        }
+    }
+
+    if (!ok) return -1;
+
+    char path[FC_URI_MAX * 2 + 2];
+    int path_count = 0;
+
+    if (!ref_path)
+    {
+        ok = fc_urip_append(path, sizeof(path), &path_count, base->path.data, base->path.count);
+    }
+    else if (ref->scheme.data || ref->host.data || (ref->path.count && ref->path.data[0] == '/'))
+    {
+        ok = fc_urip_append(path, sizeof(path), &path_count, ref->path.data, ref->path.count);
+    }
+    else {
+        // Merge, section 5.2.3
+        if (base->host.data && base->path.count == 0)
+        {
+            ok = fc_urip_append(path, sizeof(path), &path_count, "/", 1);
+        }
+        else {
+            int directory = base->path.count;
+            while (directory && base->path.data[directory - 1] != '/') directory--;
+
+            ok = fc_urip_append(path, sizeof(path), &path_count, base->path.data, directory);
+        }
+
+        ok = ok && fc_urip_append(path, sizeof(path), &path_count, ref->path.data, ref->path.count);
+    }
+
+    if (ref_path)
+    {
+        ok = ok && fc_urip_remove_dot_segments(path, path_count, dst, dst_size, &written);
+    }
+    else {
+        ok = ok && fc_urip_append(dst, dst_size, &written, path, path_count);
+    }
+
+    if (query.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "?", 1);
+        ok = ok && fc_urip_append(dst, dst_size, &written, query.data, query.count);
+    }
+
+    if (ref->fragment.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "#", 1);
+        ok = ok && fc_urip_append(dst, dst_size, &written, ref->fragment.data, ref->fragment.count);
+    }
+
+    if (!ok) return -1;
+
+    dst[written] = '\0';
+
+    return written;
+}
+
+static int fc_urip_hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static char fc_urip_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c;
+}
+
+static bool fc_urip_is_unreserved(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+// Appends str decoding the percent-encoded unreserved characters and uppercasing the others.
+static bool fc_urip_append_normalized(char* dst, int dst_size, int* written, const char* str, int count, bool lowercase)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    for (int i = 0; i < count; ++i)
+    {
+        char c = str[i];
+
+        if (c == '%' && i + 2 < count)
+        {
+            int high = fc_urip_hex_value(str[i + 1]);
+            int low  = fc_urip_hex_value(str[i + 2]);
+
+            if (high >= 0 && low >= 0)
+            {
+                char decoded = (char)(high * 16 + low);
+                i += 2;
+
+                if (fc_urip_is_unreserved(decoded))
+                {
+                    c = lowercase ? fc_urip_lower(decoded) : decoded;
+                }
+                else {
+                    char encoded[3] = { '%', hex[high], hex[low] };
+                    if (!fc_urip_append(dst, dst_size, written, encoded, 3)) return false;
+                    continue;
+                }
+            }
+        }
+        else if (lowercase) {
+            c = fc_urip_lower(c);
+        }
+
+        if (!fc_urip_append(dst, dst_size, written, &c, 1)) return false;
+    }
+
+    return true;
+}
+
+static bool fc_urip_is_default_port(fc_uri_str scheme, fc_uri_str port)
+{
+    int value = 0;
+    for (int i = 0; i < port.count; ++i)
+    {
+        if (port.data[i] < '0' || port.data[i] > '9' || value > 65535) return false;
+        value = value * 10 + (port.data[i] - '0');
+    }
+
+    struct { const char* scheme; int port; } defaults[] = {
+        { "http", 80 }, { "https", 443 }, { "ws", 80 }, { "wss", 443 }, { "ftp", 21 },
+    };
+
+    for (unsigned i = 0; i < sizeof(defaults) / sizeof(defaults[0]); ++i)
+    {
+        const char* d = defaults[i].scheme;
+        int n = (int)strlen(d);
+        if (n != scheme.count || port.count == 0) continue;
+
+        bool same = true;
+        for (int k = 0; k < n; ++k)
+        {
+            if (fc_urip_lower(scheme.data[k]) != d[k]) same = false;
+        }
+
+        if (same) return value == defaults[i].port;
+    }
+
+    return false;
+}
+
+int fc_uri_normalize(const fc_uri_view* uri, char* dst, int dst_size)
+{
+    int written = 0;
+    bool ok = true;
+
+    if (uri->scheme.data)
+    {
+        ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->scheme.data, uri->scheme.count, true);
+        ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+    }
+
+    if (uri->host.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "//", 2);
+
+        if (uri->user.data)
+        {
+            ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->user.data, uri->user.count, false);
+            if (uri->access_info.data)
+            {
+                ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+                ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->access_info.data, uri->access_info.count, false);
+            }
+            ok = ok && fc_urip_append(dst, dst_size, &written, "@", 1);
+        }
+
+        if (uri->ipv6_host) ok = ok && fc_urip_append(dst, dst_size, &written, "[", 1);
+        ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->host.data, uri->host.count, true);
+        if (uri->ipv6_host) ok = ok && fc_urip_append(dst, dst_size, &written, "]", 1);
+
+        if (uri->port.count && !fc_urip_is_default_port(uri->scheme, uri->port))
+        {
+            ok = ok && fc_urip_append(dst, dst_size, &written, ":", 1);
+            ok = ok && fc_urip_append(dst, dst_size, &written, uri->port.data, uri->port.count);
+        }
+    }
+
+    if (uri->host.data && uri->path.count == 0)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "/", 1);
+    }
+    else {
+        // Unreserved characters are decoded first so that "%2E%2E" is a dot segment too.
+        char path[FC_URI_MAX + 1];
+        int path_count = 0;
+
+        ok = ok && fc_urip_append_normalized(path, sizeof(path), &path_count, uri->path.data, uri->path.count, false);
+
+        if (uri->scheme.data || uri->host.data || (path_count && path[0] == '/'))
+        {
+            ok = ok && fc_urip_remove_dot_segments(path, path_count, dst, dst_size, &written);
+        }
+        else {
+            ok = ok && fc_urip_append(dst, dst_size, &written, path, path_count);
+        }
+    }
+
+    if (uri->query.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "?", 1);
+        ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->query.data, uri->query.count, false);
+    }
+
+    if (uri->fragment.data)
+    {
+        ok = ok && fc_urip_append(dst, dst_size, &written, "#", 1);
+        ok = ok && fc_urip_append_normalized(dst, dst_size, &written, uri->fragment.data, uri->fragment.count, false);
+    }
+
+    if (!ok || written >= dst_size) return -1;
+
+    dst[written] = '\0';
+
+    return written;
+}
+
+bool fc_iri_parse(const char* src, fc_uri* uri)
+{
+    int length = (int)strlen(src);
+    if (length == 0 || length > FC_URI_MAX) return false;
+
+    fc_urip_lexer_state parser = {};
+
+    fc_urip_init_parser_state(&parser, src, length);
+    parser.validate_utf8 = true;
+
+    return fc_urip_parse(&parser, uri) && !parser.invalid_utf8;
+}
+
+// Appends src to dst at *written, percent-encoding every non-ASCII byte and validating the UTF-8.
+static bool fc_urip_percent_encode_utf8(const char* src, int count, char* dst, int dst_size, int* written)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    fc_urip_utf8_state utf8;
+    fc_urip_utf8_begin(&utf8);
+
+    for (int i = 0; i < count;)
+    {
+        int n = count - i < 16 ? count - i : 16;
+
+#ifdef FC_URIP_SSSE3
+        char block_bytes[16] = {};
+        memcpy(block_bytes, src + i, n);
+        __m128i block = _mm_loadu_si128((const __m128i*)block_bytes);
+
+        fc_urip_utf8_block(&utf8, block);
+
+        if (_mm_movemask_epi8(block) == 0)
+        {
+            if (*written + n >= dst_size) return false;
+
+            memcpy(dst + *written, src + i, n);
+            *written += n;
+            i += n;
+            continue;
+        }
+#endif
+
+        for (int end = i + n; i < end; ++i)
+        {
+            unsigned char c = (unsigned char)src[i];
+#ifndef FC_URIP_SSSE3
+            fc_urip_utf8_byte(&utf8, c);
+#endif
+            if (c < 0x80)
+            {
+                if (*written + 1 >= dst_size) return false;
+                dst[(*written)++] = (char)c;
+            }
+            else {
+                if (*written + 3 >= dst_size) return false;
+                dst[(*written)++] = '%';
+                dst[(*written)++] = hex[c >> 4];
+                dst[(*written)++] = hex[c & 0x0F];
+            }
+        }
+    }
+
+    return fc_urip_utf8_end(&utf8);
+}
+
+int fc_iri_to_uri(const char* iri, char* dst, int dst_size)
+{
+    if (dst_size < 1) return -1;
+
+    int length = (int)strlen(iri);
+
+    // The host goes through IDNA rather than percent-encoding.
+    const char* host_begin = iri;
+    const char* host_end   = iri;
+
+    fc_urip_lexer_state parser = {};
+    fc_urip_init_parser_state(&parser, iri, length);
+
+    fc_urip_read_until(&parser, ":");
+    if (fc_urip_accept_char(&parser, ':') && fc_urip_accept_str(&parser, "//"))
+    {
+        fc_uri_str authority = fc_urip_read_until(&parser, "/?#");
+
+        host_begin = authority.data;
+        host_end   = authority.data + authority.count;
+
+        for (const char* c = host_end; c != authority.data; --c)
+        {
+            if (c[-1] == '@')
+            {
+                host_begin = c;
+                break;
+            }
+        }
+
+        const char* host_stop = host_begin;
+        if (host_stop != host_end && *host_stop == '[')
+        {
+            while (host_stop != host_end && *host_stop != ']') host_stop++;
+        }
+        while (host_stop != host_end && *host_stop != ':') host_stop++;
+
+        host_end = host_stop;
+    }
+
+    int written = 0;
+
+    if (!fc_urip_percent_encode_utf8(iri, (int)(host_begin - iri), dst, dst_size, &written)) return -1;
+
+    if (host_begin != host_end)
+    {
+        const char* host;
+        int host_count = fc_uri_host_to_ascii(host_begin, (int)(host_end - host_begin), dst + written, dst_size - written, &host);
+        if (host_count < 0 || written + host_count >= dst_size) return -1;
+
+        if (host == host_begin)
+        {
+            memcpy(dst + written, host, host_count);
+        }
+        written += host_count;
+    }
+
+    if (!fc_urip_percent_encode_utf8(host_end, (int)(iri + length - host_end), dst, dst_size, &written)) return -1;
+
+    dst[written] = '\0';
+
+    return written;
+}
+
+// Punycode, RFC3492
+
+enum
+{
+    FC_URIP_PUNY_BASE         = 36,
+    FC_URIP_PUNY_TMIN         = 1,
+    FC_URIP_PUNY_TMAX         = 26,
+    FC_URIP_PUNY_SKEW         = 38,
+    FC_URIP_PUNY_DAMP         = 700,
+    FC_URIP_PUNY_INITIAL_BIAS = 72,
+    FC_URIP_PUNY_INITIAL_N    = 128,
+
+    FC_URIP_LABEL_MAX = 63, // Every code point takes at least one character, so this also bounds the code points.
+};
+
+static unsigned fc_urip_puny_adapt(unsigned delta, unsigned num_points, bool first_time)
+{
+    delta = first_time ? delta / FC_URIP_PUNY_DAMP : delta / 2;
+    delta += delta / num_points;
+
+    unsigned k = 0;
+    while (delta > ((FC_URIP_PUNY_BASE - FC_URIP_PUNY_TMIN) * FC_URIP_PUNY_TMAX) / 2)
+    {
+        delta /= FC_URIP_PUNY_BASE - FC_URIP_PUNY_TMIN;
+        k += FC_URIP_PUNY_BASE;
+    }
+
+    return k + (FC_URIP_PUNY_BASE - FC_URIP_PUNY_TMIN + 1) * delta / (delta + FC_URIP_PUNY_SKEW);
+}
+
+static unsigned fc_urip_puny_threshold(unsigned k, unsigned bias)
+{
+    if (k <= bias) return FC_URIP_PUNY_TMIN;
+    if (k >= bias + FC_URIP_PUNY_TMAX) return FC_URIP_PUNY_TMAX;
+    return k - bias;
+}
+
+static char fc_urip_puny_digit(unsigned d)
+{
+    return (char)(d < 26 ? 'a' + d : '0' + d - 26);
+}
+
+static unsigned fc_urip_puny_digit_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0' + 26;
+    if (c >= 'a' && c <= 'z') return c - 'a';
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    return FC_URIP_PUNY_BASE;
+}
+
+// Decodes one code point, returns -1 on invalid UTF-8.
+static int fc_urip_utf8_decode(const char* src, int count, int* i)
+{
+    unsigned char c = (unsigned char)src[*i];
+    *i += 1;
+
+    if (c < 0x80) return c;
+
+    int need;
+    int cp;
+    int min;
+    if      (c >= 0xC2 && c <= 0xDF) { need = 1; cp = c & 0x1F; min = 0x80; }
+    else if (c >= 0xE0 && c <= 0xEF) { need = 2; cp = c & 0x0F; min = 0x800; }
+    else if (c >= 0xF0 && c <= 0xF4) { need = 3; cp = c & 0x07; min = 0x10000; }
+    else return -1;
+
+    if (*i + need > count) return -1;
+
+    for (int k = 0; k < need; ++k)
+    {
+        unsigned char cc = (unsigned char)src[*i];
+        if ((cc & 0xC0) != 0x80) return -1;
+
+        cp = (cp << 6) | (cc & 0x3F);
+        *i += 1;
+    }
+
+    if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return -1;
+
+    return cp;
+}
+
+static int fc_urip_utf8_encode(int cp, char* dst, int dst_size)
+{
+    if (cp < 0x80)
+    {
+        if (dst_size < 1) return -1;
+        dst[0] = (char)cp;
+        return 1;
+    }
+    if (cp < 0x800)
+    {
+        if (dst_size < 2) return -1;
+        dst[0] = (char)(0xC0 | (cp >> 6));
+        dst[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    }
+    if (cp < 0x10000)
+    {
+        if (dst_size < 3) return -1;
+        dst[0] = (char)(0xE0 | (cp >> 12));
+        dst[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        dst[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    }
+
+    if (dst_size < 4) return -1;
+    dst[0] = (char)(0xF0 | (cp >> 18));
+    dst[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    dst[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+    dst[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+int fc_punycode_encode(const char* src, int count, char* dst, int dst_size)
+{
+    if (dst_size < 1) return -1;
+
+    int code_points[FC_URIP_LABEL_MAX];
+    int code_point_count = 0;
+
+    for (int i = 0; i < count;)
+    {
+        if (code_point_count == FC_URIP_LABEL_MAX) return -1;
+
+        int cp = fc_urip_utf8_decode(src, count, &i);
+        if (cp < 0) return -1;
+
+        code_points[code_point_count++] = cp;
+    }
+
+    int written = 0;
+
+    for (int i = 0; i < code_point_count; ++i)
+    {
+        if (code_points[i] < 0x80)
+        {
+            if (written + 1 >= dst_size) return -1;
+            dst[written++] = (char)code_points[i];
+        }
+    }
+
+    unsigned handled = written;
+    unsigned basic   = written;
+
+    if (basic > 0)
+    {
+        if (written + 1 >= dst_size) return -1;
+        dst[written++] = '-';
+    }
+
+    unsigned n     = FC_URIP_PUNY_INITIAL_N;
+    unsigned delta = 0;
+    unsigned bias  = FC_URIP_PUNY_INITIAL_BIAS;
+
+    while (handled < (unsigned)code_point_count)
+    {
+        unsigned m = 0x10FFFF + 1;
+        for (int i = 0; i < code_point_count; ++i)
+        {
+            if ((unsigned)code_points[i] >= n && (unsigned)code_points[i] < m) m = code_points[i];
+        }
+
+        // Bounded by 0x110000 * 64, no overflow possible.
+        delta += (m - n) * (handled + 1);
+        n = m;
+
+        for (int i = 0; i < code_point_count; ++i)
+        {
+            if ((unsigned)code_points[i] < n) delta++;
+
+            if ((unsigned)code_points[i] == n)
+            {
+                unsigned q = delta;
+                for (unsigned k = FC_URIP_PUNY_BASE;; k += FC_URIP_PUNY_BASE)
+                {
+                    unsigned t = fc_urip_puny_threshold(k, bias);
+                    if (q < t) break;
+
+                    if (written + 1 >= dst_size) return -1;
+                    dst[written++] = fc_urip_puny_digit(t + (q - t) % (FC_URIP_PUNY_BASE - t));
+
+                    q = (q - t) / (FC_URIP_PUNY_BASE - t);
+                }
+
+                if (written + 1 >= dst_size) return -1;
+                dst[written++] = fc_urip_puny_digit(q);
+
+                bias = fc_urip_puny_adapt(delta, handled + 1, handled == basic);
+                delta = 0;
+                handled++;
+            }
+        }
+
+        delta++;
+        n++;
+    }
+
+    dst[written] = '\0';
+
+    return written;
+}
+
+int fc_punycode_decode(const char* src, int count, char* dst, int dst_size)
+{
+    int code_points[FC_URIP_LABEL_MAX];
+    unsigned code_point_count = 0;
+
+    int basic = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (src[i] == '-') basic = i;
+    }
+
+    if (basic > FC_URIP_LABEL_MAX) return -1;
+
+    for (int i = 0; i < basic; ++i)
+    {
+        if ((unsigned char)src[i] >= 0x80) return -1;
+        code_points[code_point_count++] = src[i];
+    }
+
+    unsigned n    = FC_URIP_PUNY_INITIAL_N;
+    unsigned i    = 0;
+    unsigned bias = FC_URIP_PUNY_INITIAL_BIAS;
+
+    for (int in = basic > 0 ? basic + 1 : 0; in < count;)
+    {
+        unsigned old_i = i;
+        unsigned w = 1;
+
+        for (unsigned k = FC_URIP_PUNY_BASE;; k += FC_URIP_PUNY_BASE)
+        {
+            if (in >= count) return -1;
+
+            unsigned digit = fc_urip_puny_digit_value(src[in++]);
+            if (digit >= FC_URIP_PUNY_BASE) return -1;
+            if (digit > (0xFFFFFFFFu - i) / w) return -1;
+
+            i += digit * w;
+
+            unsigned t = fc_urip_puny_threshold(k, bias);
+            if (digit < t) break;
+
+            if (w > 0xFFFFFFFFu / (FC_URIP_PUNY_BASE - t)) return -1;
+            w *= FC_URIP_PUNY_BASE - t;
+        }
+
+        bias = fc_urip_puny_adapt(i - old_i, code_point_count + 1, old_i == 0);
+
+        // Checked before adding, n can't wrap around (RFC3492 section 6.2)
+        if (i / (code_point_count + 1) > 0x10FFFF - n) return -1;
+
+        n += i / (code_point_count + 1);
+        i %= code_point_count + 1;
+
+        if (n > 0x10FFFF || (n >= 0xD800 && n <= 0xDFFF) || code_point_count == FC_URIP_LABEL_MAX) return -1;
+
+        memmove(code_points + i + 1, code_points + i, (code_point_count - i) * sizeof(int));
+        code_points[i++] = n;
+        code_point_count++;
+    }
+
+    int written = 0;
+    for (unsigned k = 0; k < code_point_count; ++k)
+    {
+        int bytes = fc_urip_utf8_encode(code_points[k], dst + written, dst_size - written - 1);
+        if (bytes < 0) return -1;
+        written += bytes;
+    }
+
+    if (written >= dst_size) return -1;
+    dst[written] = '\0';
+
+    return written;
+}
+
+// IDNA
+
+// Length of the label separator at src, IDNA also accepts U+3002, U+FF0E and U+FF61 as dots.
+static int fc_urip_label_separator(const char* src, int count)
+{
+    if (src[0] == '.') return 1;
+    if (count < 3) return 0;
+
+    const unsigned char* c = (const unsigned char*)src;
+    if (c[0] == 0xE3 && c[1] == 0x80 && c[2] == 0x82) return 3; // U+3002
+    if (c[0] == 0xEF && c[1] == 0xBC && c[2] == 0x8E) return 3; // U+FF0E
+    if (c[0] == 0xEF && c[1] == 0xBD && c[2] == 0xA1) return 3; // U+FF61
+
+    return 0;
+}
+
+static bool fc_urip_is_ace_label(const char* label, int count)
+{
+    return count >= 4 && (label[0] | 0x20) == 'x' && (label[1] | 0x20) == 'n' && label[2] == '-' && label[3] == '-';
+}
+
+int fc_uri_host_to_ascii(const char* host, int count, char* buf, int buf_size, const char** result)
+{
+    int i = 0;
+    while (i < count && (unsigned char)host[i] < 0x80) i++;
+
+    if (i == count)
+    {
+        *result = host;
+        return count;
+    }
+
+    int written = 0;
+
+    for (int label = 0; label <= count;)
+    {
+        int end = label;
+        int separator = 0;
+        bool ascii = true;
+
+        while (end < count && !(separator = fc_urip_label_separator(host + end, count - end)))
+        {
+            if ((unsigned char)host[end] >= 0x80) ascii = false;
+            end++;
+        }
+
+        if (ascii)
+        {
+            if (written + (end - label) >= buf_size) return -1;
+            memcpy(buf + written, host + label, end - label);
+            written += end - label;
+        }
+        else {
+            if (written + 4 >= buf_size) return -1;
+            memcpy(buf + written, "xn--", 4);
+
+            int encoded = fc_punycode_encode(host + label, end - label, buf + written + 4, buf_size - written - 4);
+            if (encoded < 0 || encoded + 4 > FC_URIP_LABEL_MAX) return -1;
+
+            written += encoded + 4;
+        }
+
+        if (end == count) break;
+
+        if (written + 1 >= buf_size) return -1;
+        buf[written++] = '.';
+
+        label = end + separator;
+    }
+
+    if (written > FC_URI_HOST_MAX) return -1;
+
+    buf[written] = '\0';
+    *result = buf;
+
+    return written;
+}
+
+int fc_uri_host_to_unicode(const char* host, int count, char* buf, int buf_size, const char** result)
+{
+    bool has_ace = false;
+    for (int label = 0; label < count && !has_ace;)
+    {
+        has_ace = fc_urip_is_ace_label(host + label, count - label);
+
+        while (label < count && host[label] != '.') label++;
+        label++;
+    }
+
+    if (!has_ace)
+    {
+        *result = host;
+        return count;
+    }
+
+    int written = 0;
+
+    for (int label = 0; label <= count;)
+    {
+        int end = label;
+        while (end < count && host[end] != '.') end++;
+
+        if (fc_urip_is_ace_label(host + label, end - label))
+        {
+            int decoded = fc_punycode_decode(host + label + 4, end - label - 4, buf + written, buf_size - written);
+            if (decoded < 0) return -1;
+
+            written += decoded;
+        }
+        else {
+            if (written + (end - label) >= buf_size) return -1;
+            memcpy(buf + written, host + label, end - label);
+            written += end - label;
+        }
+
+        if (end == count) break;
+
+        if (written + 1 >= buf_size) return -1;
+        buf[written++] = '.';
+
+        label = end + 1;
+    }
+
+    buf[written] = '\0';
+    *result = buf;
 
-    uri->scheme   = fc_urip_copy_string(scheme.data,    scheme.count,    uri->buf, &offset);
-    uri->user     = fc_urip_copy_string(user.data,      user.count,      uri->buf, &offset);
-    uri->access_info = fc_urip_copy_string(access_info.data, access_info.count, uri->buf, &offset);
-    uri->host     = fc_urip_copy_string(host.data,      host.count,      uri->buf, &offset);
-    uri->port     = fc_urip_copy_string(port.data,      port.count,      uri->buf, &offset);
-    uri->path     = fc_urip_copy_string(path.data,      path.count,      uri->buf, &offset);
-    uri->query    = fc_urip_copy_string(query.data,     query.count,     uri->buf, &offset);
-    uri->fragment = fc_urip_copy_string(fragment.data,  fragment.count,  uri->buf, &offset);
+    return written;
 }
 
 #endif // FC_URI_PARSE_IMPLEMENTATION
@@ -0,0 +1,432 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_GRAPH_LAYOUT_IMPLEMENTATION
+        #include "fc_graph_layout.h"
+
+        #define FC_URI_PATH_TREE_IMPLEMENTATION
+        #include "fc_uri_path_tree.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_path_tree.h"
+    "
+
+Example:
+    fc_path_tree tree;
+    fc_path_tree_init(&tree, true); // One subtree per host
+
+    fc_uri_view uri;
+    for (int i = 0; i < url_count; ++i)
+    {
+        if (fc_uri_parse_view(urls[i], -1, &uri)) fc_path_tree_add(&tree, &uri);
+    }
+
+    fc_graph graph = fc_path_tree_get(&tree);
+    fc_path_tree_layout(&tree, FC_PATH_TREE_RADIAL, 32.f);
+
+    for (int i = 0; i < graph.node_count; ++i)
+    {
+        // (const char*)graph.nodes[i].user_data is the segment, graph.nodes[i].user_i64 the pages under it
+    }
+
+    fc_path_tree_free(&tree);
+
+Info:
+    Trie of the path segments of a set of URIs, "/a/b" and "/a/c" share the node of "a". Empty segments are
+    skipped, so "/a/b/" is the same page as "/a/b", and the query is ignored. Segments are kept as they are,
+    without decoding. With by_host the hosts (lowercased) are the first level under the root.
+
+    Node 0 is the root and every node comes after its parent, which is what makes the passes over the tree
+    simple loops: fc_path_tree_get sums the pages of each subtree walking the nodes backwards, and the layouts
+    split the space of a node between its children in one forward pass. There is one edge per node but the root,
+    edges[i - 1] goes from the parent of node i to i, weighted by the pages under i.
+
+    The layouts give every node a share of its parent's space proportional to the leaves under it, leaves are
+    evenly spaced (a layered tree drawing in the spirit of Reingold and Tilford, without the compaction).
+    FC_PATH_TREE_RADIAL puts depth d on a circle of radius d * distance, FC_PATH_TREE_LAYERED on the line
+    y = d * distance with leaves distance apart. Both take linear time, there is no force simulation.
+*/
+
+#ifndef FC_URI_PATH_TREE
+#define FC_URI_PATH_TREE
+
+#include "fc_uri_parse.h"
+
+// The implementation part of fc_graph_layout.h is outside of its include guard
+#ifndef FC_GRAPH_LAYOUT
+#include "fc_graph_layout.h"
+#endif
+
+#include <stdint.h>
+
+typedef struct
+{
+    int parent;
+    int first_child;
+    int last_child;
+    int next_sibling;
+    int depth;
+
+    uint32_t name_offset;
+    uint64_t hash;
+    uint64_t pages; // URIs that end here
+} fc_path_tree_node;
+
+typedef struct
+{
+    bool by_host;
+
+    fc_path_tree_node* tree_nodes;
+    int node_count;
+    int node_capacity;
+
+    char* names; // Null-terminated
+    uint32_t names_size;
+    uint32_t names_capacity;
+
+    int* table; // Node index + 1 by (parent, segment), 0 for empty slots
+    int table_mask;
+
+    // Filled by fc_path_tree_get
+    fc_node* nodes;
+    fc_edge* edges;
+
+    bool failed; // Out of memory
+} fc_path_tree;
+
+typedef enum
+{
+    FC_PATH_TREE_RADIAL,
+    FC_PATH_TREE_LAYERED,
+} fc_path_tree_layout_kind;
+
+bool fc_path_tree_init(fc_path_tree* tree, bool by_host);
+void fc_path_tree_free(fc_path_tree* tree);
+
+// Returns false if out of memory, or if by_host is set and the URI has no host.
+bool fc_path_tree_add(fc_path_tree* tree, const fc_uri_view* uri);
+
+// user_i64 of the nodes is the number of pages under them, user_data their segment.
+// The graph is valid until the next fc_path_tree_add or fc_path_tree_get.
+fc_graph fc_path_tree_get(fc_path_tree* tree);
+
+// Sets the positions of the nodes of the last fc_path_tree_get, the root is at the origin.
+void fc_path_tree_layout(fc_path_tree* tree, fc_path_tree_layout_kind kind, float distance);
+
+#endif // FC_URI_PATH_TREE
+
+#ifdef FC_URI_PATH_TREE_IMPLEMENTATION
+
+#include <string.h> // memcpy, memset
+#include <math.h>   // cosf, sinf
+
+#ifndef FC_URI_PATH_TREE_REALLOC
+#include <stdlib.h>
+#define FC_URI_PATH_TREE_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_PATH_TREE_FREE
+#include <stdlib.h>
+#define FC_URI_PATH_TREE_FREE(ptr)          free(ptr)
+#endif
+
+static bool fc_path_tree_resize(void** data, size_t capacity, size_t size)
+{
+    void* resized = FC_URI_PATH_TREE_REALLOC(*data, capacity * size);
+    if (!resized) return false;
+
+    *data = resized;
+
+    return true;
+}
+
+static bool fc_path_tree_rehash(fc_path_tree* tree, int slot_count)
+{
+    if (!fc_path_tree_resize((void**)&tree->table, slot_count, sizeof(int))) return false;
+
+    memset(tree->table, 0, slot_count * sizeof(int));
+    tree->table_mask = slot_count - 1;
+
+    for (int i = 1; i < tree->node_count; ++i)
+    {
+        int slot = (int)(tree->tree_nodes[i].hash & tree->table_mask);
+        while (tree->table[slot]) slot = (slot + 1) & tree->table_mask;
+        tree->table[slot] = i + 1;
+    }
+
+    return true;
+}
+
+// Child of parent named segment, added if it is not there. -1 if out of memory.
+static int fc_path_tree_child(fc_path_tree* tree, int parent, const char* segment, int count)
+{
+    uint64_t hash = fc_uri_hash(segment, count, (uint64_t)parent * 0x9E3779B97F4A7C15ull);
+
+    int slot = (int)(hash & tree->table_mask);
+    for (; tree->table[slot]; slot = (slot + 1) & tree->table_mask)
+    {
+        int node = tree->table[slot] - 1;
+        const fc_path_tree_node* candidate = &tree->tree_nodes[node];
+        const char* name = tree->names + candidate->name_offset;
+
+        if (candidate->hash == hash && candidate->parent == parent && memcmp(name, segment, count) == 0 && name[count] == '\0') return node;
+    }
+
+    if (tree->node_count == tree->node_capacity)
+    {
+        int capacity = tree->node_capacity * 2;
+        if (!fc_path_tree_resize((void**)&tree->tree_nodes, capacity, sizeof(fc_path_tree_node))) return -1;
+
+        tree->node_capacity = capacity;
+    }
+
+    if (tree->names_size + count + 1 > tree->names_capacity)
+    {
+        uint32_t capacity = tree->names_capacity * 2;
+        while (capacity < tree->names_size + count + 1) capacity *= 2;
+
+        if (!fc_path_tree_resize((void**)&tree->names, capacity, 1)) return -1;
+
+        tree->names_capacity = capacity;
+    }
+
+    int index = tree->node_count++;
+
+    fc_path_tree_node* node = &tree->tree_nodes[index];
+    node->parent = parent;
+    node->first_child = -1;
+    node->last_child = -1;
+    node->next_sibling = -1;
+    node->depth = tree->tree_nodes[parent].depth + 1;
+    node->name_offset = tree->names_size;
+    node->hash = hash;
+    node->pages = 0;
+
+    memcpy(tree->names + tree->names_size, segment, count);
+    tree->names[tree->names_size + count] = '\0';
+    tree->names_size += count + 1;
+
+    fc_path_tree_node* parent_node = &tree->tree_nodes[parent];
+    if (parent_node->last_child >= 0) {
+        tree->tree_nodes[parent_node->last_child].next_sibling = index;
+    } else {
+        parent_node->first_child = index;
+    }
+    parent_node->last_child = index;
+
+    // Load factor below 1/2
+    if (2 * tree->node_count > tree->table_mask + 1) {
+        if (!fc_path_tree_rehash(tree, 2 * (tree->table_mask + 1))) return -1;
+    } else {
+        tree->table[slot] = index + 1;
+    }
+
+    return index;
+}
+
+bool fc_path_tree_init(fc_path_tree* tree, bool by_host)
+{
+    memset(tree, 0, sizeof(*tree));
+
+    tree->by_host = by_host;
+    tree->node_capacity = 1024;
+    tree->names_capacity = 16384;
+
+    if (!fc_path_tree_resize((void**)&tree->tree_nodes, tree->node_capacity, sizeof(fc_path_tree_node)) ||
+        !fc_path_tree_resize((void**)&tree->names, tree->names_capacity, 1) ||
+        !fc_path_tree_rehash(tree, 2048))
+    {
+        fc_path_tree_free(tree);
+        return false;
+    }
+
+    fc_path_tree_node* root = &tree->tree_nodes[0];
+    root->parent = -1;
+    root->first_child = -1;
+    root->last_child = -1;
+    root->next_sibling = -1;
+    root->depth = 0;
+    root->name_offset = 0;
+    root->hash = 0;
+    root->pages = 0;
+
+    tree->names[0] = '\0';
+    tree->names_size = 1;
+    tree->node_count = 1;
+
+    return true;
+}
+
+void fc_path_tree_free(fc_path_tree* tree)
+{
+    FC_URI_PATH_TREE_FREE(tree->tree_nodes);
+    FC_URI_PATH_TREE_FREE(tree->names);
+    FC_URI_PATH_TREE_FREE(tree->table);
+    FC_URI_PATH_TREE_FREE(tree->nodes);
+    FC_URI_PATH_TREE_FREE(tree->edges);
+
+    memset(tree, 0, sizeof(*tree));
+}
+
+bool fc_path_tree_add(fc_path_tree* tree, const fc_uri_view* uri)
+{
+    int node = 0;
+
+    if (tree->by_host)
+    {
+        if (!uri->host.data || uri->host.count > FC_URI_HOST_MAX) return false;
+
+        char host[FC_URI_HOST_MAX];
+        for (int i = 0; i < uri->host.count; ++i)
+        {
+            char c = uri->host.data[i];
+            host[i] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+        }
+
+        node = fc_path_tree_child(tree, 0, host, uri->host.count);
+    }
+
+    const char* c = uri->path.data;
+    const char* end = c + uri->path.count;
+
+    while (node >= 0 && c < end)
+    {
+        const char* slash = (const char*)memchr(c, '/', end - c);
+        const char* segment_end = slash ? slash : end;
+
+        if (segment_end != c) node = fc_path_tree_child(tree, node, c, (int)(segment_end - c));
+
+        c = segment_end + 1;
+    }
+
+    if (node < 0)
+    {
+        tree->failed = true;
+        return false;
+    }
+
+    tree->tree_nodes[node].pages++;
+
+    return true;
+}
+
+fc_graph fc_path_tree_get(fc_path_tree* tree)
+{
+    fc_graph graph = {};
+
+    if (!fc_path_tree_resize((void**)&tree->nodes, tree->node_count, sizeof(fc_node)) ||
+        !fc_path_tree_resize((void**)&tree->edges, tree->node_count, sizeof(fc_edge)))
+    {
+        tree->failed = true;
+        return graph;
+    }
+
+    for (int i = 0; i < tree->node_count; ++i)
+    {
+        fc_node* node = &tree->nodes[i];
+        node->position = fc_v2f{ 0, 0 };
+        node->user_i64 = (int64_t)tree->tree_nodes[i].pages;
+        node->user_data = tree->names + tree->tree_nodes[i].name_offset;
+    }
+
+    // Children come after their parent, walking backwards every subtree is complete before it is added up
+    for (int i = tree->node_count - 1; i > 0; --i)
+    {
+        int parent = tree->tree_nodes[i].parent;
+        tree->nodes[parent].user_i64 += tree->nodes[i].user_i64;
+
+        fc_edge* edge = &tree->edges[i - 1];
+        *edge = fc_edge_default;
+        edge->first = parent;
+        edge->second = i;
+        edge->weight = (float)tree->nodes[i].user_i64;
+    }
+
+    graph.nodes = tree->nodes;
+    graph.node_count = tree->node_count;
+    graph.edges = tree->edges;
+    graph.edge_count = tree->node_count - 1;
+
+    return graph;
+}
+
+void fc_path_tree_layout(fc_path_tree* tree, fc_path_tree_layout_kind kind, float distance)
+{
+    int count = tree->node_count;
+    if (!tree->nodes || count == 0) return;
+
+    // Leaves under every node, then the [begin, begin + leaves) interval of each one in leaf units
+    float* leaves = (float*)FC_URI_PATH_TREE_REALLOC(NULL, (size_t)count * 2 * sizeof(float));
+    if (!leaves)
+    {
+        tree->failed = true;
+        return;
+    }
+
+    float* begin = leaves + count;
+
+    for (int i = 0; i < count; ++i) leaves[i] = tree->tree_nodes[i].first_child < 0 ? 1.f : 0.f;
+    for (int i = count - 1; i > 0; --i) leaves[tree->tree_nodes[i].parent] += leaves[i];
+
+    begin[0] = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        float next = begin[i];
+
+        for (int child = tree->tree_nodes[i].first_child; child >= 0; child = tree->tree_nodes[child].next_sibling)
+        {
+            begin[child] = next;
+            next += leaves[child];
+        }
+    }
+
+    float total = leaves[0];
+
+    for (int i = 0; i < count; ++i)
+    {
+        float center = begin[i] + 0.5f * leaves[i];
+        float depth = (float)tree->tree_nodes[i].depth;
+
+        if (kind == FC_PATH_TREE_RADIAL) {
+            float angle = 6.28318531f * center / total;
+            tree->nodes[i].position = fc_v2f{ depth * distance * cosf(angle), depth * distance * sinf(angle) };
+        } else {
+            tree->nodes[i].position = fc_v2f{ (center - 0.5f * total) * distance, depth * distance };
+        }
+    }
+
+    FC_URI_PATH_TREE_FREE(leaves);
+}
+
+#endif // FC_URI_PATH_TREE_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
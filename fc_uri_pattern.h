@@ -0,0 +1,645 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_PATTERN_IMPLEMENTATION
+        #include "fc_uri_pattern.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_pattern.h"
+    "
+
+Example:
+    fc_uri_patterns patterns;
+    fc_uri_patterns_init(&patterns);
+
+    fc_uri_patterns_add(&patterns, "https://api.example.com/v*?debug=*", -1, 1);
+    fc_uri_patterns_add(&patterns, "*://ads.*", -1, 2);
+
+    // One scratch per thread, the patterns can be shared once they're all added
+    fc_uri_pattern_scratch scratch = {};
+
+    fc_uri_view uri;
+    fc_uri_parse_view("https://api.example.com/v1?debug=true", -1, &uri);
+
+    uint32_t rules[64];
+    int count = fc_uri_patterns_match(&patterns, &uri, &scratch, rules, 64); // 1, rules = { 1 }
+
+    fc_uri_pattern_scratch_free(&scratch);
+    fc_uri_patterns_free(&patterns);
+
+Info:
+    Matches a URI against many patterns at once and returns the ids of all the rules that match.
+
+    A pattern is "scheme://host:port/path?query", where '*' matches any run of characters inside its component.
+    Components left out of the pattern match anything (so "https://example.com" matches every path), the port
+    is matched as written in the URI, and the fragment is ignored. Scheme and host are compared ignoring case.
+
+    All the patterns of a component are merged in one trie, so a pattern shared by many rules, or a common
+    prefix, is only matched once. The trie is run as an NFA over the component, which costs the number of
+    characters times the number of live states, not the number of patterns.
+    Each rule is then attached to one of its components and only checked when that component matched, by looking
+    up whether its other components matched too. The component is picked when the rule is added: the one whose
+    final node has the fewest rules attached so far, so that rules sharing a host spread over their paths and
+    queries, and a URI only checks the rules that share all of it.
+*/
+
+#ifndef FC_URI_PATTERN
+#define FC_URI_PATTERN
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+#define FC_URI_PATTERN_COMPONENTS 5 // Scheme, host, port, path, query
+
+typedef struct
+{
+    uint32_t star;       // Node reached by a '*', FC_URI_PATTERN_NONE if there isn't one
+    uint32_t first_rule; // Rules attached to the pattern that ends here
+    uint32_t rule_count; // How many
+    bool is_star;        // Loops on any character
+} fc_uri_pattern_node;
+
+typedef struct
+{
+    uint32_t id;
+    uint32_t node[FC_URI_PATTERN_COMPONENTS];
+    uint32_t next; // Next rule attached to the same node
+} fc_uri_pattern_rule;
+
+typedef struct
+{
+    fc_uri_pattern_node* nodes;
+    uint32_t node_count;
+    uint32_t node_capacity;
+
+    uint64_t* edge_keys; // (node << 8 | character) + 1, 0 for empty slots
+    uint32_t* edge_nodes;
+    uint32_t edge_count;
+    uint32_t edge_mask;
+
+    fc_uri_pattern_rule* rules;
+    uint32_t rule_count;
+    uint32_t rule_capacity;
+} fc_uri_patterns;
+
+typedef struct
+{
+    uint32_t* current;
+    uint32_t* next;
+    uint32_t* finals;
+    uint32_t* step_mark;
+    uint32_t* match_mark;
+    uint32_t capacity;
+
+    uint32_t step;
+    uint32_t match;
+} fc_uri_pattern_scratch;
+
+bool fc_uri_patterns_init(fc_uri_patterns* patterns);
+void fc_uri_patterns_free(fc_uri_patterns* patterns);
+
+// Returns false if the pattern is malformed or memory runs out.
+bool fc_uri_patterns_add(fc_uri_patterns* patterns, const char* pattern, int count, uint32_t rule_id);
+
+// Writes up to max_rules matching rule ids, returns how many rules matched (which can be more than max_rules).
+int fc_uri_patterns_match(const fc_uri_patterns* patterns, const fc_uri_view* uri, fc_uri_pattern_scratch* scratch,
+                          uint32_t* rules, int max_rules);
+
+void fc_uri_pattern_scratch_free(fc_uri_pattern_scratch* scratch);
+
+#endif // FC_URI_PATTERN
+
+#ifdef FC_URI_PATTERN_IMPLEMENTATION
+
+#include <string.h> // memset, strlen
+
+#ifndef FC_URI_PATTERN_REALLOC
+#include <stdlib.h>
+#define FC_URI_PATTERN_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_PATTERN_FREE
+#include <stdlib.h>
+#define FC_URI_PATTERN_FREE(ptr)          free(ptr)
+#endif
+
+#define FC_URI_PATTERN_NONE 0xFFFFFFFFu
+
+enum
+{
+    FC_URI_PATTERN_SCHEME,
+    FC_URI_PATTERN_HOST,
+    FC_URI_PATTERN_PORT,
+    FC_URI_PATTERN_PATH,
+    FC_URI_PATTERN_QUERY,
+};
+
+// Among components with as many attached rules, and as many literal characters, the usually more selective first.
+static const int fc_uri_pattern_pivots[FC_URI_PATTERN_COMPONENTS] = {
+    FC_URI_PATTERN_HOST, FC_URI_PATTERN_PATH, FC_URI_PATTERN_QUERY, FC_URI_PATTERN_SCHEME, FC_URI_PATTERN_PORT,
+};
+
+static bool fc_uri_pattern_grow(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity) return true;
+
+    uint32_t grown = *capacity ? *capacity : 64;
+    while (grown < needed) grown *= 2;
+
+    void* resized = FC_URI_PATTERN_REALLOC(*array, (size_t)grown * element_size);
+    if (!resized) return false;
+
+    *array = resized;
+    *capacity = grown;
+
+    return true;
+}
+
+static uint32_t fc_uri_pattern_new_node(fc_uri_patterns* patterns, bool is_star)
+{
+    if (!fc_uri_pattern_grow((void**)&patterns->nodes, &patterns->node_capacity, patterns->node_count + 1, sizeof(fc_uri_pattern_node)))
+    {
+        return FC_URI_PATTERN_NONE;
+    }
+
+    fc_uri_pattern_node* node = &patterns->nodes[patterns->node_count];
+    node->star = FC_URI_PATTERN_NONE;
+    node->first_rule = FC_URI_PATTERN_NONE;
+    node->rule_count = 0;
+    node->is_star = is_star;
+
+    return patterns->node_count++;
+}
+
+static uint64_t fc_uri_pattern_edge_hash(uint64_t key)
+{
+    key *= 0x9E3779B97F4A7C15ull;
+    return key ^ (key >> 29);
+}
+
+static uint32_t fc_uri_pattern_edge(const fc_uri_patterns* patterns, uint32_t node, unsigned char c)
+{
+    uint64_t key = ((uint64_t)node << 8 | c) + 1;
+
+    for (uint64_t slot = fc_uri_pattern_edge_hash(key) & patterns->edge_mask;; slot = (slot + 1) & patterns->edge_mask)
+    {
+        if (patterns->edge_keys[slot] == key) return patterns->edge_nodes[slot];
+        if (patterns->edge_keys[slot] == 0) return FC_URI_PATTERN_NONE;
+    }
+}
+
+static bool fc_uri_pattern_rehash_edges(fc_uri_patterns* patterns)
+{
+    uint32_t slot_count = (patterns->edge_mask + 1) * 2;
+
+    uint64_t* keys  = (uint64_t*)FC_URI_PATTERN_REALLOC(NULL, slot_count * sizeof(uint64_t));
+    uint32_t* nodes = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, slot_count * sizeof(uint32_t));
+
+    if (!keys || !nodes)
+    {
+        FC_URI_PATTERN_FREE(keys);
+        FC_URI_PATTERN_FREE(nodes);
+        return false;
+    }
+
+    memset(keys, 0, slot_count * sizeof(uint64_t));
+
+    for (uint32_t i = 0; i <= patterns->edge_mask; ++i)
+    {
+        if (!patterns->edge_keys[i]) continue;
+
+        uint64_t slot = fc_uri_pattern_edge_hash(patterns->edge_keys[i]) & (slot_count - 1);
+        while (keys[slot]) slot = (slot + 1) & (slot_count - 1);
+
+        keys[slot]  = patterns->edge_keys[i];
+        nodes[slot] = patterns->edge_nodes[i];
+    }
+
+    FC_URI_PATTERN_FREE(patterns->edge_keys);
+    FC_URI_PATTERN_FREE(patterns->edge_nodes);
+
+    patterns->edge_keys  = keys;
+    patterns->edge_nodes = nodes;
+    patterns->edge_mask  = slot_count - 1;
+
+    return true;
+}
+
+static uint32_t fc_uri_pattern_add_edge(fc_uri_patterns* patterns, uint32_t node, unsigned char c)
+{
+    // Keep the table at most half full
+    if ((patterns->edge_count + 1) * 2 > patterns->edge_mask + 1)
+    {
+        if (!fc_uri_pattern_rehash_edges(patterns)) return FC_URI_PATTERN_NONE;
+    }
+
+    uint32_t child = fc_uri_pattern_new_node(patterns, false);
+    if (child == FC_URI_PATTERN_NONE) return FC_URI_PATTERN_NONE;
+
+    uint64_t key = ((uint64_t)node << 8 | c) + 1;
+    uint64_t slot = fc_uri_pattern_edge_hash(key) & patterns->edge_mask;
+
+    while (patterns->edge_keys[slot]) slot = (slot + 1) & patterns->edge_mask;
+
+    patterns->edge_keys[slot]  = key;
+    patterns->edge_nodes[slot] = child;
+    patterns->edge_count++;
+
+    return child;
+}
+
+static char fc_uri_pattern_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+// Adds the glob to the trie of the component, returns the node where it ends.
+static uint32_t fc_uri_pattern_insert(fc_uri_patterns* patterns, int component, const char* glob, int count, bool lowercase)
+{
+    uint32_t node = component; // The roots are the first nodes
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (glob[i] == '*')
+        {
+            if (patterns->nodes[node].is_star) continue; // "**" is the same as "*"
+
+            if (patterns->nodes[node].star == FC_URI_PATTERN_NONE)
+            {
+                uint32_t star = fc_uri_pattern_new_node(patterns, true);
+                if (star == FC_URI_PATTERN_NONE) return FC_URI_PATTERN_NONE;
+
+                patterns->nodes[node].star = star;
+            }
+
+            node = patterns->nodes[node].star;
+            continue;
+        }
+
+        unsigned char c = (unsigned char)(lowercase ? fc_uri_pattern_lower(glob[i]) : glob[i]);
+
+        uint32_t child = fc_uri_pattern_edge(patterns, node, c);
+        if (child == FC_URI_PATTERN_NONE) child = fc_uri_pattern_add_edge(patterns, node, c);
+        if (child == FC_URI_PATTERN_NONE) return FC_URI_PATTERN_NONE;
+
+        node = child;
+    }
+
+    return node;
+}
+
+bool fc_uri_patterns_init(fc_uri_patterns* patterns)
+{
+    memset(patterns, 0, sizeof(*patterns));
+
+    patterns->edge_mask = 63;
+    patterns->edge_keys  = (uint64_t*)FC_URI_PATTERN_REALLOC(NULL, 64 * sizeof(uint64_t));
+    patterns->edge_nodes = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, 64 * sizeof(uint32_t));
+
+    if (!patterns->edge_keys || !patterns->edge_nodes)
+    {
+        fc_uri_patterns_free(patterns);
+        return false;
+    }
+
+    memset(patterns->edge_keys, 0, 64 * sizeof(uint64_t));
+
+    for (int c = 0; c < FC_URI_PATTERN_COMPONENTS; ++c)
+    {
+        if (fc_uri_pattern_new_node(patterns, false) == FC_URI_PATTERN_NONE)
+        {
+            fc_uri_patterns_free(patterns);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void fc_uri_patterns_free(fc_uri_patterns* patterns)
+{
+    FC_URI_PATTERN_FREE(patterns->nodes);
+    FC_URI_PATTERN_FREE(patterns->edge_keys);
+    FC_URI_PATTERN_FREE(patterns->edge_nodes);
+    FC_URI_PATTERN_FREE(patterns->rules);
+
+    memset(patterns, 0, sizeof(*patterns));
+}
+
+bool fc_uri_patterns_add(fc_uri_patterns* patterns, const char* pattern, int count, uint32_t rule_id)
+{
+    if (count < 0) count = (int)strlen(pattern);
+
+    fc_uri_str globs[FC_URI_PATTERN_COMPONENTS];
+    for (int c = 0; c < FC_URI_PATTERN_COMPONENTS; ++c)
+    {
+        globs[c].data  = "*";
+        globs[c].count = 1;
+    }
+
+    const char* cursor = pattern;
+    const char* end = pattern + count;
+
+    // Scheme, optional
+    for (const char* p = cursor; p + 2 < end && *p != '/' && *p != '?'; ++p)
+    {
+        if (p[0] == ':' && p[1] == '/' && p[2] == '/')
+        {
+            globs[FC_URI_PATTERN_SCHEME].data  = cursor;
+            globs[FC_URI_PATTERN_SCHEME].count = (int)(p - cursor);
+            cursor = p + 3;
+            break;
+        }
+    }
+
+    // Authority, up to the path or the query
+    const char* authority = cursor;
+    while (cursor < end && *cursor != '/' && *cursor != '?') ++cursor;
+
+    const char* port = NULL;
+    bool in_brackets = false;
+
+    for (const char* p = authority; p < cursor; ++p)
+    {
+        if (*p == '[') in_brackets = true;
+        if (*p == ']') in_brackets = false;
+        if (*p == ':' && !in_brackets) port = p;
+    }
+
+    if (in_brackets) return false;
+
+    if (cursor > authority)
+    {
+        globs[FC_URI_PATTERN_HOST].data  = authority;
+        globs[FC_URI_PATTERN_HOST].count = (int)((port ? port : cursor) - authority);
+    }
+
+    if (port)
+    {
+        globs[FC_URI_PATTERN_PORT].data  = port + 1;
+        globs[FC_URI_PATTERN_PORT].count = (int)(cursor - port - 1);
+    }
+
+    if (cursor < end && *cursor == '/')
+    {
+        const char* path = cursor;
+        while (cursor < end && *cursor != '?') ++cursor;
+
+        globs[FC_URI_PATTERN_PATH].data  = path;
+        globs[FC_URI_PATTERN_PATH].count = (int)(cursor - path);
+    }
+
+    if (cursor < end && *cursor == '?')
+    {
+        globs[FC_URI_PATTERN_QUERY].data  = cursor + 1;
+        globs[FC_URI_PATTERN_QUERY].count = (int)(end - cursor - 1);
+    }
+
+    if (!fc_uri_pattern_grow((void**)&patterns->rules, &patterns->rule_capacity, patterns->rule_count + 1, sizeof(fc_uri_pattern_rule)))
+    {
+        return false;
+    }
+
+    fc_uri_pattern_rule* rule = &patterns->rules[patterns->rule_count];
+    rule->id = rule_id;
+
+    for (int c = 0; c < FC_URI_PATTERN_COMPONENTS; ++c)
+    {
+        bool lowercase = c == FC_URI_PATTERN_SCHEME || c == FC_URI_PATTERN_HOST;
+
+        rule->node[c] = fc_uri_pattern_insert(patterns, c, globs[c].data, globs[c].count, lowercase);
+        if (rule->node[c] == FC_URI_PATTERN_NONE) return false;
+    }
+
+    // Attach to the component with the fewest rules, then the most literal characters. A "*" matches every URI,
+    // it's only used when the whole pattern is made of them.
+    int pivot = fc_uri_pattern_pivots[0];
+    uint32_t pivot_rules = FC_URI_PATTERN_NONE;
+    int pivot_literals = -1;
+
+    for (int i = 0; i < FC_URI_PATTERN_COMPONENTS; ++i)
+    {
+        int c = fc_uri_pattern_pivots[i];
+
+        int literals = 0;
+        for (int j = 0; j < globs[c].count; ++j) literals += globs[c].data[j] != '*';
+
+        if (!literals) continue;
+
+        uint32_t attached = patterns->nodes[rule->node[c]].rule_count;
+
+        if (attached < pivot_rules || (attached == pivot_rules && literals > pivot_literals))
+        {
+            pivot = c;
+            pivot_rules = attached;
+            pivot_literals = literals;
+        }
+    }
+
+    fc_uri_pattern_node* node = &patterns->nodes[rule->node[pivot]];
+    rule->next = node->first_rule;
+    node->first_rule = patterns->rule_count++;
+    node->rule_count++;
+
+    return true;
+}
+
+void fc_uri_pattern_scratch_free(fc_uri_pattern_scratch* scratch)
+{
+    FC_URI_PATTERN_FREE(scratch->current);
+    FC_URI_PATTERN_FREE(scratch->next);
+    FC_URI_PATTERN_FREE(scratch->finals);
+    FC_URI_PATTERN_FREE(scratch->step_mark);
+    FC_URI_PATTERN_FREE(scratch->match_mark);
+
+    memset(scratch, 0, sizeof(*scratch));
+}
+
+static bool fc_uri_pattern_reserve(fc_uri_pattern_scratch* scratch, uint32_t node_count)
+{
+    if (node_count <= scratch->capacity) return true;
+
+    fc_uri_pattern_scratch_free(scratch);
+
+    scratch->current    = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, node_count * sizeof(uint32_t));
+    scratch->next       = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, node_count * sizeof(uint32_t));
+    scratch->finals     = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, node_count * sizeof(uint32_t));
+    scratch->step_mark  = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, node_count * sizeof(uint32_t));
+    scratch->match_mark = (uint32_t*)FC_URI_PATTERN_REALLOC(NULL, node_count * sizeof(uint32_t));
+
+    if (!scratch->current || !scratch->next || !scratch->finals || !scratch->step_mark || !scratch->match_mark)
+    {
+        fc_uri_pattern_scratch_free(scratch);
+        return false;
+    }
+
+    memset(scratch->step_mark, 0, node_count * sizeof(uint32_t));
+    memset(scratch->match_mark, 0, node_count * sizeof(uint32_t));
+    scratch->capacity = node_count;
+
+    return true;
+}
+
+// Adds node, and the node after a '*' that can match nothing, to the state list.
+static void fc_uri_pattern_add_state(const fc_uri_patterns* patterns, fc_uri_pattern_scratch* scratch, uint32_t* states, uint32_t* count, uint32_t node)
+{
+    if (scratch->step_mark[node] != scratch->step)
+    {
+        scratch->step_mark[node] = scratch->step;
+        states[(*count)++] = node;
+    }
+
+    uint32_t star = patterns->nodes[node].star;
+
+    if (star != FC_URI_PATTERN_NONE && scratch->step_mark[star] != scratch->step)
+    {
+        scratch->step_mark[star] = scratch->step;
+        states[(*count)++] = star;
+    }
+}
+
+static void fc_uri_pattern_next_step(fc_uri_pattern_scratch* scratch)
+{
+    if (++scratch->step == 0)
+    {
+        memset(scratch->step_mark, 0, scratch->capacity * sizeof(uint32_t));
+        scratch->step = 1;
+    }
+}
+
+// Runs the trie of the component over text, returns the states it ends in (in scratch->current).
+static uint32_t fc_uri_pattern_run(const fc_uri_patterns* patterns, fc_uri_pattern_scratch* scratch, int component, fc_uri_str text, bool lowercase)
+{
+    uint32_t count = 0;
+
+    fc_uri_pattern_next_step(scratch);
+    fc_uri_pattern_add_state(patterns, scratch, scratch->current, &count, component);
+
+    for (int i = 0; i < text.count && count; ++i)
+    {
+        unsigned char c = (unsigned char)(lowercase ? fc_uri_pattern_lower(text.data[i]) : text.data[i]);
+
+        uint32_t next_count = 0;
+        fc_uri_pattern_next_step(scratch);
+
+        for (uint32_t s = 0; s < count; ++s)
+        {
+            uint32_t node = scratch->current[s];
+
+            if (patterns->nodes[node].is_star)
+            {
+                fc_uri_pattern_add_state(patterns, scratch, scratch->next, &next_count, node);
+            }
+
+            uint32_t child = fc_uri_pattern_edge(patterns, node, c);
+            if (child != FC_URI_PATTERN_NONE)
+            {
+                fc_uri_pattern_add_state(patterns, scratch, scratch->next, &next_count, child);
+            }
+        }
+
+        uint32_t* swap = scratch->current;
+        scratch->current = scratch->next;
+        scratch->next = swap;
+
+        count = next_count;
+    }
+
+    return count;
+}
+
+int fc_uri_patterns_match(const fc_uri_patterns* patterns, const fc_uri_view* uri, fc_uri_pattern_scratch* scratch,
+                          uint32_t* rules, int max_rules)
+{
+    if (!fc_uri_pattern_reserve(scratch, patterns->node_count)) return 0;
+
+    if (++scratch->match == 0)
+    {
+        memset(scratch->match_mark, 0, scratch->capacity * sizeof(uint32_t));
+        scratch->match = 1;
+    }
+
+    fc_uri_str texts[FC_URI_PATTERN_COMPONENTS] = { uri->scheme, uri->host, uri->port, uri->path, uri->query };
+
+    // An empty path after an authority is the same as "/"
+    if (uri->host.data && texts[FC_URI_PATTERN_PATH].count == 0)
+    {
+        texts[FC_URI_PATTERN_PATH].data  = "/";
+        texts[FC_URI_PATTERN_PATH].count = 1;
+    }
+
+    // The tries of the components don't share nodes, so all the final states fit in one list.
+    // Every component has to be run before checking rules, a rule needs all of its components marked.
+    uint32_t final_count = 0;
+
+    for (int c = 0; c < FC_URI_PATTERN_COMPONENTS; ++c)
+    {
+        if (!texts[c].data) texts[c].count = 0;
+
+        bool lowercase = c == FC_URI_PATTERN_SCHEME || c == FC_URI_PATTERN_HOST;
+        uint32_t count = fc_uri_pattern_run(patterns, scratch, c, texts[c], lowercase);
+
+        for (uint32_t s = 0; s < count; ++s)
+        {
+            scratch->match_mark[scratch->current[s]] = scratch->match;
+            scratch->finals[final_count++] = scratch->current[s];
+        }
+    }
+
+    int matched = 0;
+
+    for (uint32_t s = 0; s < final_count; ++s)
+    {
+        for (uint32_t r = patterns->nodes[scratch->finals[s]].first_rule; r != FC_URI_PATTERN_NONE; r = patterns->rules[r].next)
+        {
+            const fc_uri_pattern_rule* rule = &patterns->rules[r];
+
+            bool all = true;
+            for (int c = 0; c < FC_URI_PATTERN_COMPONENTS && all; ++c)
+            {
+                all = scratch->match_mark[rule->node[c]] == scratch->match;
+            }
+
+            if (!all) continue;
+
+            if (matched < max_rules) rules[matched] = rule->id;
+            ++matched;
+        }
+    }
+
+    return matched;
+}
+
+#endif // FC_URI_PATTERN_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
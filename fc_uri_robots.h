@@ -0,0 +1,683 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_ROBOTS_IMPLEMENTATION
+        #include "fc_uri_robots.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_robots.h"
+    "
+
+Example:
+    fc_robots_cache cache;
+    fc_robots_cache_init(&cache);
+
+    // When robots.txt for a host has been fetched
+    fc_robots robots;
+    fc_robots_parse(&robots, robots_txt, robots_txt_length, "FooBot");
+    fc_robots_cache_put(&cache, host_id, &robots); // The cache takes ownership
+
+    // Before every fetch, from any thread
+    fc_uri_view uri;
+    fc_uri_parse_view(url, url_length, &uri);
+
+    bool allowed;
+    if (!fc_robots_cache_check(&cache, host_id, &uri, &allowed))
+    {
+        // Not in the cache yet, fetch robots.txt first
+    }
+
+    fc_robots_cache_free(&cache);
+
+Info:
+    robots.txt parser and matcher following RFC 9309.
+
+    fc_robots_parse keeps the rules of the groups for the given user agent (matched case insensitively on the
+    product token), or of the "*" groups if no group names it. Groups with the same user agent are merged.
+    The crawl-delay of the group is kept too, in milliseconds, FC_ROBOTS_NO_DELAY if there isn't one.
+
+    A path is checked against path and query ("/" for an empty path), the longest matching rule wins and allow
+    wins ties, /robots.txt is always allowed. Rules are compared byte for byte, without decoding percent-encoding.
+
+    Rules without wildcards, usually almost all of them, are merged in a trie that is walked once along the path.
+    Rules with '*' or '$' are sorted by length and only tried while they could beat the best match so far, each
+    one matches its pieces between '*' greedily left to right, which never needs to backtrack.
+    Checking doesn't allocate.
+
+    fc_robots_cache keeps the compiled rules per host id (see fc_uri_frontier.h), behind a read-write lock.
+    Requires POSIX threads.
+*/
+
+#ifndef FC_URI_ROBOTS
+#define FC_URI_ROBOTS
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <pthread.h>
+
+#define FC_ROBOTS_NO_DELAY 0xFFFFFFFFu
+
+typedef struct
+{
+    uint32_t first_child;
+    uint32_t next_sibling;
+    char c;
+    uint8_t verdict; // Rules that end here
+} fc_robots_node;
+
+typedef struct
+{
+    uint32_t offset;
+    uint32_t count; // Including '*' and '$', this is what longest match compares
+    bool allow;
+} fc_robots_wildcard;
+
+typedef struct
+{
+    fc_robots_node* nodes; // nodes[0] is the root
+    uint32_t node_count;
+    uint32_t node_capacity;
+
+    fc_robots_wildcard* wildcards;
+    uint32_t wildcard_count;
+    uint32_t wildcard_capacity;
+
+    char* patterns;
+    uint32_t patterns_count;
+    uint32_t patterns_capacity;
+
+    uint32_t crawl_delay; // Milliseconds
+} fc_robots;
+
+typedef struct
+{
+    uint32_t key; // Host id + 1, 0 for empty slots
+    fc_robots robots;
+} fc_robots_cache_entry;
+
+typedef struct
+{
+    pthread_rwlock_t lock;
+
+    fc_robots_cache_entry* entries;
+    uint32_t entry_count;
+    uint32_t mask;
+} fc_robots_cache;
+
+// user_agent is the product token of the crawler, e.g. "FooBot". Returns false if memory runs out.
+bool fc_robots_parse(fc_robots* robots, const char* text, int count, const char* user_agent);
+void fc_robots_free(fc_robots* robots);
+
+bool fc_robots_allowed(const fc_robots* robots, const fc_uri_view* uri);
+
+bool fc_robots_cache_init(fc_robots_cache* cache);
+void fc_robots_cache_free(fc_robots_cache* cache);
+
+// Takes ownership of robots, replacing the rules the host had.
+bool fc_robots_cache_put(fc_robots_cache* cache, uint32_t host_id, fc_robots* robots);
+
+// Returns false if the host has no rules in the cache.
+bool fc_robots_cache_check(fc_robots_cache* cache, uint32_t host_id, const fc_uri_view* uri, bool* allowed);
+
+#endif // FC_URI_ROBOTS
+
+#ifdef FC_URI_ROBOTS_IMPLEMENTATION
+
+#include <string.h> // memset, memcpy, strlen
+#include <stdlib.h> // qsort, realloc
+
+#ifndef FC_URI_ROBOTS_REALLOC
+#define FC_URI_ROBOTS_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_ROBOTS_FREE
+#define FC_URI_ROBOTS_FREE(ptr)          free(ptr)
+#endif
+
+#define FC_ROBOTS_NONE 0xFFFFFFFFu
+
+enum
+{
+    FC_ROBOTS_ALLOW    = 1 << 0,
+    FC_ROBOTS_DISALLOW = 1 << 1,
+};
+
+static bool fc_robots_grow(void** array, uint32_t* capacity, uint32_t needed, size_t element_size)
+{
+    if (needed <= *capacity) return true;
+
+    uint32_t grown = *capacity ? *capacity : 16;
+    while (grown < needed) grown *= 2;
+
+    void* resized = FC_URI_ROBOTS_REALLOC(*array, (size_t)grown * element_size);
+    if (!resized) return false;
+
+    *array = resized;
+    *capacity = grown;
+
+    return true;
+}
+
+static char fc_robots_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+static bool fc_robots_equals_nocase(const char* a, int a_count, const char* b, int b_count)
+{
+    if (a_count != b_count) return false;
+
+    for (int i = 0; i < a_count; ++i)
+    {
+        if (fc_robots_lower(a[i]) != fc_robots_lower(b[i])) return false;
+    }
+
+    return true;
+}
+
+static uint32_t fc_robots_new_node(fc_robots* robots, char c)
+{
+    if (!fc_robots_grow((void**)&robots->nodes, &robots->node_capacity, robots->node_count + 1, sizeof(fc_robots_node)))
+    {
+        return FC_ROBOTS_NONE;
+    }
+
+    fc_robots_node* node = &robots->nodes[robots->node_count];
+    node->first_child = FC_ROBOTS_NONE;
+    node->next_sibling = FC_ROBOTS_NONE;
+    node->c = c;
+    node->verdict = 0;
+
+    return robots->node_count++;
+}
+
+static uint32_t fc_robots_child(const fc_robots* robots, uint32_t node, char c)
+{
+    for (uint32_t child = robots->nodes[node].first_child; child != FC_ROBOTS_NONE; child = robots->nodes[child].next_sibling)
+    {
+        if (robots->nodes[child].c == c) return child;
+    }
+
+    return FC_ROBOTS_NONE;
+}
+
+static bool fc_robots_add_rule(fc_robots* robots, const char* pattern, int count, bool allow)
+{
+    bool wildcard = false;
+    for (int i = 0; i < count; ++i) wildcard |= pattern[i] == '*' || pattern[i] == '$';
+
+    if (wildcard)
+    {
+        if (!fc_robots_grow((void**)&robots->patterns, &robots->patterns_capacity, robots->patterns_count + count, 1) ||
+            !fc_robots_grow((void**)&robots->wildcards, &robots->wildcard_capacity, robots->wildcard_count + 1, sizeof(fc_robots_wildcard)))
+        {
+            return false;
+        }
+
+        fc_robots_wildcard* rule = &robots->wildcards[robots->wildcard_count++];
+        rule->offset = robots->patterns_count;
+        rule->count = count;
+        rule->allow = allow;
+
+        memcpy(robots->patterns + robots->patterns_count, pattern, count);
+        robots->patterns_count += count;
+
+        return true;
+    }
+
+    uint32_t node = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        uint32_t child = fc_robots_child(robots, node, pattern[i]);
+
+        if (child == FC_ROBOTS_NONE)
+        {
+            child = fc_robots_new_node(robots, pattern[i]);
+            if (child == FC_ROBOTS_NONE) return false;
+
+            robots->nodes[child].next_sibling = robots->nodes[node].first_child;
+            robots->nodes[node].first_child = child;
+        }
+
+        node = child;
+    }
+
+    robots->nodes[node].verdict |= allow ? FC_ROBOTS_ALLOW : FC_ROBOTS_DISALLOW;
+
+    return true;
+}
+
+static int fc_robots_compare_wildcards(const void* a, const void* b)
+{
+    const fc_robots_wildcard* x = (const fc_robots_wildcard*)a;
+    const fc_robots_wildcard* y = (const fc_robots_wildcard*)b;
+
+    // Longest first, allow first among equals
+    if (x->count != y->count) return x->count > y->count ? -1 : 1;
+    if (x->allow != y->allow) return x->allow ? -1 : 1;
+
+    return 0;
+}
+
+// Trims spaces and tabs from both ends.
+static void fc_robots_trim(const char** begin, const char** end)
+{
+    while (*begin < *end && (**begin == ' ' || **begin == '\t')) ++*begin;
+    while (*end > *begin && ((*end)[-1] == ' ' || (*end)[-1] == '\t' || (*end)[-1] == '\r')) --*end;
+}
+
+bool fc_robots_parse(fc_robots* robots, const char* text, int count, const char* user_agent)
+{
+    memset(robots, 0, sizeof(*robots));
+    robots->crawl_delay = FC_ROBOTS_NO_DELAY;
+
+    if (count < 0) count = (int)strlen(text);
+
+    int agent_count = (int)strlen(user_agent);
+
+    if (fc_robots_new_node(robots, 0) == FC_ROBOTS_NONE) return false;
+
+    // First pass finds out whether any group names us, the second one adds the rules of the groups that apply.
+    bool specific = false;
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        bool in_agents = false; // The previous relevant line was a user-agent
+        bool group_specific = false;
+        bool group_star = false;
+
+        for (int begin = 0; begin < count;)
+        {
+            int end = begin;
+            while (end < count && text[end] != '\n') ++end;
+
+            const char* line = text + begin;
+            const char* line_end = text + end;
+            begin = end + 1;
+
+            for (const char* p = line; p < line_end; ++p)
+            {
+                if (*p == '#')
+                {
+                    line_end = p;
+                    break;
+                }
+            }
+
+            const char* colon = line;
+            while (colon < line_end && *colon != ':') ++colon;
+            if (colon == line_end) continue;
+
+            const char* key = line;
+            const char* key_end = colon;
+            const char* value = colon + 1;
+            const char* value_end = line_end;
+
+            fc_robots_trim(&key, &key_end);
+            fc_robots_trim(&value, &value_end);
+
+            int key_count = (int)(key_end - key);
+            int value_count = (int)(value_end - value);
+
+            if (fc_robots_equals_nocase(key, key_count, "user-agent", 10))
+            {
+                if (!in_agents)
+                {
+                    group_specific = false;
+                    group_star = false;
+                }
+
+                in_agents = true;
+
+                // Only the product token counts
+                int token_count = 0;
+                while (token_count < value_count)
+                {
+                    char c = fc_robots_lower(value[token_count]);
+                    if (!((c >= 'a' && c <= 'z') || c == '_' || c == '-' || c == '*')) break;
+                    ++token_count;
+                }
+
+                if (fc_robots_equals_nocase(value, token_count, user_agent, agent_count)) {
+                    group_specific = true;
+                    specific = true;
+                } else if (token_count == 1 && value[0] == '*') {
+                    group_star = true;
+                }
+
+                continue;
+            }
+
+            bool allow = fc_robots_equals_nocase(key, key_count, "allow", 5);
+            bool disallow = fc_robots_equals_nocase(key, key_count, "disallow", 8);
+            bool delay = fc_robots_equals_nocase(key, key_count, "crawl-delay", 11);
+
+            if (!allow && !disallow && !delay) continue; // Sitemap and unknown lines don't end the user-agent lines
+
+            in_agents = false;
+
+            if (pass == 0) continue;
+            if (!(specific ? group_specific : group_star)) continue;
+
+            if (delay)
+            {
+                // Seconds, possibly with a fraction
+                uint64_t milliseconds = 0;
+                int i = 0;
+
+                while (i < value_count && value[i] >= '0' && value[i] <= '9' && milliseconds < 0xFFFFFFFFull)
+                {
+                    milliseconds = milliseconds * 10 + (value[i++] - '0') * 1000;
+                }
+
+                if (i < value_count && value[i] == '.')
+                {
+                    uint64_t scale = 100;
+                    for (++i; i < value_count && value[i] >= '0' && value[i] <= '9' && scale; ++i, scale /= 10)
+                    {
+                        milliseconds += (value[i] - '0') * scale;
+                    }
+                }
+
+                if (i > 0 && milliseconds < FC_ROBOTS_NO_DELAY) robots->crawl_delay = (uint32_t)milliseconds;
+                continue;
+            }
+
+            // Empty rules match nothing, rules have to start with '/' or '*'
+            if (value_count == 0 || (value[0] != '/' && value[0] != '*')) continue;
+
+            if (!fc_robots_add_rule(robots, value, value_count, allow))
+            {
+                fc_robots_free(robots);
+                return false;
+            }
+        }
+    }
+
+    if (robots->wildcard_count)
+    {
+        qsort(robots->wildcards, robots->wildcard_count, sizeof(fc_robots_wildcard), fc_robots_compare_wildcards);
+    }
+
+    return true;
+}
+
+void fc_robots_free(fc_robots* robots)
+{
+    FC_URI_ROBOTS_FREE(robots->nodes);
+    FC_URI_ROBOTS_FREE(robots->wildcards);
+    FC_URI_ROBOTS_FREE(robots->patterns);
+
+    memset(robots, 0, sizeof(*robots));
+}
+
+// Path and query seen as one string, without copying them together.
+typedef struct
+{
+    fc_uri_str path;
+    fc_uri_str query;
+    int count;
+} fc_robots_target;
+
+static char fc_robots_at(const fc_robots_target* target, int i)
+{
+    if (i < target->path.count) return target->path.data[i];
+    if (i == target->path.count) return '?';
+
+    return target->query.data[i - target->path.count - 1];
+}
+
+static bool fc_robots_piece_at(const fc_robots_target* target, int at, const char* piece, int count)
+{
+    if (at + count > target->count) return false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (fc_robots_at(target, at + i) != piece[i]) return false;
+    }
+
+    return true;
+}
+
+// First position from at where piece is, -1 if there's none.
+static int fc_robots_find(const fc_robots_target* target, int at, const char* piece, int count)
+{
+    for (; at + count <= target->count; ++at)
+    {
+        if (fc_robots_piece_at(target, at, piece, count)) return at;
+    }
+
+    return -1;
+}
+
+// Pieces between '*' are matched at their first occurrence after the previous one, a later one could only
+// leave less room for what follows. The last piece of a '$' rule has to end the target instead.
+static bool fc_robots_wildcard_matches(const char* pattern, int count, const fc_robots_target* target)
+{
+    bool anchored = count > 0 && pattern[count - 1] == '$';
+    if (anchored) --count;
+
+    int end = 0;
+    while (end < count && pattern[end] != '*') ++end;
+
+    if (!fc_robots_piece_at(target, 0, pattern, end)) return false;
+    if (end == count) return !anchored || end == target->count;
+
+    int at = end;
+
+    for (int begin = end + 1;; begin = end + 1)
+    {
+        end = begin;
+        while (end < count && pattern[end] != '*') ++end;
+
+        const char* piece = pattern + begin;
+        int piece_count = end - begin;
+
+        if (end == count && anchored)
+        {
+            int last = target->count - piece_count;
+            return last >= at && fc_robots_piece_at(target, last, piece, piece_count);
+        }
+
+        at = fc_robots_find(target, at, piece, piece_count);
+        if (at < 0) return false;
+        if (end == count) return true;
+
+        at += piece_count;
+    }
+}
+
+bool fc_robots_allowed(const fc_robots* robots, const fc_uri_view* uri)
+{
+    fc_robots_target target;
+    target.path = uri->path;
+    target.query = uri->query;
+
+    if (!target.path.data || target.path.count == 0)
+    {
+        target.path.data = "/";
+        target.path.count = 1;
+    }
+
+    if (!target.query.data) target.query.count = -1; // No '?'
+
+    target.count = target.path.count + target.query.count + 1;
+
+    if (target.query.count < 0 && fc_robots_equals_nocase(target.path.data, target.path.count, "/robots.txt", 11)) return true;
+
+    int best = -1;
+    bool best_allow = true;
+
+    // Walk the trie along the target, every node with a verdict is a longer match
+    uint32_t node = 0;
+
+    for (int i = 0; i < target.count && robots->node_count; ++i)
+    {
+        node = fc_robots_child(robots, node, fc_robots_at(&target, i));
+        if (node == FC_ROBOTS_NONE) break;
+
+        uint8_t verdict = robots->nodes[node].verdict;
+
+        if (verdict)
+        {
+            best = i + 1;
+            best_allow = (verdict & FC_ROBOTS_ALLOW) != 0;
+        }
+    }
+
+    for (uint32_t w = 0; w < robots->wildcard_count; ++w)
+    {
+        const fc_robots_wildcard* rule = &robots->wildcards[w];
+
+        if ((int)rule->count < best) break;
+        if ((int)rule->count == best && (best_allow || !rule->allow)) break;
+
+        if (fc_robots_wildcard_matches(robots->patterns + rule->offset, rule->count, &target))
+        {
+            best = rule->count;
+            best_allow = rule->allow;
+            break;
+        }
+    }
+
+    return best_allow;
+}
+
+bool fc_robots_cache_init(fc_robots_cache* cache)
+{
+    cache->entry_count = 0;
+    cache->mask = 63;
+    cache->entries = (fc_robots_cache_entry*)FC_URI_ROBOTS_REALLOC(NULL, 64 * sizeof(fc_robots_cache_entry));
+
+    if (!cache->entries) return false;
+
+    memset(cache->entries, 0, 64 * sizeof(fc_robots_cache_entry));
+    pthread_rwlock_init(&cache->lock, NULL);
+
+    return true;
+}
+
+void fc_robots_cache_free(fc_robots_cache* cache)
+{
+    if (!cache->entries) return;
+
+    for (uint32_t i = 0; i <= cache->mask; ++i)
+    {
+        if (cache->entries[i].key) fc_robots_free(&cache->entries[i].robots);
+    }
+
+    FC_URI_ROBOTS_FREE(cache->entries);
+    cache->entries = NULL;
+
+    pthread_rwlock_destroy(&cache->lock);
+}
+
+static uint32_t fc_robots_cache_slot(const fc_robots_cache_entry* entries, uint32_t mask, uint32_t key)
+{
+    uint32_t slot = (key * 0x9E3779B1u) & mask;
+    while (entries[slot].key && entries[slot].key != key) slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+bool fc_robots_cache_put(fc_robots_cache* cache, uint32_t host_id, fc_robots* robots)
+{
+    uint32_t key = host_id + 1;
+
+    pthread_rwlock_wrlock(&cache->lock);
+
+    // Keep the table at most half full
+    if ((cache->entry_count + 1) * 2 > cache->mask + 1)
+    {
+        uint32_t slot_count = (cache->mask + 1) * 2;
+
+        fc_robots_cache_entry* entries = (fc_robots_cache_entry*)FC_URI_ROBOTS_REALLOC(NULL, slot_count * sizeof(fc_robots_cache_entry));
+        if (!entries)
+        {
+            pthread_rwlock_unlock(&cache->lock);
+            return false;
+        }
+
+        memset(entries, 0, slot_count * sizeof(fc_robots_cache_entry));
+
+        for (uint32_t i = 0; i <= cache->mask; ++i)
+        {
+            if (cache->entries[i].key)
+            {
+                entries[fc_robots_cache_slot(entries, slot_count - 1, cache->entries[i].key)] = cache->entries[i];
+            }
+        }
+
+        FC_URI_ROBOTS_FREE(cache->entries);
+        cache->entries = entries;
+        cache->mask = slot_count - 1;
+    }
+
+    fc_robots_cache_entry* entry = &cache->entries[fc_robots_cache_slot(cache->entries, cache->mask, key)];
+
+    if (entry->key) {
+        fc_robots_free(&entry->robots);
+    } else {
+        cache->entry_count++;
+    }
+
+    entry->key = key;
+    entry->robots = *robots;
+
+    pthread_rwlock_unlock(&cache->lock);
+
+    memset(robots, 0, sizeof(*robots));
+
+    return true;
+}
+
+bool fc_robots_cache_check(fc_robots_cache* cache, uint32_t host_id, const fc_uri_view* uri, bool* allowed)
+{
+    uint32_t key = host_id + 1;
+
+    pthread_rwlock_rdlock(&cache->lock);
+
+    const fc_robots_cache_entry* entry = &cache->entries[fc_robots_cache_slot(cache->entries, cache->mask, key)];
+    bool found = entry->key == key;
+
+    if (found) *allowed = fc_robots_allowed(&entry->robots, uri);
+
+    pthread_rwlock_unlock(&cache->lock);
+
+    return found;
+}
+
+#endif // FC_URI_ROBOTS_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
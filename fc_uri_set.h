@@ -0,0 +1,540 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_SET_IMPLEMENTATION
+        #include "fc_uri_set.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_set.h"
+    "
+
+Example:
+    // uris are normalized strings, see fc_uri_normalize. Order and duplicates don't matter.
+    fc_uri_set set;
+    fc_uri_set_build(&set, uris, uri_count, 16);
+    fc_uri_set_write(&set, "seen.set");
+    fc_uri_set_free(&set);
+
+    fc_uri_set seen;
+    fc_uri_set_map(&seen, "seen.set");
+
+    if (fc_uri_set_contains(&seen, "https://example.com/", 20)) { ... }
+
+    fc_uri_set_iterator it;
+    fc_uri_set_prefix(&seen, "https://example.com/", 20, &it);
+
+    fc_uri_str uri;
+    while (fc_uri_set_next(&it, &uri))
+    {
+        // Every element starting with "https://example.com/", in order
+    }
+
+Info:
+    Immutable sorted set of strings, front coded in blocks: the first string of a block is stored whole,
+    the others as the length of the prefix they share with the previous one and the rest of the bytes.
+    Sorted URIs share long prefixes so this takes a fraction of the plain strings.
+
+    Lookups binary search the first strings of the blocks and scan one block, so they are O(log n).
+    The in-memory and on-disk layouts are the same, fc_uri_set_map just maps the file. All integers are
+    little-endian varints except the header and the block offsets, which are in native byte order:
+        "FCURISET", uint64 count, uint32 block_size, uint32 block_count, uint64 data_size,
+        uint64 block_offsets[block_count], data[data_size]
+
+    Elements can be up to FC_URI_MAX bytes long, longer ones are skipped while building.
+*/
+
+#ifndef FC_URI_SET
+#define FC_URI_SET
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct
+{
+    int64_t  count;
+    uint32_t block_size;
+    uint32_t block_count;
+
+    const uint64_t* block_offsets;
+    const uint8_t*  data;
+    uint64_t        data_size;
+
+    // Internal
+    void*  image;
+    size_t image_size;
+    bool   mapped;
+} fc_uri_set;
+
+typedef struct
+{
+    const fc_uri_set* set;
+
+    int64_t index;
+    uint64_t position; // Of the next element in data
+
+    const char* prefix;
+    int prefix_count;
+
+    char current[FC_URI_MAX + 1];
+    int  current_count;
+} fc_uri_set_iterator;
+
+bool fc_uri_set_build(fc_uri_set* set, const fc_uri_str* uris, int64_t count, int block_size);
+bool fc_uri_set_write(const fc_uri_set* set, const char* path);
+bool fc_uri_set_map(fc_uri_set* set, const char* path);
+void fc_uri_set_free(fc_uri_set* set);
+
+bool fc_uri_set_contains(const fc_uri_set* set, const char* uri, int count);
+
+// Number of elements smaller than uri.
+int64_t fc_uri_set_rank(const fc_uri_set* set, const char* uri, int count);
+
+// Writes the element at index into dst, returns its length or -1 if index is out of range or dst is too small.
+int fc_uri_set_select(const fc_uri_set* set, int64_t index, char* dst, int dst_size);
+
+// Iterates the elements starting with prefix, an empty prefix iterates the whole set.
+void fc_uri_set_prefix(const fc_uri_set* set, const char* prefix, int prefix_count, fc_uri_set_iterator* it);
+bool fc_uri_set_next(fc_uri_set_iterator* it, fc_uri_str* uri);
+
+#endif // FC_URI_SET
+
+#ifdef FC_URI_SET_IMPLEMENTATION
+
+#include <string.h>   // memcmp, memcpy
+#include <stdio.h>    // FILE
+#include <fcntl.h>    // open
+#include <unistd.h>   // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+
+#ifndef FC_URI_SET_MALLOC
+#include <stdlib.h>
+#define FC_URI_SET_MALLOC(size) malloc(size)
+#endif
+#ifndef FC_URI_SET_FREE
+#include <stdlib.h>
+#define FC_URI_SET_FREE(ptr)    free(ptr)
+#endif
+
+#define FC_URI_SET_HEADER_SIZE 32
+
+static const char fc_uri_set_magic[8] = { 'F', 'C', 'U', 'R', 'I', 'S', 'E', 'T' };
+
+static int fc_uri_set_compare(const char* a, int a_count, const char* b, int b_count)
+{
+    int common = a_count < b_count ? a_count : b_count;
+    int result = memcmp(a, b, common);
+
+    if (result) return result;
+    return a_count - b_count;
+}
+
+static int fc_uri_set_sort_compare(const void* a, const void* b)
+{
+    const fc_uri_str* x = (const fc_uri_str*)a;
+    const fc_uri_str* y = (const fc_uri_str*)b;
+    return fc_uri_set_compare(x->data, x->count, y->data, y->count);
+}
+
+static int fc_uri_set_varint_size(uint64_t value)
+{
+    int size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+static uint8_t* fc_uri_set_write_varint(uint8_t* dst, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *dst++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *dst++ = (uint8_t)value;
+    return dst;
+}
+
+static uint64_t fc_uri_set_read_varint(const uint8_t* data, uint64_t* position)
+{
+    uint64_t value = 0;
+    int shift = 0;
+
+    for (;;)
+    {
+        uint8_t byte = data[(*position)++];
+        value |= (uint64_t)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80)) return value;
+        shift += 7;
+    }
+}
+
+static int fc_uri_set_shared_prefix(fc_uri_str a, fc_uri_str b)
+{
+    int i = 0;
+    while (i < a.count && i < b.count && a.data[i] == b.data[i]) i++;
+    return i;
+}
+
+// Sets the pointers into the image, which starts with the header.
+static bool fc_uri_set_attach(fc_uri_set* set)
+{
+    const uint8_t* image = (const uint8_t*)set->image;
+
+    if (set->image_size < FC_URI_SET_HEADER_SIZE || memcmp(image, fc_uri_set_magic, 8) != 0) return false;
+
+    memcpy(&set->count,       image + 8,  8);
+    memcpy(&set->block_size,  image + 16, 4);
+    memcpy(&set->block_count, image + 20, 4);
+    memcpy(&set->data_size,   image + 24, 8);
+
+    uint64_t expected = FC_URI_SET_HEADER_SIZE + (uint64_t)set->block_count * 8 + set->data_size;
+    if (expected > set->image_size || set->block_size == 0) return false;
+    if ((uint64_t)set->block_count != ((uint64_t)set->count + set->block_size - 1) / set->block_size) return false;
+
+    set->block_offsets = (const uint64_t*)(image + FC_URI_SET_HEADER_SIZE);
+    set->data          = image + FC_URI_SET_HEADER_SIZE + (uint64_t)set->block_count * 8;
+
+    return true;
+}
+
+bool fc_uri_set_build(fc_uri_set* set, const fc_uri_str* uris, int64_t count, int block_size)
+{
+    *set = fc_uri_set{};
+
+    if (block_size < 1) block_size = 16;
+
+    fc_uri_str* sorted = (fc_uri_str*)FC_URI_SET_MALLOC((count ? count : 1) * sizeof(fc_uri_str));
+    if (!sorted) return false;
+
+    int64_t unique = 0;
+    for (int64_t i = 0; i < count; ++i)
+    {
+        if (uris[i].count <= FC_URI_MAX) sorted[unique++] = uris[i];
+    }
+
+    qsort(sorted, unique, sizeof(fc_uri_str), fc_uri_set_sort_compare);
+
+    int64_t kept = 0;
+    for (int64_t i = 0; i < unique; ++i)
+    {
+        if (kept && fc_uri_set_compare(sorted[kept - 1].data, sorted[kept - 1].count, sorted[i].data, sorted[i].count) == 0) continue;
+        sorted[kept++] = sorted[i];
+    }
+
+    // Exact size first, so that the image is allocated once.
+    uint32_t block_count = (uint32_t)((kept + block_size - 1) / block_size);
+    uint64_t data_size = 0;
+
+    for (int64_t i = 0; i < kept; ++i)
+    {
+        if (i % block_size == 0)
+        {
+            data_size += fc_uri_set_varint_size(sorted[i].count) + sorted[i].count;
+        }
+        else {
+            int shared = fc_uri_set_shared_prefix(sorted[i - 1], sorted[i]);
+            data_size += fc_uri_set_varint_size(shared) + fc_uri_set_varint_size(sorted[i].count - shared) + sorted[i].count - shared;
+        }
+    }
+
+    set->image_size = FC_URI_SET_HEADER_SIZE + (size_t)block_count * 8 + data_size;
+    set->image = FC_URI_SET_MALLOC(set->image_size);
+    if (!set->image)
+    {
+        FC_URI_SET_FREE(sorted);
+        return false;
+    }
+
+    uint8_t* image = (uint8_t*)set->image;
+    uint32_t block_size32 = (uint32_t)block_size;
+
+    memcpy(image,      fc_uri_set_magic, 8);
+    memcpy(image + 8,  &kept,            8);
+    memcpy(image + 16, &block_size32,    4);
+    memcpy(image + 20, &block_count,     4);
+    memcpy(image + 24, &data_size,       8);
+
+    uint64_t* block_offsets = (uint64_t*)(image + FC_URI_SET_HEADER_SIZE);
+    uint8_t* data = image + FC_URI_SET_HEADER_SIZE + (size_t)block_count * 8;
+    uint8_t* cursor = data;
+
+    for (int64_t i = 0; i < kept; ++i)
+    {
+        int shared = 0;
+
+        if (i % block_size == 0)
+        {
+            block_offsets[i / block_size] = cursor - data;
+        }
+        else {
+            shared = fc_uri_set_shared_prefix(sorted[i - 1], sorted[i]);
+            cursor = fc_uri_set_write_varint(cursor, shared);
+        }
+
+        cursor = fc_uri_set_write_varint(cursor, sorted[i].count - shared);
+        memcpy(cursor, sorted[i].data + shared, sorted[i].count - shared);
+        cursor += sorted[i].count - shared;
+    }
+
+    FC_URI_SET_FREE(sorted);
+
+    return fc_uri_set_attach(set);
+}
+
+bool fc_uri_set_write(const fc_uri_set* set, const char* path)
+{
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+
+    bool ok = fwrite(set->image, set->image_size, 1, out) == 1;
+
+    return fclose(out) == 0 && ok;
+}
+
+bool fc_uri_set_map(fc_uri_set* set, const char* path)
+{
+    *set = fc_uri_set{};
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < FC_URI_SET_HEADER_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED) return false;
+
+    set->image      = mapping;
+    set->image_size = info.st_size;
+    set->mapped     = true;
+
+    if (!fc_uri_set_attach(set))
+    {
+        fc_uri_set_free(set);
+        return false;
+    }
+
+    return true;
+}
+
+void fc_uri_set_free(fc_uri_set* set)
+{
+    if (set->mapped)
+    {
+        munmap(set->image, set->image_size);
+    }
+    else if (set->image) {
+        FC_URI_SET_FREE(set->image);
+    }
+
+    *set = fc_uri_set{};
+}
+
+// Decodes the element at *position into buffer, which holds the previous element of the block.
+static int fc_uri_set_decode(const fc_uri_set* set, int64_t index, uint64_t* position, char* buffer, int previous_count)
+{
+    int shared = 0;
+    if (index % set->block_size != 0)
+    {
+        shared = (int)fc_uri_set_read_varint(set->data, position);
+        if (shared > previous_count) shared = previous_count;
+    }
+
+    int suffix = (int)fc_uri_set_read_varint(set->data, position);
+    if (shared + suffix > FC_URI_MAX) suffix = FC_URI_MAX - shared;
+
+    memcpy(buffer + shared, set->data + *position, suffix);
+    *position += suffix;
+
+    return shared + suffix;
+}
+
+// Last block whose first element is <= uri, or -1 when uri comes before every element.
+static int64_t fc_uri_set_find_block(const fc_uri_set* set, const char* uri, int count)
+{
+    int64_t lo = 0;
+    int64_t hi = (int64_t)set->block_count - 1;
+    int64_t found = -1;
+
+    while (lo <= hi)
+    {
+        int64_t mid = lo + (hi - lo) / 2;
+
+        uint64_t position = set->block_offsets[mid];
+        uint64_t head_count = fc_uri_set_read_varint(set->data, &position);
+
+        if (fc_uri_set_compare((const char*)set->data + position, (int)head_count, uri, count) <= 0)
+        {
+            found = mid;
+            lo = mid + 1;
+        }
+        else {
+            hi = mid - 1;
+        }
+    }
+
+    return found;
+}
+
+// Rank of uri, *found tells whether the element at the rank is uri itself.
+static int64_t fc_uri_set_lower_bound(const fc_uri_set* set, const char* uri, int count, bool* found)
+{
+    *found = false;
+
+    int64_t block = fc_uri_set_find_block(set, uri, count);
+    if (block < 0) return 0;
+
+    char buffer[FC_URI_MAX + 1];
+    int buffer_count = 0;
+
+    uint64_t position = set->block_offsets[block];
+    int64_t index = block * set->block_size;
+    int64_t block_end = index + set->block_size < set->count ? index + set->block_size : set->count;
+
+    for (; index < block_end; ++index)
+    {
+        buffer_count = fc_uri_set_decode(set, index, &position, buffer, buffer_count);
+
+        int order = fc_uri_set_compare(buffer, buffer_count, uri, count);
+        if (order >= 0)
+        {
+            *found = order == 0;
+            return index;
+        }
+    }
+
+    return index;
+}
+
+bool fc_uri_set_contains(const fc_uri_set* set, const char* uri, int count)
+{
+    bool found;
+    fc_uri_set_lower_bound(set, uri, count, &found);
+    return found;
+}
+
+int64_t fc_uri_set_rank(const fc_uri_set* set, const char* uri, int count)
+{
+    bool found;
+    return fc_uri_set_lower_bound(set, uri, count, &found);
+}
+
+// Moves the iterator to index, decoding from the start of its block.
+static void fc_uri_set_seek(fc_uri_set_iterator* it, int64_t index)
+{
+    const fc_uri_set* set = it->set;
+
+    it->index = index;
+    it->current_count = 0;
+
+    if (index >= set->count) return;
+
+    int64_t block = index / set->block_size;
+    it->position = set->block_offsets[block];
+
+    for (int64_t i = block * set->block_size; i < index; ++i)
+    {
+        it->current_count = fc_uri_set_decode(set, i, &it->position, it->current, it->current_count);
+    }
+}
+
+int fc_uri_set_select(const fc_uri_set* set, int64_t index, char* dst, int dst_size)
+{
+    if (index < 0 || index >= set->count) return -1;
+
+    char buffer[FC_URI_MAX + 1];
+    int64_t block = index / set->block_size;
+    uint64_t position = set->block_offsets[block];
+    int count = 0;
+
+    for (int64_t i = block * set->block_size; i <= index; ++i)
+    {
+        count = fc_uri_set_decode(set, i, &position, buffer, count);
+    }
+
+    if (count >= dst_size) return -1;
+
+    memcpy(dst, buffer, count);
+    dst[count] = '\0';
+
+    return count;
+}
+
+void fc_uri_set_prefix(const fc_uri_set* set, const char* prefix, int prefix_count, fc_uri_set_iterator* it)
+{
+    it->set = set;
+    it->prefix = prefix;
+    it->prefix_count = prefix_count;
+
+    fc_uri_set_seek(it, fc_uri_set_rank(set, prefix, prefix_count));
+}
+
+bool fc_uri_set_next(fc_uri_set_iterator* it, fc_uri_str* uri)
+{
+    const fc_uri_set* set = it->set;
+
+    if (it->index >= set->count) return false;
+
+    it->current_count = fc_uri_set_decode(set, it->index, &it->position, it->current, it->current_count);
+
+    if (it->current_count < it->prefix_count || memcmp(it->current, it->prefix, it->prefix_count) != 0)
+    {
+        it->index = set->count;
+        return false;
+    }
+
+    it->index++;
+    if (it->index < set->count && it->index % set->block_size == 0)
+    {
+        it->position = set->block_offsets[it->index / set->block_size];
+    }
+
+    uri->data  = it->current;
+    uri->count = it->current_count;
+
+    return true;
+}
+
+#endif // FC_URI_SET_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,544 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_SITEMAP_IMPLEMENTATION
+        #include "fc_uri_sitemap.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_sitemap.h"
+    "
+
+Example:
+    fc_sitemap sitemap;
+    fc_sitemap_begin(&sitemap);
+
+    while (int count = read(fd, chunk, sizeof(chunk)))
+    {
+        fc_sitemap_feed(&sitemap, chunk, count);
+
+        fc_sitemap_url url;
+        while (fc_sitemap_next(&sitemap, &url))
+        {
+            if (url.index) {
+                // url.uri is another sitemap, from a <sitemapindex>
+            } else {
+                // url.uri is a page
+            }
+        }
+    }
+
+Info:
+    Streaming extractor of the <loc> values of sitemaps and sitemap indexes (https://www.sitemaps.org/protocol.html).
+
+    It's not an XML parser, it only understands tags, comments, CDATA sections, processing instructions and
+    the character references in text (the five predefined entities and numeric ones), which is everything that
+    can show up around a <loc>. Namespace prefixes are ignored ("sm:loc" is a <loc>).
+    Outside of <loc> the input is skipped with memchr, inside it's copied in bulk up to the next '<' or '&'.
+
+    Values are trimmed and parsed with fc_uri_parse_view, the ones that are longer than FC_URI_MAX or don't
+    parse are counted in skipped. Chunks can split the input anywhere, nothing is allocated.
+*/
+
+#ifndef FC_URI_SITEMAP
+#define FC_URI_SITEMAP
+
+#include "fc_uri_parse.h"
+
+#define FC_SITEMAP_NAME_MAX 16
+
+typedef struct
+{
+    fc_uri_str  loc; // With character references decoded and surrounding whitespace removed
+    fc_uri_view uri; // loc parsed
+
+    bool index; // The <loc> is in a <sitemap> rather than in a <url>
+} fc_sitemap_url;
+
+typedef struct
+{
+    int state;
+
+    char name[FC_SITEMAP_NAME_MAX];
+    int  name_count;
+    bool closing;
+    char quote;
+    int  match; // Progress in matching "<!--", "<![CDATA[" and their ends
+
+    bool in_loc;
+    bool in_sitemap;
+
+    char entity[12];
+    int  entity_count;
+
+    char value[FC_URI_MAX + 1];
+    int  value_count;
+    bool value_overflow;
+
+    int skipped;
+
+    const char* chunk;
+    const char* chunk_end;
+} fc_sitemap;
+
+void fc_sitemap_begin(fc_sitemap* sitemap);
+void fc_sitemap_feed(fc_sitemap* sitemap, const char* chunk, int count);
+
+// Returns the next URL in the current chunk. The views in url are valid until the next call.
+bool fc_sitemap_next(fc_sitemap* sitemap, fc_sitemap_url* url);
+
+#endif // FC_URI_SITEMAP
+
+#ifdef FC_URI_SITEMAP_IMPLEMENTATION
+
+#include <string.h> // memchr, memcmp, memcpy, strlen
+
+enum
+{
+    FC_SITEMAP_TEXT,        // Outside of <loc>
+    FC_SITEMAP_VALUE,       // Inside of <loc>
+    FC_SITEMAP_ENTITY,
+    FC_SITEMAP_TAG_OPEN,
+    FC_SITEMAP_TAG_NAME,
+    FC_SITEMAP_TAG,         // Attributes, up to '>'
+    FC_SITEMAP_DECLARATION, // <! that may become a comment or CDATA
+    FC_SITEMAP_COMMENT,
+    FC_SITEMAP_CDATA,
+    FC_SITEMAP_BOGUS,       // Skipped up to the next '>'
+};
+
+static bool fc_sitemap_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+// Tag name without the namespace prefix.
+static fc_uri_str fc_sitemap_local_name(const fc_sitemap* sitemap)
+{
+    int begin = sitemap->name_count < FC_SITEMAP_NAME_MAX ? sitemap->name_count : 0;
+    while (begin > 0 && sitemap->name[begin - 1] != ':') --begin;
+
+    fc_uri_str name;
+    name.data  = sitemap->name + begin;
+    name.count = sitemap->name_count - begin;
+
+    return name;
+}
+
+static bool fc_sitemap_name_is(fc_uri_str name, const char* other, int count)
+{
+    return name.count == count && memcmp(name.data, other, count) == 0;
+}
+
+static void fc_sitemap_append(fc_sitemap* sitemap, const char* str, int count)
+{
+    if (sitemap->value_count + count > FC_URI_MAX)
+    {
+        sitemap->value_overflow = true;
+        return;
+    }
+
+    memcpy(sitemap->value + sitemap->value_count, str, count);
+    sitemap->value_count += count;
+}
+
+static void fc_sitemap_append_code_point(fc_sitemap* sitemap, unsigned cp)
+{
+    if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) cp = 0xFFFD;
+
+    char utf8[4];
+    int count;
+
+    if (cp < 0x80) {
+        utf8[0] = (char)cp;
+        count = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F));
+        count = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F));
+        count = 3;
+    } else {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F));
+        count = 4;
+    }
+
+    fc_sitemap_append(sitemap, utf8, count);
+}
+
+// Decodes the reference in sitemap->entity ("amp", "#38", "#x26"), terminated tells whether it ended with ';'.
+static void fc_sitemap_flush_entity(fc_sitemap* sitemap, bool terminated)
+{
+    const char* e = sitemap->entity;
+    int count = sitemap->entity_count;
+
+    if (terminated && count > 1 && e[0] == '#')
+    {
+        bool hex = e[1] == 'x';
+        unsigned cp = 0;
+        bool digits = hex ? count > 2 : true;
+
+        for (int i = hex ? 2 : 1; i < count && digits; ++i)
+        {
+            char c = e[i];
+            unsigned d;
+
+            if      (c >= '0' && c <= '9')        d = c - '0';
+            else if (hex && c >= 'a' && c <= 'f') d = c - 'a' + 10;
+            else if (hex && c >= 'A' && c <= 'F') d = c - 'A' + 10;
+            else {
+                digits = false;
+                break;
+            }
+
+            if (cp <= 0x10FFFF) cp = cp * (hex ? 16 : 10) + d;
+        }
+
+        if (digits)
+        {
+            fc_sitemap_append_code_point(sitemap, cp);
+            return;
+        }
+    }
+
+    if (terminated)
+    {
+        struct { const char* name; char c; } names[] = {
+            { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' }, { "apos", '\'' },
+        };
+
+        for (unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+        {
+            if (count == (int)strlen(names[i].name) && memcmp(e, names[i].name, count) == 0)
+            {
+                fc_sitemap_append(sitemap, &names[i].c, 1);
+                return;
+            }
+        }
+    }
+
+    // Malformed, keep it as it was
+    fc_sitemap_append(sitemap, "&", 1);
+    fc_sitemap_append(sitemap, e, count);
+    if (terminated) fc_sitemap_append(sitemap, ";", 1);
+}
+
+void fc_sitemap_begin(fc_sitemap* sitemap)
+{
+    sitemap->state = FC_SITEMAP_TEXT;
+    sitemap->in_loc = false;
+    sitemap->in_sitemap = false;
+    sitemap->skipped = 0;
+    sitemap->chunk = sitemap->chunk_end = NULL;
+}
+
+void fc_sitemap_feed(fc_sitemap* sitemap, const char* chunk, int count)
+{
+    sitemap->chunk     = chunk;
+    sitemap->chunk_end = chunk + count;
+}
+
+static int fc_sitemap_content_state(const fc_sitemap* sitemap)
+{
+    return sitemap->in_loc ? FC_SITEMAP_VALUE : FC_SITEMAP_TEXT;
+}
+
+// Called at the '>' of a tag, returns true if it closed a <loc> with a valid URI.
+static bool fc_sitemap_end_tag(fc_sitemap* sitemap, fc_sitemap_url* url)
+{
+    fc_uri_str name = fc_sitemap_local_name(sitemap);
+    bool is_loc = fc_sitemap_name_is(name, "loc", 3);
+
+    if (fc_sitemap_name_is(name, "sitemap", 7)) sitemap->in_sitemap = !sitemap->closing;
+    if (fc_sitemap_name_is(name, "url", 3)) sitemap->in_sitemap = false;
+
+    if (is_loc && !sitemap->closing)
+    {
+        sitemap->in_loc = true;
+        sitemap->value_count = 0;
+        sitemap->value_overflow = false;
+    }
+
+    bool found = false;
+
+    if (is_loc && sitemap->closing && sitemap->in_loc)
+    {
+        sitemap->in_loc = false;
+
+        const char* value = sitemap->value;
+        int count = sitemap->value_count;
+
+        while (count && fc_sitemap_is_space(*value)) { value++; count--; }
+        while (count && fc_sitemap_is_space(value[count - 1])) count--;
+
+        found = !sitemap->value_overflow && fc_uri_parse_view(value, count, &url->uri);
+
+        if (found) {
+            url->loc.data = value;
+            url->loc.count = count;
+            url->index = sitemap->in_sitemap;
+        } else {
+            sitemap->skipped++;
+        }
+    }
+
+    sitemap->state = fc_sitemap_content_state(sitemap);
+
+    return found;
+}
+
+bool fc_sitemap_next(fc_sitemap* sitemap, fc_sitemap_url* url)
+{
+    const char* c   = sitemap->chunk;
+    const char* end = sitemap->chunk_end;
+
+    bool found = false;
+
+    while (c != end && !found)
+    {
+        switch (sitemap->state)
+        {
+            case FC_SITEMAP_TEXT:
+            {
+                const char* open = (const char*)memchr(c, '<', end - c);
+                if (!open)
+                {
+                    c = end;
+                    break;
+                }
+
+                c = open + 1;
+                sitemap->state = FC_SITEMAP_TAG_OPEN;
+            } break;
+
+            case FC_SITEMAP_VALUE:
+            {
+                const char* start = c;
+                while (c != end && *c != '<' && *c != '&') c++;
+
+                fc_sitemap_append(sitemap, start, (int)(c - start));
+
+                if (c == end) break;
+
+                if (*c == '&')
+                {
+                    sitemap->entity_count = 0;
+                    sitemap->state = FC_SITEMAP_ENTITY;
+                } else {
+                    sitemap->state = FC_SITEMAP_TAG_OPEN;
+                }
+                c++;
+            } break;
+
+            case FC_SITEMAP_ENTITY:
+            {
+                if (*c == ';')
+                {
+                    fc_sitemap_flush_entity(sitemap, true);
+                    sitemap->state = FC_SITEMAP_VALUE;
+                    c++;
+                }
+                else if (*c == '<' || *c == '&' || fc_sitemap_is_space(*c) || sitemap->entity_count == (int)sizeof(sitemap->entity))
+                {
+                    fc_sitemap_flush_entity(sitemap, false);
+                    sitemap->state = FC_SITEMAP_VALUE;
+                }
+                else {
+                    sitemap->entity[sitemap->entity_count++] = *c++;
+                }
+            } break;
+
+            case FC_SITEMAP_TAG_OPEN:
+            {
+                sitemap->name_count = 0;
+                sitemap->closing = false;
+                sitemap->match = 0;
+
+                if (*c == '/') {
+                    sitemap->closing = true;
+                    sitemap->state = FC_SITEMAP_TAG_NAME;
+                    c++;
+                } else if (*c == '!') {
+                    sitemap->state = FC_SITEMAP_DECLARATION;
+                    c++;
+                } else if (*c == '?') {
+                    sitemap->state = FC_SITEMAP_BOGUS;
+                    c++;
+                } else {
+                    sitemap->state = FC_SITEMAP_TAG_NAME;
+                }
+            } break;
+
+            case FC_SITEMAP_TAG_NAME:
+            {
+                while (c != end && *c != '>' && *c != '/' && !fc_sitemap_is_space(*c))
+                {
+                    // Longer names can't be anything we look for, make sure they don't match by keeping the count.
+                    if (sitemap->name_count < FC_SITEMAP_NAME_MAX) sitemap->name[sitemap->name_count] = *c;
+                    sitemap->name_count++;
+                    c++;
+                }
+
+                if (c == end) break;
+
+                if (*c == '>') {
+                    found = fc_sitemap_end_tag(sitemap, url);
+                } else {
+                    sitemap->quote = 0;
+                    sitemap->state = FC_SITEMAP_TAG;
+                }
+                c++;
+            } break;
+
+            case FC_SITEMAP_TAG:
+            {
+                // Attribute values can contain '>'
+                while (c != end)
+                {
+                    if (sitemap->quote) {
+                        if (*c == sitemap->quote) sitemap->quote = 0;
+                    } else if (*c == '"' || *c == '\'') {
+                        sitemap->quote = *c;
+                    } else if (*c == '>') {
+                        break;
+                    }
+                    c++;
+                }
+
+                if (c == end) break;
+
+                found = fc_sitemap_end_tag(sitemap, url);
+                c++;
+            } break;
+
+            case FC_SITEMAP_DECLARATION:
+            {
+                static const char comment[] = "--";
+                static const char cdata[]   = "[CDATA[";
+
+                bool maybe_comment = sitemap->match < 2 && *c == comment[sitemap->match];
+                bool maybe_cdata   = sitemap->match < 7 && *c == cdata[sitemap->match];
+
+                c++;
+                sitemap->match++;
+
+                if (maybe_comment && sitemap->match == 2) {
+                    sitemap->match = 0;
+                    sitemap->state = FC_SITEMAP_COMMENT;
+                } else if (maybe_cdata && sitemap->match == 7) {
+                    sitemap->match = 0;
+                    sitemap->state = FC_SITEMAP_CDATA;
+                } else if (!maybe_comment && !maybe_cdata) {
+                    sitemap->state = c[-1] == '>' ? fc_sitemap_content_state(sitemap) : FC_SITEMAP_BOGUS;
+                }
+            } break;
+
+            case FC_SITEMAP_COMMENT:
+            {
+                // match counts the '-' seen right before
+                if (*c == '>' && sitemap->match >= 2) {
+                    sitemap->state = fc_sitemap_content_state(sitemap);
+                } else if (*c == '-') {
+                    sitemap->match++;
+                } else {
+                    sitemap->match = 0;
+
+                    const char* dash = (const char*)memchr(c, '-', end - c);
+                    c = dash ? dash : end;
+                    break;
+                }
+                c++;
+            } break;
+
+            case FC_SITEMAP_CDATA:
+            {
+                // match counts the ']' seen right before, they are content unless a '>' follows two of them
+                if (*c == ']') {
+                    sitemap->match++;
+                    c++;
+                    break;
+                }
+
+                if (*c == '>' && sitemap->match >= 2)
+                {
+                    if (sitemap->in_loc)
+                    {
+                        for (int i = 2; i < sitemap->match; ++i) fc_sitemap_append(sitemap, "]", 1);
+                    }
+
+                    sitemap->state = fc_sitemap_content_state(sitemap);
+                    c++;
+                    break;
+                }
+
+                if (sitemap->in_loc)
+                {
+                    for (int i = 0; i < sitemap->match; ++i) fc_sitemap_append(sitemap, "]", 1);
+                }
+
+                sitemap->match = 0;
+
+                const char* start = c;
+                while (c != end && *c != ']') c++;
+
+                if (sitemap->in_loc) fc_sitemap_append(sitemap, start, (int)(c - start));
+            } break;
+
+            case FC_SITEMAP_BOGUS:
+            {
+                const char* close = (const char*)memchr(c, '>', end - c);
+                if (!close)
+                {
+                    c = end;
+                    break;
+                }
+
+                c = close + 1;
+                sitemap->state = fc_sitemap_content_state(sitemap);
+            } break;
+        }
+    }
+
+    sitemap->chunk = c;
+
+    return found;
+}
+
+#endif // FC_URI_SITEMAP_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
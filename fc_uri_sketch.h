@@ -0,0 +1,765 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_SKETCH_IMPLEMENTATION
+        #include "fc_uri_sketch.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_sketch.h"
+    "
+
+Example:
+    // One of each per thread, or per log file
+    fc_topk paths;
+    fc_topk_init(&paths, 100, 16, (1u << FC_URI_HOST) | (1u << FC_URI_PATH)); // Top 100 host + path
+
+    fc_host_hll distinct;
+    fc_host_hll_init(&distinct, 12, FC_SKETCH_ALL_COMPONENTS); // Distinct URLs per host, ~1.6% error
+
+    fc_uri_view uri;
+    while (next_log_line(&line, &line_length))
+    {
+        if (!fc_uri_parse_view(line, line_length, &uri)) continue;
+
+        fc_topk_add(&paths, &uri, 1);
+        fc_host_hll_add(&distinct, &uri);
+    }
+
+    // Then all of them are merged into one
+    fc_topk_merge(&total_paths, &paths);
+    fc_host_hll_merge(&total_distinct, &distinct);
+
+    fc_topk_item top[100];
+    int top_count = fc_topk_sorted(&total_paths, top); // top[0] is the most frequent
+
+    for (int i = 0; i < total_distinct.entry_count; ++i)
+    {
+        // total_distinct.entries[i].host, fc_host_hll_estimate(&total_distinct, i)
+    }
+
+Info:
+    Fixed memory aggregates of parsed URIs, for counts over logs too large for an exact table of all the URLs.
+    Keys are made of some of the components of the URI, picked with a mask of (1 << fc_uri_component) bits.
+
+    fc_topk finds heavy hitters with a Count-Min sketch (Cormode and Muthukrishnan, 2005) and a min-heap of
+    the k keys with the highest estimates. Estimates never undercount, they overcount by at most
+    e * total / width with probability 1 - e^-FC_SKETCH_DEPTH. Keys are kept as text for reporting, the
+    selected components joined by ' ' and cut at FC_SKETCH_KEY_MAX bytes.
+
+    fc_hll counts distinct keys with HyperLogLog (Flajolet et al., 2007) on 2^precision one byte registers,
+    the standard error is 1.04 / sqrt(2^precision). fc_host_hll keeps one per host (case insensitive).
+
+    Sketches are not thread safe, each thread fills its own and they are merged afterwards. Merging is exact
+    for fc_hll (register-wise max, SSE2) and for the Count-Min counters (sum), the heavy hitters of a merge are
+    the best k of the candidates of both, estimated again on the merged counters. Sketches can only be merged
+    with sketches created with the same parameters.
+*/
+
+#ifndef FC_URI_SKETCH
+#define FC_URI_SKETCH
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+#define FC_SKETCH_DEPTH 4
+
+#ifndef FC_SKETCH_KEY_MAX
+#define FC_SKETCH_KEY_MAX 128
+#endif
+
+#define FC_SKETCH_ALL_COMPONENTS ((1u << FC_URI_COMPONENT_COUNT) - 1)
+
+// Hash of the selected components, absent and empty components hash differently.
+uint64_t fc_sketch_hash(const fc_uri_view* uri, uint32_t components);
+
+typedef struct
+{
+    uint64_t hash;
+    uint64_t count; // Estimate
+
+    int key_count;
+    char key[FC_SKETCH_KEY_MAX];
+
+    int slot; // Internal
+} fc_topk_item;
+
+typedef struct
+{
+    uint64_t* counters; // FC_SKETCH_DEPTH rows of width_mask + 1
+    uint32_t width_mask;
+    int width_log2;
+    uint32_t components;
+    uint64_t total;
+
+    fc_topk_item* heap; // Min-heap on count
+    int heap_count;
+    int k;
+
+    int* slots; // Heap index + 1 by hash, 0 for empty slots
+    int slot_mask;
+} fc_topk;
+
+// width is 2^width_log2 counters per row, width_log2 is 1 to 31. Returns false if out of memory.
+bool fc_topk_init(fc_topk* topk, int k, int width_log2, uint32_t components);
+void fc_topk_free(fc_topk* topk);
+
+void fc_topk_add(fc_topk* topk, const fc_uri_view* uri, uint64_t weight);
+uint64_t fc_topk_estimate(const fc_topk* topk, const fc_uri_view* uri);
+
+// Returns false if the sketches don't have the same parameters or if out of memory, into is unchanged then.
+bool fc_topk_merge(fc_topk* into, const fc_topk* from);
+
+// Copies the heavy hitters into items (room for k), most frequent first. Returns how many there are.
+int fc_topk_sorted(const fc_topk* topk, fc_topk_item* items);
+
+typedef struct
+{
+    uint8_t* registers;
+    int precision;
+} fc_hll;
+
+// precision is 4 to 18. Returns false if out of memory.
+bool fc_hll_init(fc_hll* hll, int precision);
+void fc_hll_free(fc_hll* hll);
+
+void fc_hll_add(fc_hll* hll, uint64_t hash);
+bool fc_hll_merge(fc_hll* into, const fc_hll* from);
+double fc_hll_estimate(const fc_hll* hll);
+
+typedef struct
+{
+    uint64_t host_hash;
+    int host_count;
+    char host[FC_URI_HOST_MAX + 1]; // Lowercase, null-terminated
+} fc_host_hll_entry;
+
+typedef struct
+{
+    fc_host_hll_entry* entries;
+    int entry_count;
+    int entry_capacity;
+
+    uint8_t* registers; // 2^precision per entry
+
+    int* table; // Entry index + 1 by host hash, 0 for empty slots
+    int table_mask;
+
+    int precision;
+    uint32_t components; // What makes two URIs of a host distinct
+} fc_host_hll;
+
+bool fc_host_hll_init(fc_host_hll* hosts, int precision, uint32_t components);
+void fc_host_hll_free(fc_host_hll* hosts);
+
+// Returns false if the URI has no host, the host is too long or out of memory.
+bool fc_host_hll_add(fc_host_hll* hosts, const fc_uri_view* uri);
+bool fc_host_hll_merge(fc_host_hll* into, const fc_host_hll* from);
+
+// Entry of a host, -1 if it was never seen.
+int fc_host_hll_find(const fc_host_hll* hosts, const char* host, int count);
+double fc_host_hll_estimate(const fc_host_hll* hosts, int entry);
+
+#endif // FC_URI_SKETCH
+
+#ifdef FC_URI_SKETCH_IMPLEMENTATION
+
+#include <string.h> // memcpy, memset
+#include <math.h>   // log
+
+#ifndef FC_URI_SKETCH_REALLOC
+#include <stdlib.h>
+#define FC_URI_SKETCH_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_SKETCH_FREE
+#include <stdlib.h>
+#define FC_URI_SKETCH_FREE(ptr)          free(ptr)
+#endif
+
+#ifdef FC_URI_SSE2
+#define FC_SKETCH_SSE2
+#include <emmintrin.h>
+#endif
+
+uint64_t fc_sketch_hash(const fc_uri_view* uri, uint32_t components)
+{
+    uint64_t h = components;
+
+    for (int i = 0; i < FC_URI_COMPONENT_COUNT; ++i)
+    {
+        if (!(components & (1u << i))) continue;
+
+        fc_uri_str component = fc_uri_view_component(uri, (fc_uri_component)i);
+
+        h = fc_uri_hash(component.data ? component.data : "", component.count, h + (component.data ? 1 : 2));
+    }
+
+    return h;
+}
+
+static int fc_sketch_key(const fc_uri_view* uri, uint32_t components, char* key)
+{
+    int count = 0;
+    bool first = true;
+
+    for (int i = 0; i < FC_URI_COMPONENT_COUNT; ++i)
+    {
+        if (!(components & (1u << i))) continue;
+
+        if (!first && count < FC_SKETCH_KEY_MAX) key[count++] = ' ';
+        first = false;
+
+        fc_uri_str component = fc_uri_view_component(uri, (fc_uri_component)i);
+
+        int take = component.count;
+        if (take > FC_SKETCH_KEY_MAX - count) take = FC_SKETCH_KEY_MAX - count;
+
+        if (take > 0) memcpy(key + count, component.data, take);
+        count += take;
+    }
+
+    return count;
+}
+
+// Top-K
+
+static uint32_t fc_topk_column(const fc_topk* topk, uint64_t hash, int row)
+{
+    // Multiply-shift with a different multiplier per row, keys that collide in a row rarely collide in the others
+    static const uint64_t multipliers[FC_SKETCH_DEPTH] = {
+        0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull,
+    };
+
+    return (uint32_t)((hash * multipliers[row]) >> (64 - topk->width_log2));
+}
+
+static uint64_t fc_topk_estimate_hash(const fc_topk* topk, uint64_t hash)
+{
+    uint64_t estimate = UINT64_MAX;
+
+    for (int row = 0; row < FC_SKETCH_DEPTH; ++row)
+    {
+        uint64_t counter = topk->counters[(size_t)row * (topk->width_mask + 1) + fc_topk_column(topk, hash, row)];
+        if (counter < estimate) estimate = counter;
+    }
+
+    return estimate;
+}
+
+bool fc_topk_init(fc_topk* topk, int k, int width_log2, uint32_t components)
+{
+    memset(topk, 0, sizeof(*topk));
+
+    topk->width_mask = (1u << width_log2) - 1;
+    topk->width_log2 = width_log2;
+    topk->components = components;
+    topk->k = k;
+
+    int slot_count = 4;
+    while (slot_count < 2 * k) slot_count *= 2;
+    topk->slot_mask = slot_count - 1;
+
+    size_t counters_size = (size_t)FC_SKETCH_DEPTH * (topk->width_mask + 1) * sizeof(uint64_t);
+
+    topk->counters = (uint64_t*)FC_URI_SKETCH_REALLOC(NULL, counters_size);
+    topk->heap = (fc_topk_item*)FC_URI_SKETCH_REALLOC(NULL, k * sizeof(fc_topk_item));
+    topk->slots = (int*)FC_URI_SKETCH_REALLOC(NULL, slot_count * sizeof(int));
+
+    if (!topk->counters || !topk->heap || !topk->slots)
+    {
+        fc_topk_free(topk);
+        return false;
+    }
+
+    memset(topk->counters, 0, counters_size);
+    memset(topk->slots, 0, slot_count * sizeof(int));
+
+    return true;
+}
+
+void fc_topk_free(fc_topk* topk)
+{
+    FC_URI_SKETCH_FREE(topk->counters);
+    FC_URI_SKETCH_FREE(topk->heap);
+    FC_URI_SKETCH_FREE(topk->slots);
+
+    memset(topk, 0, sizeof(*topk));
+}
+
+// Slot of hash, or the empty slot where it would go.
+static int fc_topk_find_slot(const fc_topk* topk, uint64_t hash)
+{
+    int slot = (int)(hash & topk->slot_mask);
+
+    while (topk->slots[slot] && topk->heap[topk->slots[slot] - 1].hash != hash) slot = (slot + 1) & topk->slot_mask;
+
+    return slot;
+}
+
+// Linear probing deletion, later entries of the cluster are shifted back instead of leaving a tombstone.
+static void fc_topk_remove_slot(fc_topk* topk, int slot)
+{
+    int next = slot;
+
+    for (;;)
+    {
+        next = (next + 1) & topk->slot_mask;
+        if (!topk->slots[next]) break;
+
+        int home = (int)(topk->heap[topk->slots[next] - 1].hash & topk->slot_mask);
+
+        // The entry can move back to slot only if its home is not in (slot, next]
+        bool stays = slot <= next ? (home > slot && home <= next) : (home > slot || home <= next);
+        if (stays) continue;
+
+        topk->slots[slot] = topk->slots[next];
+        topk->heap[topk->slots[slot] - 1].slot = slot;
+        slot = next;
+    }
+
+    topk->slots[slot] = 0;
+}
+
+static void fc_topk_swap(fc_topk* topk, int a, int b)
+{
+    fc_topk_item item = topk->heap[a];
+    topk->heap[a] = topk->heap[b];
+    topk->heap[b] = item;
+
+    topk->slots[topk->heap[a].slot] = a + 1;
+    topk->slots[topk->heap[b].slot] = b + 1;
+}
+
+static void fc_topk_sift_up(fc_topk* topk, int i)
+{
+    while (i > 0 && topk->heap[(i - 1) / 2].count > topk->heap[i].count)
+    {
+        fc_topk_swap(topk, i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+static void fc_topk_sift_down(fc_topk* topk, int i)
+{
+    for (;;)
+    {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < topk->heap_count && topk->heap[left].count < topk->heap[smallest].count) smallest = left;
+        if (right < topk->heap_count && topk->heap[right].count < topk->heap[smallest].count) smallest = right;
+
+        if (smallest == i) return;
+
+        fc_topk_swap(topk, i, smallest);
+        i = smallest;
+    }
+}
+
+void fc_topk_add(fc_topk* topk, const fc_uri_view* uri, uint64_t weight)
+{
+    uint64_t hash = fc_sketch_hash(uri, topk->components);
+    uint64_t estimate = UINT64_MAX;
+
+    topk->total += weight;
+
+    for (int row = 0; row < FC_SKETCH_DEPTH; ++row)
+    {
+        uint64_t* counter = &topk->counters[(size_t)row * (topk->width_mask + 1) + fc_topk_column(topk, hash, row)];
+        *counter += weight;
+
+        if (*counter < estimate) estimate = *counter;
+    }
+
+    int slot = fc_topk_find_slot(topk, hash);
+
+    if (topk->slots[slot])
+    {
+        int i = topk->slots[slot] - 1;
+        topk->heap[i].count = estimate;
+        fc_topk_sift_down(topk, i);
+        return;
+    }
+
+    int i;
+    if (topk->heap_count < topk->k) {
+        i = topk->heap_count++;
+    } else {
+        if (topk->k == 0 || estimate <= topk->heap[0].count) return;
+
+        // Replaces the smallest
+        i = 0;
+        fc_topk_remove_slot(topk, topk->heap[0].slot);
+        slot = fc_topk_find_slot(topk, hash);
+    }
+
+    fc_topk_item* item = &topk->heap[i];
+    item->hash = hash;
+    item->count = estimate;
+    item->key_count = fc_sketch_key(uri, topk->components, item->key);
+    item->slot = slot;
+
+    topk->slots[slot] = i + 1;
+
+    if (i == 0) {
+        fc_topk_sift_down(topk, 0);
+    } else {
+        fc_topk_sift_up(topk, i);
+    }
+}
+
+uint64_t fc_topk_estimate(const fc_topk* topk, const fc_uri_view* uri)
+{
+    return fc_topk_estimate_hash(topk, fc_sketch_hash(uri, topk->components));
+}
+
+static int fc_topk_compare_descending(const void* a, const void* b)
+{
+    uint64_t ca = ((const fc_topk_item*)a)->count;
+    uint64_t cb = ((const fc_topk_item*)b)->count;
+
+    return ca < cb ? 1 : (ca > cb ? -1 : 0);
+}
+
+bool fc_topk_merge(fc_topk* into, const fc_topk* from)
+{
+    if (into->width_mask != from->width_mask || into->components != from->components || into->k != from->k) return false;
+
+    fc_topk_item* candidates = (fc_topk_item*)FC_URI_SKETCH_REALLOC(NULL, (into->heap_count + from->heap_count + 1) * sizeof(fc_topk_item));
+    if (!candidates) return false;
+
+    size_t counter_count = (size_t)FC_SKETCH_DEPTH * (into->width_mask + 1);
+    for (size_t i = 0; i < counter_count; ++i) into->counters[i] += from->counters[i];
+
+    into->total += from->total;
+
+    int candidate_count = into->heap_count;
+    memcpy(candidates, into->heap, into->heap_count * sizeof(fc_topk_item));
+
+    for (int i = 0; i < from->heap_count; ++i)
+    {
+        int slot = fc_topk_find_slot(into, from->heap[i].hash);
+        if (!into->slots[slot]) candidates[candidate_count++] = from->heap[i];
+    }
+
+    for (int i = 0; i < candidate_count; ++i) candidates[i].count = fc_topk_estimate_hash(into, candidates[i].hash);
+
+    qsort(candidates, candidate_count, sizeof(fc_topk_item), fc_topk_compare_descending);
+    if (candidate_count > into->k) candidate_count = into->k;
+
+    // Ascending order is already a min-heap
+    memset(into->slots, 0, (into->slot_mask + 1) * sizeof(int));
+    into->heap_count = candidate_count;
+
+    for (int i = 0; i < candidate_count; ++i)
+    {
+        fc_topk_item* item = &into->heap[i];
+        *item = candidates[candidate_count - 1 - i];
+
+        item->slot = fc_topk_find_slot(into, item->hash);
+        into->slots[item->slot] = i + 1;
+    }
+
+    FC_URI_SKETCH_FREE(candidates);
+
+    return true;
+}
+
+int fc_topk_sorted(const fc_topk* topk, fc_topk_item* items)
+{
+    memcpy(items, topk->heap, topk->heap_count * sizeof(fc_topk_item));
+    qsort(items, topk->heap_count, sizeof(fc_topk_item), fc_topk_compare_descending);
+
+    return topk->heap_count;
+}
+
+// HyperLogLog
+
+static void fc_hll_add_registers(uint8_t* registers, int precision, uint64_t hash)
+{
+    uint64_t index = hash >> (64 - precision);
+
+    // The guard bit caps the rank at 64 - precision + 1
+    uint64_t rest = (hash << precision) | ((uint64_t)1 << (precision - 1));
+    uint8_t rank = (uint8_t)(fc_uri_clz64(rest) + 1);
+
+    if (rank > registers[index]) registers[index] = rank;
+}
+
+static void fc_hll_merge_registers(uint8_t* into, const uint8_t* from, int count)
+{
+    int i = 0;
+
+#ifdef FC_SKETCH_SSE2
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(into + i));
+        __m128i b = _mm_loadu_si128((const __m128i*)(from + i));
+        _mm_storeu_si128((__m128i*)(into + i), _mm_max_epu8(a, b));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        if (from[i] > into[i]) into[i] = from[i];
+    }
+}
+
+static double fc_hll_estimate_registers(const uint8_t* registers, int precision)
+{
+    int m = 1 << precision;
+
+    double inverse_powers[66];
+    for (int r = 0; r < 66; ++r) inverse_powers[r] = 1.0 / (double)((uint64_t)1 << (r < 63 ? r : 63));
+
+    double sum = 0;
+    int zeros = 0;
+
+    for (int i = 0; i < m; ++i)
+    {
+        sum += inverse_powers[registers[i]];
+        zeros += registers[i] == 0;
+    }
+
+    double alpha;
+    if (m == 16) {
+        alpha = 0.673;
+    } else if (m == 32) {
+        alpha = 0.697;
+    } else if (m == 64) {
+        alpha = 0.709;
+    } else {
+        alpha = 0.7213 / (1.0 + 1.079 / m);
+    }
+
+    double estimate = alpha * m * m / sum;
+
+    // Linear counting for small cardinalities, 64 bit hashes need no large range correction
+    if (estimate <= 2.5 * m && zeros) estimate = m * log((double)m / zeros);
+
+    return estimate;
+}
+
+bool fc_hll_init(fc_hll* hll, int precision)
+{
+    hll->precision = precision;
+    hll->registers = (uint8_t*)FC_URI_SKETCH_REALLOC(NULL, (size_t)1 << precision);
+    if (!hll->registers) return false;
+
+    memset(hll->registers, 0, (size_t)1 << precision);
+
+    return true;
+}
+
+void fc_hll_free(fc_hll* hll)
+{
+    FC_URI_SKETCH_FREE(hll->registers);
+    hll->registers = NULL;
+}
+
+void fc_hll_add(fc_hll* hll, uint64_t hash)
+{
+    fc_hll_add_registers(hll->registers, hll->precision, hash);
+}
+
+bool fc_hll_merge(fc_hll* into, const fc_hll* from)
+{
+    if (into->precision != from->precision) return false;
+
+    fc_hll_merge_registers(into->registers, from->registers, 1 << into->precision);
+
+    return true;
+}
+
+double fc_hll_estimate(const fc_hll* hll)
+{
+    return fc_hll_estimate_registers(hll->registers, hll->precision);
+}
+
+// HyperLogLog per host
+
+bool fc_host_hll_init(fc_host_hll* hosts, int precision, uint32_t components)
+{
+    memset(hosts, 0, sizeof(*hosts));
+
+    hosts->precision = precision;
+    hosts->components = components;
+
+    return true;
+}
+
+void fc_host_hll_free(fc_host_hll* hosts)
+{
+    FC_URI_SKETCH_FREE(hosts->entries);
+    FC_URI_SKETCH_FREE(hosts->registers);
+    FC_URI_SKETCH_FREE(hosts->table);
+
+    memset(hosts, 0, sizeof(*hosts));
+}
+
+// Lowercase copy of host into lower, returns false if it is too long.
+static bool fc_host_hll_lower(const char* host, int count, char* lower)
+{
+    if (count > FC_URI_HOST_MAX) return false;
+
+    for (int i = 0; i < count; ++i)
+    {
+        char c = host[i];
+        lower[i] = (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+    }
+    lower[count] = '\0';
+
+    return true;
+}
+
+static int fc_host_hll_find_slot(const fc_host_hll* hosts, uint64_t hash, const char* host, int count)
+{
+    int slot = (int)(hash & hosts->table_mask);
+
+    for (; hosts->table[slot]; slot = (slot + 1) & hosts->table_mask)
+    {
+        const fc_host_hll_entry* entry = &hosts->entries[hosts->table[slot] - 1];
+        if (entry->host_hash == hash && entry->host_count == count && memcmp(entry->host, host, count) == 0) break;
+    }
+
+    return slot;
+}
+
+static bool fc_host_hll_grow(fc_host_hll* hosts)
+{
+    int capacity = hosts->entry_capacity ? hosts->entry_capacity * 2 : 16;
+    size_t register_count = (size_t)1 << hosts->precision;
+
+    fc_host_hll_entry* entries = (fc_host_hll_entry*)FC_URI_SKETCH_REALLOC(hosts->entries, capacity * sizeof(fc_host_hll_entry));
+    if (!entries) return false;
+    hosts->entries = entries;
+
+    uint8_t* registers = (uint8_t*)FC_URI_SKETCH_REALLOC(hosts->registers, capacity * register_count);
+    if (!registers) return false;
+    hosts->registers = registers;
+
+    int* table = (int*)FC_URI_SKETCH_REALLOC(NULL, 2 * capacity * sizeof(int));
+    if (!table) return false;
+
+    FC_URI_SKETCH_FREE(hosts->table);
+    hosts->table = table;
+    hosts->table_mask = 2 * capacity - 1;
+    hosts->entry_capacity = capacity;
+
+    memset(hosts->table, 0, 2 * capacity * sizeof(int));
+    for (int i = 0; i < hosts->entry_count; ++i)
+    {
+        const fc_host_hll_entry* entry = &hosts->entries[i];
+        hosts->table[fc_host_hll_find_slot(hosts, entry->host_hash, entry->host, entry->host_count)] = i + 1;
+    }
+
+    return true;
+}
+
+// Entry of a lowercase host, added if it is not there yet. -1 if out of memory.
+static int fc_host_hll_entry_of(fc_host_hll* hosts, const char* host, int count)
+{
+    uint64_t hash = fc_uri_hash(host, count, 0);
+
+    if (hosts->entry_count)
+    {
+        int slot = fc_host_hll_find_slot(hosts, hash, host, count);
+        if (hosts->table[slot]) return hosts->table[slot] - 1;
+    }
+
+    if (hosts->entry_count == hosts->entry_capacity && !fc_host_hll_grow(hosts)) return -1;
+
+    int index = hosts->entry_count++;
+
+    fc_host_hll_entry* entry = &hosts->entries[index];
+    entry->host_hash = hash;
+    entry->host_count = count;
+    memcpy(entry->host, host, count + 1);
+
+    memset(hosts->registers + ((size_t)index << hosts->precision), 0, (size_t)1 << hosts->precision);
+
+    hosts->table[fc_host_hll_find_slot(hosts, hash, host, count)] = index + 1;
+
+    return index;
+}
+
+bool fc_host_hll_add(fc_host_hll* hosts, const fc_uri_view* uri)
+{
+    char host[FC_URI_HOST_MAX + 1];
+    if (!uri->host.data || !fc_host_hll_lower(uri->host.data, uri->host.count, host)) return false;
+
+    int index = fc_host_hll_entry_of(hosts, host, uri->host.count);
+    if (index < 0) return false;
+
+    fc_hll_add_registers(hosts->registers + ((size_t)index << hosts->precision), hosts->precision, fc_sketch_hash(uri, hosts->components));
+
+    return true;
+}
+
+bool fc_host_hll_merge(fc_host_hll* into, const fc_host_hll* from)
+{
+    if (into->precision != from->precision || into->components != from->components) return false;
+
+    for (int i = 0; i < from->entry_count; ++i)
+    {
+        const fc_host_hll_entry* entry = &from->entries[i];
+
+        int index = fc_host_hll_entry_of(into, entry->host, entry->host_count);
+        if (index < 0) return false;
+
+        fc_hll_merge_registers(into->registers + ((size_t)index << into->precision),
+                               from->registers + ((size_t)i << from->precision), 1 << into->precision);
+    }
+
+    return true;
+}
+
+int fc_host_hll_find(const fc_host_hll* hosts, const char* host, int count)
+{
+    char lower[FC_URI_HOST_MAX + 1];
+    if (!hosts->entry_count || !fc_host_hll_lower(host, count, lower)) return -1;
+
+    int slot = fc_host_hll_find_slot(hosts, fc_uri_hash(lower, count, 0), lower, count);
+
+    return hosts->table[slot] - 1;
+}
+
+double fc_host_hll_estimate(const fc_host_hll* hosts, int entry)
+{
+    return fc_hll_estimate_registers(hosts->registers + ((size_t)entry << hosts->precision), hosts->precision);
+}
+
+#endif // FC_URI_SKETCH_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,436 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_SNI_IMPLEMENTATION
+        #include "fc_uri_sni.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_sni.h"
+    "
+
+Example:
+    // Loading certificates
+    fc_sni_builder builder;
+    fc_sni_builder_begin(&builder);
+
+    fc_sni_builder_add(&builder, "example.com", -1, 0);
+    fc_sni_builder_add(&builder, "*.example.com", -1, 0);
+    fc_sni_builder_add(&builder, "api.example.net", -1, 1);
+
+    fc_sni_index index;
+    fc_sni_index_init(&index, fc_sni_builder_build(&builder));
+
+    // On every handshake, from any thread
+    uint32_t certificate;
+    if (fc_sni_index_lookup(&index, uri.host.data, uri.host.count, &certificate))
+    {
+        // "www.EXAMPLE.com" gives 0, "a.b.example.com" nothing
+    }
+
+    // Reloading, readers keep going
+    fc_sni_table* old_table = fc_sni_index_swap(&index, fc_sni_builder_build(&new_builder));
+    fc_sni_table_free(old_table); // No reader is using it any more
+
+Info:
+    Matches hosts against the names of certificates (RFC 6125 section 6.4). Names and hosts are compared case
+    insensitively and without a trailing dot. A wildcard is only allowed as the whole leftmost label, "*.example.com",
+    and matches exactly one non empty label: "www.example.com" but not "example.com" or "a.b.example.com".
+    An exact name wins over a wildcard, when the same name is added twice the first value is kept.
+
+    Labels are hashed right to left, so the hash of the parent domain is a step of the hash of the host: a lookup
+    lowercases and hashes the host once and then probes the table twice, exact and wildcard, in O(labels).
+
+    A table is immutable once built, one allocation. fc_sni_index lets readers look up without locks while the
+    table is replaced: readers count themselves in one of two counters picked by an epoch, and check again that
+    the epoch didn't flip meanwhile. The swap flips the epoch and waits for the old counter to drain before
+    returning the old table. Swaps have to be serialized by the caller.
+*/
+
+#ifndef FC_URI_SNI
+#define FC_URI_SNI
+
+#include "fc_uri_parse.h"
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint64_t hash;
+    uint32_t name_offset; // Lowercase, without "*." for wildcards
+    uint32_t value;
+    uint16_t name_count;
+    uint8_t  wildcard;
+    uint8_t  used;
+} fc_sni_slot;
+
+typedef struct
+{
+    uint32_t slot_mask;
+    uint32_t name_count;
+
+    fc_sni_slot* slots;
+    char* names;
+} fc_sni_table;
+
+typedef struct
+{
+    fc_sni_slot* entries;
+    int entry_count;
+    int entry_capacity;
+
+    char* names;
+    uint32_t names_size;
+    uint32_t names_capacity;
+
+    bool failed; // Out of memory, build returns NULL
+} fc_sni_builder;
+
+typedef struct
+{
+    fc_sni_table* table;
+
+    uint64_t epoch;
+    uint64_t readers[2];
+} fc_sni_index;
+
+void fc_sni_builder_begin(fc_sni_builder* builder);
+
+// count can be -1 for null-terminated names. Returns false if name is not a valid host or wildcard name.
+bool fc_sni_builder_add(fc_sni_builder* builder, const char* name, int count, uint32_t value);
+
+// Frees the builder. Returns NULL if out of memory.
+fc_sni_table* fc_sni_builder_build(fc_sni_builder* builder);
+void fc_sni_builder_free(fc_sni_builder* builder);
+
+bool fc_sni_table_lookup(const fc_sni_table* table, const char* host, int count, uint32_t* value);
+void fc_sni_table_free(fc_sni_table* table);
+
+void fc_sni_index_init(fc_sni_index* index, fc_sni_table* table);
+bool fc_sni_index_lookup(fc_sni_index* index, const char* host, int count, uint32_t* value);
+
+// Publishes table and returns the previous one once no lookup uses it.
+fc_sni_table* fc_sni_index_swap(fc_sni_index* index, fc_sni_table* table);
+
+#endif // FC_URI_SNI
+
+#ifdef FC_URI_SNI_IMPLEMENTATION
+
+#include <string.h> // memcpy, memset
+
+#ifndef FC_URI_SNI_REALLOC
+#include <stdlib.h>
+#define FC_URI_SNI_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+#ifndef FC_URI_SNI_FREE
+#include <stdlib.h>
+#define FC_URI_SNI_FREE(ptr)          free(ptr)
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // _mm_pause
+#define FC_SNI_PAUSE() _mm_pause()
+#else
+#define FC_SNI_PAUSE()
+#endif
+
+#define FC_SNI_WILDCARD_SALT 0x5DEECE66DA3C9B2Full
+#define FC_SNI_LABEL_MAX 63
+
+static char fc_sni_lower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (char)(c + ('a' - 'A')) : c;
+}
+
+// Hashes the lowercase labels of host right to left. *parent_hash is the hash without the leftmost label and
+// *first_label its length, 0 when there is a single label. Returns false for empty or too long labels.
+static bool fc_sni_hash(const char* host, int count, uint64_t* hash, uint64_t* parent_hash, int* first_label)
+{
+    if (count > 0 && host[count - 1] == '.') count--;
+    if (count <= 0 || count > FC_URI_HOST_MAX) return false;
+
+    uint64_t h = 0;
+    *parent_hash = 0;
+    *first_label = 0;
+
+    int end = count;
+    while (end > 0)
+    {
+        int begin = end;
+        while (begin > 0 && host[begin - 1] != '.') begin--;
+
+        int label_count = end - begin;
+        if (label_count == 0 || label_count > FC_SNI_LABEL_MAX) return false;
+
+        char label[FC_SNI_LABEL_MAX];
+        for (int i = 0; i < label_count; ++i) label[i] = fc_sni_lower(host[begin + i]);
+
+        if (begin == 0 && end != count)
+        {
+            *parent_hash = h;
+            *first_label = label_count;
+        }
+
+        h = fc_uri_hash(label, label_count, h);
+
+        end = begin - 1;
+    }
+
+    *hash = h;
+
+    return true;
+}
+
+static bool fc_sni_equals(const char* lower, const char* host, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        if (lower[i] != fc_sni_lower(host[i])) return false;
+    }
+
+    return true;
+}
+
+void fc_sni_builder_begin(fc_sni_builder* builder)
+{
+    memset(builder, 0, sizeof(*builder));
+}
+
+void fc_sni_builder_free(fc_sni_builder* builder)
+{
+    FC_URI_SNI_FREE(builder->entries);
+    FC_URI_SNI_FREE(builder->names);
+
+    memset(builder, 0, sizeof(*builder));
+}
+
+bool fc_sni_builder_add(fc_sni_builder* builder, const char* name, int count, uint32_t value)
+{
+    if (count < 0) count = (int)strlen(name);
+    if (count > 0 && name[count - 1] == '.') count--;
+
+    bool wildcard = count >= 2 && name[0] == '*' && name[1] == '.';
+    if (wildcard)
+    {
+        name += 2;
+        count -= 2;
+    }
+
+    uint64_t hash, parent_hash;
+    int first_label;
+    if (!fc_sni_hash(name, count, &hash, &parent_hash, &first_label)) return false;
+
+    if (memchr(name, '*', count)) return false; // Partial wildcards like "w*.example.com" are not supported
+
+    if (builder->entry_count == builder->entry_capacity)
+    {
+        int capacity = builder->entry_capacity ? builder->entry_capacity * 2 : 256;
+
+        fc_sni_slot* entries = (fc_sni_slot*)FC_URI_SNI_REALLOC(builder->entries, capacity * sizeof(fc_sni_slot));
+        if (!entries)
+        {
+            builder->failed = true;
+            return false;
+        }
+
+        builder->entries = entries;
+        builder->entry_capacity = capacity;
+    }
+
+    if (builder->names_size + count > builder->names_capacity)
+    {
+        uint32_t capacity = builder->names_capacity ? builder->names_capacity * 2 : 4096;
+        while (capacity < builder->names_size + count) capacity *= 2;
+
+        char* names = (char*)FC_URI_SNI_REALLOC(builder->names, capacity);
+        if (!names)
+        {
+            builder->failed = true;
+            return false;
+        }
+
+        builder->names = names;
+        builder->names_capacity = capacity;
+    }
+
+    fc_sni_slot* entry = &builder->entries[builder->entry_count++];
+    entry->hash = wildcard ? hash ^ FC_SNI_WILDCARD_SALT : hash;
+    entry->name_offset = builder->names_size;
+    entry->name_count = (uint16_t)count;
+    entry->value = value;
+    entry->wildcard = wildcard;
+    entry->used = 1;
+
+    for (int i = 0; i < count; ++i) builder->names[builder->names_size + i] = fc_sni_lower(name[i]);
+    builder->names_size += count;
+
+    return true;
+}
+
+static const fc_sni_slot* fc_sni_find(const fc_sni_table* table, uint64_t hash, bool wildcard, const char* host, int count)
+{
+    for (uint32_t slot = (uint32_t)hash & table->slot_mask; table->slots[slot].used; slot = (slot + 1) & table->slot_mask)
+    {
+        const fc_sni_slot* candidate = &table->slots[slot];
+
+        if (candidate->hash == hash && candidate->wildcard == wildcard && candidate->name_count == count &&
+            fc_sni_equals(table->names + candidate->name_offset, host, count))
+        {
+            return candidate;
+        }
+    }
+
+    return NULL;
+}
+
+fc_sni_table* fc_sni_builder_build(fc_sni_builder* builder)
+{
+    if (builder->failed)
+    {
+        fc_sni_builder_free(builder);
+        return NULL;
+    }
+
+    uint32_t slot_count = 16;
+    while (slot_count < 2 * (uint32_t)builder->entry_count) slot_count *= 2;
+
+    // One allocation: table, slots, names
+    size_t size = sizeof(fc_sni_table) + slot_count * sizeof(fc_sni_slot) + builder->names_size;
+
+    fc_sni_table* table = (fc_sni_table*)FC_URI_SNI_REALLOC(NULL, size);
+    if (!table)
+    {
+        fc_sni_builder_free(builder);
+        return NULL;
+    }
+
+    table->slot_mask = slot_count - 1;
+    table->name_count = 0;
+    table->slots = (fc_sni_slot*)(table + 1);
+    table->names = (char*)(table->slots + slot_count);
+
+    memset(table->slots, 0, slot_count * sizeof(fc_sni_slot));
+    if (builder->names_size) memcpy(table->names, builder->names, builder->names_size);
+
+    for (int i = 0; i < builder->entry_count; ++i)
+    {
+        const fc_sni_slot* entry = &builder->entries[i];
+
+        if (fc_sni_find(table, entry->hash, entry->wildcard, table->names + entry->name_offset, entry->name_count)) continue;
+
+        uint32_t slot = (uint32_t)entry->hash & table->slot_mask;
+        while (table->slots[slot].used) slot = (slot + 1) & table->slot_mask;
+
+        table->slots[slot] = *entry;
+        table->name_count++;
+    }
+
+    fc_sni_builder_free(builder);
+
+    return table;
+}
+
+bool fc_sni_table_lookup(const fc_sni_table* table, const char* host, int count, uint32_t* value)
+{
+    uint64_t hash, parent_hash;
+    int first_label;
+
+    if (!table || !fc_sni_hash(host, count, &hash, &parent_hash, &first_label)) return false;
+    if (host[count - 1] == '.') count--;
+
+    const fc_sni_slot* found = fc_sni_find(table, hash, false, host, count);
+
+    if (!found && first_label)
+    {
+        found = fc_sni_find(table, parent_hash ^ FC_SNI_WILDCARD_SALT, true, host + first_label + 1, count - first_label - 1);
+    }
+
+    if (!found) return false;
+
+    *value = found->value;
+
+    return true;
+}
+
+void fc_sni_table_free(fc_sni_table* table)
+{
+    FC_URI_SNI_FREE(table);
+}
+
+void fc_sni_index_init(fc_sni_index* index, fc_sni_table* table)
+{
+    index->table = table;
+    index->epoch = 0;
+    index->readers[0] = 0;
+    index->readers[1] = 0;
+}
+
+bool fc_sni_index_lookup(fc_sni_index* index, const char* host, int count, uint32_t* value)
+{
+    uint64_t* readers;
+
+    // The epoch can flip between reading it and counting ourselves in, then a later swap would wait on the
+    // other counter while we hold the table it returns. Count again under the new epoch.
+    for (;;)
+    {
+        uint64_t epoch = __atomic_load_n(&index->epoch, __ATOMIC_SEQ_CST);
+        readers = &index->readers[epoch & 1];
+        __atomic_fetch_add(readers, 1, __ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(&index->epoch, __ATOMIC_SEQ_CST) == epoch) break;
+
+        __atomic_fetch_sub(readers, 1, __ATOMIC_RELEASE);
+    }
+
+    const fc_sni_table* table = __atomic_load_n(&index->table, __ATOMIC_SEQ_CST);
+    bool found = fc_sni_table_lookup(table, host, count, value);
+
+    __atomic_fetch_sub(readers, 1, __ATOMIC_RELEASE);
+
+    return found;
+}
+
+fc_sni_table* fc_sni_index_swap(fc_sni_index* index, fc_sni_table* table)
+{
+    fc_sni_table* old_table = __atomic_exchange_n(&index->table, table, __ATOMIC_SEQ_CST);
+
+    // Readers that counted themselves in the old epoch may have the old table, the ones after the flip can't
+    uint64_t epoch = __atomic_fetch_add(&index->epoch, 1, __ATOMIC_SEQ_CST);
+
+    while (__atomic_load_n(&index->readers[epoch & 1], __ATOMIC_ACQUIRE)) FC_SNI_PAUSE();
+
+    return old_table;
+}
+
+#endif // FC_URI_SNI_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
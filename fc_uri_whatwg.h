@@ -0,0 +1,1396 @@
+/*
+Author:
+    - Filippo Crocchini
+
+Copyright:
+    This library is available under the MIT license, see end of the file.
+
+Usage:
+    // Do this in only one file
+    "
+        #define FC_URI_PARSE_IMPLEMENTATION
+        #include "fc_uri_parse.h"
+
+        #define FC_URI_WHATWG_IMPLEMENTATION
+        #include "fc_uri_whatwg.h"
+
+        // Just include as usual in the others
+        #include "fc_uri_whatwg.h"
+    "
+
+Example:
+    char href[FC_URI_MAX + 1];
+    fc_uri_view url;
+
+    int count = fc_url_parse("HTTP://EXAMPLE.com:80/a/./b/../c d?x#y", -1, NULL, href, sizeof(href), &url);
+    // href is "http://example.com/a/c%20d?x#y", url.host is "example.com", url.port is not present
+
+    // Relative inputs need a base, which has to be the result of an earlier fc_url_parse
+    char base_href[FC_URI_MAX + 1];
+    fc_uri_view base;
+    fc_url_parse("https://example.com/dir/page", -1, NULL, base_href, sizeof(base_href), &base);
+
+    count = fc_url_parse("..\\other?q", -1, &base, href, sizeof(href), &url);
+    // href is "https://example.com/other?q"
+
+Info:
+    URL parser following the WHATWG URL Standard (https://url.spec.whatwg.org), the way browsers parse URLs.
+    fc_uri_parse follows RFC3986 instead, the two disagree on inputs like "http:\\\\host", "http://host:80" or
+    "HTTP://%65xample.com".
+
+    The output is the serialized URL (href) and views of its components, as in fc_uri_view:
+        - scheme has no ':', host has no brackets for IPv6 addresses (ipv6_host is set)
+        - user and access_info (password) are not present when empty
+        - host is not present for URLs without one ("mailto:x"), present and empty for "file:///x"
+        - port is not present when missing or equal to the default port of the scheme
+        - query and fragment are present but empty for "x:?#"
+    The "/." the standard puts in front of paths starting with "//" in URLs without a host is not part of path.
+
+    Every component is written in one pass over the input, without checking the space left in dst byte by byte
+    when the worst case fits. Hosts made of lowercase letters, digits, '-' and '.' are copied as they are.
+
+    Hosts of special schemes are percent-decoded, lowercased and converted with fc_uri_host_to_ascii. That is
+    Punycode without the UTS46 mapping and validity tables: ASCII hosts are exact, but only fullwidth forms, ideographic
+    full stops and ignored code points are mapped in non-ASCII labels (no case folding or NFC) and most of the code
+    points UTS46 disallows are accepted.
+    Inputs are UTF-8 and no longer than FC_URI_MAX after trimming, queries are always encoded as UTF-8.
+*/
+
+#ifndef FC_URI_WHATWG
+#define FC_URI_WHATWG
+
+#include "fc_uri_parse.h"
+
+// Parses src, resolving it against base when that is not NULL. base has to be the output of an earlier call,
+// its components must point into its own href and must not overlap dst. count can be -1 for null-terminated strings.
+// Writes the href into dst and its components into url. Returns the length of the href (without the '\0'),
+// or -1 if src is not a valid URL or dst is too small.
+int fc_url_parse(const char* src, int count, const fc_uri_view* base, char* dst, int dst_size, fc_uri_view* url);
+
+#endif // FC_URI_WHATWG
+
+#ifdef FC_URI_WHATWG_IMPLEMENTATION
+
+#ifdef FC_URI_SSE2
+#define FC_URL_SSE2 // Delimiter scan
+#include <emmintrin.h>
+#endif
+
+#define FC_URL_ENCODE_C0             0x01
+#define FC_URL_ENCODE_FRAGMENT       0x02
+#define FC_URL_ENCODE_QUERY          0x04
+#define FC_URL_ENCODE_SPECIAL_QUERY  0x08
+#define FC_URL_ENCODE_PATH           0x10
+#define FC_URL_ENCODE_USERINFO       0x20
+#define FC_URL_FORBIDDEN_HOST        0x40
+#define FC_URL_FORBIDDEN_DOMAIN      0x80
+
+// Percent-encode sets and forbidden host code points of the ASCII range, everything else is encoded.
+static const unsigned char fc_url_ascii_class[128] = {
+    0xFF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xFF, 0xFF, 0xBF, 0xBF, 0xFF, 0xBF, 0xBF,
+    0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF, 0xBF,
+    0xFE, 0x00, 0x3E, 0xFC, 0x00, 0x80, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0x20, 0xFE, 0x20, 0xFE, 0xF0,
+    0xE0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xE0, 0xE0, 0xE0, 0xE0, 0x00,
+    0x32, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x30, 0xE0, 0x30, 0x00, 0xBF,
+};
+
+typedef struct
+{
+    const char* end;
+    const fc_uri_view* base;
+
+    char* dst;
+    int dst_size;
+    int count;
+    bool overflow;
+
+    bool special;
+    bool file;
+    int default_port; // -1 for none
+
+    // Offsets of the components in dst, begin is -1 for the missing ones
+    int begin[FC_URI_COMPONENT_COUNT];
+    int end_of[FC_URI_COMPONENT_COUNT];
+    bool ipv6_host;
+} fc_url_state;
+
+static void fc_url_put(fc_url_state* state, const char* data, int count)
+{
+    if (state->overflow || count > state->dst_size - 1 - state->count)
+    {
+        state->overflow = true;
+        return;
+    }
+
+    memcpy(state->dst + state->count, data, count);
+    state->count += count;
+}
+
+static void fc_url_put_char(fc_url_state* state, char c)
+{
+    if (state->overflow || state->count >= state->dst_size - 1)
+    {
+        state->overflow = true;
+        return;
+    }
+
+    state->dst[state->count++] = c;
+}
+
+static void fc_url_put_encoded(fc_url_state* state, const char* data, int count, unsigned char set)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    const unsigned char* c   = (const unsigned char*)data;
+    const unsigned char* end = c + count;
+
+    // Byte by byte when it might not fit, there is no need to check every byte otherwise
+    if (state->overflow || count > (state->dst_size - 1 - state->count) / 3)
+    {
+        for (; c != end; ++c)
+        {
+            if (*c < 0x80 && !(fc_url_ascii_class[*c] & set)) {
+                fc_url_put_char(state, (char)*c);
+            } else {
+                char encoded[3] = { '%', hex[*c >> 4], hex[*c & 15] };
+                fc_url_put(state, encoded, 3);
+            }
+        }
+
+        return;
+    }
+
+    char* out = state->dst + state->count;
+
+    for (; c != end; ++c)
+    {
+        if (*c < 0x80 && !(fc_url_ascii_class[*c] & set)) {
+            *out++ = (char)*c;
+        } else {
+            out[0] = '%';
+            out[1] = hex[*c >> 4];
+            out[2] = hex[*c & 15];
+            out += 3;
+        }
+    }
+
+    state->count = (int)(out - state->dst);
+}
+
+static void fc_url_put_decimal(fc_url_state* state, uint32_t value)
+{
+    char digits[10];
+    int count = 0;
+
+    do
+    {
+        digits[sizeof(digits) - 1 - count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    fc_url_put(state, digits + sizeof(digits) - count, count);
+}
+
+static bool fc_url_is_alpha(char c)
+{
+    return (unsigned)((c | 0x20) - 'a') < 26;
+}
+
+static bool fc_url_is_digit(char c)
+{
+    return (unsigned)(c - '0') < 10;
+}
+
+static int fc_url_hex_value(char c)
+{
+    if (fc_url_is_digit(c)) return c - '0';
+    if ((unsigned)((c | 0x20) - 'a') < 6) return (c | 0x20) - 'a' + 10;
+    return -1;
+}
+
+static bool fc_url_is_slash(const fc_url_state* state, char c)
+{
+    return c == '/' || (state->special && c == '\\');
+}
+
+// First tab or newline, they are removed from the input.
+static const char* fc_url_scan_newline(const char* c, const char* end)
+{
+#ifdef FC_URL_SSE2
+    while (end - c >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)c);
+
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')),
+                                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+
+        int found_mask = _mm_movemask_epi8(found);
+        if (found_mask) return c + fc_uri_ctz(found_mask);
+
+        c += 16;
+    }
+#endif
+
+    while (c != end && ((unsigned char)*c > '\r' || (*c != '\t' && *c != '\n' && *c != '\r'))) c++;
+
+    return c;
+}
+
+// End of the path segment, or of the authority. Called once per segment, the stops are constants.
+static const char* fc_url_scan_delimiter(const fc_url_state* state, const char* c)
+{
+    const char* end = state->end;
+
+#ifdef FC_URL_SSE2
+    const __m128i backslash = state->special ? _mm_set1_epi8('\\') : _mm_set1_epi8('/');
+
+    while (end - c >= 16)
+    {
+        __m128i block = _mm_loadu_si128((const __m128i*)c);
+
+        __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('/')), _mm_cmpeq_epi8(block, backslash)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('?')), _mm_cmpeq_epi8(block, _mm_set1_epi8('#'))));
+
+        int found_mask = _mm_movemask_epi8(found);
+        if (found_mask) return c + fc_uri_ctz(found_mask);
+
+        c += 16;
+    }
+#endif
+
+    while (c != end && *c != '/' && *c != '?' && *c != '#' && !(state->special && *c == '\\')) c++;
+
+    return c;
+}
+
+// "C:" or "C|"
+static bool fc_url_is_drive_letter(const char* data, int count)
+{
+    return count == 2 && fc_url_is_alpha(data[0]) && (data[1] == ':' || data[1] == '|');
+}
+
+static bool fc_url_starts_with_drive_letter(const char* data, const char* end)
+{
+    if (end - data < 2 || !fc_url_is_drive_letter(data, 2)) return false;
+
+    return end - data == 2 || data[2] == '/' || data[2] == '\\' || data[2] == '?' || data[2] == '#';
+}
+
+// Path made of just "/C:"
+static bool fc_url_is_drive_letter_path(const char* path, int count)
+{
+    return count == 3 && path[0] == '/' && fc_url_is_alpha(path[1]) && path[2] == ':';
+}
+
+// 1 for ".", 2 for "..", percent-encoded dots included. 0 otherwise.
+static int fc_url_dot_segment(const char* data, int count)
+{
+    int dots = 0;
+
+    for (int i = 0; i < count; ++dots)
+    {
+        if (dots == 2) return 0;
+
+        if (data[i] == '.') {
+            i += 1;
+        } else if (i + 3 <= count && data[i] == '%' && data[i + 1] == '2' && (data[i + 2] | 0x20) == 'e') {
+            i += 3;
+        } else {
+            return 0;
+        }
+    }
+
+    return dots;
+}
+
+// ------------------------------------------------------------------------------------------------------------
+// Hosts
+
+// Decimal, octal ("0" prefix) or hexadecimal ("0x" prefix). Saturates above 32 bits.
+static bool fc_url_ipv4_number(const char* data, int count, uint64_t* value)
+{
+    if (count == 0) return false;
+
+    int radix = 10;
+
+    if (count >= 2 && data[0] == '0' && (data[1] | 0x20) == 'x') {
+        radix = 16;
+        data += 2;
+        count -= 2;
+    } else if (count >= 2 && data[0] == '0') {
+        radix = 8;
+        data += 1;
+        count -= 1;
+    }
+
+    uint64_t result = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        int digit = fc_url_hex_value(data[i]);
+        if (digit < 0 || digit >= radix) return false;
+
+        result = result * radix + digit;
+        if (result > 0xFFFFFFFFFull) result = 0xFFFFFFFFFull;
+    }
+
+    *value = result;
+
+    return true;
+}
+
+static bool fc_url_ends_in_number(const char* host, int count)
+{
+    if (count && host[count - 1] == '.') count--;
+
+    int last = count;
+    while (last && host[last - 1] != '.') last--;
+
+    if (last == count) return false;
+
+    bool digits = true;
+    for (int i = last; i < count && digits; ++i) digits = fc_url_is_digit(host[i]);
+
+    if (digits) return true;
+
+    if (count - last < 2 || host[last] != '0' || (host[last + 1] | 0x20) != 'x') return false;
+
+    for (int i = last + 2; i < count; ++i)
+    {
+        if (fc_url_hex_value(host[i]) < 0) return false;
+    }
+
+    return true;
+}
+
+static bool fc_url_parse_ipv4(const char* host, int count, uint32_t* address)
+{
+    if (count && host[count - 1] == '.') count--;
+
+    uint64_t numbers[4];
+    int number_count = 0;
+
+    for (int part = 0; part <= count;)
+    {
+        int end = part;
+        while (end < count && host[end] != '.') end++;
+
+        if (number_count == 4 || !fc_url_ipv4_number(host + part, end - part, &numbers[number_count])) return false;
+        number_count++;
+
+        part = end + 1;
+    }
+
+    for (int i = 0; i + 1 < number_count; ++i)
+    {
+        if (numbers[i] > 255) return false;
+    }
+
+    if (numbers[number_count - 1] >= (1ull << (8 * (5 - number_count)))) return false;
+
+    uint64_t result = numbers[number_count - 1];
+    for (int i = 0; i + 1 < number_count; ++i)
+    {
+        result += numbers[i] << (8 * (3 - i));
+    }
+
+    *address = (uint32_t)result;
+
+    return true;
+}
+
+static bool fc_url_parse_ipv6(const char* data, int count, uint16_t pieces[8])
+{
+    const char* c   = data;
+    const char* end = data + count;
+
+    int piece = 0;
+    int compress = -1;
+
+    memset(pieces, 0, 8 * sizeof(uint16_t));
+
+    if (c != end && *c == ':')
+    {
+        if (end - c < 2 || c[1] != ':') return false;
+
+        c += 2;
+        compress = ++piece;
+    }
+
+    while (c != end)
+    {
+        if (piece == 8) return false;
+
+        if (*c == ':')
+        {
+            if (compress != -1) return false;
+
+            c++;
+            compress = ++piece;
+            continue;
+        }
+
+        int value = 0;
+        int length = 0;
+
+        while (length < 4 && c != end && fc_url_hex_value(*c) >= 0)
+        {
+            value = value * 16 + fc_url_hex_value(*c);
+            c++;
+            length++;
+        }
+
+        if (c != end && *c == '.')
+        {
+            // Embedded IPv4 address, strictly dotted decimal
+            if (length == 0 || piece > 6) return false;
+
+            c -= length;
+
+            int numbers_seen = 0;
+
+            while (c != end)
+            {
+                if (numbers_seen > 0)
+                {
+                    if (*c != '.' || numbers_seen == 4) return false;
+                    c++;
+                }
+
+                if (c == end || !fc_url_is_digit(*c)) return false;
+
+                int number = -1;
+
+                while (c != end && fc_url_is_digit(*c))
+                {
+                    if (number == 0) return false;
+
+                    number = (number < 0 ? 0 : number * 10) + (*c - '0');
+                    if (number > 255) return false;
+                    c++;
+                }
+
+                pieces[piece] = (uint16_t)(pieces[piece] * 0x100 + number);
+                numbers_seen++;
+
+                if (numbers_seen == 2 || numbers_seen == 4) piece++;
+            }
+
+            if (numbers_seen != 4) return false;
+            break;
+        }
+
+        if (c != end && *c == ':') {
+            c++;
+            if (c == end) return false;
+        } else if (c != end) {
+            return false;
+        }
+
+        pieces[piece++] = (uint16_t)value;
+    }
+
+    if (compress != -1) {
+        int swaps = piece - compress;
+
+        for (piece = 7; piece != 0 && swaps > 0; --piece, --swaps)
+        {
+            uint16_t swap = pieces[piece];
+            pieces[piece] = pieces[compress + swaps - 1];
+            pieces[compress + swaps - 1] = swap;
+        }
+    } else if (piece != 8) {
+        return false;
+    }
+
+    return true;
+}
+
+static void fc_url_put_ipv6(fc_url_state* state, const uint16_t pieces[8])
+{
+    static const char hex[] = "0123456789abcdef";
+
+    // The first longest run of two or more zeroes becomes "::"
+    int compress = -1;
+    int compress_length = 1;
+
+    for (int i = 0; i < 8;)
+    {
+        int run = i;
+        while (run < 8 && pieces[run] == 0) run++;
+
+        if (run - i > compress_length)
+        {
+            compress = i;
+            compress_length = run - i;
+        }
+
+        i = run == i ? i + 1 : run;
+    }
+
+    for (int i = 0; i < 8; ++i)
+    {
+        if (i == compress)
+        {
+            fc_url_put(state, i == 0 ? "::" : ":", i == 0 ? 2 : 1);
+            i += compress_length - 1;
+            continue;
+        }
+
+        char digits[4];
+        int count = 0;
+
+        for (int shift = 12; shift >= 0; shift -= 4)
+        {
+            int digit = (pieces[i] >> shift) & 15;
+            if (digit || count || shift == 0) digits[count++] = hex[digit];
+        }
+
+        fc_url_put(state, digits, count);
+        if (i != 7) fc_url_put_char(state, ':');
+    }
+}
+
+static bool fc_url_valid_utf8(const unsigned char* data, int count)
+{
+    for (int i = 0; i < count;)
+    {
+        unsigned char c = data[i];
+
+        int need;
+        unsigned char lo = 0x80, hi = 0xBF;
+
+        if      (c < 0x80)                { i++; continue; }
+        else if (c >= 0xC2 && c <= 0xDF) { need = 1; }
+        else if (c == 0xE0)              { need = 2; lo = 0xA0; }
+        else if (c == 0xED)              { need = 2; hi = 0x9F; }
+        else if (c >= 0xE1 && c <= 0xEF) { need = 2; }
+        else if (c == 0xF0)              { need = 3; lo = 0x90; }
+        else if (c >= 0xF1 && c <= 0xF3) { need = 3; }
+        else if (c == 0xF4)              { need = 3; hi = 0x8F; }
+        else return false;
+
+        if (count - i <= need) return false;
+
+        for (int k = 1; k <= need; ++k)
+        {
+            unsigned char next = data[i + k];
+            if (next < lo || next > hi) return false;
+
+            lo = 0x80;
+            hi = 0xBF;
+        }
+
+        i += need + 1;
+    }
+
+    return true;
+}
+
+// The UTS46 mappings that don't need tables, in place on valid UTF-8: fullwidth ASCII, ideographic full stops
+// and code points mapped to nothing. Noncharacters and U+FFFD are disallowed, returns -1 for them.
+static int fc_url_map_domain(char* domain, int count)
+{
+    int written = 0;
+
+    for (int i = 0; i < count;)
+    {
+        unsigned char c = (unsigned char)domain[i];
+        int length = c < 0x80 ? 1 : c < 0xE0 ? 2 : c < 0xF0 ? 3 : 4;
+
+        uint32_t code_point = length == 1 ? c : c & (0x7F >> length);
+        for (int k = 1; k < length; ++k) code_point = (code_point << 6) | (domain[i + k] & 0x3F);
+
+        if ((code_point >= 0xFDD0 && code_point <= 0xFDEF) || (code_point & 0xFFFE) == 0xFFFE || code_point == 0xFFFD) return -1;
+
+        bool ignored = code_point == 0xAD || code_point == 0x34F || (code_point >= 0x180B && code_point <= 0x180D) ||
+                       code_point == 0x200B || code_point == 0x2060 || (code_point >= 0xFE00 && code_point <= 0xFE0F) ||
+                       code_point == 0xFEFF;
+
+        if (code_point >= 0xFF01 && code_point <= 0xFF5E) {
+            char ascii = (char)(code_point - 0xFF01 + 0x21);
+            domain[written++] = (unsigned)(ascii - 'A') < 26 ? (char)(ascii | 0x20) : ascii;
+        } else if (code_point == 0x3002 || code_point == 0xFF61) {
+            domain[written++] = '.';
+        } else if (code_point == 0x3000) {
+            domain[written++] = ' ';
+        } else if (!ignored) {
+            memmove(domain + written, domain + i, length);
+            written += length;
+        }
+
+        i += length;
+    }
+
+    return written;
+}
+
+// Host of a special scheme: domain or IPv4 address.
+static bool fc_url_put_domain(fc_url_state* state, const char* data, int count)
+{
+    // Already canonical: lowercase letters, digits, '-' and '.', no "--" of ACE labels and not an IPv4 address
+    int plain = 0;
+    bool dashes = false;
+
+    for (; plain < count; ++plain)
+    {
+        char c = data[plain];
+        if (!((unsigned)(c - 'a') < 26 || fc_url_is_digit(c) || c == '.' || c == '-')) break;
+
+        dashes |= c == '-' && plain && data[plain - 1] == '-';
+    }
+
+    if (plain == count && count && !dashes && !fc_url_ends_in_number(data, count))
+    {
+        fc_url_put(state, data, count);
+        return true;
+    }
+
+    char decoded[FC_URI_MAX];
+    int decoded_count = 0;
+    bool ascii = true;
+
+    for (int i = 0; i < count; ++i)
+    {
+        char c = data[i];
+
+        if (c == '%' && i + 2 < count && fc_url_hex_value(data[i + 1]) >= 0 && fc_url_hex_value(data[i + 2]) >= 0)
+        {
+            c = (char)(fc_url_hex_value(data[i + 1]) * 16 + fc_url_hex_value(data[i + 2]));
+            i += 2;
+        }
+
+        if ((unsigned)(c - 'A') < 26) c |= 0x20;
+        if ((unsigned char)c >= 0x80) ascii = false;
+
+        decoded[decoded_count++] = c;
+    }
+
+    const char* host = decoded;
+    char idna[FC_URI_HOST_MAX + 1];
+
+    if (!ascii)
+    {
+        if (!fc_url_valid_utf8((const unsigned char*)decoded, decoded_count)) return false;
+
+        decoded_count = fc_url_map_domain(decoded, decoded_count);
+        if (decoded_count < 0) return false;
+
+        ascii = true;
+        for (int i = 0; i < decoded_count && ascii; ++i) ascii = (unsigned char)decoded[i] < 0x80;
+    }
+
+    if (!ascii)
+    {
+        decoded_count = fc_uri_host_to_ascii(decoded, decoded_count, idna, sizeof(idna), &host);
+        if (decoded_count < 0) return false;
+    }
+
+    if (decoded_count == 0) return false;
+
+    for (int i = 0; i < decoded_count; ++i)
+    {
+        unsigned char c = (unsigned char)host[i];
+        if (c >= 0x80 || (fc_url_ascii_class[c] & FC_URL_FORBIDDEN_DOMAIN)) return false;
+    }
+
+    // ACE labels have to decode
+    for (int label = 0; label < decoded_count;)
+    {
+        int end = label;
+        while (end < decoded_count && host[end] != '.') end++;
+
+        if (end - label >= 4 && host[label] == 'x' && host[label + 1] == 'n' && host[label + 2] == '-' && host[label + 3] == '-')
+        {
+            char unicode[FC_URI_HOST_MAX * 4];
+            if (end - label == 4 || fc_punycode_decode(host + label + 4, end - label - 4, unicode, sizeof(unicode)) <= 0) return false;
+        }
+
+        label = end + 1;
+    }
+
+    if (fc_url_ends_in_number(host, decoded_count))
+    {
+        uint32_t address;
+        if (!fc_url_parse_ipv4(host, decoded_count, &address)) return false;
+
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            fc_url_put_decimal(state, (address >> shift) & 0xFF);
+            if (shift) fc_url_put_char(state, '.');
+        }
+
+        return true;
+    }
+
+    fc_url_put(state, host, decoded_count);
+
+    return true;
+}
+
+static bool fc_url_put_host(fc_url_state* state, const char* data, int count)
+{
+    if (count && data[0] == '[')
+    {
+        uint16_t pieces[8];
+        if (data[count - 1] != ']' || count < 2 || !fc_url_parse_ipv6(data + 1, count - 2, pieces)) return false;
+
+        fc_url_put_char(state, '[');
+        state->begin[FC_URI_HOST] = state->count;
+        fc_url_put_ipv6(state, pieces);
+        state->end_of[FC_URI_HOST] = state->count;
+        fc_url_put_char(state, ']');
+
+        state->ipv6_host = true;
+
+        return true;
+    }
+
+    state->begin[FC_URI_HOST] = state->count;
+
+    if (state->special) {
+        if (!fc_url_put_domain(state, data, count)) return false;
+    } else {
+        // Opaque host
+        for (int i = 0; i < count; ++i)
+        {
+            unsigned char c = (unsigned char)data[i];
+            if (c < 0x80 && (fc_url_ascii_class[c] & FC_URL_FORBIDDEN_HOST)) return false;
+        }
+
+        fc_url_put_encoded(state, data, count, FC_URL_ENCODE_C0);
+    }
+
+    state->end_of[FC_URI_HOST] = state->count;
+
+    return true;
+}
+
+static bool fc_url_put_port(fc_url_state* state, const char* data, int count)
+{
+    if (count == 0) return true;
+
+    uint32_t port = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (!fc_url_is_digit(data[i])) return false;
+
+        port = port * 10 + (data[i] - '0');
+        if (port > 65535) return false;
+    }
+
+    if ((int)port == state->default_port) return true;
+
+    fc_url_put_char(state, ':');
+    state->begin[FC_URI_PORT] = state->count;
+    fc_url_put_decimal(state, port);
+    state->end_of[FC_URI_PORT] = state->count;
+
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------------------
+// Base URL
+
+static void fc_url_copy_component(fc_url_state* state, fc_uri_component component, fc_uri_str value)
+{
+    state->begin[component] = state->count;
+    fc_url_put(state, value.data, value.count);
+    state->end_of[component] = state->count;
+}
+
+static void fc_url_copy_base_host(fc_url_state* state)
+{
+    const fc_uri_view* base = state->base;
+
+    if (base->ipv6_host) fc_url_put_char(state, '[');
+    fc_url_copy_component(state, FC_URI_HOST, base->host);
+    if (base->ipv6_host) fc_url_put_char(state, ']');
+
+    state->ipv6_host = base->ipv6_host;
+}
+
+// Credentials, host and port. Nothing for URLs without a host.
+static void fc_url_copy_base_authority(fc_url_state* state)
+{
+    const fc_uri_view* base = state->base;
+
+    if (!base->host.data) return;
+
+    fc_url_put(state, "//", 2);
+
+    if (base->user.data) fc_url_copy_component(state, FC_URI_USER, base->user);
+
+    if (base->access_info.data)
+    {
+        fc_url_put_char(state, ':');
+        fc_url_copy_component(state, FC_URI_ACCESS_INFO, base->access_info);
+    }
+
+    if (base->user.data || base->access_info.data) fc_url_put_char(state, '@');
+
+    fc_url_copy_base_host(state);
+
+    if (base->port.data)
+    {
+        fc_url_put_char(state, ':');
+        fc_url_copy_component(state, FC_URI_PORT, base->port);
+    }
+}
+
+static void fc_url_copy_base_query(fc_url_state* state)
+{
+    if (!state->base->query.data) return;
+
+    fc_url_put_char(state, '?');
+    fc_url_copy_component(state, FC_URI_QUERY, state->base->query);
+}
+
+// ------------------------------------------------------------------------------------------------------------
+// Path, query and fragment
+
+// Removes the last segment, except for the drive letter of file URLs.
+static void fc_url_shorten_path(fc_url_state* state)
+{
+    int begin = state->begin[FC_URI_PATH];
+
+    if (state->overflow) return;
+    if (state->file && fc_url_is_drive_letter_path(state->dst + begin, state->count - begin)) return;
+
+    int last = state->count;
+    while (last > begin && state->dst[last - 1] != '/') last--;
+
+    if (last > begin) state->count = last - 1;
+}
+
+// From the beginning of a segment to the end of the path, the segments are appended to the current path.
+static const char* fc_url_parse_path(fc_url_state* state, const char* c)
+{
+    const char* end = state->end;
+
+    for (;;)
+    {
+        const char* segment = c;
+        c = fc_url_scan_delimiter(state, c);
+
+        bool more = c != end && fc_url_is_slash(state, *c);
+        int dots = fc_url_dot_segment(segment, (int)(c - segment));
+
+        if (dots == 2) {
+            fc_url_shorten_path(state);
+            if (!more) fc_url_put_char(state, '/');
+        } else if (dots == 1) {
+            if (!more) fc_url_put_char(state, '/');
+        } else {
+            fc_url_put_char(state, '/');
+
+            if (state->file && state->count - 1 == state->begin[FC_URI_PATH] && fc_url_is_drive_letter(segment, (int)(c - segment))) {
+                char drive[2] = { segment[0], ':' };
+                fc_url_put(state, drive, 2);
+            } else {
+                fc_url_put_encoded(state, segment, (int)(c - segment), FC_URL_ENCODE_PATH);
+            }
+        }
+
+        if (!more) return c;
+        c++;
+    }
+}
+
+static void fc_url_parse_query(fc_url_state* state, const char* c)
+{
+    const char* end = state->end;
+
+    if (c != end && *c == '?')
+    {
+        const char* query_end = (const char*)memchr(c + 1, '#', end - c - 1);
+        if (!query_end) query_end = end;
+
+        fc_url_put_char(state, '?');
+        state->begin[FC_URI_QUERY] = state->count;
+        fc_url_put_encoded(state, c + 1, (int)(query_end - c - 1), state->special ? FC_URL_ENCODE_SPECIAL_QUERY : FC_URL_ENCODE_QUERY);
+
+        c = query_end;
+    }
+
+    if (c != end && *c == '#')
+    {
+        fc_url_put_char(state, '#');
+        state->begin[FC_URI_FRAGMENT] = state->count;
+        fc_url_put_encoded(state, c + 1, (int)(end - c - 1), FC_URL_ENCODE_FRAGMENT);
+    }
+}
+
+// Right after the authority
+static void fc_url_parse_path_start(fc_url_state* state, const char* c)
+{
+    state->begin[FC_URI_PATH] = state->count;
+
+    if (state->special) {
+        if (c != state->end && fc_url_is_slash(state, *c)) c++;
+        c = fc_url_parse_path(state, c);
+    } else if (c != state->end && *c == '/') {
+        c = fc_url_parse_path(state, c + 1);
+    }
+
+    fc_url_parse_query(state, c);
+}
+
+static void fc_url_parse_opaque_path(fc_url_state* state, const char* c)
+{
+    const char* end = state->end;
+    const char* path = c;
+
+    while (c != end && *c != '?' && *c != '#') c++;
+
+    state->begin[FC_URI_PATH] = state->count;
+    fc_url_put_encoded(state, path, (int)(c - path), FC_URL_ENCODE_C0);
+
+    fc_url_parse_query(state, c);
+}
+
+// ------------------------------------------------------------------------------------------------------------
+// Authority
+
+// Cursor right after the slashes, returns the end of the authority or NULL if it is not valid.
+static const char* fc_url_parse_authority(fc_url_state* state, const char* c)
+{
+    const char* authority_end = fc_url_scan_delimiter(state, c);
+
+    fc_url_put(state, "//", 2);
+
+    // Credentials end at the last '@', the others are encoded
+    const char* host = c;
+    const char* first_at = (const char*)memchr(c, '@', authority_end - c);
+
+    for (const char* at = authority_end; first_at && at != c; --at)
+    {
+        if (at[-1] == '@')
+        {
+            host = at;
+            break;
+        }
+    }
+
+    if (host != c)
+    {
+        const char* userinfo_end = host - 1;
+        const char* colon = (const char*)memchr(c, ':', userinfo_end - c);
+        const char* user_end = colon ? colon : userinfo_end;
+
+        if (user_end != c)
+        {
+            state->begin[FC_URI_USER] = state->count;
+            fc_url_put_encoded(state, c, (int)(user_end - c), FC_URL_ENCODE_USERINFO);
+            state->end_of[FC_URI_USER] = state->count;
+        }
+
+        if (colon && colon + 1 != userinfo_end)
+        {
+            fc_url_put_char(state, ':');
+            state->begin[FC_URI_ACCESS_INFO] = state->count;
+            fc_url_put_encoded(state, colon + 1, (int)(userinfo_end - colon - 1), FC_URL_ENCODE_USERINFO);
+            state->end_of[FC_URI_ACCESS_INFO] = state->count;
+        }
+
+        if (user_end != c || (colon && colon + 1 != userinfo_end)) fc_url_put_char(state, '@');
+
+        if (host == authority_end) return NULL;
+    }
+
+    // The ':' of IPv6 addresses don't start the port
+    const char* host_end = host;
+    bool brackets = false;
+
+    if (!memchr(host, '[', authority_end - host)) {
+        host_end = (const char*)memchr(host, ':', authority_end - host);
+        if (!host_end) host_end = authority_end;
+    } else {
+        while (host_end != authority_end && (*host_end != ':' || brackets))
+        {
+            if (*host_end == '[') brackets = true;
+            if (*host_end == ']') brackets = false;
+            host_end++;
+        }
+    }
+
+    if (host_end == host && (host_end != authority_end || state->special)) return NULL;
+
+    if (!fc_url_put_host(state, host, (int)(host_end - host))) return NULL;
+
+    if (host_end != authority_end && !fc_url_put_port(state, host_end + 1, (int)(authority_end - host_end - 1))) return NULL;
+
+    return authority_end;
+}
+
+// ------------------------------------------------------------------------------------------------------------
+// Relative and file URLs
+
+static bool fc_url_parse_relative(fc_url_state* state, const char* c)
+{
+    const fc_uri_view* base = state->base;
+    const char* end = state->end;
+
+    bool slash = c != end && fc_url_is_slash(state, *c);
+
+    if (slash && end - c >= 2 && fc_url_is_slash(state, c[1]))
+    {
+        c += 2;
+        if (state->special) while (c != end && fc_url_is_slash(state, *c)) c++;
+
+        c = fc_url_parse_authority(state, c);
+        if (!c) return false;
+
+        fc_url_parse_path_start(state, c);
+        return true;
+    }
+
+    fc_url_copy_base_authority(state);
+    state->begin[FC_URI_PATH] = state->count;
+
+    if (slash)
+    {
+        fc_url_parse_query(state, fc_url_parse_path(state, c + 1));
+        return true;
+    }
+
+    fc_url_put(state, base->path.data, base->path.count);
+
+    if (c == end) {
+        fc_url_copy_base_query(state);
+    } else if (*c == '?') {
+        fc_url_parse_query(state, c);
+    } else if (*c == '#') {
+        fc_url_copy_base_query(state);
+        fc_url_parse_query(state, c);
+    } else {
+        fc_url_shorten_path(state);
+        fc_url_parse_query(state, fc_url_parse_path(state, c));
+    }
+
+    return true;
+}
+
+static bool fc_url_parse_file(fc_url_state* state, const char* c)
+{
+    const char* end = state->end;
+
+    const fc_uri_view* base = state->base;
+    if (base && (base->scheme.count != 4 || memcmp(base->scheme.data, "file", 4) != 0)) base = NULL;
+
+    fc_url_put(state, "//", 2);
+
+    if (c != end && fc_url_is_slash(state, *c) && end - c >= 2 && fc_url_is_slash(state, c[1]))
+    {
+        c += 2;
+
+        const char* host_end = fc_url_scan_delimiter(state, c);
+
+        if (fc_url_is_drive_letter(c, (int)(host_end - c)))
+        {
+            // "file://C:/", the drive letter is the first segment
+            state->begin[FC_URI_HOST] = state->end_of[FC_URI_HOST] = state->count;
+            state->begin[FC_URI_PATH] = state->count;
+
+            fc_url_parse_query(state, fc_url_parse_path(state, c));
+            return true;
+        }
+
+        if (host_end == c) {
+            state->begin[FC_URI_HOST] = state->end_of[FC_URI_HOST] = state->count;
+        } else {
+            if (!fc_url_put_host(state, c, (int)(host_end - c))) return false;
+
+            int host = state->begin[FC_URI_HOST];
+            if (!state->overflow && state->count - host == 9 && memcmp(state->dst + host, "localhost", 9) == 0)
+            {
+                state->count = state->end_of[FC_URI_HOST] = host;
+            }
+        }
+
+        fc_url_parse_path_start(state, host_end);
+        return true;
+    }
+
+    if (base) {
+        fc_url_copy_base_host(state);
+    } else {
+        state->begin[FC_URI_HOST] = state->end_of[FC_URI_HOST] = state->count;
+    }
+
+    state->begin[FC_URI_PATH] = state->count;
+
+    if (c != end && fc_url_is_slash(state, *c))
+    {
+        // "file:/path", keeps the drive letter of the base
+        if (base && !fc_url_starts_with_drive_letter(c + 1, end) && base->path.count >= 3 &&
+            fc_url_is_drive_letter_path(base->path.data, 3) && (base->path.count == 3 || base->path.data[3] == '/'))
+        {
+            fc_url_put(state, base->path.data, 3);
+        }
+
+        fc_url_parse_query(state, fc_url_parse_path(state, c + 1));
+        return true;
+    }
+
+    if (base)
+    {
+        if (c == end || *c == '?' || *c == '#')
+        {
+            fc_url_put(state, base->path.data, base->path.count);
+            if (c == end || *c == '#') fc_url_copy_base_query(state);
+
+            fc_url_parse_query(state, c);
+            return true;
+        }
+
+        if (!fc_url_starts_with_drive_letter(c, end))
+        {
+            fc_url_put(state, base->path.data, base->path.count);
+            fc_url_shorten_path(state);
+        }
+    }
+
+    fc_url_parse_query(state, fc_url_parse_path(state, c));
+
+    return true;
+}
+
+// ------------------------------------------------------------------------------------------------------------
+
+static void fc_url_set_scheme_kind(fc_url_state* state, const char* scheme, int count)
+{
+    static const struct { const char* name; int count; int port; } special[] = {
+        { "http", 4, 80 }, { "https", 5, 443 }, { "ws", 2, 80 }, { "wss", 3, 443 }, { "ftp", 3, 21 }, { "file", 4, -1 },
+    };
+
+    state->special = false;
+    state->file = false;
+    state->default_port = -1;
+
+    for (int i = 0; i < (int)(sizeof(special) / sizeof(special[0])); ++i)
+    {
+        if (special[i].count == count && memcmp(special[i].name, scheme, count) == 0)
+        {
+            state->special = true;
+            state->file = i == 5;
+            state->default_port = special[i].port;
+        }
+    }
+}
+
+static bool fc_url_parse_state(fc_url_state* state, const char* src)
+{
+    const fc_uri_view* base = state->base;
+    const char* end = state->end;
+
+    // scheme ":" if there is one
+    const char* c = src;
+    bool has_scheme = false;
+
+    if (c != end && fc_url_is_alpha(*c))
+    {
+        c++;
+        while (c != end && (fc_url_is_alpha(*c) || fc_url_is_digit(*c) || *c == '+' || *c == '-' || *c == '.')) c++;
+
+        has_scheme = c != end && *c == ':';
+    }
+
+    state->begin[FC_URI_SCHEME] = 0;
+
+    if (!has_scheme)
+    {
+        if (!base) return false;
+
+        bool opaque_base = !base->host.data && (base->path.count == 0 || base->path.data[0] != '/');
+
+        fc_url_copy_component(state, FC_URI_SCHEME, base->scheme);
+        fc_url_put_char(state, ':');
+        fc_url_set_scheme_kind(state, base->scheme.data, base->scheme.count);
+
+        if (opaque_base)
+        {
+            // Only fragments can be resolved against "mailto:x"
+            if (src == end || *src != '#') return false;
+
+            fc_url_copy_component(state, FC_URI_PATH, base->path);
+            fc_url_copy_base_query(state);
+            fc_url_parse_query(state, src);
+            return true;
+        }
+
+        return state->file ? fc_url_parse_file(state, src) : fc_url_parse_relative(state, src);
+    }
+
+    int scheme_count = (int)(c - src);
+    if (scheme_count + 1 > state->dst_size - 1) return false;
+
+    for (int i = 0; i < scheme_count; ++i)
+    {
+        state->dst[i] = (unsigned)(src[i] - 'A') < 26 ? (char)(src[i] | 0x20) : src[i];
+    }
+
+    state->dst[scheme_count] = ':';
+    state->count = scheme_count + 1;
+    state->end_of[FC_URI_SCHEME] = scheme_count;
+
+    const char* scheme = state->dst;
+
+    fc_url_set_scheme_kind(state, scheme, scheme_count);
+    c++;
+
+    if (state->file) return fc_url_parse_file(state, c);
+
+    if (state->special)
+    {
+        if (base && base->scheme.count == scheme_count && memcmp(base->scheme.data, scheme, scheme_count) == 0)
+        {
+            return fc_url_parse_relative(state, c);
+        }
+
+        while (c != end && fc_url_is_slash(state, *c)) c++;
+
+        c = fc_url_parse_authority(state, c);
+        if (!c) return false;
+
+        fc_url_parse_path_start(state, c);
+        return true;
+    }
+
+    if (c != end && *c == '/')
+    {
+        if (end - c >= 2 && c[1] == '/')
+        {
+            c = fc_url_parse_authority(state, c + 2);
+            if (!c) return false;
+
+            fc_url_parse_path_start(state, c);
+            return true;
+        }
+
+        state->begin[FC_URI_PATH] = state->count;
+        fc_url_parse_query(state, fc_url_parse_path(state, c + 1));
+        return true;
+    }
+
+    fc_url_parse_opaque_path(state, c);
+
+    return true;
+}
+
+int fc_url_parse(const char* src, int count, const fc_uri_view* base, char* dst, int dst_size, fc_uri_view* url)
+{
+    if (count < 0) count = (int)strlen(src);
+
+    // Leading and trailing C0 controls and spaces are removed, tabs and newlines are removed everywhere
+    while (count && (unsigned char)src[0] <= 0x20) { src++; count--; }
+    while (count && (unsigned char)src[count - 1] <= 0x20) count--;
+
+    if (count > FC_URI_MAX || dst_size <= 0) return -1;
+
+    char clean[FC_URI_MAX];
+    const char* newline = fc_url_scan_newline(src, src + count);
+
+    if (newline != src + count)
+    {
+        int clean_count = (int)(newline - src);
+        memcpy(clean, src, clean_count);
+
+        for (int i = clean_count; i < count; ++i)
+        {
+            if (src[i] != '\t' && src[i] != '\n' && src[i] != '\r') clean[clean_count++] = src[i];
+        }
+
+        src = clean;
+        count = clean_count;
+    }
+
+    fc_url_state state = {};
+    state.end = src + count;
+    state.base = base;
+    state.dst = dst;
+    state.dst_size = dst_size;
+
+    for (int i = 0; i < FC_URI_COMPONENT_COUNT; ++i)
+    {
+        state.begin[i] = -1;
+        state.end_of[i] = -1;
+    }
+
+    if (!fc_url_parse_state(&state, src) || state.overflow) return -1;
+
+    // Paths starting with "//" in URLs without a host get a "/." in front, or they would read as an authority
+    int path = state.begin[FC_URI_PATH];
+    bool opaque_path = state.begin[FC_URI_HOST] < 0 && (state.count == path || dst[path] != '/');
+
+    if (state.begin[FC_URI_HOST] < 0 && !opaque_path && state.count - path >= 2 && dst[path] == '/' && dst[path + 1] == '/')
+    {
+        if (state.count + 2 > dst_size - 1) return -1;
+
+        memmove(dst + path + 2, dst + path, state.count - path);
+        memcpy(dst + path, "/.", 2);
+        state.count += 2;
+
+        for (int i = FC_URI_PATH; i < FC_URI_COMPONENT_COUNT; ++i)
+        {
+            if (state.begin[i] >= 0) state.begin[i] += 2;
+        }
+    }
+
+    dst[state.count] = '\0';
+
+    // Components that run up to the next one
+    int next = state.count;
+    for (int i = FC_URI_FRAGMENT; i >= FC_URI_PATH; --i)
+    {
+        if (state.begin[i] < 0) continue;
+
+        state.end_of[i] = next;
+        next = state.begin[i] - 1;
+    }
+
+    *url = fc_uri_view{};
+    url->ipv6_host = state.ipv6_host;
+
+    fc_uri_str* components[FC_URI_COMPONENT_COUNT] = {
+        &url->scheme, &url->user, &url->access_info, &url->host, &url->port, &url->path, &url->query, &url->fragment,
+    };
+
+    for (int i = 0; i < FC_URI_COMPONENT_COUNT; ++i)
+    {
+        if (state.begin[i] < 0) continue;
+
+        components[i]->data  = dst + state.begin[i];
+        components[i]->count = state.end_of[i] - state.begin[i];
+    }
+
+    return state.count;
+}
+
+#endif // FC_URI_WHATWG_IMPLEMENTATION
+
+/*
+    Copyright (c) 2023 Filippo Crocchini
+
+    Permission is hereby granted, free of charge, to any person obtaining a copy
+    of this software and associated documentation files (the "Software"), to deal
+    in the Software without restriction, including without limitation the rights
+    to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+    copies of the Software, and to permit persons to whom the Software is
+    furnished to do so, subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included in all
+    copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+    SOFTWARE.
+*/
@@ -0,0 +1,21 @@
+// Minimal checks for the test programs: CHECK records a failure and keeps going,
+// FC_TEST_RESULT prints the count and is the exit code of main.
+
+#include <stdio.h>
+
+static int fc_test_failures = 0;
+static int fc_test_checks   = 0;
+
+#define CHECK(condition)                                                            \
+    do                                                                              \
+    {                                                                               \
+        ++fc_test_checks;                                                           \
+        if (!(condition))                                                           \
+        {                                                                           \
+            ++fc_test_failures;                                                     \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        }                                                                           \
+    } while (0)
+
+#define FC_TEST_RESULT()                                                              \
+    (printf("%d checks, %d failed\n", fc_test_checks, fc_test_failures), fc_test_failures != 0)
@@ -0,0 +1,159 @@
+// fc_html_links: links of a page fed whole and split into chunks of every size, long values and random markup.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_HTML_LINKS_IMPLEMENTATION
+#include "../fc_html_links.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char* page =
+    "<!DOCTYPE html><html><head><title>a <a href=x></title><base href=\"/sub/\"></head><body>"
+    "<a HREF = \" img/a.png?x=1&amp;y=2&copy=3 \">t</a><!-- <a href=no> --><img src=pic.jpg alt=x>"
+    "<a href='//cdn.example.org/&#x41;&#66;.js'><script>var s='<a href=\"bad\">';</script><a data-href=nope href=../up#frag/>"
+    "<iframe src=\"javascript:void(0)\"></iframe><a href=\"mailto:a@b.c\">";
+
+// Tag, attribute, value, resolved
+static const char* page_links[][4] = {
+    {"base", "href", "/sub/", "https://example.com/sub/"},
+    {"a", "href", "img/a.png?x=1&y=2&copy=3", "https://example.com/sub/img/a.png?x=1&y=2&copy=3"},
+    {"img", "src", "pic.jpg", "https://example.com/sub/pic.jpg"},
+    {"a", "href", "//cdn.example.org/AB.js", "https://cdn.example.org/AB.js"},
+    {"a", "href", "../up#frag/", "https://example.com/up#frag/"},
+    {"iframe", "src", "javascript:void(0)", "javascript:void(0)"},
+    {"a", "href", "mailto:a@b.c", "mailto:a@b.c"},
+};
+
+static const int page_link_count = sizeof(page_links) / sizeof(page_links[0]);
+
+static bool str_equals(fc_uri_str str, const char* expected)
+{
+    return str.count == (int)strlen(expected) && memcmp(str.data, expected, str.count) == 0;
+}
+
+// Feeds html in chunks of chunk_size bytes, returns the number of links that matched page_links in order
+static int scan(fc_html_links* links, const char* html, int count, int chunk_size, int* total)
+{
+    fc_html_links_begin(links, "https://example.com/dir/page.html");
+
+    int matched = 0;
+    *total = 0;
+    for (int position = 0; position < count; position += chunk_size)
+    {
+        int size = count - position < chunk_size ? count - position : chunk_size;
+        fc_html_links_feed(links, html + position, size);
+
+        fc_html_link link;
+        while (fc_html_links_next(links, &link))
+        {
+            if (*total < page_link_count)
+            {
+                const char** expected = page_links[*total];
+                if (str_equals(link.tag, expected[0]) && str_equals(link.attribute, expected[1]) &&
+                    str_equals(link.value, expected[2]) && str_equals(link.resolved, expected[3]))
+                {
+                    matched++;
+                }
+            }
+            (*total)++;
+        }
+    }
+
+    return matched;
+}
+
+static void test_page(fc_html_links* links)
+{
+    int count = (int)strlen(page);
+
+    int total;
+    CHECK(scan(links, page, count, count, &total) == page_link_count && total == page_link_count);
+
+    int mismatches = 0;
+    for (int chunk_size = 1; chunk_size < 64; ++chunk_size)
+    {
+        if (scan(links, page, count, chunk_size, &total) != page_link_count || total != page_link_count) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+static void test_long_value(fc_html_links* links)
+{
+    // A value longer than FC_URI_MAX is skipped, the next link is still found
+    static char html[FC_URI_MAX + 128];
+    int count = 0;
+    count += sprintf(html + count, "<a href=\"");
+    memset(html + count, 'x', FC_URI_MAX + 10);
+    count += FC_URI_MAX + 10;
+    count += sprintf(html + count, "\"><img src=pic.jpg>");
+
+    for (int chunk_size = 7; chunk_size <= count; chunk_size *= 3)
+    {
+        fc_html_links_begin(links, "https://example.com/");
+        int found = 0;
+        bool only_pic = true;
+        for (int position = 0; position < count; position += chunk_size)
+        {
+            fc_html_links_feed(links, html + position, count - position < chunk_size ? count - position : chunk_size);
+            fc_html_link link;
+            while (fc_html_links_next(links, &link))
+            {
+                found++;
+                if (!str_equals(link.value, "pic.jpg")) only_pic = false;
+            }
+        }
+        CHECK(found == 1 && only_pic);
+    }
+}
+
+// Random markup only has to be survived, values must stay within bounds
+static void test_random(fc_html_links* links)
+{
+    const char* pieces[] = {"<", ">", "a", " href", "=", "\"", "'", "&", "#", "x41;", "amp;", "<!--", "-->", "<!", "</",
+                            "script", "style", "src", "base", "/", " ", "x", "\n", "&#1114112;", "&#0;", "&#x", "%"};
+    const int piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    srand(7);
+    bool in_bounds = true;
+    for (int it = 0; it < 5000; ++it)
+    {
+        char html[512];
+        int count = 0;
+        while (count < 480)
+        {
+            const char* piece = pieces[rand() % piece_count];
+            int length = (int)strlen(piece);
+            memcpy(html + count, piece, length);
+            count += length;
+        }
+
+        fc_html_links_begin(links, rand() % 2 ? "https://example.com/" : NULL);
+        int chunk_size = rand() % 64 + 1;
+        for (int position = 0; position < count; position += chunk_size)
+        {
+            fc_html_links_feed(links, html + position, count - position < chunk_size ? count - position : chunk_size);
+            fc_html_link link;
+            while (fc_html_links_next(links, &link))
+            {
+                if (link.value.count < 0 || link.value.count > FC_URI_MAX || link.resolved.count < 0 || link.resolved.count > FC_URI_MAX) in_bounds = false;
+            }
+        }
+    }
+    CHECK(in_bounds);
+}
+
+int main(void)
+{
+    fc_html_links* links = (fc_html_links*)malloc(sizeof(fc_html_links));
+
+    test_page(links);
+    test_long_value(links);
+    test_random(links);
+
+    free(links);
+
+    return FC_TEST_RESULT();
+}
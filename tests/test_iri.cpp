@@ -0,0 +1,48 @@
+// fc_iri_parse UTF-8 validation and fc_iri_to_uri.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#include "fc_test.h"
+
+#include <string.h>
+
+static void test_iri(void)
+{
+    fc_uri iri;
+    CHECK(fc_iri_parse("https://b\xc3\xbc" "cher.example/b\xc3\xbc" "cher?q=\xc3\xa9#x", &iri));
+    CHECK(strcmp(iri.scheme, "https") == 0);
+    CHECK(strcmp(iri.host, "b\xc3\xbc" "cher.example") == 0);
+    CHECK(strcmp(iri.path, "/b\xc3\xbc" "cher") == 0);
+    CHECK(strcmp(iri.query, "q=\xc3\xa9") == 0);
+    CHECK(strcmp(iri.fragment, "x") == 0);
+
+    // Truncated sequence, overlong encoding, surrogate, above U+10FFFF, stray continuation byte
+    CHECK(!fc_iri_parse("https://x/\xc3", &iri));
+    CHECK(!fc_iri_parse("https://x/\xc0\xaf", &iri));
+    CHECK(!fc_iri_parse("https://x/\xed\xa0\x80", &iri));
+    CHECK(!fc_iri_parse("https://x/\xf4\x90\x80\x80", &iri));
+    CHECK(!fc_iri_parse("https://x/\x80", &iri));
+
+    // Invalid bytes past the first 16, so the vector path sees them
+    CHECK(!fc_iri_parse("https://example.com/0123456789abcdef/\xe0\x80\x80", &iri));
+    CHECK(fc_iri_parse("https://example.com/0123456789abcdef/\xe2\x82\xac", &iri));
+
+    char out[256];
+    const char* expected = "https://us%C3%A9r@xn--bcher-kva.example:80/b%C3%BCcher?q=%C3%A9#%E2%82%AC";
+    int length = fc_iri_to_uri("https://us\xc3\xa9r@b\xc3\xbc" "cher.example:80/b\xc3\xbc" "cher?q=\xc3\xa9#\xe2\x82\xac", out, sizeof(out));
+    CHECK(length == (int)strlen(expected) && strcmp(out, expected) == 0);
+
+    length = fc_iri_to_uri("mailto:x", out, sizeof(out));
+    CHECK(length == 8 && strcmp(out, "mailto:x") == 0);
+
+    CHECK(fc_iri_to_uri("https://x/\xc3", out, sizeof(out)) == -1);
+    CHECK(fc_iri_to_uri("https://x/\xc3\xa9", out, 12) == -1);
+}
+
+int main(void)
+{
+    test_iri();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,99 @@
+// fc_linkify: matches and trimming in free text, and candidates at every offset of the 16 byte blocks.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_LINKIFY_IMPLEMENTATION
+#include "../fc_linkify.h"
+
+#include "fc_test.h"
+
+#include <string.h>
+
+static bool str_equals(fc_uri_str str, const char* expected)
+{
+    return str.count == (int)strlen(expected) && memcmp(str.data, expected, str.count) == 0;
+}
+
+static void test_matches(void)
+{
+    const char* text = "See https://example.com/a_(b)?x=1. Also (www.foo.org/path), and ftp://[::1]:21/x! nohttp:// bad, "
+                       "a.www.b.com, 'http://q.com/x'; end http://z.io";
+
+    // Match, host, path
+    const char* expected[][3] = {
+        {"https://example.com/a_(b)?x=1", "example.com", "/a_(b)"},
+        {"www.foo.org/path", "www.foo.org", "/path"},
+        {"ftp://[::1]:21/x", "::1", "/x"},
+        {"http://q.com/x", "q.com", "/x"},
+        {"http://z.io", "z.io", ""},
+    };
+
+    fc_linkify linkify;
+    fc_linkify_begin(&linkify, text, (int)strlen(text));
+
+    fc_uri_str match;
+    fc_uri_view uri;
+    int count = 0;
+    while (fc_linkify_next(&linkify, &match, &uri))
+    {
+        if (count < 5)
+        {
+            CHECK(str_equals(match, expected[count][0]));
+            CHECK(str_equals(uri.host, expected[count][1]));
+            CHECK(str_equals(uri.path, expected[count][2]));
+        }
+        count++;
+    }
+    CHECK(count == 5);
+
+    // Scheme is empty for "www." links
+    fc_linkify_begin(&linkify, "go to www.example.com.", 22);
+    CHECK(fc_linkify_next(&linkify, &match, &uri));
+    CHECK(str_equals(match, "www.example.com") && uri.scheme.count == 0);
+    CHECK(!fc_linkify_next(&linkify, &match, &uri));
+
+    fc_linkify_begin(&linkify, "", 0);
+    CHECK(!fc_linkify_next(&linkify, &match, &uri));
+}
+
+// The same link at every offset across a few blocks, with text on both sides
+static void test_offsets(void)
+{
+    const char* link = "https://example.com/x?y=1";
+    int link_length = (int)strlen(link);
+
+    int mismatches = 0;
+    for (int offset = 0; offset < 48; ++offset)
+    {
+        for (int tail = 0; tail < 20; ++tail)
+        {
+            char text[128];
+            memset(text, 'a', sizeof(text));
+            if (offset > 0) text[offset - 1] = ' ';
+            memcpy(text + offset, link, link_length);
+            int length = offset + link_length;
+            if (tail > 0)
+            {
+                text[length] = ' ';
+                length += tail;
+            }
+
+            fc_linkify linkify;
+            fc_linkify_begin(&linkify, text, length);
+
+            fc_uri_str match;
+            fc_uri_view uri;
+            bool found = fc_linkify_next(&linkify, &match, &uri);
+            if (!found || match.data != text + offset || !str_equals(match, link) || fc_linkify_next(&linkify, &match, &uri)) mismatches++;
+        }
+    }
+    CHECK(mismatches == 0);
+}
+
+int main(void)
+{
+    test_matches();
+    test_offsets();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+// Punycode (RFC 3492 section 7.1 samples) and IDNA host conversion.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// RFC 3492 section 7.1, unicode label and its Punycode
+static const char* punycode_samples[][2] = {
+    // (A) Arabic (Egyptian)
+    {"\xd9\x84\xd9\x8a\xd9\x87\xd9\x85\xd8\xa7\xd8\xa8\xd8\xaa\xd9\x83\xd9\x84\xd9\x85\xd9\x88\xd8\xb4\xd8\xb9\xd8\xb1\xd8\xa8\xd9\x8a\xd8\x9f",
+     "egbpdaj6bu4bxfgehfvwxn"},
+    // (B) Chinese (simplified)
+    {"\xe4\xbb\x96\xe4\xbb\xac\xe4\xb8\xba\xe4\xbb\x80\xe4\xb9\x88\xe4\xb8\x8d\xe8\xaf\xb4\xe4\xb8\xad\xe6\x96\x87",
+     "ihqwcrb4cv8a8dqg056pqjye"},
+    // (C) Chinese (traditional)
+    {"\xe4\xbb\x96\xe5\x80\x91\xe7\x88\xb2\xe4\xbb\x80\xe9\xba\xbd\xe4\xb8\x8d\xe8\xaa\xaa\xe4\xb8\xad\xe6\x96\x87",
+     "ihqwctvzc91f659drss3x8bo0yb"},
+    // (D) Czech
+    {"Pro\xc4\x8dprost\xc4\x9bnemluv\xc3\xad\xc4\x8d" "esky", "Proprostnemluvesky-uyb24dma41a"},
+    // (L) 3<nen>B<gumi><kinpachi><sensei>
+    {"3\xe5\xb9\xb4" "B\xe7\xb5\x84\xe9\x87\x91\xe5\x85\xab\xe5\x85\x88\xe7\x94\x9f", "3B-ww4c5e180e575a65lsy2b"},
+    // (M) <amuro><namie>-with-SUPER-MONKEYS
+    {"\xe5\xae\x89\xe5\xae\xa4\xe5\xa5\x88\xe7\xbe\x8e\xe6\x81\xb5-with-SUPER-MONKEYS", "-with-SUPER-MONKEYS-pc58ag80a8qai00g7n9n"},
+    // (Q) <pafii>de<runba>
+    {"\xe3\x83\x91\xe3\x83\x95\xe3\x82\xa3\xe3\x83\xbc" "de\xe3\x83\xab\xe3\x83\xb3\xe3\x83\x90", "de-jg4avhby1noc0d"},
+    // (R) <sono><supiido><de>
+    {"\xe3\x81\x9d\xe3\x81\xae\xe3\x82\xb9\xe3\x83\x94\xe3\x83\xbc\xe3\x83\x89\xe3\x81\xa7", "d9juau41awczczp"},
+    // (S) -> $1.00 <-
+    {"-> $1.00 <-", "-> $1.00 <--"},
+    // Single non-BMP code point
+    {"\xf0\x9f\x98\x80", "e28h"},
+};
+
+static void test_punycode(void)
+{
+    for (size_t i = 0; i < sizeof(punycode_samples) / sizeof(punycode_samples[0]); ++i)
+    {
+        const char* unicode  = punycode_samples[i][0];
+        const char* punycode = punycode_samples[i][1];
+
+        char buf[256];
+        int encoded = fc_punycode_encode(unicode, (int)strlen(unicode), buf, sizeof(buf));
+        CHECK(encoded == (int)strlen(punycode) && strcmp(buf, punycode) == 0);
+
+        int decoded = fc_punycode_decode(punycode, (int)strlen(punycode), buf, sizeof(buf));
+        CHECK(decoded == (int)strlen(unicode) && strcmp(buf, unicode) == 0);
+
+        // One byte short of the output and the '\0'
+        CHECK(fc_punycode_encode(unicode, (int)strlen(unicode), buf, (int)strlen(punycode)) == -1);
+    }
+
+    char buf[64];
+
+    // Not a digit of base 36, and a delta that overflows
+    CHECK(fc_punycode_decode("zz!", 3, buf, sizeof(buf)) == -1);
+    CHECK(fc_punycode_decode("99999999999999999999", 20, buf, sizeof(buf)) == -1);
+
+    // Encode then decode random labels
+    srand(3);
+    int mismatches = 0;
+    for (int it = 0; it < 20000; ++it)
+    {
+        char label[64];
+        int length = 0;
+        int code_points = rand() % 8 + 1;
+        for (int i = 0; i < code_points; ++i)
+        {
+            int type = rand() % 4;
+            unsigned cp = type == 0 ? 'a' + rand() % 26 : type == 1 ? 0x80 + rand() % 0x700 : type == 2 ? 0x4E00 + rand() % 0x5000 : 0x10000 + rand() % 0x1000;
+            length += fc_urip_utf8_encode(cp, label + length, (int)sizeof(label) - length);
+        }
+
+        char encoded[128];
+        char decoded[128];
+        int encoded_length = fc_punycode_encode(label, length, encoded, sizeof(encoded));
+        int decoded_length = encoded_length < 0 ? -1 : fc_punycode_decode(encoded, encoded_length, decoded, sizeof(decoded));
+        if (decoded_length != length || memcmp(decoded, label, length) != 0) mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+static void test_host_conversion(void)
+{
+    char buf[FC_URI_HOST_MAX + 1];
+    const char* result;
+
+    const char* host = "www.b\xc3\xbc" "cher.example";
+    int length = fc_uri_host_to_ascii(host, (int)strlen(host), buf, sizeof(buf), &result);
+    CHECK(length == 25 && strncmp(result, "www.xn--bcher-kva.example", 25) == 0 && result == buf);
+
+    length = fc_uri_host_to_unicode("www.xn--bcher-kva.example", 25, buf, sizeof(buf), &result);
+    CHECK(length == (int)strlen(host) && strncmp(result, host, length) == 0);
+
+    // Nothing to convert, the host itself is returned
+    host = "example.com";
+    length = fc_uri_host_to_ascii(host, 11, buf, sizeof(buf), &result);
+    CHECK(length == 11 && result == host);
+
+    // Ideographic full stop separates labels
+    host = "a\xe3\x80\x82" "b\xc3\xbc";
+    length = fc_uri_host_to_ascii(host, (int)strlen(host), buf, sizeof(buf), &result);
+    CHECK(length == 11 && strncmp(result, "a.xn--b-eha", 11) == 0);
+
+    CHECK(fc_uri_host_to_unicode("www.xn--zz!.example", 19, buf, sizeof(buf), &result) == -1);
+}
+
+int main(void)
+{
+    test_punycode();
+    test_host_conversion();
+
+    return FC_TEST_RESULT();
+}
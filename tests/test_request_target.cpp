@@ -0,0 +1,84 @@
+// fc_uri_parse_request_target on the four forms of RFC 9112 section 3.2, and fc_uri_origin_form.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#include "fc_test.h"
+
+#include <string.h>
+
+static bool str_equals(fc_uri_str str, const char* expected)
+{
+    return str.count == (int)strlen(expected) && (str.count == 0 || memcmp(str.data, expected, str.count) == 0);
+}
+
+typedef struct
+{
+    const char* target;
+    fc_uri_target_form form;
+    const char* host;
+    const char* port;
+    const char* path;
+    const char* query;
+    const char* origin; // Absolute-form only
+} target_case;
+
+static const target_case cases[] = {
+    {"/a/b?q=1", FC_URI_TARGET_ORIGIN, "", "", "/a/b", "q=1", NULL},
+    {"/", FC_URI_TARGET_ORIGIN, "", "", "/", "", NULL},
+    {"/where?q=now", FC_URI_TARGET_ORIGIN, "", "", "/where", "q=now", NULL},
+    {"*", FC_URI_TARGET_ASTERISK, "", "", "", "", NULL},
+    {"example.com:443", FC_URI_TARGET_AUTHORITY, "example.com", "443", "", "", NULL},
+    {"[::1]:8443", FC_URI_TARGET_AUTHORITY, "::1", "8443", "", "", NULL},
+    {"http://h.com/p?q", FC_URI_TARGET_ABSOLUTE, "h.com", "", "/p", "q", "/p?q"},
+    {"http://h.com?q", FC_URI_TARGET_ABSOLUTE, "h.com", "", "", "q", "/?q"},
+    {"http://h.com", FC_URI_TARGET_ABSOLUTE, "h.com", "", "", "", "/"},
+    {"http://www.example.org/pub/WWW/TheProject.html", FC_URI_TARGET_ABSOLUTE, "www.example.org", "", "/pub/WWW/TheProject.html", "", "/pub/WWW/TheProject.html"},
+};
+
+// Not a request-target: fragments, userinfo in authority-form, no port, junk after '*'
+static const char* invalid_targets[] = {"*x", "user@h:1", "h", "h:", "http://h.com/p#f", "/p#f", ""};
+
+int main(void)
+{
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); ++i)
+    {
+        const target_case* c = &cases[i];
+
+        fc_uri_view uri;
+        fc_uri_target_form form = fc_uri_parse_request_target(c->target, -1, &uri);
+        CHECK(form == c->form);
+        CHECK(str_equals(uri.host, c->host));
+        CHECK(str_equals(uri.port, c->port));
+        CHECK(str_equals(uri.path, c->path));
+        CHECK(str_equals(uri.query, c->query));
+
+        if (c->origin)
+        {
+            fc_uri_str parts[2];
+            int part_count = fc_uri_origin_form(&uri, parts);
+
+            char origin[FC_URI_MAX + 1];
+            int length = 0;
+            for (int p = 0; p < part_count; ++p)
+            {
+                memcpy(origin + length, parts[p].data, parts[p].count);
+                length += parts[p].count;
+            }
+            CHECK(length == (int)strlen(c->origin) && memcmp(origin, c->origin, length) == 0);
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(invalid_targets) / sizeof(invalid_targets[0]); ++i)
+    {
+        fc_uri_view uri;
+        CHECK(fc_uri_parse_request_target(invalid_targets[i], -1, &uri) == FC_URI_TARGET_INVALID);
+    }
+
+    // count bounds the target, "/a" followed by bytes that are not part of it
+    fc_uri_view uri;
+    CHECK(fc_uri_parse_request_target("/a HTTP/1.1", 2, &uri) == FC_URI_TARGET_ORIGIN);
+    CHECK(str_equals(uri.path, "/a"));
+
+    return FC_TEST_RESULT();
+}
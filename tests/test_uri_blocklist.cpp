@@ -0,0 +1,258 @@
+// fc_uri_blocklist: filter syntax, exceptions, random lists against a reference matcher written from the syntax
+// (every start position, no token index), and long URLs that repeat a rule's tokens.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_BLOCKLIST_IMPLEMENTATION
+#include "../fc_uri_blocklist.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+static bool is_separator(char c)
+{
+    return !(isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.' || c == '%');
+}
+
+// pattern at url[at], '*' any run, '^' a separator or the end of the url
+static bool reference_match_at(const char* pattern, const char* url, int at, bool end_anchor)
+{
+    if (*pattern == '\0') return !end_anchor || url[at] == '\0';
+
+    if (*pattern == '*')
+    {
+        for (int skip = at; ; ++skip)
+        {
+            if (reference_match_at(pattern + 1, url, skip, end_anchor)) return true;
+            if (url[skip] == '\0') return false;
+        }
+    }
+
+    if (*pattern == '^')
+    {
+        if (url[at] == '\0') return reference_match_at(pattern + 1, url, at, end_anchor);
+        return is_separator(url[at]) && reference_match_at(pattern + 1, url, at + 1, end_anchor);
+    }
+
+    return url[at] != '\0' && tolower((unsigned char)*pattern) == url[at] && reference_match_at(pattern + 1, url, at + 1, end_anchor);
+}
+
+typedef struct
+{
+    std::string pattern;
+    bool exception;
+    bool host_anchor;
+    bool start_anchor;
+    bool end_anchor;
+} reference_rule;
+
+static reference_rule reference_parse(std::string rule)
+{
+    reference_rule parsed = {};
+    if (rule.compare(0, 2, "@@") == 0)
+    {
+        parsed.exception = true;
+        rule = rule.substr(2);
+    }
+    if (rule.compare(0, 2, "||") == 0)
+    {
+        parsed.host_anchor = true;
+        rule = rule.substr(2);
+    }
+    else if (rule.compare(0, 1, "|") == 0) {
+        parsed.start_anchor = true;
+        rule = rule.substr(1);
+    }
+    if (!rule.empty() && rule[rule.size() - 1] == '|')
+    {
+        parsed.end_anchor = true;
+        rule = rule.substr(0, rule.size() - 1);
+    }
+    parsed.pattern = rule;
+    return parsed;
+}
+
+static bool reference_rule_matches(const reference_rule* rule, const std::string& url)
+{
+    const char* pattern = rule->pattern.c_str();
+
+    if (rule->start_anchor) return reference_match_at(pattern, url.c_str(), 0, rule->end_anchor);
+
+    if (rule->host_anchor)
+    {
+        fc_uri_view uri;
+        if (!fc_uri_parse_view(url.data(), (int)url.size(), &uri) || !uri.host.data) return false;
+
+        int host = (int)(uri.host.data - url.data());
+        for (int at = host; at < host + uri.host.count; ++at)
+        {
+            if ((at == host || url[at - 1] == '.') && reference_match_at(pattern, url.c_str(), at, rule->end_anchor)) return true;
+        }
+        return false;
+    }
+
+    for (int at = 0; at <= (int)url.size(); ++at)
+    {
+        if (reference_match_at(pattern, url.c_str(), at, rule->end_anchor)) return true;
+    }
+    return false;
+}
+
+static fc_blocklist_result reference_match(const std::vector<reference_rule>& rules, std::string url)
+{
+    for (size_t i = 0; i < url.size(); ++i) url[i] = (char)tolower((unsigned char)url[i]);
+
+    bool blocked = false;
+    bool allowed = false;
+    for (size_t r = 0; r < rules.size(); ++r)
+    {
+        if (reference_rule_matches(&rules[r], url)) (rules[r].exception ? allowed : blocked) = true;
+    }
+    return !blocked ? FC_BLOCKLIST_NONE : allowed ? FC_BLOCKLIST_ALLOW : FC_BLOCKLIST_BLOCK;
+}
+
+static void test_syntax(void)
+{
+    fc_blocklist list;
+    fc_blocklist_init(&list);
+
+    // Not URL rules
+    CHECK(!fc_blocklist_add(&list, "! comment", -1, 0));
+    CHECK(!fc_blocklist_add(&list, "[Adblock Plus 2.0]", -1, 0));
+    CHECK(!fc_blocklist_add(&list, "example.com##.ad", -1, 0));
+    CHECK(!fc_blocklist_add(&list, "example.com#@#.ad", -1, 0));
+    CHECK(!fc_blocklist_add(&list, "/banner\\d+/", -1, 0));
+    CHECK(!fc_blocklist_add(&list, "   ", -1, 0));
+    CHECK(list.rule_count == 0);
+
+    const char* text =
+        "! Title: test list\n"
+        "||ads.example.com^\n"
+        "|https://tracker.\r\n"
+        "example.com##.banner\n"
+        "/pixel.gif|\n"
+        "@@||ads.example.com/allowed/*$script,domain=foo.com\n"
+        "\n"
+        "&ad_id=\n";
+    CHECK(fc_blocklist_add_list(&list, text, (int)strlen(text)) == 5);
+    CHECK(fc_blocklist_compile(&list));
+
+    fc_blocklist_scratch scratch = {};
+    uint32_t rule = 0;
+
+    // Ids are line numbers
+    CHECK(fc_blocklist_match(&list, "https://ads.example.com/banner.png", -1, &scratch, &rule) == FC_BLOCKLIST_BLOCK && rule == 1);
+    CHECK(fc_blocklist_match(&list, "http://cdn.ads.example.com:8080/x", -1, &scratch, &rule) == FC_BLOCKLIST_BLOCK && rule == 1);
+    CHECK(fc_blocklist_match(&list, "https://bads.example.com/", -1, &scratch, &rule) == FC_BLOCKLIST_NONE);
+    CHECK(fc_blocklist_match(&list, "https://ads.example.community/", -1, &scratch, &rule) == FC_BLOCKLIST_NONE);
+    CHECK(fc_blocklist_match(&list, "HTTPS://TRACKER.net/t", -1, &scratch, &rule) == FC_BLOCKLIST_BLOCK && rule == 2);
+    CHECK(fc_blocklist_match(&list, "http://tracker.net/t", -1, &scratch, &rule) == FC_BLOCKLIST_NONE);
+    CHECK(fc_blocklist_match(&list, "https://site.org/img/pixel.gif", -1, &scratch, &rule) == FC_BLOCKLIST_BLOCK && rule == 4);
+    CHECK(fc_blocklist_match(&list, "https://site.org/img/pixel.gif?x=1", -1, &scratch, &rule) == FC_BLOCKLIST_NONE);
+    CHECK(fc_blocklist_match(&list, "https://site.org/?q=1&ad_id=7", -1, &scratch, &rule) == FC_BLOCKLIST_BLOCK && rule == 7);
+
+    // The exception only allows what a blocking rule matched
+    CHECK(fc_blocklist_match(&list, "https://ads.example.com/allowed/a.js", -1, &scratch, &rule) == FC_BLOCKLIST_ALLOW && rule == 5);
+
+    fc_blocklist_scratch_free(&scratch);
+    fc_blocklist_free(&list);
+
+    // An exception alone doesn't make a result
+    fc_blocklist_init(&list);
+    fc_blocklist_add(&list, "@@||good.example^", -1, 1);
+    fc_blocklist_compile(&list);
+    CHECK(fc_blocklist_match(&list, "https://good.example/x", -1, &scratch, &rule) == FC_BLOCKLIST_NONE);
+    fc_blocklist_scratch_free(&scratch);
+    fc_blocklist_free(&list);
+}
+
+static void test_random_lists(void)
+{
+    const char* atoms[] = {"ads", "a", "b", "x1", "/", "^", "*", ".", "-", "_", "?", "=", "%2f", "track", "js", "com"};
+    const char* prefixes[] = {"", "", "|", "||", "@@", "@@||", "|http"};
+
+    srand(3);
+    int mismatches = 0;
+    for (int it = 0; it < 3000; ++it)
+    {
+        fc_blocklist list;
+        fc_blocklist_init(&list);
+
+        std::vector<reference_rule> rules;
+        for (int k = 0; k < 6; ++k)
+        {
+            std::string rule = prefixes[rand() % 7];
+            int atom_count = 1 + rand() % 5;
+            for (int j = 0; j < atom_count; ++j) rule += atoms[rand() % 16];
+            if (rand() % 6 == 0) rule += "|";
+
+            if (fc_blocklist_add(&list, rule.c_str(), -1, k)) rules.push_back(reference_parse(rule));
+        }
+        fc_blocklist_compile(&list);
+
+        fc_blocklist_scratch scratch = {};
+        for (int q = 0; q < 20; ++q)
+        {
+            std::string url = std::string(rand() % 2 ? "http" : "HTTPS") + "://" + (rand() % 2 ? "ads." : "") + (rand() % 2 ? "a.b" : "x1-track.com");
+            int atom_count = rand() % 8;
+            for (int j = 0; j < atom_count; ++j) url += atoms[rand() % 16];
+
+            if (fc_blocklist_match(&list, url.c_str(), -1, &scratch, NULL) != reference_match(rules, url)) mismatches++;
+        }
+
+        fc_blocklist_scratch_free(&scratch);
+        fc_blocklist_free(&list);
+    }
+    CHECK(mismatches == 0);
+}
+
+static double elapsed_ms(const struct timespec* begin)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - begin->tv_sec) * 1e3 + (now.tv_nsec - begin->tv_nsec) / 1e6;
+}
+
+// Rules that almost match at every repetition of their tokens must not make matching quadratic
+static void test_long_url(void)
+{
+    fc_blocklist list;
+    fc_blocklist_init(&list);
+    fc_blocklist_add(&list, "a/a/a/a/a/a/a/a/b", -1, 1);
+    fc_blocklist_add(&list, "a^a^a^a^a^a^a^c", -1, 2);
+    fc_blocklist_add(&list, "/a/*zz", -1, 3);
+    fc_blocklist_compile(&list);
+
+    std::string url = "https://x.com/";
+    for (int i = 0; i < 3000; ++i) url += "a/";
+
+    fc_blocklist_scratch scratch = {};
+    struct timespec begin;
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    CHECK(fc_blocklist_match(&list, url.c_str(), -1, &scratch, NULL) == FC_BLOCKLIST_NONE);
+
+    // Generous for sanitizer builds, a quadratic scan takes seconds
+    CHECK(elapsed_ms(&begin) < 200);
+
+    url += "b";
+    CHECK(fc_blocklist_match(&list, url.c_str(), -1, &scratch, NULL) == FC_BLOCKLIST_BLOCK);
+
+    fc_blocklist_scratch_free(&scratch);
+    fc_blocklist_free(&list);
+}
+
+int main(void)
+{
+    test_syntax();
+    test_random_lists();
+    test_long_url();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+// fc_uri_cache: results from several threads against fc_uri_parse_view, with more keys than entries so that sets evict.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_CACHE_IMPLEMENTATION
+#include "../fc_uri_cache.h"
+
+#include "fc_test.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define KEY_COUNT    3000
+#define THREAD_COUNT 4
+
+static fc_uri_cache cache;
+static char keys[KEY_COUNT][FC_URI_CACHE_KEY_MAX + 64];
+
+// Same components at the same offsets from the start of each input
+static bool view_same(const fc_uri_view* a, const char* a_src, const fc_uri_view* b, const char* b_src)
+{
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        fc_uri_str x = fc_uri_view_component(a, (fc_uri_component)c);
+        fc_uri_str y = fc_uri_view_component(b, (fc_uri_component)c);
+        if ((x.data == NULL) != (y.data == NULL) || x.count != y.count) return false;
+        if (x.data && x.data - a_src != y.data - b_src) return false;
+    }
+    return a->ipv6_host == b->ipv6_host;
+}
+
+static void* worker(void* arg)
+{
+    long thread = (long)arg;
+    long mismatches = 0;
+
+    // A copy of the key, the views must point into it and not into the cache or another thread's copy
+    char src[sizeof(keys[0])];
+
+    for (int i = 0; i < 30000; ++i)
+    {
+        const char* key = keys[(i * 7919 + thread * 131) % KEY_COUNT];
+        int count = (int)strlen(key);
+        memcpy(src, key, count + 1);
+
+        fc_uri_view cached;
+        bool cached_ok = fc_uri_cache_parse(&cache, src, i % 5 == 0 ? -1 : count, &cached);
+
+        fc_uri_view expected;
+        bool expected_ok = fc_uri_parse_view(key, count, &expected);
+
+        if (cached_ok != expected_ok || (cached_ok && !view_same(&cached, src, &expected, key))) mismatches++;
+    }
+
+    return (void*)mismatches;
+}
+
+int main(void)
+{
+    for (int i = 0; i < KEY_COUNT; ++i)
+    {
+        if (i % 50 == 0)      sprintf(keys[i], "nocolon%d", i);
+        else if (i % 13 == 0) sprintf(keys[i], "http://u:p@[::%x]:8/x?y#z", i);
+        else if (i % 17 == 0) sprintf(keys[i], "https://example.com/%0*d", FC_URI_CACHE_KEY_MAX, i); // Not cached
+        else if (i % 19 == 0) sprintf(keys[i], "http://[::1/%d", i);
+        else                  sprintf(keys[i], "https://api.example.com/v1/users/%d/items?limit=10", i);
+    }
+
+    CHECK(fc_uri_cache_init(&cache, 1024));
+
+    pthread_t threads[THREAD_COUNT];
+    for (long t = 0; t < THREAD_COUNT; ++t) pthread_create(&threads[t], NULL, worker, (void*)t);
+
+    long mismatches = 0;
+    for (int t = 0; t < THREAD_COUNT; ++t)
+    {
+        void* result;
+        pthread_join(threads[t], &result);
+        mismatches += (long)result;
+    }
+    CHECK(mismatches == 0);
+
+    // Hit after a miss, and an empty input
+    fc_uri_view first;
+    fc_uri_view second;
+    CHECK(fc_uri_cache_parse(&cache, "https://example.com/a", -1, &first));
+    CHECK(fc_uri_cache_parse(&cache, "https://example.com/a", -1, &second));
+    CHECK(second.host.count == 11 && memcmp(second.host.data, "example.com", 11) == 0);
+    CHECK(!fc_uri_cache_parse(&cache, "", 0, &first));
+
+    fc_uri_cache_free(&cache);
+
+    return FC_TEST_RESULT();
+}
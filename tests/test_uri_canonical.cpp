@@ -0,0 +1,237 @@
+// fc_uri_canonical: cases of the AWS Signature Version 4 test suite (canonical request, its hash and the
+// signature for the suite's credentials), encoding and sorting rules, the limits, and the SHA-256 test vectors.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_CANONICAL_IMPLEMENTATION
+#include "../fc_uri_canonical.h"
+
+#include "fc_test.h"
+
+#include <string.h>
+
+#include <string>
+
+#define EMPTY_HASH "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"
+
+static void string_sink(void* context, const char* data, int count)
+{
+    ((std::string*)context)->append(data, count);
+}
+
+static std::string hex(const unsigned char* digest)
+{
+    std::string result;
+    for (int i = 0; i < 32; ++i)
+    {
+        result += "0123456789abcdef"[digest[i] >> 4];
+        result += "0123456789abcdef"[digest[i] & 15];
+    }
+    return result;
+}
+
+static std::string sha256_hex(const std::string& data)
+{
+    fc_sha256 sha;
+    unsigned char digest[32];
+    fc_sha256_begin(&sha);
+    fc_sha256_update(&sha, data.data(), (int)data.size());
+    fc_sha256_finish(&sha, digest);
+    return hex(digest);
+}
+
+// HMAC-SHA256 (RFC 2104) with keys up to 64 bytes, enough for the signing key chain
+static void hmac(const unsigned char* key, int key_count, const std::string& message, unsigned char digest[32])
+{
+    unsigned char inner_pad[64];
+    unsigned char outer_pad[64];
+    for (int i = 0; i < 64; ++i)
+    {
+        unsigned char byte = i < key_count ? key[i] : 0;
+        inner_pad[i] = byte ^ 0x36;
+        outer_pad[i] = byte ^ 0x5c;
+    }
+
+    fc_sha256 sha;
+    unsigned char inner[32];
+    fc_sha256_begin(&sha);
+    fc_sha256_update(&sha, inner_pad, 64);
+    fc_sha256_update(&sha, message.data(), (int)message.size());
+    fc_sha256_finish(&sha, inner);
+
+    fc_sha256_begin(&sha);
+    fc_sha256_update(&sha, outer_pad, 64);
+    fc_sha256_update(&sha, inner, 32);
+    fc_sha256_finish(&sha, digest);
+}
+
+// Signature of the suite's requests: 20150830, us-east-1, "service" and the example secret key
+static std::string signature(const std::string& request_hash)
+{
+    std::string secret = "AWS4wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY";
+    const char* scope[] = {"20150830", "us-east-1", "service", "aws4_request"};
+
+    unsigned char key[32];
+    hmac((const unsigned char*)secret.data(), (int)secret.size(), scope[0], key);
+    for (int i = 1; i < 4; ++i) hmac(key, 32, scope[i], key);
+
+    unsigned char digest[32];
+    hmac(key, 32, "AWS4-HMAC-SHA256\n20150830T123600Z\n20150830/us-east-1/service/aws4_request\n" + request_hash, digest);
+    return hex(digest);
+}
+
+// Canonical request of url with the suite's Host and X-Amz-Date headers plus extra ones
+static std::string canonical(const char* method, const char* url, const fc_canonical_header* extra = NULL, int extra_count = 0,
+                             const char* payload_hash = EMPTY_HASH)
+{
+    fc_canonical_header headers[8] = {
+        {{"Host", 4}, {"example.amazonaws.com", 21}},
+        {{"X-Amz-Date", 10}, {"20150830T123600Z", 16}},
+    };
+    for (int i = 0; i < extra_count; ++i) headers[2 + i] = extra[i];
+
+    fc_uri_view uri;
+    fc_uri_parse_view(url, -1, &uri);
+
+    std::string result;
+    if (!fc_canonical_request(method, &uri, headers, 2 + extra_count, payload_hash, string_sink, &result)) return "refused";
+    return result;
+}
+
+static void test_suite(void)
+{
+    // get-vanilla
+    std::string request = canonical("GET", "https://example.amazonaws.com/");
+    CHECK(request == "GET\n/\n\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\nhost;x-amz-date\n" EMPTY_HASH);
+    CHECK(sha256_hex(request) == "bb579772317eb040ac9ed261061d46c1f17a8133879d6129b6e1c25292927e63");
+    CHECK(signature(sha256_hex(request)) == "5fa00fa31553b73ebf1942676e86291e8372ff2a2260956d9b8aae1d763fbf31");
+
+    // An empty path is "/"
+    CHECK(canonical("GET", "https://example.amazonaws.com") == request);
+
+    // get-vanilla-query-order-key-case
+    request = canonical("GET", "https://example.amazonaws.com/?Param2=value2&Param1=value1");
+    CHECK(request == "GET\n/\nParam1=value1&Param2=value2\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\nhost;x-amz-date\n" EMPTY_HASH);
+    CHECK(sha256_hex(request) == "816cd5b414d056048ba4f7c5386d6e0533120fb1fcfa93762cf0fc39e2cf19e0");
+    CHECK(signature(sha256_hex(request)) == "b97d918cfa904a5beff61c982a1b6f458b799221646efd99d3219ec94cdf2500");
+
+    const std::string headers = "\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\nhost;x-amz-date\n" EMPTY_HASH;
+
+    // get-vanilla-query-order-value, get-vanilla-utf8-query, get-utf8, get-space, get-unreserved
+    CHECK(canonical("GET", "https://example.amazonaws.com/?Param1=value2&Param1=Value1") == "GET\n/\nParam1=Value1&Param1=value2" + headers);
+    CHECK(canonical("GET", "https://example.amazonaws.com/?\xE1\x88\xB4=bar") == "GET\n/\n%E1%88%B4=bar" + headers);
+    CHECK(canonical("GET", "https://example.amazonaws.com/\xE1\x88\xB4") == "GET\n/%E1%88%B4\n" + headers);
+    CHECK(canonical("GET", "https://example.amazonaws.com/example%20space/") == "GET\n/example%20space/\n" + headers);
+
+    const char* unreserved = "/-._~0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    CHECK(canonical("GET", (std::string("https://example.amazonaws.com") + unreserved).c_str()) == "GET\n" + std::string(unreserved) + "\n" + headers);
+
+    // get-header-value-trim, get-header-key-duplicate
+    fc_canonical_header trim[] = {
+        {{"My-Header1", 10}, {" value1", 7}},
+        {{"My-Header2", 10}, {" \"a   b   c\"", 12}},
+    };
+    CHECK(canonical("GET", "https://example.amazonaws.com/", trim, 2) ==
+          "GET\n/\n\nhost:example.amazonaws.com\nmy-header1:value1\nmy-header2:\"a b c\"\nx-amz-date:20150830T123600Z\n\n"
+          "host;my-header1;my-header2;x-amz-date\n" EMPTY_HASH);
+
+    fc_canonical_header duplicate[] = {
+        {{"My-Header1", 10}, {"value2", 6}},
+        {{"My-Header1", 10}, {"value2", 6}},
+        {{"My-Header1", 10}, {"value1", 6}},
+    };
+    CHECK(canonical("GET", "https://example.amazonaws.com/", duplicate, 3) ==
+          "GET\n/\n\nhost:example.amazonaws.com\nmy-header1:value2,value2,value1\nx-amz-date:20150830T123600Z\n\n"
+          "host;my-header1;x-amz-date\n" EMPTY_HASH);
+
+    // post-x-www-form-urlencoded, the payload is "Param1=value1"
+    fc_canonical_header content_type[] = {{{"Content-Type", 12}, {"application/x-www-form-urlencoded", 33}}};
+    std::string payload_hash = sha256_hex("Param1=value1");
+    CHECK(payload_hash == "9095672bbd1f56dfc5b65f3e153adc8731a4a654192329106275f4c7b24d0b6e");
+    CHECK(canonical("POST", "https://example.amazonaws.com/", content_type, 1, payload_hash.c_str()) ==
+          "POST\n/\n\ncontent-type:application/x-www-form-urlencoded\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\n"
+          "content-type;host;x-amz-date\n" + payload_hash);
+}
+
+static void test_encoding(void)
+{
+    const std::string headers = "\nhost:example.amazonaws.com\nx-amz-date:20150830T123600Z\n\nhost;x-amz-date\n" EMPTY_HASH;
+
+    // Encoded and raw input give the same result, '+' is not a space, bad escapes are encoded, dot segments stay and
+    // empty parameters are dropped
+    CHECK(canonical("GET", "http://h/a%2fb/my+x/%7e/./..?b=2&a=%zz&a=1&%C3%A9&x%20y=+&&c") ==
+          "GET\n/a%2Fb/my%2Bx/~/./..\n%C3%A9=&a=%25zz&a=1&b=2&c=&x%20y=%2B" + headers);
+
+    // Long enough to go through the sink many times, the hash sink sees the same bytes
+    std::string url = "http://h/";
+    for (int i = 0; i < 200; ++i) url += "seg%20ment/";
+    url += "?";
+    for (int i = 0; i < 200; ++i) url += "k" + std::to_string(199 - i) + "=v&";
+
+    fc_uri_view uri;
+    fc_uri_parse_view(url.data(), (int)url.size(), &uri);
+    fc_canonical_header host = {{"Host", 4}, {"h", 1}};
+
+    std::string text;
+    CHECK(fc_canonical_request("GET", &uri, &host, 1, EMPTY_HASH, string_sink, &text));
+    CHECK(text.size() > 3000 && text.find("k0=v&k1=v&k10=v&k100=v&k101=v") != std::string::npos);
+
+    fc_sha256 sha;
+    unsigned char digest[32];
+    fc_sha256_begin(&sha);
+    CHECK(fc_canonical_request("GET", &uri, &host, 1, EMPTY_HASH, fc_sha256_sink, &sha));
+    fc_sha256_finish(&sha, digest);
+    CHECK(hex(digest) == sha256_hex(text));
+
+    // Limits
+    std::string params = "http://h/?";
+    for (int i = 0; i <= FC_CANONICAL_MAX_PARAMS; ++i) params += "p=&";
+    CHECK(canonical("GET", params.c_str()) == "refused");
+
+    fc_canonical_header many[FC_CANONICAL_MAX_HEADERS + 1];
+    for (int i = 0; i < FC_CANONICAL_MAX_HEADERS + 1; ++i) many[i] = host;
+    fc_uri_parse_view("http://h/", -1, &uri);
+    CHECK(!fc_canonical_request("GET", &uri, many, FC_CANONICAL_MAX_HEADERS + 1, EMPTY_HASH, string_sink, &text));
+}
+
+// FIPS 180-2 examples, one million 'a' fed in uneven pieces
+static void test_sha256(void)
+{
+    CHECK(sha256_hex("") == EMPTY_HASH);
+    CHECK(sha256_hex("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(sha256_hex("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq") ==
+          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    std::string million(1000000, 'a');
+    fc_sha256 sha;
+    unsigned char digest[32];
+    fc_sha256_begin(&sha);
+    for (size_t at = 0; at < million.size(); at += 777)
+    {
+        size_t count = million.size() - at < 777 ? million.size() - at : 777;
+        fc_sha256_update(&sha, million.data() + at, (int)count);
+    }
+    fc_sha256_finish(&sha, digest);
+    CHECK(hex(digest) == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    // Lengths around the padding boundary
+    int wrong = 0;
+    for (int length = 50; length < 70; ++length)
+    {
+        std::string data(length, 'x');
+        fc_sha256_begin(&sha);
+        for (int i = 0; i < length; ++i) fc_sha256_update(&sha, &data[i], 1);
+        fc_sha256_finish(&sha, digest);
+        wrong += hex(digest) != sha256_hex(data);
+    }
+    CHECK(wrong == 0);
+}
+
+int main(void)
+{
+    test_sha256();
+    test_suite();
+    test_encoding();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,263 @@
+// fc_uri_columns: every component read back as parsed with each column kind, dictionary codes, rows that are
+// refused, and truncated or corrupted images that must either fail to map or stay within the mapping.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_COLUMNS_IMPLEMENTATION
+#include "../fc_uri_columns.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+static void make_path(char* path, const char* name)
+{
+    snprintf(path, 64, "/tmp/fc_test_%s_XXXXXX", name);
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+}
+
+static bool str_same(fc_uri_str a, fc_uri_str b)
+{
+    if ((a.data == NULL) != (b.data == NULL) || a.count != b.count) return false;
+    return a.count == 0 || memcmp(a.data, b.data, a.count) == 0;
+}
+
+static std::vector<std::string> test_uris(int count)
+{
+    const char* forms[] = {
+        "http://h%d.example.com/a/b/c/%d?q=%d",
+        "https://user:pw@h%d.example.com:8443/a/b/%d#f%d",
+        "http://[::%d]:80/x/%d?",
+        "mailto:user%d@example.com?subject=%d",
+        "urn:isbn:%d-%d",
+        "file:///tmp/%d/%d",
+        "http://h%d.example.com?%d#%d",
+        "http://h%d.example.com/%d/%d/very/long/shared/prefix/of/the/path",
+    };
+
+    std::vector<std::string> uris;
+    for (int i = 0; i < count; ++i)
+    {
+        char uri[128];
+        snprintf(uri, sizeof(uri), forms[i % 8], i % 300, i / 3, i);
+        uris.push_back(uri);
+    }
+    return uris;
+}
+
+// Every row and component of columns against the parse of uris
+static int compare_rows(const fc_uri_columns* columns, const std::vector<std::string>& uris)
+{
+    char buffer[FC_URI_MAX + 1];
+    int mismatches = columns->row_count != (int64_t)uris.size();
+
+    for (int64_t row = 0; row < columns->row_count && row < (int64_t)uris.size(); ++row)
+    {
+        fc_uri_view uri;
+        fc_uri_parse_view(uris[row].data(), (int)uris[row].size(), &uri);
+
+        for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+        {
+            fc_uri_str value = fc_uri_columns_get(columns, row, (fc_uri_component)c, buffer);
+            mismatches += !str_same(value, fc_uri_view_component(&uri, (fc_uri_component)c));
+        }
+        mismatches += fc_uri_columns_ipv6_host(columns, row) != uri.ipv6_host;
+    }
+    return mismatches;
+}
+
+static void test_round_trip(uint32_t front_coded, const char* name)
+{
+    std::vector<std::string> uris = test_uris(3000);
+
+    fc_uri_columns_writer* writer = (fc_uri_columns_writer*)malloc(sizeof(fc_uri_columns_writer));
+    fc_uri_columns_writer_begin(writer, front_coded);
+
+    int refused = 0;
+    for (size_t i = 0; i < uris.size(); ++i)
+    {
+        fc_uri_view uri;
+        refused += !fc_uri_parse_view(uris[i].data(), (int)uris[i].size(), &uri) || !fc_uri_columns_writer_add(writer, &uri);
+    }
+    CHECK(refused == 0);
+
+    char path[64];
+    make_path(path, name);
+    CHECK(fc_uri_columns_writer_write(writer, path));
+    fc_uri_columns_writer_free(writer);
+    free(writer);
+
+    fc_uri_columns columns;
+    CHECK(fc_uri_columns_map(&columns, path));
+    CHECK(compare_rows(&columns, uris) == 0);
+
+    // Out of range rows are absent
+    char buffer[FC_URI_MAX + 1];
+    CHECK(fc_uri_columns_get(&columns, -1, FC_URI_HOST, buffer).data == NULL);
+    CHECK(fc_uri_columns_get(&columns, columns.row_count, FC_URI_PATH, buffer).data == NULL);
+
+    // Hosts are a dictionary of 300+ values, codes are 2 bytes: equal hosts have equal codes and the entry is the host
+    CHECK(columns.columns[FC_URI_HOST].width == 2);
+    std::map<std::string, uint32_t> codes;
+    int wrong = 0;
+    for (int64_t row = 0; row < columns.row_count; ++row)
+    {
+        uint32_t code = fc_uri_columns_code(&columns, row, FC_URI_HOST);
+        fc_uri_str host = fc_uri_columns_get(&columns, row, FC_URI_HOST, buffer);
+        if (!host.data)
+        {
+            wrong += code != 0;
+            continue;
+        }
+
+        std::string key(host.data, host.count);
+        if (codes.count(key)) wrong += codes[key] != code;
+        codes[key] = code;
+        wrong += !str_same(fc_uri_columns_entry(&columns, FC_URI_HOST, code), host);
+    }
+    CHECK(wrong == 0);
+    CHECK(codes.size() == columns.columns[FC_URI_HOST].entry_count);
+    CHECK(fc_uri_columns_entry(&columns, FC_URI_HOST, (uint32_t)codes.size() + 1).data == NULL);
+    CHECK(fc_uri_columns_code(&columns, 0, FC_URI_PATH) == 0);
+
+    fc_uri_columns_free(&columns);
+    unlink(path);
+}
+
+static void test_refused(void)
+{
+    static char long_uri[FC_URI_MAX + 100];
+    memcpy(long_uri, "http://x/", 9);
+    memset(long_uri + 9, 'a', FC_URI_MAX + 50);
+
+    fc_uri_view uri;
+    fc_uri_parse_view(long_uri, FC_URI_MAX + 59, &uri);
+
+    fc_uri_columns_writer* writer = (fc_uri_columns_writer*)malloc(sizeof(fc_uri_columns_writer));
+
+    // A front coded path longer than FC_URI_MAX doesn't fit the decode buffer
+    fc_uri_columns_writer_begin(writer, 1 << FC_URI_PATH);
+    CHECK(!fc_uri_columns_writer_add(writer, &uri));
+    CHECK(writer->row_count == 0 && !writer->failed);
+    fc_uri_columns_writer_free(writer);
+
+    // As plain bytes it's fine
+    fc_uri_columns_writer_begin(writer, 0);
+    CHECK(fc_uri_columns_writer_add(writer, &uri));
+    CHECK(writer->row_count == 1);
+    fc_uri_columns_writer_free(writer);
+
+    free(writer);
+}
+
+static bool write_bytes(const char* path, const unsigned char* data, size_t size)
+{
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = fwrite(data, 1, size, out) == size;
+    return fclose(out) == 0 && ok;
+}
+
+// Views must point into the mapping or the decode buffer, with their whole length
+static int outside_views(const fc_uri_columns* columns)
+{
+    char buffer[FC_URI_MAX + 1];
+    const char* begin = (const char*)columns->image;
+    const char* end = begin + columns->image_size;
+
+    int outside = 0;
+    for (int64_t row = 0; row < columns->row_count; ++row)
+    {
+        for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+        {
+            fc_uri_str value = fc_uri_columns_get(columns, row, (fc_uri_component)c, buffer);
+            if (!value.data) continue;
+
+            bool in_image = value.data >= begin && value.count >= 0 && value.count <= end - value.data;
+            bool in_buffer = value.data == buffer && value.count >= 0 && value.count <= FC_URI_MAX;
+            outside += !in_image && !in_buffer;
+        }
+    }
+    return outside;
+}
+
+static void test_corrupted(void)
+{
+    std::vector<std::string> uris = test_uris(40);
+
+    fc_uri_columns_writer* writer = (fc_uri_columns_writer*)malloc(sizeof(fc_uri_columns_writer));
+    fc_uri_columns_writer_begin(writer, (1 << FC_URI_PATH) | (1 << FC_URI_FRAGMENT));
+    for (size_t i = 0; i < uris.size(); ++i)
+    {
+        fc_uri_view uri;
+        fc_uri_parse_view(uris[i].data(), (int)uris[i].size(), &uri);
+        fc_uri_columns_writer_add(writer, &uri);
+    }
+
+    char path[64];
+    make_path(path, "columns");
+    CHECK(fc_uri_columns_writer_write(writer, path));
+    fc_uri_columns_writer_free(writer);
+    free(writer);
+
+    fc_uri_columns columns;
+    CHECK(fc_uri_columns_map(&columns, path));
+    std::vector<unsigned char> image((const unsigned char*)columns.image, (const unsigned char*)columns.image + columns.image_size);
+    fc_uri_columns_free(&columns);
+
+    // Every section is needed, no truncation maps
+    int mapped = 0;
+    for (size_t cut = 0; cut < image.size(); cut += cut < 64 ? 1 : 37)
+    {
+        write_bytes(path, image.data(), cut);
+        if (fc_uri_columns_map(&columns, path))
+        {
+            mapped++;
+            fc_uri_columns_free(&columns);
+        }
+    }
+    CHECK(mapped == 0);
+
+    // Flipped bits and random bytes may map, but then nothing is read outside of the image
+    srand(7);
+    int outside = 0;
+    for (int it = 0; it < 400; ++it)
+    {
+        std::vector<unsigned char> copy = image;
+        int changes = 1 + rand() % 4;
+        for (int k = 0; k < changes; ++k)
+        {
+            size_t at = rand() % copy.size();
+            if (rand() % 2) {
+                copy[at] ^= (unsigned char)(1 << (rand() % 8));
+            } else {
+                copy[at] = (unsigned char)rand();
+            }
+        }
+
+        write_bytes(path, copy.data(), copy.size());
+        if (!fc_uri_columns_map(&columns, path)) continue;
+        outside += outside_views(&columns);
+        fc_uri_columns_free(&columns);
+    }
+    CHECK(outside == 0);
+
+    unlink(path);
+}
+
+int main(void)
+{
+    test_round_trip(0, "bytes");
+    test_round_trip((1 << FC_URI_USER) | (1 << FC_URI_PATH) | (1 << FC_URI_QUERY) | (1 << FC_URI_FRAGMENT), "front");
+    test_refused();
+    test_corrupted();
+
+    return FC_TEST_RESULT();
+}
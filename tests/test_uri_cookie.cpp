@@ -0,0 +1,408 @@
+// fc_uri_cookie: RFC 6265 date cases, domain and path matching, ordering and expiry, a random sequence of
+// Set-Cookie headers against a simple list based reference jar, and random bytes into the parsers.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_COOKIE_IMPLEMENTATION
+#include "../fc_uri_cookie.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <vector>
+
+static bool date_is(const char* date, uint64_t expected)
+{
+    uint64_t time = 12345;
+    return fc_cookie_parse_date(date, -1, &time) && time == expected;
+}
+
+static bool not_date(const char* date)
+{
+    uint64_t time;
+    return !fc_cookie_parse_date(date, -1, &time);
+}
+
+static void test_dates(void)
+{
+    // The three formats of HTTP dates (RFC 7231) and what browsers see in the wild
+    CHECK(date_is("Wed, 21 Oct 2015 07:28:00 GMT", 1445412480));
+    CHECK(date_is("Sunday, 06-Nov-94 08:49:37 GMT", 784111777));
+    CHECK(date_is("Sun Nov  6 08:49:37 1994", 784111777));
+    CHECK(date_is("Thursday, 01-Jan-1970 00:00:00 GMT", 0));
+    CHECK(date_is("Wednesday, 01-Jan-10 00:00:00 GMT", 1262304000));
+    CHECK(date_is("Mon, 10-Dec-07 20:35:03 GMT", 1197318903));
+    CHECK(date_is("Tue, 18-Oct-2011 07:42:42 GMT", 1318923762));
+    CHECK(date_is("Sat, 15 Oct 2011 0:0:0 GMT", 1318636800));
+
+    // Tokens in any order, months by their first three letters, trailing junk after the digits
+    CHECK(date_is("1 DECEMBER 2030 1:2:3", 1922317323));
+    CHECK(date_is("2030 dec 1 01:02:03abc", 1922317323));
+    CHECK(date_is("Mon, 10 Decx 2007 10:00:00", 1197280800));
+    CHECK(date_is("Thu, 01 Jan 1970 00:00:00 GMT\t!junk 99:99:99", 0));
+
+    CHECK(date_is("Fri, 29 Feb 2008 23:59:59 GMT", 1204329599));
+    CHECK(date_is("Tue, 29 Feb 2000 12:00:00 GMT", 951825600));
+    CHECK(date_is("Fri, 31 Dec 9999 23:59:59 GMT", 253402300799ull));
+    CHECK(date_is("Mon, 01 Jan 1601 00:00:00 GMT", 0)); // Before the epoch
+    CHECK(date_is("1 Jan 69 00:00:00", 3124224000ull)); // 2069
+    CHECK(date_is("1 Jan 70 00:00:00", 0));
+
+    // Out of range fields, missing fields, dates that don't exist
+    CHECK(not_date("Thu, 10 Dec 2009 25:27:23 GMT"));
+    CHECK(not_date("Thu, 10 Dec 2009 23:60:00 GMT"));
+    CHECK(not_date("Thu, 10 Dec 2009 23:00:60 GMT"));
+    CHECK(not_date("Wed, 09 Dec 1600 16:27:23 GMT"));
+    CHECK(not_date("Mon, 0 Dec 2007 10:00:00"));
+    CHECK(not_date("Mon, 32 Dec 2007 10:00:00"));
+    CHECK(not_date("Thu, 30 Feb 2012 00:00:00 GMT"));
+    CHECK(not_date("Mon, 29 Feb 2100 00:00:00 GMT"));
+    CHECK(not_date("Thu, 31 Apr 2014 00:00:00 GMT"));
+    CHECK(not_date("Mon, 10 Dec 2007"));
+    CHECK(not_date("Mon, 10 Dec 02007 10:00:00"));
+    CHECK(not_date("69 Jan 1 00:00:00")); // 69 is the day, 1 is not a year
+    CHECK(not_date("12:00:00"));
+    CHECK(not_date(""));
+    CHECK(not_date("Thu\x01" "10\x7f" "Dec 2009 12:00:00")); // Control characters are not delimiters
+
+    // count limits the input
+    uint64_t time;
+    CHECK(!fc_cookie_parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 16, &time));
+    CHECK(fc_cookie_parse_date("Wed, 21 Oct 2015 07:28:00 GMT", 25, &time) && time == 1445412480);
+
+    // Every day of a few years through the formatter of the C library
+    int wrong = 0;
+    for (time_t t = 946684800; t < 946684800 + 5 * 366 * 86400; t += 86400 + 3607)
+    {
+        struct tm tm;
+        gmtime_r(&t, &tm);
+
+        char text[64];
+        strftime(text, sizeof(text), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+        wrong += !date_is(text, (uint64_t)t);
+    }
+    CHECK(wrong == 0);
+}
+
+static bool set(fc_cookie_jar* jar, const char* url, const char* header, uint64_t now)
+{
+    fc_uri_view uri;
+    fc_uri_parse_view(url, -1, &uri);
+    return fc_cookie_jar_set(jar, &uri, header, -1, now);
+}
+
+static std::string header(const fc_cookie_jar* jar, const char* url, uint64_t now)
+{
+    fc_uri_view uri;
+    fc_uri_parse_view(url, -1, &uri);
+
+    char dst[1024];
+    int length = fc_cookie_jar_header(jar, &uri, now, dst, sizeof(dst));
+    if (length < 0 || length != (int)strlen(dst)) return "error";
+    return dst;
+}
+
+static void test_jar(void)
+{
+    fc_cookie_jar jar;
+    fc_cookie_jar_init(&jar);
+
+    const char* url = "https://www.Example.com/shop/cart/view";
+    CHECK(set(&jar, url, "id=42; Domain=.example.com; Path=/shop; Max-Age=3600; Secure", 1000));
+    CHECK(set(&jar, url, " h = 1 ", 1000));
+    CHECK(set(&jar, url, "r=root; path=/", 1000));
+
+    // Domain must match the host and not be a top level domain
+    CHECK(!set(&jar, url, "x=1; Domain=com", 1000));
+    CHECK(!set(&jar, url, "x=1; Domain=other.com", 1000));
+    CHECK(!set(&jar, url, "x=1; Domain=ww.example.com", 1000));
+    CHECK(!set(&jar, url, "novalue", 1000));
+    CHECK(!set(&jar, url, "=1", 1000));
+    CHECK(!set(&jar, "urn:x", "x=1", 1000));
+    CHECK(jar.count == 3);
+
+    // Longer paths first: /shop/cart (the default path), /shop, /
+    CHECK(header(&jar, url, 1000) == "h=1; id=42; r=root");
+    CHECK(header(&jar, "https://WWW.EXAMPLE.COM/shop/cart", 1000) == "h=1; id=42; r=root");
+    CHECK(header(&jar, "https://www.example.com/shop/carts", 1000) == "id=42; r=root");
+    CHECK(header(&jar, "https://sub.example.com/shop/x", 1000) == "id=42");
+    CHECK(header(&jar, "https://sub.example.com/shopping", 1000) == "");
+    CHECK(header(&jar, "http://sub.example.com/shop/x", 1000) == ""); // Secure
+    CHECK(header(&jar, "wss://example.com/shop", 1000) == "id=42");
+    CHECK(header(&jar, "https://badexample.com/shop", 1000) == "");
+    CHECK(header(&jar, "https://www.example.com", 1000) == "r=root");
+
+    fc_uri_view uri;
+    fc_uri_parse_view(url, -1, &uri);
+    char small[5];
+    CHECK(fc_cookie_jar_header(&jar, &uri, 1000, small, sizeof(small)) == -1);
+    char exact[19];
+    CHECK(fc_cookie_jar_header(&jar, &uri, 1000, exact, sizeof(exact)) == 18);
+
+    // Replacing keeps the creation time and so the order, Max-Age wins over Expires
+    CHECK(set(&jar, url, "r=new; path=/; expires=Thu, 01 Jan 1970 00:00:00 GMT; max-age=10000", 1001));
+    CHECK(set(&jar, url, "z=last; path=/", 1002));
+    CHECK(jar.count == 4);
+    CHECK(header(&jar, url, 1002) == "h=1; id=42; r=new; z=last");
+
+    // Expiry: lookups skip what expired, expire removes it
+    CHECK(header(&jar, url, 4600) == "h=1; r=new; z=last");
+    CHECK(fc_cookie_jar_expire(&jar, 4599) == 0);
+    CHECK(fc_cookie_jar_expire(&jar, 4600) == 1);
+    CHECK(jar.count == 3 && jar.heap_count == 1);
+    CHECK(fc_cookie_jar_expire(&jar, 20000) == 1);
+    CHECK(jar.count == 2 && jar.heap_count == 0);
+
+    // An expiry in the past deletes, a bad one is ignored
+    CHECK(set(&jar, url, "z=gone; path=/; expires=Thu, 01 Jan 1970 00:00:00 GMT", 20000));
+    CHECK(set(&jar, url, "h=2; expires=Thu, 30 Feb 2012 00:00:00 GMT", 20000));
+    CHECK(set(&jar, url, "h=3; max-age=1x", 20000));
+    CHECK(jar.count == 1 && jar.heap_count == 0);
+    CHECK(header(&jar, url, 1ull << 40) == "h=3");
+    CHECK(set(&jar, url, "h=; max-age=0", 20000));
+    CHECK(jar.count == 0);
+    CHECK(header(&jar, url, 20000) == "");
+
+    fc_cookie_jar_free(&jar);
+}
+
+// A cookie of the reference jar
+typedef struct
+{
+    std::string name;
+    std::string value;
+    std::string domain;
+    std::string path;
+    bool host_only;
+    bool secure;
+    uint64_t expires;
+    uint64_t creation;
+} reference_cookie;
+
+static std::string lowercase(std::string text)
+{
+    for (size_t i = 0; i < text.size(); ++i) text[i] = (char)tolower((unsigned char)text[i]);
+    return text;
+}
+
+static bool reference_domain_match(const std::string& host, const std::string& domain)
+{
+    if (host == domain) return true;
+    return host.size() > domain.size() && host.compare(host.size() - domain.size(), domain.size(), domain) == 0 &&
+           host[host.size() - domain.size() - 1] == '.';
+}
+
+static bool reference_path_match(const std::string& request, const std::string& path)
+{
+    if (request.compare(0, path.size(), path) != 0) return false;
+    return request.size() == path.size() || path[path.size() - 1] == '/' || request[path.size()] == '/';
+}
+
+// The random headers are made of well formed parts, so this only handles those
+static void reference_set(std::vector<reference_cookie>* jar, uint64_t* creation, const std::string& host, const std::string& request_path,
+                          const std::string& name, const std::string& value, const std::string& domain, const std::string& path,
+                          bool secure, bool has_max_age, int64_t max_age, bool has_expires, uint64_t expires, uint64_t now)
+{
+    reference_cookie cookie;
+    cookie.name = name;
+    cookie.value = value;
+    cookie.secure = secure;
+    cookie.expires = has_max_age ? (max_age <= 0 ? 0 : now + max_age) : has_expires ? expires : FC_COOKIE_SESSION;
+
+    cookie.host_only = domain.empty();
+    cookie.domain = cookie.host_only ? host : domain;
+    if (!cookie.host_only && (!reference_domain_match(host, domain) || domain.find('.') == std::string::npos)) return;
+
+    cookie.path = path;
+    if (path.empty())
+    {
+        size_t last_slash = request_path.rfind('/');
+        cookie.path = last_slash == std::string::npos || last_slash == 0 ? "/" : request_path.substr(0, last_slash);
+    }
+
+    cookie.creation = (*creation)++;
+    for (size_t i = 0; i < jar->size(); ++i)
+    {
+        reference_cookie* old = &(*jar)[i];
+        if (old->name == cookie.name && old->domain == cookie.domain && old->path == cookie.path)
+        {
+            cookie.creation = old->creation;
+            jar->erase(jar->begin() + i);
+            break;
+        }
+    }
+
+    if (cookie.expires > now) jar->push_back(cookie);
+}
+
+static std::string reference_header(const std::vector<reference_cookie>& jar, const std::string& host, const std::string& request_path,
+                                    bool secure_uri, uint64_t now)
+{
+    std::vector<const reference_cookie*> matches;
+    for (size_t i = 0; i < jar.size(); ++i)
+    {
+        const reference_cookie* cookie = &jar[i];
+        if (cookie->expires <= now || (cookie->secure && !secure_uri)) continue;
+        if (cookie->host_only ? host != cookie->domain : !reference_domain_match(host, cookie->domain)) continue;
+        if (!reference_path_match(request_path.empty() ? "/" : request_path, cookie->path)) continue;
+        matches.push_back(cookie);
+    }
+
+    // Longer paths first, then older ones, by insertion
+    for (size_t i = 1; i < matches.size(); ++i)
+    {
+        for (size_t j = i; j > 0; --j)
+        {
+            const reference_cookie* a = matches[j - 1];
+            const reference_cookie* b = matches[j];
+            bool swap = a->path.size() < b->path.size() || (a->path.size() == b->path.size() && a->creation > b->creation);
+            if (!swap) break;
+            matches[j - 1] = b;
+            matches[j] = a;
+        }
+    }
+
+    std::string result;
+    for (size_t i = 0; i < matches.size(); ++i) result += (i ? "; " : "") + matches[i]->name + "=" + matches[i]->value;
+    return result;
+}
+
+static void test_random_jar(void)
+{
+    const char* hosts[] = {"example.com", "a.Example.com", "b.a.example.com", "other.org", "com"};
+    const char* paths[] = {"", "/", "/a", "/a/", "/a/b", "/ab", "/a/b/c"};
+    const char* domains[] = {"", "example.com", ".A.example.com", "other.org", "com", "b.a.example.com"};
+    const char* cookie_paths[] = {"", "/", "/a", "/a/b", "/a/"};
+
+    fc_cookie_jar jar;
+    fc_cookie_jar_init(&jar);
+    std::vector<reference_cookie> reference;
+    uint64_t creation = 0;
+
+    srand(8);
+    uint64_t now = 1000000000;
+    int mismatches = 0;
+    for (int it = 0; it < 20000; ++it)
+    {
+        now += rand() % 5;
+
+        bool https = rand() % 2;
+        std::string host = hosts[rand() % 5];
+        std::string request_path = paths[rand() % 7];
+        std::string url = (https ? "https://" : "http://") + host + request_path;
+        host = lowercase(host);
+
+        if (rand() % 3 == 0)
+        {
+            std::string expected = reference_header(reference, host, request_path, https, now);
+            mismatches += header(&jar, url.c_str(), now) != expected;
+            continue;
+        }
+
+        if (rand() % 50 == 0)
+        {
+            size_t before = reference.size();
+            for (size_t i = 0; i < reference.size();) reference[i].expires <= now ? (void)reference.erase(reference.begin() + i) : (void)++i;
+            mismatches += fc_cookie_jar_expire(&jar, now) != (int)(before - reference.size());
+            continue;
+        }
+
+        std::string name = "n" + std::to_string(rand() % 6);
+        std::string value = "v" + std::to_string(it);
+        std::string domain = rand() % 2 ? "" : domains[rand() % 6];
+        std::string path = cookie_paths[rand() % 5];
+        bool secure = rand() % 4 == 0;
+        bool has_max_age = rand() % 3 == 0;
+        int64_t max_age = rand() % 60 - 5;
+        bool has_expires = rand() % 3 == 0;
+        time_t expires = (time_t)(now + rand() % 60 - 5);
+
+        std::string set_cookie = name + "=" + value;
+        if (!domain.empty()) set_cookie += "; Domain=" + domain;
+        if (!path.empty()) set_cookie += "; Path=" + path;
+        if (secure) set_cookie += "; Secure";
+        if (has_max_age) set_cookie += "; Max-Age=" + std::to_string(max_age);
+        if (has_expires)
+        {
+            struct tm tm;
+            gmtime_r(&expires, &tm);
+            char date[64];
+            strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &tm);
+            set_cookie += std::string("; Expires=") + date;
+        }
+
+        std::string lower_domain = lowercase(domain[0] == '.' ? domain.substr(1) : domain);
+        reference_set(&reference, &creation, host, request_path, name, value, lower_domain, path, secure, has_max_age, max_age,
+                      has_expires, (uint64_t)expires, now);
+        set(&jar, url.c_str(), set_cookie.c_str(), now);
+        mismatches += jar.count != (int)reference.size();
+    }
+    CHECK(mismatches == 0);
+
+    // The domain lists and the heap still hold every live cookie exactly once
+    int listed = 0;
+    int broken = 0;
+    for (int d = 0; d < jar.domain_count; ++d)
+    {
+        int previous = -1;
+        for (int i = jar.domains[d].first; i >= 0; i = jar.cookies[i].next)
+        {
+            broken += jar.cookies[i].previous != previous || jar.cookies[i].domain != d;
+            previous = i;
+            listed++;
+        }
+    }
+    int with_expiry = 0;
+    for (size_t i = 0; i < reference.size(); ++i) with_expiry += reference[i].expires != FC_COOKIE_SESSION;
+    CHECK(broken == 0);
+    CHECK(listed == jar.count);
+    CHECK(jar.heap_count == with_expiry);
+
+    fc_cookie_jar_free(&jar);
+}
+
+static void test_random_bytes(void)
+{
+    fc_cookie_jar jar;
+    fc_cookie_jar_init(&jar);
+
+    fc_uri_view uri;
+    fc_uri_parse_view("https://a.b.example.com/x/y", -1, &uri);
+
+    const char alphabet[] = "=;., -:/0123456789abcdefDdMmPpSsEe\t\x01\xff";
+    srand(9);
+    for (int it = 0; it < 20000; ++it)
+    {
+        char text[64];
+        int count = rand() % (int)sizeof(text);
+        for (int i = 0; i < count; ++i) text[i] = rand() % 4 ? alphabet[rand() % (sizeof(alphabet) - 1)] : (char)rand();
+
+        uint64_t time;
+        fc_cookie_parse_date(text, count, &time);
+        fc_cookie_jar_set(&jar, &uri, text, count, 1000 + it);
+    }
+
+    char dst[64];
+    int length = fc_cookie_jar_header(&jar, &uri, 1000, dst, sizeof(dst));
+    CHECK(length == -1 || length == (int)strlen(dst));
+
+    fc_cookie_jar_expire(&jar, UINT64_MAX - 1);
+    CHECK(jar.heap_count == 0);
+
+    fc_cookie_jar_free(&jar);
+}
+
+int main(void)
+{
+    test_dates();
+    test_jar();
+    test_random_jar();
+    test_random_bytes();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,191 @@
+// fc_uri_file: parallel parse against fc_uri_parse_view, columns round trip, truncated and corrupted columns files.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_COLUMNS_IMPLEMENTATION
+#include "../fc_uri_columns.h"
+#define FC_URI_FILE_IMPLEMENTATION
+#include "../fc_uri_file.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define LINE_COUNT 5001
+
+static char lines[LINE_COUNT][128];
+
+static void make_path(char* path, const char* name)
+{
+    snprintf(path, 64, "/tmp/fc_test_%s_XXXXXX", name);
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+}
+
+static bool str_same(fc_uri_str a, fc_uri_str b)
+{
+    if ((a.data == NULL) != (b.data == NULL) || a.count != b.count) return false;
+    return a.count == 0 || memcmp(a.data, b.data, a.count) == 0;
+}
+
+static bool view_same(const fc_uri_view* a, const fc_uri_view* b)
+{
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        if (!str_same(fc_uri_view_component(a, (fc_uri_component)c), fc_uri_view_component(b, (fc_uri_component)c))) return false;
+    }
+    return a->ipv6_host == b->ipv6_host;
+}
+
+// Every line of file against the parse of lines[], returns the number of lines that differ
+static int compare_lines(const fc_uri_file* file)
+{
+    int mismatches = 0;
+    for (int64_t line = 0; line < file->line_count; ++line)
+    {
+        fc_uri_view expected;
+        bool expected_ok = fc_uri_parse_view(lines[line], -1, &expected);
+
+        fc_uri_view uri;
+        bool ok = fc_uri_file_line(file, line, &uri);
+        if (ok != expected_ok || (ok && !view_same(&uri, &expected))) mismatches++;
+    }
+    return mismatches;
+}
+
+static bool write_bytes(const char* path, const char* data, size_t size)
+{
+    FILE* out = fopen(path, "wb");
+    if (!out) return false;
+    bool ok = fwrite(data, 1, size, out) == size;
+    return fclose(out) == 0 && ok;
+}
+
+static char* read_bytes(const char* path, size_t* size)
+{
+    FILE* in = fopen(path, "rb");
+    if (!in) return NULL;
+    fseek(in, 0, SEEK_END);
+    *size = (size_t)ftell(in);
+    fseek(in, 0, SEEK_SET);
+    char* data = (char*)malloc(*size ? *size : 1);
+    if (fread(data, 1, *size, in) != *size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(in);
+    return data;
+}
+
+// Loads path and reads every line, the views have to stay inside the mapping. Returns whether it loaded.
+static bool load_and_touch(const char* path, bool* in_bounds)
+{
+    fc_uri_file file;
+    if (!fc_uri_file_load(&file, path)) return false;
+
+    const char* begin = (const char*)file.columns.image;
+    const char* end   = begin + file.columns.image_size;
+
+    for (int64_t line = 0; line < file.line_count; ++line)
+    {
+        fc_uri_view uri;
+        fc_uri_file_line(&file, line, &uri);
+        for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+        {
+            fc_uri_str str = fc_uri_view_component(&uri, (fc_uri_component)c);
+            if (str.data && (str.count < 0 || str.data < begin || str.data + str.count > end)) *in_bounds = false;
+        }
+    }
+
+    fc_uri_file_close(&file);
+    return true;
+}
+
+int main(void)
+{
+    char text_path[64];
+    char columns_path[64];
+    char corrupt_path[64];
+    make_path(text_path, "lines");
+    make_path(columns_path, "columns");
+    make_path(corrupt_path, "corrupt");
+
+    // Mixed line endings, lines that don't parse, empty lines and a last line with no newline
+    FILE* out = fopen(text_path, "wb");
+    for (int i = 0; i < LINE_COUNT; ++i)
+    {
+        switch (i % 11)
+        {
+        case 3:  sprintf(lines[i], "not a uri %d", i); break;
+        case 5:  lines[i][0] = '\0'; break; // LINE_COUNT - 1 is not one of these, it would not be a line
+        case 7:  sprintf(lines[i], "http://[2001:db8::%x]:8080/v6?i=%d", i, i); break;
+        default: sprintf(lines[i], "https://host%d.example.com:%d/path/%d/x?q=%d#f", i % 97, 80 + i % 3, i, i); break;
+        }
+        fprintf(out, "%s%s", lines[i], i == LINE_COUNT - 1 ? "" : i % 7 == 0 ? "\r\n" : "\n");
+    }
+    fclose(out);
+
+    const int thread_counts[] = {1, 3, 8};
+    for (int t = 0; t < 3; ++t)
+    {
+        fc_uri_file file;
+        CHECK(fc_uri_file_open(&file, text_path, thread_counts[t]));
+        CHECK(file.line_count == LINE_COUNT);
+        CHECK(compare_lines(&file) == 0);
+
+        if (t == 0) CHECK(fc_uri_file_write_columns(&file, columns_path));
+        fc_uri_file_close(&file);
+    }
+
+    fc_uri_file file;
+    CHECK(fc_uri_file_load(&file, columns_path));
+    CHECK(file.line_count == LINE_COUNT);
+    CHECK(compare_lines(&file) == 0);
+    fc_uri_file_close(&file);
+
+    CHECK(!fc_uri_file_load(&file, "/nonexistent/fc_test.columns"));
+
+    size_t size = 0;
+    char* image = read_bytes(columns_path, &size);
+    CHECK(image != NULL);
+
+    bool in_bounds = true;
+
+    // Truncations of the image, none of them is a whole file
+    int truncated_loads = 0;
+    for (size_t cut = 0; image && cut < size; cut += cut < 64 ? 1 : 211)
+    {
+        write_bytes(corrupt_path, image, cut);
+        truncated_loads += load_and_touch(corrupt_path, &in_bounds);
+    }
+    CHECK(truncated_loads == 0);
+
+    // Random bytes changed, these can still load but must not read outside the mapping
+    srand(5);
+    for (int it = 0; image && it < 500; ++it)
+    {
+        char* copy = (char*)malloc(size);
+        memcpy(copy, image, size);
+        int changes = 1 + rand() % 4;
+        for (int k = 0; k < changes; ++k)
+        {
+            size_t position = (size_t)rand() % size;
+            if (rand() % 2) copy[position] ^= (char)(1 << (rand() % 8));
+            else            copy[position] = (char)rand();
+        }
+        write_bytes(corrupt_path, copy, size);
+        load_and_touch(corrupt_path, &in_bounds);
+        free(copy);
+    }
+    CHECK(in_bounds);
+
+    free(image);
+    unlink(text_path);
+    unlink(columns_path);
+    unlink(corrupt_path);
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,231 @@
+// fc_uri_filter: concurrent batch inserts into both filters, no false negatives, false positive rates,
+// the cuckoo victim slot after the filter fills up, batch against single lookups and mapped files.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_FILTER_IMPLEMENTATION
+#include "../fc_uri_filter.h"
+
+#include "fc_test.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define THREAD_COUNT 4
+#define KEY_COUNT    20000
+
+static fc_bloom_filter bloom;
+static fc_cuckoo_filter cuckoo;
+static bool inserted[THREAD_COUNT][KEY_COUNT];
+
+static uint64_t test_key(uint64_t i)
+{
+    uint64_t x = (i + 1) * 0x9E3779B97F4A7C15ull;
+    return x ^ (x >> 29);
+}
+
+static uint64_t thread_key(long thread, int i)
+{
+    return test_key((uint64_t)thread * 1000000 + i);
+}
+
+static void* bloom_worker(void* arg)
+{
+    long thread = (long)arg;
+    uint64_t* keys = (uint64_t*)malloc(KEY_COUNT * sizeof(uint64_t));
+    for (int i = 0; i < KEY_COUNT; ++i) keys[i] = thread_key(thread, i);
+
+    // Half in a batch, half one at a time
+    fc_bloom_insert_batch(&bloom, keys, KEY_COUNT / 2);
+    for (int i = KEY_COUNT / 2; i < KEY_COUNT; ++i) fc_bloom_insert(&bloom, keys[i]);
+
+    free(keys);
+    return NULL;
+}
+
+static void* cuckoo_worker(void* arg)
+{
+    long thread = (long)arg;
+    uint64_t* keys = (uint64_t*)malloc(KEY_COUNT * sizeof(uint64_t));
+    for (int i = 0; i < KEY_COUNT; ++i) keys[i] = thread_key(thread, i);
+
+    fc_cuckoo_insert_batch(&cuckoo, keys, KEY_COUNT / 2, inserted[thread]);
+    for (int i = KEY_COUNT / 2; i < KEY_COUNT; ++i) inserted[thread][i] = fc_cuckoo_insert(&cuckoo, keys[i]);
+
+    free(keys);
+    return NULL;
+}
+
+static void run_threads(void* (*worker)(void*))
+{
+    pthread_t threads[THREAD_COUNT];
+    for (long t = 0; t < THREAD_COUNT; ++t) pthread_create(&threads[t], NULL, worker, (void*)t);
+    for (int t = 0; t < THREAD_COUNT; ++t) pthread_join(threads[t], NULL);
+}
+
+static void make_path(char* path, const char* name)
+{
+    snprintf(path, 64, "/tmp/fc_test_%s_XXXXXX", name);
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+}
+
+static void test_bloom(void)
+{
+    CHECK(fc_bloom_init(&bloom, THREAD_COUNT * KEY_COUNT, 0.01));
+    run_threads(bloom_worker);
+
+    int misses = 0;
+    for (long t = 0; t < THREAD_COUNT; ++t)
+    {
+        for (int i = 0; i < KEY_COUNT; ++i) misses += !fc_bloom_contains(&bloom, thread_key(t, i));
+    }
+    CHECK(misses == 0);
+
+    // Keys that were never inserted, one at a time and in batches
+    int false_positives = 0;
+    int batch_mismatches = 0;
+    for (int i = 0; i < KEY_COUNT; i += 100)
+    {
+        uint64_t keys[100];
+        bool results[100];
+        for (int k = 0; k < 100; ++k) keys[k] = test_key(50000000 + i + k);
+        fc_bloom_contains_batch(&bloom, keys, 100, results);
+        for (int k = 0; k < 100; ++k)
+        {
+            bool contained = fc_bloom_contains(&bloom, keys[k]);
+            false_positives += contained;
+            batch_mismatches += contained != results[k];
+        }
+    }
+    CHECK(batch_mismatches == 0);
+    CHECK(false_positives < KEY_COUNT * 0.02);
+
+    // Written, mapped back read-only, then writable: inserts go to the file
+    char path[64];
+    make_path(path, "bloom");
+    CHECK(fc_bloom_write(&bloom, path));
+    fc_bloom_free(&bloom);
+
+    CHECK(fc_bloom_map(&bloom, path, false));
+    misses = 0;
+    for (int i = 0; i < KEY_COUNT; ++i) misses += !fc_bloom_contains(&bloom, thread_key(2, i));
+    CHECK(misses == 0);
+    fc_bloom_free(&bloom);
+
+    CHECK(fc_bloom_map(&bloom, path, true));
+    fc_bloom_insert(&bloom, test_key(77777777));
+    fc_bloom_free(&bloom);
+
+    CHECK(fc_bloom_map(&bloom, path, false));
+    CHECK(fc_bloom_contains(&bloom, test_key(77777777)));
+    fc_bloom_free(&bloom);
+
+    // Not a filter file
+    FILE* out = fopen(path, "wb");
+    fputs("not a bloom filter", out);
+    fclose(out);
+    CHECK(!fc_bloom_map(&bloom, path, false));
+    CHECK(!fc_cuckoo_map(&cuckoo, path, false));
+
+    unlink(path);
+}
+
+static void test_cuckoo(void)
+{
+    CHECK(fc_cuckoo_init(&cuckoo, THREAD_COUNT * KEY_COUNT));
+    run_threads(cuckoo_worker);
+
+    int failed = 0;
+    int misses = 0;
+    for (long t = 0; t < THREAD_COUNT; ++t)
+    {
+        for (int i = 0; i < KEY_COUNT; ++i)
+        {
+            failed += !inserted[t][i];
+            misses += inserted[t][i] && !fc_cuckoo_contains(&cuckoo, thread_key(t, i));
+        }
+    }
+    CHECK(failed == 0);
+    CHECK(misses == 0);
+
+    int false_positives = 0;
+    for (int i = 0; i < KEY_COUNT; ++i) false_positives += fc_cuckoo_contains(&cuckoo, test_key(50000000 + i));
+    CHECK(false_positives < KEY_COUNT * 0.01);
+
+    // Fill it up, the key that doesn't fit anymore is parked in the victim slot and is still found
+    uint64_t extra = 0;
+    while (fc_cuckoo_insert(&cuckoo, test_key(90000000 + extra))) extra++;
+    CHECK(*cuckoo.victim != 0);
+
+    misses = 0;
+    for (uint64_t i = 0; i < extra; ++i) misses += !fc_cuckoo_contains(&cuckoo, test_key(90000000 + i));
+    CHECK(misses == 0);
+
+    // A full filter refuses inserts without evicting anything
+    CHECK(!fc_cuckoo_insert(&cuckoo, test_key(123456789)));
+
+    // Removes free slots, the victim moves back into the buckets
+    int removed = 0;
+    for (int i = 0; i < 200 && *cuckoo.victim; ++i) removed += fc_cuckoo_remove(&cuckoo, thread_key(1, i));
+    CHECK(*cuckoo.victim == 0);
+    CHECK(removed > 0 && removed < 200);
+
+    misses = 0;
+    for (long t = 0; t < THREAD_COUNT; ++t)
+    {
+        for (int i = t == 1 ? removed : 0; i < KEY_COUNT; ++i) misses += !fc_cuckoo_contains(&cuckoo, thread_key(t, i));
+    }
+    for (uint64_t i = 0; i < extra; ++i) misses += !fc_cuckoo_contains(&cuckoo, test_key(90000000 + i));
+    CHECK(misses == 0);
+
+    // Batch lookups agree with single ones
+    int batch_mismatches = 0;
+    for (int i = 0; i < KEY_COUNT; i += 100)
+    {
+        uint64_t keys[100];
+        bool results[100];
+        for (int k = 0; k < 100; ++k) keys[k] = k % 2 ? thread_key(3, i + k) : test_key(50000000 + i + k);
+        fc_cuckoo_contains_batch(&cuckoo, keys, 100, results);
+        for (int k = 0; k < 100; ++k) batch_mismatches += results[k] != fc_cuckoo_contains(&cuckoo, keys[k]);
+    }
+    CHECK(batch_mismatches == 0);
+
+    char path[64];
+    make_path(path, "cuckoo");
+    CHECK(fc_cuckoo_write(&cuckoo, path));
+    fc_cuckoo_free(&cuckoo);
+
+    CHECK(fc_cuckoo_map(&cuckoo, path, true));
+    misses = 0;
+    for (int i = 0; i < KEY_COUNT; ++i) misses += !fc_cuckoo_contains(&cuckoo, thread_key(0, i));
+    CHECK(misses == 0);
+    CHECK(fc_cuckoo_remove(&cuckoo, thread_key(0, 0)));
+    fc_cuckoo_free(&cuckoo);
+
+    unlink(path);
+}
+
+static void test_key_normalization(void)
+{
+    // Equivalent URIs have the same key
+    fc_uri_view a;
+    fc_uri_view b;
+    fc_uri_view c;
+    fc_uri_parse_view("HTTP://Example.COM:80/a/./b/../c/%7euser", -1, &a);
+    fc_uri_parse_view("http://example.com/a/c/~user", -1, &b);
+    fc_uri_parse_view("http://example.com/a/c/~user2", -1, &c);
+    CHECK(fc_uri_filter_key(&a) == fc_uri_filter_key(&b));
+    CHECK(fc_uri_filter_key(&a) != fc_uri_filter_key(&c));
+}
+
+int main(void)
+{
+    test_bloom();
+    test_cuckoo();
+    test_key_normalization();
+
+    return FC_TEST_RESULT();
+}
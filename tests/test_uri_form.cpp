@@ -0,0 +1,213 @@
+// fc_uri_form: decoding examples, and random bodies fed in random chunks against a reference decoder written
+// from the spec, with small limits so that long keys are skipped and long values come in pieces.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#define FC_FORM_KEY_MAX   16
+#define FC_FORM_VALUE_MAX 32
+#define FC_URI_FORM_IMPLEMENTATION
+#include "../fc_uri_form.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+typedef struct
+{
+    std::string key;
+    std::string value;
+    bool has_value;
+} form_pair;
+
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+static std::string reference_decode(const std::string& text)
+{
+    std::string decoded;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        if (text[i] == '+') {
+            decoded += ' ';
+        } else if (text[i] == '%' && i + 2 < text.size() && hex_value(text[i + 1]) >= 0 && hex_value(text[i + 2]) >= 0) {
+            decoded += (char)(hex_value(text[i + 1]) * 16 + hex_value(text[i + 2]));
+            i += 2;
+        } else {
+            decoded += text[i];
+        }
+    }
+    return decoded;
+}
+
+// Split on '&', empty sequences are dropped, then on the first '='
+static std::vector<form_pair> reference_pairs(const std::string& body, int* skipped)
+{
+    std::vector<form_pair> pairs;
+    *skipped = 0;
+
+    size_t at = 0;
+    while (at <= body.size())
+    {
+        size_t end = body.find('&', at);
+        if (end == std::string::npos) end = body.size();
+
+        std::string sequence = body.substr(at, end - at);
+        at = end + 1;
+        if (sequence.empty()) continue;
+
+        size_t equals = sequence.find('=');
+
+        form_pair pair;
+        pair.has_value = equals != std::string::npos;
+        pair.key = reference_decode(sequence.substr(0, equals));
+        pair.value = pair.has_value ? reference_decode(sequence.substr(equals + 1)) : "";
+
+        if (pair.key.size() > FC_FORM_KEY_MAX) {
+            (*skipped)++;
+        } else {
+            pairs.push_back(pair);
+        }
+    }
+    return pairs;
+}
+
+// Decodes body in chunks of the given sizes (cycled), pieces of a value are joined back
+static std::vector<form_pair> decode(std::string body, const std::vector<size_t>& chunk_sizes, int* skipped, int* wrong)
+{
+    fc_form* form = (fc_form*)malloc(sizeof(fc_form));
+    fc_form_begin(form);
+
+    std::vector<form_pair> pairs;
+    bool continued = false;
+
+    size_t at = 0;
+    size_t chunk = 0;
+    for (;;)
+    {
+        bool last = at == body.size();
+        if (last) {
+            fc_form_finish(form);
+        } else {
+            size_t count = chunk_sizes[chunk++ % chunk_sizes.size()];
+            if (count > body.size() - at) count = body.size() - at;
+            fc_form_feed(form, &body[at], (int)count);
+            at += count;
+        }
+
+        fc_form_pair pair;
+        while (fc_form_next(form, &pair))
+        {
+            // Only what is copied into the decoder is limited, views into the chunk can be longer
+            *wrong += (pair.key.data == form->key && pair.key.count > FC_FORM_KEY_MAX) ||
+                      (pair.value.data == form->value && pair.value.count > FC_FORM_VALUE_MAX + 2);
+
+            std::string key(pair.key.data, pair.key.count);
+            std::string value(pair.value.data ? pair.value.data : "", pair.value.count);
+            if (continued)
+            {
+                *wrong += pairs.back().key != key;
+                pairs.back().value += value;
+            }
+            else {
+                form_pair decoded = {key, value, pair.value.data != NULL};
+                pairs.push_back(decoded);
+            }
+            continued = pair.partial;
+        }
+
+        if (last) break;
+    }
+
+    *wrong += continued;
+    *skipped = form->skipped;
+    free(form);
+    return pairs;
+}
+
+static bool same_pairs(const std::vector<form_pair>& a, const std::vector<form_pair>& b)
+{
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        if (a[i].key != b[i].key || a[i].value != b[i].value || a[i].has_value != b[i].has_value) return false;
+    }
+    return true;
+}
+
+static void test_examples(void)
+{
+    std::vector<size_t> whole(1, 1000);
+    int skipped = 0;
+    int wrong = 0;
+
+    std::vector<form_pair> pairs = decode("a=b+c%21&&d&e=&%3D=%zz%4&f=%E2%82%AC=", whole, &skipped, &wrong);
+    CHECK(pairs.size() == 5);
+    CHECK(pairs.size() == 5 && pairs[0].key == "a" && pairs[0].value == "b c!" && pairs[0].has_value);
+    CHECK(pairs.size() == 5 && pairs[1].key == "d" && !pairs[1].has_value);
+    CHECK(pairs.size() == 5 && pairs[2].key == "e" && pairs[2].value.empty() && pairs[2].has_value);
+    CHECK(pairs.size() == 5 && pairs[3].key == "=" && pairs[3].value == "%zz%4");
+    CHECK(pairs.size() == 5 && pairs[4].key == "f" && pairs[4].value == "\xE2\x82\xAC=");
+    CHECK(skipped == 0 && wrong == 0);
+
+    // Key over the limit, value over the limit in pieces
+    pairs = decode("kkkkkkkkkkkkkkkkk=1&v=" + std::string(100, 'x') + "&z", whole, &skipped, &wrong);
+    CHECK(pairs.size() == 2 && pairs[0].key == "v" && pairs[0].value == std::string(100, 'x') && pairs[1].key == "z");
+    CHECK(skipped == 1 && wrong == 0);
+
+    // Escapes cut by every chunk boundary
+    std::vector<size_t> bytes(1, 1);
+    pairs = decode("%41%42=%2b%2B%e2%82%ac", bytes, &skipped, &wrong);
+    CHECK(pairs.size() == 1 && pairs[0].key == "AB" && pairs[0].value == "++\xE2\x82\xAC");
+    CHECK(wrong == 0);
+
+    pairs = decode("", whole, &skipped, &wrong);
+    CHECK(pairs.empty());
+}
+
+static void test_random(void)
+{
+    const char* pieces[] = {"a", "b", "key", "=", "&", "&&", "+", "%41", "%4", "%", "%zz", "%2B", "%26", "%3D", "hello",
+                            "x", "%e2%82%ac", "="};
+    const int piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    srand(3);
+    int mismatches = 0;
+    int wrong = 0;
+    for (int it = 0; it < 20000; ++it)
+    {
+        std::string body;
+        int count = rand() % 30;
+        for (int i = 0; i < count; ++i) body += pieces[rand() % piece_count];
+        if (rand() % 10 == 0) body += std::string(rand() % 100, 'v');
+
+        std::vector<size_t> chunk_sizes;
+        for (int i = 0; i < 8; ++i) chunk_sizes.push_back(rand() % 3 == 0 ? body.size() + 1 : 1 + rand() % 7);
+
+        int expected_skipped = 0;
+        std::vector<form_pair> expected = reference_pairs(body, &expected_skipped);
+
+        int skipped = 0;
+        std::vector<form_pair> pairs = decode(body, chunk_sizes, &skipped, &wrong);
+        mismatches += !same_pairs(pairs, expected) || skipped != expected_skipped;
+    }
+    CHECK(mismatches == 0);
+    CHECK(wrong == 0);
+}
+
+int main(void)
+{
+    test_examples();
+    test_random();
+
+    return FC_TEST_RESULT();
+}
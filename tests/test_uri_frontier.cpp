@@ -0,0 +1,159 @@
+// fc_uri_frontier: per host FIFO order and politeness delays on simulated time, delays longer than a turn of
+// the wheel, and every URI handed out exactly once with producer and fetcher threads.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_FRONTIER_IMPLEMENTATION
+#include "../fc_uri_frontier.h"
+
+#include "fc_test.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_COUNT 50
+#define PAGE_COUNT 20
+
+static void test_politeness(void)
+{
+    fc_frontier frontier;
+    CHECK(fc_frontier_init(&frontier, 4, 1000, 10, 0));
+
+    int refused = 0;
+    for (int page = 0; page < PAGE_COUNT; ++page)
+    {
+        for (int host = 0; host < HOST_COUNT; ++host)
+        {
+            char url[100];
+            snprintf(url, sizeof(url), "http://Host%d.com/p%d", host, page);
+            fc_uri_view uri;
+            fc_uri_parse_view(url, -1, &uri);
+            refused += !fc_frontier_enqueue(&frontier, &uri, (uint64_t)host * 1000 + page, 0);
+        }
+    }
+    CHECK(refused == 0);
+
+    // Host ids ignore case, host 3 waits longer and host 4 longer than a turn of the wheel (1024 slots of 10ms)
+    uint32_t slow_host = fc_frontier_host_id(&frontier, "HOST3.com", -1);
+    uint32_t slower_host = fc_frontier_host_id(&frontier, "host4.com", -1);
+    fc_frontier_set_delay(&frontier, slow_host, 5000);
+    fc_frontier_set_delay(&frontier, slower_host, 25000);
+
+    uint64_t last_fetch[HOST_COUNT];
+    int next_page[HOST_COUNT] = {0};
+    bool fetched[HOST_COUNT] = {false};
+
+    int dequeued = 0;
+    int early = 0;
+    int out_of_order = 0;
+    for (uint64_t now = 0; now < 1000000 && dequeued < HOST_COUNT * PAGE_COUNT; now += 7)
+    {
+        fc_frontier_item item;
+        while (fc_frontier_dequeue(&frontier, now, (int)now, &item))
+        {
+            int host = (int)(item.reference / 1000);
+            int page = (int)(item.reference % 1000);
+            uint64_t delay = host == 3 ? 5000 : host == 4 ? 25000 : 1000;
+
+            if (fetched[host] && now - last_fetch[host] < delay) early++;
+            if (page != next_page[host]) out_of_order++;
+
+            fetched[host] = true;
+            last_fetch[host] = now;
+            next_page[host] = page + 1;
+            dequeued++;
+        }
+    }
+    CHECK(dequeued == HOST_COUNT * PAGE_COUNT);
+    CHECK(early == 0);
+    CHECK(out_of_order == 0);
+
+    char name[64];
+    CHECK(fc_frontier_host_name(&frontier, slow_host, name, sizeof(name)) == 9 && strcmp(name, "host3.com") == 0);
+    CHECK(fc_frontier_host_name(&frontier, slow_host, name, 9) == -1);
+    CHECK(fc_frontier_host_id(&frontier, "", 0) == FC_FRONTIER_NONE);
+
+    // Nothing left, then a host that became ready long after the wheel last moved
+    fc_frontier_item item;
+    CHECK(!fc_frontier_dequeue(&frontier, 1000000, 0, &item));
+    CHECK(fc_frontier_enqueue_host(&frontier, slower_host, 1, 10000000));
+    CHECK(fc_frontier_dequeue(&frontier, 10000000, 0, &item) && item.reference == 1 && item.host_id == slower_host);
+
+    fc_frontier_free(&frontier);
+}
+
+#define THREAD_COUNT  4
+#define THREAD_ITEMS  5000
+
+static fc_frontier shared;
+static uint64_t clock_ms;
+static int handed_out[THREAD_COUNT * THREAD_ITEMS];
+static int producers_done;
+
+static void* producer(void* arg)
+{
+    long thread = (long)arg;
+    for (int i = 0; i < THREAD_ITEMS; ++i)
+    {
+        char host[32];
+        int count = snprintf(host, sizeof(host), "h%d.example", (int)((thread * 7 + i) % 97));
+        uint32_t host_id = fc_frontier_host_id(&shared, host, count);
+        fc_frontier_enqueue_host(&shared, host_id, (uint64_t)thread * THREAD_ITEMS + i, __atomic_load_n(&clock_ms, __ATOMIC_RELAXED));
+    }
+    __atomic_add_fetch(&producers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void* fetcher(void* arg)
+{
+    long thread = (long)arg;
+    int idle = 0;
+    while (idle < 1000)
+    {
+        uint64_t now = __atomic_add_fetch(&clock_ms, 1, __ATOMIC_RELAXED);
+
+        fc_frontier_item item;
+        if (fc_frontier_dequeue(&shared, now, (int)thread, &item))
+        {
+            __atomic_add_fetch(&handed_out[item.reference], 1, __ATOMIC_RELAXED);
+            idle = 0;
+        }
+        else if (__atomic_load_n(&producers_done, __ATOMIC_ACQUIRE) == THREAD_COUNT) {
+            idle++;
+        }
+    }
+    return NULL;
+}
+
+static void test_threads(void)
+{
+    CHECK(fc_frontier_init(&shared, 4, 2, 1, 0));
+
+    pthread_t producers[THREAD_COUNT];
+    pthread_t fetchers[THREAD_COUNT];
+    for (long t = 0; t < THREAD_COUNT; ++t)
+    {
+        pthread_create(&producers[t], NULL, producer, (void*)t);
+        pthread_create(&fetchers[t], NULL, fetcher, (void*)t);
+    }
+    for (int t = 0; t < THREAD_COUNT; ++t)
+    {
+        pthread_join(producers[t], NULL);
+        pthread_join(fetchers[t], NULL);
+    }
+
+    int wrong = 0;
+    for (int i = 0; i < THREAD_COUNT * THREAD_ITEMS; ++i) wrong += handed_out[i] != 1;
+    CHECK(wrong == 0);
+
+    fc_frontier_free(&shared);
+}
+
+int main(void)
+{
+    test_politeness();
+    test_threads();
+
+    return FC_TEST_RESULT();
+}
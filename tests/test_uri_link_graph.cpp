@@ -0,0 +1,192 @@
+// fc_uri_link_graph: random links against an exact model of nodes, edges and limits, domain merging examples,
+// and the graph handed to fc_graph_layout.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_GRAPH_LAYOUT_IMPLEMENTATION
+#define FC_URI_LINK_GRAPH_IMPLEMENTATION
+#include "../fc_uri_link_graph.h"
+
+#include "fc_test.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MAX_NODES 300
+#define MAX_EDGES 2000
+
+// What the graph should hold, built the way the header describes it
+typedef struct
+{
+    std::map<std::string, int> nodes;
+    std::vector<std::string> names;
+    std::map<std::pair<int, int>, uint32_t> edges;
+    uint64_t self_links;
+    uint64_t dropped;
+} reference_graph;
+
+static int reference_node(reference_graph* graph, const std::string& name)
+{
+    std::map<std::string, int>::iterator it = graph->nodes.find(name);
+    if (it != graph->nodes.end()) return it->second;
+    if ((int)graph->names.size() >= MAX_NODES) return -1;
+
+    graph->names.push_back(name);
+    return graph->nodes[name] = (int)graph->names.size() - 1;
+}
+
+static bool reference_add(reference_graph* graph, const std::string& source, const std::string& target)
+{
+    int first = reference_node(graph, source);
+    int second = first >= 0 ? reference_node(graph, target) : -1;
+    if (second < 0)
+    {
+        graph->dropped++;
+        return false;
+    }
+
+    if (first == second)
+    {
+        graph->self_links++;
+        return true;
+    }
+
+    std::pair<int, int> key(first, second);
+    if (!graph->edges.count(key) && (int)graph->edges.size() >= MAX_EDGES)
+    {
+        graph->dropped++;
+        return false;
+    }
+    graph->edges[key]++;
+    return true;
+}
+
+static bool add(fc_link_graph* graph, const char* source, const char* target)
+{
+    fc_uri_view a, b;
+    fc_uri_parse_view(source, -1, &a);
+    fc_uri_parse_view(target, -1, &b);
+    return fc_link_graph_add(graph, &a, &b);
+}
+
+static void test_random_links(void)
+{
+    fc_link_graph graph;
+    CHECK(fc_link_graph_init(&graph, FC_LINK_GRAPH_HOSTS, MAX_NODES, MAX_EDGES));
+
+    reference_graph reference;
+    reference.self_links = 0;
+    reference.dropped = 0;
+
+    srand(4);
+    int disagreements = 0;
+    for (int i = 0; i < 30000; ++i)
+    {
+        // More hosts than max_nodes and more pairs than max_edges, some hosts more popular than others
+        int source = rand() % (rand() % 2 ? 40 : 400);
+        int target = rand() % (rand() % 2 ? 40 : 400);
+
+        char source_url[64];
+        char target_url[64];
+        snprintf(source_url, sizeof(source_url), "http://%s%d.example.com./p%d", i % 2 ? "H" : "h", source, i);
+        snprintf(target_url, sizeof(target_url), "https://h%d.EXAMPLE.com:8080/", target);
+
+        char source_name[32];
+        char target_name[32];
+        snprintf(source_name, sizeof(source_name), "h%d.example.com", source);
+        snprintf(target_name, sizeof(target_name), "h%d.example.com", target);
+
+        disagreements += add(&graph, source_url, target_url) != reference_add(&reference, source_name, target_name);
+    }
+    CHECK(disagreements == 0);
+    CHECK(!graph.failed);
+    CHECK(graph.links == 30000);
+    CHECK(graph.self_links == reference.self_links);
+    CHECK(graph.dropped == reference.dropped);
+    CHECK(graph.node_count == MAX_NODES && graph.edge_count == MAX_EDGES);
+
+    // Node ids are in first seen order, names are lowercase without the trailing dot
+    fc_graph view = fc_link_graph_get(&graph, false);
+    CHECK(view.node_count == (int)reference.names.size());
+    CHECK(view.edge_count == (int)reference.edges.size());
+
+    int wrong = 0;
+    for (int i = 0; i < view.node_count; ++i)
+    {
+        wrong += view.nodes[i].user_i64 != i || reference.names[i] != (const char*)view.nodes[i].user_data;
+        wrong += fc_link_graph_find(&graph, reference.names[i].data(), (int)reference.names[i].size()) != i;
+    }
+    for (int e = 0; e < view.edge_count; ++e)
+    {
+        std::pair<int, int> key(view.edges[e].first, view.edges[e].second);
+        wrong += !reference.edges.count(key) || view.edges[e].weight != (float)reference.edges[key];
+    }
+    CHECK(wrong == 0);
+
+    CHECK(fc_link_graph_find(&graph, "H0.Example.COM", 14) == reference.nodes["h0.example.com"]);
+    CHECK(fc_link_graph_find(&graph, "h999.example.com", 16) == -1);
+
+    // Log weights
+    view = fc_link_graph_get(&graph, true);
+    wrong = 0;
+    for (int e = 0; e < view.edge_count; ++e)
+    {
+        float expected = 1 + logf((float)reference.edges[std::make_pair(view.edges[e].first, view.edges[e].second)]);
+        wrong += fabsf(view.edges[e].weight - expected) > 1e-4f;
+    }
+    CHECK(wrong == 0);
+
+    fc_link_graph_free(&graph);
+}
+
+static void test_domains(void)
+{
+    fc_link_graph graph;
+    CHECK(fc_link_graph_init(&graph, FC_LINK_GRAPH_DOMAINS, 100, 100));
+
+    CHECK(add(&graph, "http://www.example.com/", "http://a.b.Example.com/"));
+    CHECK(add(&graph, "http://news.bbc.co.uk/", "http://www.bbc.co.uk/x"));
+    CHECK(add(&graph, "http://shop.example.co.uk/", "http://example.com."));
+    CHECK(add(&graph, "http://192.168.1.20/", "http://10.0.0.1/"));
+    CHECK(add(&graph, "http://[2001:db8::1]/", "http://a.github.io/"));
+    CHECK(add(&graph, "http://localhost/", "http://a.b.io/"));
+    CHECK(!add(&graph, "mailto:x@example.com", "http://example.com/"));
+
+    const char* expected[] = {"example.com", "bbc.co.uk", "example.co.uk", "192.168.1.20", "10.0.0.1", "2001:db8::1",
+                              "github.io", "localhost", "b.io"};
+    const int expected_count = sizeof(expected) / sizeof(expected[0]);
+
+    fc_graph view = fc_link_graph_get(&graph, false);
+    CHECK(view.node_count == expected_count);
+    for (int i = 0; i < view.node_count && i < expected_count; ++i) CHECK(strcmp((const char*)view.nodes[i].user_data, expected[i]) == 0);
+
+    // Links inside a domain are self links, and any host of a domain finds its node
+    CHECK(graph.self_links == 2);
+    CHECK(fc_link_graph_find(&graph, "deep.sub.bbc.co.uk", 18) == 1);
+    CHECK(fc_link_graph_find(&graph, "2001:db8::1", 11) == 5);
+
+    // The layout takes the graph as it is, every node gets a finite position
+    fc_layout_info info = fc_layout_info_default;
+    info.iteration_cap = 50;
+    fc_layout_graph(view, info);
+
+    int bad = 0;
+    for (int i = 0; i < view.node_count; ++i) bad += !isfinite(view.nodes[i].position.x) || !isfinite(view.nodes[i].position.y);
+    CHECK(bad == 0);
+
+    fc_link_graph_free(&graph);
+}
+
+int main(void)
+{
+    test_random_links();
+    test_domains();
+
+    return FC_TEST_RESULT();
+}
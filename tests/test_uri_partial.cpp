@@ -0,0 +1,163 @@
+// fc_uri_parse_partial: every component mask against the full parse on random URIs built from URI pieces,
+// for both the views and the copies, limited counts, and errors in the skipped part.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+static void copied_fields(fc_uri* uri, char* fields[FC_URI_COMPONENT_COUNT])
+{
+    fields[FC_URI_SCHEME] = uri->scheme;
+    fields[FC_URI_USER] = uri->user;
+    fields[FC_URI_ACCESS_INFO] = uri->access_info;
+    fields[FC_URI_HOST] = uri->host;
+    fields[FC_URI_PORT] = uri->port;
+    fields[FC_URI_PATH] = uri->path;
+    fields[FC_URI_QUERY] = uri->query;
+    fields[FC_URI_FRAGMENT] = uri->fragment;
+}
+
+static bool same_view(fc_uri_str a, fc_uri_str b)
+{
+    return a.data == b.data && a.count == b.count;
+}
+
+static bool same_copy(const char* a, const char* b)
+{
+    return a == b || (a && b && strcmp(a, b) == 0);
+}
+
+// Compares the partial parses of src with the full ones for one mask, returns the number of differences
+static int compare(const std::string& src, unsigned components)
+{
+    fc_uri_view full;
+    if (!fc_uri_parse_view(src.data(), (int)src.size(), &full)) return 0;
+
+    int wrong = 0;
+
+    fc_uri_view part;
+    if (!fc_uri_parse_view_partial(src.data(), (int)src.size(), components, &part)) return 1;
+
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        fc_uri_str expected = components & (1u << c) ? fc_uri_view_component(&full, (fc_uri_component)c) : fc_uri_str{};
+        wrong += !same_view(fc_uri_view_component(&part, (fc_uri_component)c), expected);
+    }
+    wrong += (components & (1u << FC_URI_HOST)) && part.ipv6_host != full.ipv6_host;
+
+    // The copies, large structs so on the heap
+    fc_uri* full_copy = (fc_uri*)malloc(sizeof(fc_uri));
+    fc_uri* part_copy = (fc_uri*)malloc(sizeof(fc_uri));
+    fc_uri_parse(src.c_str(), full_copy);
+    wrong += !fc_uri_parse_partial(src.c_str(), components, part_copy);
+
+    char* full_fields[FC_URI_COMPONENT_COUNT];
+    char* part_fields[FC_URI_COMPONENT_COUNT];
+    copied_fields(full_copy, full_fields);
+    copied_fields(part_copy, part_fields);
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        wrong += !same_copy(part_fields[c], components & (1u << c) ? full_fields[c] : NULL);
+    }
+
+    free(full_copy);
+    free(part_copy);
+    return wrong;
+}
+
+static std::string random_uri(void)
+{
+    const char* pieces[] = {"http", "HTTPS", ":", "//", "u", "@", ":", "p", "[", "::1", "]", "h.com", "/", "a", "?", "q", "#", "f", "=", "%41",
+                            "8080", "", "1.2.3.4", "[v1.x]", "."};
+    const int piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    // Mostly "scheme:" first so that many of them parse
+    std::string src = rand() % 4 ? (rand() % 2 ? "http:" : "x-y+z:") : "";
+    int count = rand() % 14;
+    for (int i = 0; i < count; ++i) src += pieces[rand() % piece_count];
+    return src;
+}
+
+static void test_random(void)
+{
+    srand(10);
+    int parsed = 0;
+    int wrong = 0;
+    for (int it = 0; it < 30000; ++it)
+    {
+        std::string src = random_uri();
+
+        fc_uri_view full;
+        parsed += fc_uri_parse_view(src.data(), (int)src.size(), &full);
+
+        for (int m = 0; m < 8; ++m) wrong += compare(src, rand() % (FC_URI_ALL_COMPONENTS + 1));
+        wrong += compare(src, 1u << FC_URI_HOST);
+        wrong += compare(src, 1u << FC_URI_PATH);
+        wrong += compare(src, FC_URI_ALL_COMPONENTS);
+    }
+    CHECK(parsed > 10000);
+    CHECK(wrong == 0);
+}
+
+static void test_every_mask(void)
+{
+    const char* urls[] = {
+        "https://user:pw@www.example.com:8080/some/path/index.html?query=string&with=many#fragment",
+        "http://[2001:db8::1]:80/p?q#f",
+        "ftp://ftp.example.com",
+        "http://h.com?#",
+        "mailto:someone@example.com",
+        "urn:isbn:0451450523",
+        "file:///etc/hosts",
+        "http://@h:/",
+    };
+
+    int wrong = 0;
+    for (int i = 0; i < (int)(sizeof(urls) / sizeof(urls[0])); ++i)
+    {
+        for (unsigned m = 0; m <= FC_URI_ALL_COMPONENTS; ++m) wrong += compare(urls[i], m);
+    }
+    CHECK(wrong == 0);
+}
+
+static void test_limits(void)
+{
+    // count is respected, the part after it is not looked at
+    const char* src = "http://a.com/path?q#f";
+    fc_uri_view view;
+    CHECK(fc_uri_parse_view_partial(src, 12, 1u << FC_URI_HOST, &view));
+    CHECK(view.host.count == 5 && memcmp(view.host.data, "a.com", 5) == 0);
+    CHECK(fc_uri_parse_view_partial(src, 12, 1u << FC_URI_QUERY, &view) && view.query.data == NULL);
+    CHECK(fc_uri_parse_view_partial(src, 19, 1u << FC_URI_QUERY, &view) && view.query.count == 1);
+
+    int wrong = 0;
+    std::string long_src = "https://u@h.example.com:1/a/b/c?x=1&y=2#frag";
+    for (int count = 0; count <= (int)long_src.size(); ++count) wrong += compare(long_src.substr(0, count), rand() % (FC_URI_ALL_COMPONENTS + 1));
+    CHECK(wrong == 0);
+
+    // Errors in the part that is skipped are not reported
+    CHECK(!fc_uri_parse_view("http://[::1/", -1, &view));
+    CHECK(fc_uri_parse_view_partial("http://[::1/", -1, 1u << FC_URI_SCHEME, &view));
+    CHECK(view.scheme.count == 4 && view.host.data == NULL);
+    CHECK(!fc_uri_parse_view_partial("http://[::1/", -1, 1u << FC_URI_HOST, &view));
+    CHECK(!fc_uri_parse_view_partial("no scheme", -1, 1u << FC_URI_SCHEME, &view));
+
+    // No components at all only checks the scheme
+    CHECK(fc_uri_parse_view_partial("http://h/", -1, 0, &view));
+    CHECK(view.scheme.data == NULL && view.host.data == NULL && view.path.data == NULL);
+}
+
+int main(void)
+{
+    test_random();
+    test_every_mask();
+    test_limits();
+
+    return FC_TEST_RESULT();
+}
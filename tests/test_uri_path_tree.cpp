@@ -0,0 +1,189 @@
+// fc_uri_path_tree: random URIs against a map of every path prefix, page sums of the subtrees, edges, and
+// the radial and layered layouts.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_GRAPH_LAYOUT_IMPLEMENTATION
+#define FC_URI_PATH_TREE_IMPLEMENTATION
+#include "../fc_uri_path_tree.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// "host/a/b" of a URI, empty segments skipped
+static std::string reference_key(const fc_uri_view* uri, bool by_host)
+{
+    std::string key;
+    if (by_host)
+    {
+        key.assign(uri->host.data, uri->host.count);
+        for (size_t i = 0; i < key.size(); ++i) key[i] = (char)tolower((unsigned char)key[i]);
+    }
+
+    const char* at = uri->path.data;
+    const char* end = at + uri->path.count;
+    while (at < end)
+    {
+        const char* slash = (const char*)memchr(at, '/', end - at);
+        const char* segment_end = slash ? slash : end;
+        if (segment_end != at) key += "/" + std::string(at, segment_end - at);
+        at = segment_end + 1;
+    }
+    return key;
+}
+
+// The same key for a node, from the names up its parents
+static std::string node_key(const fc_path_tree* tree, const fc_graph* graph, int node, bool by_host)
+{
+    std::string key;
+    for (; node > 0; node = tree->tree_nodes[node].parent)
+    {
+        bool host_level = by_host && tree->tree_nodes[node].depth == 1;
+        key = (host_level ? "" : "/") + std::string((const char*)graph->nodes[node].user_data) + key;
+    }
+    return key;
+}
+
+static void test_random_tree(bool by_host)
+{
+    srand(by_host ? 3 : 5);
+
+    fc_path_tree tree;
+    CHECK(fc_path_tree_init(&tree, by_host));
+
+    // Pages ending at each key, and under each prefix
+    std::map<std::string, uint64_t> ends;
+    std::map<std::string, uint64_t> under;
+    int added = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        std::string url = std::string("https://") + (rand() % 2 ? "H" : "h") + std::to_string(rand() % 20) + ".com";
+        int depth = rand() % 6;
+        for (int d = 0; d < depth; ++d) url += (rand() % 8 ? "/s" : "//s") + std::to_string(rand() % (d * 7 + 3));
+        if (rand() % 4 == 0) url += "/";
+        if (rand() % 5 == 0) url += "?q=1/x";
+
+        fc_uri_view uri;
+        fc_uri_parse_view(url.data(), (int)url.size(), &uri);
+        added += fc_path_tree_add(&tree, &uri);
+
+        std::string key = reference_key(&uri, by_host);
+        ends[key]++;
+        for (size_t at = 0; at <= key.size(); ++at)
+        {
+            if (at == key.size() || (key[at] == '/' && at > 0)) under[key.substr(0, at)]++;
+        }
+    }
+    CHECK(added == 20000);
+
+    fc_graph graph = fc_path_tree_get(&tree);
+
+    // Every prefix is a node, plus the root
+    std::map<std::string, uint64_t> prefixes = under;
+    prefixes.erase("");
+    CHECK(graph.node_count == (int)prefixes.size() + 1);
+    CHECK(graph.edge_count == graph.node_count - 1);
+    CHECK(graph.nodes[0].user_i64 == 20000);
+
+    int wrong = 0;
+    for (int i = 1; i < graph.node_count; ++i)
+    {
+        const fc_path_tree_node* node = &tree.tree_nodes[i];
+        std::string key = node_key(&tree, &graph, i, by_host);
+
+        wrong += node->parent >= i;
+        wrong += node->depth != tree.tree_nodes[node->parent].depth + 1;
+        wrong += node->pages != ends[key];
+        wrong += graph.nodes[i].user_i64 != (int64_t)under[key];
+
+        const fc_edge* edge = &graph.edges[i - 1];
+        wrong += edge->first != node->parent || edge->second != i || edge->weight != (float)under[key];
+    }
+    CHECK(wrong == 0);
+
+    // Radial: depth d on the circle of radius d * distance
+    fc_path_tree_layout(&tree, FC_PATH_TREE_RADIAL, 32.f);
+    wrong = 0;
+    for (int i = 0; i < graph.node_count; ++i)
+    {
+        float radius = sqrtf(graph.nodes[i].position.x * graph.nodes[i].position.x + graph.nodes[i].position.y * graph.nodes[i].position.y);
+        wrong += fabsf(radius - 32.f * tree.tree_nodes[i].depth) > 0.01f * (1 + tree.tree_nodes[i].depth);
+    }
+    CHECK(wrong == 0);
+
+    // Layered: depth d on y = d * distance, leaves distance apart, parents between their children
+    fc_path_tree_layout(&tree, FC_PATH_TREE_LAYERED, 10.f);
+    std::vector<float> leaves;
+    wrong = 0;
+    for (int i = 0; i < graph.node_count; ++i)
+    {
+        const fc_path_tree_node* node = &tree.tree_nodes[i];
+        wrong += graph.nodes[i].position.y != 10.f * node->depth;
+
+        if (node->first_child < 0) {
+            leaves.push_back(graph.nodes[i].position.x);
+        } else {
+            float x = graph.nodes[i].position.x;
+            float first = graph.nodes[node->first_child].position.x;
+            float last = graph.nodes[node->last_child].position.x;
+            wrong += x < std::min(first, last) - 0.01f || x > std::max(first, last) + 0.01f;
+        }
+    }
+    std::sort(leaves.begin(), leaves.end());
+    for (size_t i = 1; i < leaves.size(); ++i) wrong += fabsf(leaves[i] - leaves[i - 1] - 10.f) > 0.01f;
+    CHECK(wrong == 0);
+
+    fc_path_tree_free(&tree);
+}
+
+static void test_examples(void)
+{
+    fc_path_tree tree;
+    CHECK(fc_path_tree_init(&tree, false));
+
+    const char* urls[] = {"http://a.com/a/b", "http://b.com/a/b/", "http://a.com/a//c?x/y", "urn:x:y", "http://a.com"};
+    for (int i = 0; i < 5; ++i)
+    {
+        fc_uri_view uri;
+        fc_uri_parse_view(urls[i], -1, &uri);
+        CHECK(fc_path_tree_add(&tree, &uri));
+    }
+
+    // root, a, b, c, x:y
+    fc_graph graph = fc_path_tree_get(&tree);
+    CHECK(graph.node_count == 5);
+    CHECK(graph.nodes[0].user_i64 == 5 && tree.tree_nodes[0].pages == 1);
+    CHECK(strcmp((const char*)graph.nodes[1].user_data, "a") == 0 && graph.nodes[1].user_i64 == 3);
+    CHECK(strcmp((const char*)graph.nodes[2].user_data, "b") == 0 && tree.tree_nodes[2].pages == 2);
+    CHECK(strcmp((const char*)graph.nodes[4].user_data, "x:y") == 0);
+    fc_path_tree_free(&tree);
+
+    // By host, URIs without one are refused
+    CHECK(fc_path_tree_init(&tree, true));
+    fc_uri_view uri;
+    fc_uri_parse_view("urn:x:y", -1, &uri);
+    CHECK(!fc_path_tree_add(&tree, &uri));
+    fc_uri_parse_view("http://A.com/", -1, &uri);
+    CHECK(fc_path_tree_add(&tree, &uri));
+    graph = fc_path_tree_get(&tree);
+    CHECK(graph.node_count == 2 && strcmp((const char*)graph.nodes[1].user_data, "a.com") == 0 && tree.tree_nodes[1].pages == 1);
+    fc_path_tree_free(&tree);
+}
+
+int main(void)
+{
+    test_random_tree(true);
+    test_random_tree(false);
+    test_examples();
+
+    return FC_TEST_RESULT();
+}
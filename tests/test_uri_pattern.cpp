@@ -0,0 +1,158 @@
+// fc_uri_pattern: matches of many random patterns against a per-pattern reference glob matcher, and max_rules.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_PATTERN_IMPLEMENTATION
+#include "../fc_uri_pattern.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static bool glob_matches(const char* glob, int glob_count, const char* text, int text_count, bool ignore_case)
+{
+    if (glob_count == 0) return text_count == 0;
+
+    if (*glob == '*')
+    {
+        for (int skip = 0; skip <= text_count; ++skip)
+        {
+            if (glob_matches(glob + 1, glob_count - 1, text + skip, text_count - skip, ignore_case)) return true;
+        }
+        return false;
+    }
+
+    if (text_count == 0) return false;
+
+    bool same = ignore_case ? tolower((unsigned char)*glob) == tolower((unsigned char)*text) : *glob == *text;
+    return same && glob_matches(glob + 1, glob_count - 1, text + 1, text_count - 1, ignore_case);
+}
+
+// Pattern split as documented: [scheme://][host][:port][/path][?query], missing components match anything
+static bool reference_matches(const std::string& pattern, const fc_uri_view* uri)
+{
+    std::string globs[5] = {"*", "*", "*", "*", "*"};
+    std::string rest = pattern;
+
+    size_t scheme_end = rest.find("://");
+    if (scheme_end != std::string::npos && rest.find_first_of("/?") >= scheme_end)
+    {
+        globs[0] = rest.substr(0, scheme_end);
+        rest = rest.substr(scheme_end + 3);
+    }
+
+    size_t authority_end = std::min(rest.find_first_of("/?"), rest.size());
+    std::string authority = rest.substr(0, authority_end);
+    rest = rest.substr(authority_end);
+
+    size_t port = authority.find(':');
+    if (!authority.empty()) globs[1] = authority.substr(0, port);
+    if (port != std::string::npos) globs[2] = authority.substr(port + 1);
+
+    if (!rest.empty() && rest[0] == '/')
+    {
+        size_t path_end = std::min(rest.find('?'), rest.size());
+        globs[3] = rest.substr(0, path_end);
+        rest = rest.substr(path_end);
+    }
+    if (!rest.empty() && rest[0] == '?') globs[4] = rest.substr(1);
+
+    fc_uri_str texts[5] = {uri->scheme, uri->host, uri->port, uri->path, uri->query};
+    if (uri->host.data && texts[3].count == 0) texts[3] = fc_uri_str{"/", 1};
+
+    for (int c = 0; c < 5; ++c)
+    {
+        int count = texts[c].data ? texts[c].count : 0;
+        if (!glob_matches(globs[c].data(), (int)globs[c].size(), texts[c].data, count, c < 2)) return false;
+    }
+    return true;
+}
+
+int main(void)
+{
+    const char* schemes[] = {"", "https://", "http://", "*://", "HTTP://"};
+    const char* hosts[]   = {"*.example.com", "example.com", "*", "a.*", "api.example.com", "", "*.EXAMPLE.com", "ex*le.com"};
+    const char* ports[]   = {"", "", ":8080", ":*"};
+    const char* paths[]   = {"", "/api/*", "/api/v1", "/*", "/a*b", "/", "/*/v1*"};
+    const char* queries[] = {"", "?x=*", "?*", "?", "?*debug*"};
+
+    std::vector<std::string> rules;
+    fc_uri_patterns patterns;
+    CHECK(fc_uri_patterns_init(&patterns));
+
+    srand(5);
+    int refused = 0;
+    for (int i = 0; i < 2000; ++i)
+    {
+        std::string pattern = std::string(schemes[rand() % 5]) + hosts[rand() % 8] + ports[rand() % 4] + paths[rand() % 7] + queries[rand() % 5];
+        if (pattern.empty()) pattern = "*";
+        rules.push_back(pattern);
+        refused += !fc_uri_patterns_add(&patterns, pattern.data(), (int)pattern.size(), (uint32_t)i);
+    }
+    CHECK(refused == 0);
+    CHECK(!fc_uri_patterns_add(&patterns, "http://[::1/x", -1, 9999));
+
+    const char* uri_schemes[] = {"https", "http", "ftp", "HTTPS"};
+    const char* uri_hosts[]   = {"www.example.com", "example.com", "a.b", "api.example.com", "API.Example.Com", "exampIe.com", "a.example.com"};
+    const char* uri_ports[]   = {"", ":8080", ":443"};
+    const char* uri_paths[]   = {"", "/", "/api/v1", "/api/v2/x", "/a1b", "/ab", "/x/v1/y", "/API/v1"};
+    const char* uri_queries[] = {"", "?", "?x=1", "?y=2&debug=1", "?x="};
+
+    fc_uri_pattern_scratch scratch = {};
+    std::vector<uint32_t> matched(rules.size());
+    int mismatches = 0;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        std::string url = std::string(uri_schemes[rand() % 4]) + "://" + uri_hosts[rand() % 7] + uri_ports[rand() % 3] + uri_paths[rand() % 8] + uri_queries[rand() % 5];
+
+        fc_uri_view uri;
+        if (!fc_uri_parse_view(url.data(), (int)url.size(), &uri)) continue;
+
+        int count = fc_uri_patterns_match(&patterns, &uri, &scratch, matched.data(), (int)matched.size());
+        std::vector<uint32_t> got(matched.begin(), matched.begin() + std::min(count, (int)matched.size()));
+        std::sort(got.begin(), got.end());
+
+        std::vector<uint32_t> expected;
+        for (size_t r = 0; r < rules.size(); ++r)
+        {
+            if (reference_matches(rules[r], &uri)) expected.push_back((uint32_t)r);
+        }
+
+        if (got != expected) mismatches++;
+
+        // Fewer slots than matches: the count is still the total
+        uint32_t few[3];
+        if (fc_uri_patterns_match(&patterns, &uri, &scratch, few, 3) != count) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    // Example from the header
+    fc_uri_patterns example;
+    fc_uri_patterns_init(&example);
+    fc_uri_patterns_add(&example, "https://api.example.com/v*?debug=*", -1, 1);
+    fc_uri_patterns_add(&example, "*://ads.*", -1, 2);
+
+    fc_uri_view uri;
+    fc_uri_parse_view("https://api.example.com/v1?debug=true", -1, &uri);
+    uint32_t ids[4];
+    CHECK(fc_uri_patterns_match(&example, &uri, &scratch, ids, 4) == 1 && ids[0] == 1);
+
+    fc_uri_parse_view("http://ads.tracker.net/pixel", -1, &uri);
+    CHECK(fc_uri_patterns_match(&example, &uri, &scratch, ids, 4) == 1 && ids[0] == 2);
+
+    fc_uri_parse_view("https://api.example.com/v1", -1, &uri);
+    CHECK(fc_uri_patterns_match(&example, &uri, &scratch, ids, 4) == 0);
+
+    fc_uri_patterns_free(&example);
+    fc_uri_pattern_scratch_free(&scratch);
+    fc_uri_patterns_free(&patterns);
+
+    return FC_TEST_RESULT();
+}
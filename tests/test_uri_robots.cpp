@@ -0,0 +1,276 @@
+// fc_uri_robots: group selection and precedence (RFC 9309 and the usual precedence examples), random rule sets
+// against a backtracking reference, random bytes as robots.txt, and the cache used while it's being filled.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_ROBOTS_IMPLEMENTATION
+#include "../fc_uri_robots.h"
+
+#include "fc_test.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+static bool allowed(const fc_robots* robots, const char* url)
+{
+    fc_uri_view uri;
+    fc_uri_parse_view(url, -1, &uri);
+    return fc_robots_allowed(robots, &uri);
+}
+
+static bool allowed_by(const char* text, const char* url)
+{
+    fc_robots robots;
+    fc_robots_parse(&robots, text, -1, "FooBot");
+    bool result = allowed(&robots, url);
+    fc_robots_free(&robots);
+    return result;
+}
+
+static void test_groups(void)
+{
+    const char* text =
+        "# test\n"
+        "User-agent: *\n"
+        "Disallow: /private\n"
+        "Allow: /private/public\n"
+        "Crawl-delay: 2.5\n"
+        "\n"
+        "User-agent: FooBot/1.0\n"
+        "User-agent: other\n"
+        "Disallow: /\n"
+        "Allow: /$\n"
+        "Allow: /ok*\n"
+        "Disallow: /*.gif$\n"
+        "Allow: /ok/x.gif\n"
+        "Sitemap: http://a/s.xml\n"
+        "user-agent: foobot\n"
+        "crawl-delay: 3\n"
+        "disallow: /p?q=1\n";
+
+    // FooBot has its own groups, merged
+    fc_robots robots;
+    CHECK(fc_robots_parse(&robots, text, -1, "FooBot"));
+    CHECK(allowed(&robots, "http://a/"));
+    CHECK(allowed(&robots, "http://a"));
+    CHECK(!allowed(&robots, "http://a/x"));
+    CHECK(allowed(&robots, "http://a/ok/y"));
+    CHECK(!allowed(&robots, "http://a/ok/y.gif"));
+    CHECK(allowed(&robots, "http://a/ok/x.gif"));
+    CHECK(allowed(&robots, "http://a/robots.txt"));
+    CHECK(!allowed(&robots, "http://a/p?q=1"));
+    CHECK(!allowed(&robots, "http://a/p?q=2"));
+    CHECK(allowed(&robots, "http://a/okay.gif?x"));
+    CHECK(robots.crawl_delay == 3000);
+    fc_robots_free(&robots);
+
+    // Anyone else gets the "*" group
+    CHECK(fc_robots_parse(&robots, text, -1, "BarBot"));
+    CHECK(!allowed(&robots, "http://a/private/x"));
+    CHECK(allowed(&robots, "http://a/private/public/y"));
+    CHECK(allowed(&robots, "http://a/x"));
+    CHECK(robots.crawl_delay == 2500);
+    fc_robots_free(&robots);
+
+    // No group applies: everything is allowed
+    CHECK(fc_robots_parse(&robots, "User-agent: other\nDisallow: /\n", -1, "FooBot"));
+    CHECK(allowed(&robots, "http://a/x"));
+    CHECK(robots.crawl_delay == FC_ROBOTS_NO_DELAY);
+    fc_robots_free(&robots);
+}
+
+// Longest match wins, allow wins ties, '$' ends the path
+static void test_precedence(void)
+{
+    CHECK(allowed_by("user-agent: *\nallow: /p\ndisallow: /\n", "http://a/page"));
+    CHECK(allowed_by("user-agent: *\nallow: /folder\ndisallow: /folder\n", "http://a/folder/page"));
+    CHECK(!allowed_by("user-agent: *\nallow: /page\ndisallow: /*.htm\n", "http://a/page.htm"));
+    CHECK(allowed_by("user-agent: *\nallow: /page\ndisallow: /*.ph\n", "http://a/page.php5"));
+    CHECK(allowed_by("user-agent: *\nallow: /$\ndisallow: /\n", "http://a/"));
+    CHECK(!allowed_by("user-agent: *\nallow: /$\ndisallow: /\n", "http://a/page.htm"));
+    CHECK(!allowed_by("user-agent: *\ndisallow: /fish*.php\n", "http://a/fishheads/catfish.php?parameters"));
+    CHECK(allowed_by("user-agent: *\ndisallow: /fish*.php\n", "http://a/Fish.PHP"));
+    CHECK(!allowed_by("user-agent: *\ndisallow: /*?\n", "http://a/x?y"));
+    CHECK(allowed_by("user-agent: *\ndisallow: /*?\n", "http://a/x"));
+
+    // Bytes are compared as they are, percent-encoding isn't decoded
+    CHECK(allowed_by("user-agent: *\ndisallow: /a%3cb\n", "http://a/a%3Cb"));
+}
+
+static bool reference_match(const char* pattern, const std::string& target, size_t at)
+{
+    if (*pattern == '\0') return true;
+    if (*pattern == '$' && pattern[1] == '\0') return at == target.size();
+    if (*pattern == '*')
+    {
+        for (size_t skip = at; skip <= target.size(); ++skip)
+        {
+            if (reference_match(pattern + 1, target, skip)) return true;
+        }
+        return false;
+    }
+    return at < target.size() && target[at] == *pattern && reference_match(pattern + 1, target, at + 1);
+}
+
+static void test_random_rules(void)
+{
+    const char alphabet[] = "ab/*?";
+
+    srand(1);
+    int mismatches = 0;
+    for (int it = 0; it < 5000; ++it)
+    {
+        std::string rules[6];
+        bool allow[6];
+        std::string text = "user-agent: *\n";
+        for (int r = 0; r < 6; ++r)
+        {
+            rules[r] = "/";
+            int length = rand() % 6;
+            for (int i = 0; i < length; ++i) rules[r] += alphabet[rand() % 5];
+            if (rand() % 3 == 0) rules[r] += "$";
+            allow[r] = rand() % 2;
+            text += std::string(allow[r] ? "allow: " : "disallow: ") + rules[r] + "\n";
+        }
+
+        fc_robots robots;
+        fc_robots_parse(&robots, text.c_str(), (int)text.size(), "FooBot");
+
+        for (int q = 0; q < 10; ++q)
+        {
+            std::string path = "/";
+            int length = rand() % 8;
+            for (int i = 0; i < length; ++i) path += "ab/?"[rand() % 4];
+
+            std::string url = "http://h" + path;
+
+            int best = -1;
+            bool expected = true;
+            for (int r = 0; r < 6; ++r)
+            {
+                if (!reference_match(rules[r].c_str(), path, 0)) continue;
+                int rule_length = (int)rules[r].size();
+                if (rule_length > best)
+                {
+                    best = rule_length;
+                    expected = allow[r];
+                }
+                else if (rule_length == best && allow[r]) {
+                    expected = true;
+                }
+            }
+
+            if (allowed(&robots, url.c_str()) != expected) mismatches++;
+        }
+
+        fc_robots_free(&robots);
+    }
+    CHECK(mismatches == 0);
+}
+
+// Random bytes, with a few of the field names mixed in, only have to be survived (the sanitizers check that)
+static void test_random_text(void)
+{
+    const char* pieces[] = {"user-agent:", "User-Agent: FooBot", "allow:", "disallow:", "crawl-delay:", "sitemap:", " ", "\n", "\r\n",
+                            "#", "*", "$", "/", "a", "9999999999999", "1.5", "\xff", "\0", ":", "\t"};
+    const int piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    srand(9);
+    for (int it = 0; it < 5000; ++it)
+    {
+        char text[600];
+        int count = 0;
+        while (count < 560)
+        {
+            const char* piece = pieces[rand() % piece_count];
+            int length = piece[0] ? (int)strlen(piece) : 1;
+            memcpy(text + count, piece, length);
+            count += length;
+        }
+
+        fc_robots robots;
+        if (fc_robots_parse(&robots, text, count, "FooBot"))
+        {
+            allowed(&robots, "http://a/a/b/c?d");
+            allowed(&robots, "http://a");
+            fc_robots_free(&robots);
+        }
+    }
+}
+
+static fc_robots_cache cache;
+
+static void* cache_writer(void* arg)
+{
+    (void)arg;
+    for (uint32_t host = 0; host < 1000; ++host)
+    {
+        fc_robots robots;
+        fc_robots_parse(&robots, "user-agent: *\ndisallow: /x\n", -1, "FooBot");
+        fc_robots_cache_put(&cache, host, &robots);
+    }
+    return NULL;
+}
+
+static void* cache_reader(void* arg)
+{
+    (void)arg;
+    fc_uri_view uri;
+    fc_uri_parse_view("http://a/x", -1, &uri);
+
+    long wrong = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        bool is_allowed = true;
+        if (fc_robots_cache_check(&cache, (uint32_t)(i % 1000), &uri, &is_allowed) && is_allowed) wrong++;
+    }
+    return (void*)wrong;
+}
+
+static void test_cache(void)
+{
+    CHECK(fc_robots_cache_init(&cache));
+
+    pthread_t writer;
+    pthread_t readers[3];
+    pthread_create(&writer, NULL, cache_writer, NULL);
+    for (int t = 0; t < 3; ++t) pthread_create(&readers[t], NULL, cache_reader, NULL);
+
+    long wrong = 0;
+    pthread_join(writer, NULL);
+    for (int t = 0; t < 3; ++t)
+    {
+        void* result;
+        pthread_join(readers[t], &result);
+        wrong += (long)result;
+    }
+    CHECK(wrong == 0);
+
+    fc_uri_view uri;
+    fc_uri_parse_view("http://a/y", -1, &uri);
+    bool is_allowed = false;
+    CHECK(fc_robots_cache_check(&cache, 500, &uri, &is_allowed) && is_allowed);
+    CHECK(!fc_robots_cache_check(&cache, 5000, &uri, &is_allowed));
+
+    // Replacing a host's rules
+    fc_robots robots;
+    fc_robots_parse(&robots, "user-agent: *\ndisallow: /y\n", -1, "FooBot");
+    CHECK(fc_robots_cache_put(&cache, 500, &robots));
+    CHECK(fc_robots_cache_check(&cache, 500, &uri, &is_allowed) && !is_allowed);
+
+    fc_robots_cache_free(&cache);
+}
+
+int main(void)
+{
+    test_groups();
+    test_precedence();
+    test_random_rules();
+    test_random_text();
+    test_cache();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,133 @@
+// fc_uri_set: membership, rank/select and prefix iteration against std::set, built and mapped from a file.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_SET_IMPLEMENTATION
+#include "../fc_uri_set.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+static void check_set(const fc_uri_set* set, const std::set<std::string>& reference)
+{
+    CHECK(set->count == (int64_t)reference.size());
+
+    int mismatches = 0;
+    int64_t index = 0;
+    for (std::set<std::string>::const_iterator it = reference.begin(); it != reference.end(); ++it, ++index)
+    {
+        const std::string& uri = *it;
+        if (!fc_uri_set_contains(set, uri.data(), (int)uri.size())) mismatches++;
+        if (fc_uri_set_rank(set, uri.data(), (int)uri.size()) != index) mismatches++;
+
+        char selected[FC_URI_MAX + 1];
+        int length = fc_uri_set_select(set, index, selected, sizeof(selected));
+        if (length != (int)uri.size() || uri != selected) mismatches++;
+
+        // Right after this element, no element has a byte below '!'
+        std::string after = uri + "!";
+        if (fc_uri_set_contains(set, after.data(), (int)after.size()) != (reference.count(after) > 0)) mismatches++;
+        if (fc_uri_set_rank(set, after.data(), (int)after.size()) != index + 1) mismatches++;
+    }
+    CHECK(mismatches == 0);
+
+    char selected[FC_URI_MAX + 1];
+    CHECK(fc_uri_set_select(set, set->count, selected, sizeof(selected)) == -1);
+    CHECK(fc_uri_set_rank(set, "", 0) == 0);
+
+    const char* prefixes[] = {"", "https://www.site42.com/", "https://www.site42.com/category/7/", "https://www.site4", "zzz", "https://www.site499.com/category/49/item/99999"};
+    for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); ++p)
+    {
+        const char* prefix = prefixes[p];
+        size_t prefix_count = strlen(prefix);
+
+        std::vector<std::string> expected;
+        for (std::set<std::string>::const_iterator it = reference.lower_bound(prefix); it != reference.end() && it->compare(0, prefix_count, prefix) == 0; ++it)
+        {
+            expected.push_back(*it);
+        }
+
+        fc_uri_set_iterator it;
+        fc_uri_set_prefix(set, prefix, (int)prefix_count, &it);
+
+        size_t count = 0;
+        bool same = true;
+        fc_uri_str uri;
+        while (fc_uri_set_next(&it, &uri))
+        {
+            if (count >= expected.size() || expected[count] != std::string(uri.data, uri.count)) same = false;
+            count++;
+        }
+        CHECK(same && count == expected.size());
+    }
+}
+
+int main(void)
+{
+    srand(2);
+
+    std::vector<std::string> uris;
+    for (int i = 0; i < 20000; ++i)
+    {
+        char uri[200];
+        snprintf(uri, sizeof(uri), "https://www.site%d.com/category/%d/item/%d?ref=%d", rand() % 500, rand() % 50, rand() % 100000, rand() % 10);
+        uris.push_back(uri);
+    }
+    uris.push_back(uris[0]); // Duplicate
+    uris.push_back(std::string(FC_URI_MAX + 1, 'x')); // Too long, skipped
+
+    std::vector<fc_uri_str> input;
+    for (size_t i = 0; i < uris.size(); ++i) input.push_back(fc_uri_str{uris[i].data(), (int)uris[i].size()});
+
+    std::set<std::string> reference(uris.begin(), uris.end() - 1);
+
+    const int block_sizes[] = {1, 16, 100};
+    for (int b = 0; b < 3; ++b)
+    {
+        fc_uri_set set;
+        CHECK(fc_uri_set_build(&set, input.data(), (int64_t)input.size(), block_sizes[b]));
+        check_set(&set, reference);
+        fc_uri_set_free(&set);
+    }
+
+    // Written and mapped back
+    char path[64] = "/tmp/fc_test_set_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+
+    fc_uri_set set;
+    CHECK(fc_uri_set_build(&set, input.data(), (int64_t)input.size(), 16));
+    CHECK(fc_uri_set_write(&set, path));
+    fc_uri_set_free(&set);
+
+    CHECK(fc_uri_set_map(&set, path));
+    check_set(&set, reference);
+    fc_uri_set_free(&set);
+
+    // Not a set file
+    FILE* out = fopen(path, "wb");
+    fputs("FCURISEX and some more bytes to fill a header", out);
+    fclose(out);
+    CHECK(!fc_uri_set_map(&set, path));
+    unlink(path);
+
+    CHECK(fc_uri_set_build(&set, NULL, 0, 16));
+    CHECK(set.count == 0);
+    CHECK(!fc_uri_set_contains(&set, "a", 1));
+    CHECK(fc_uri_set_rank(&set, "a", 1) == 0);
+
+    fc_uri_set_iterator it;
+    fc_uri_str uri;
+    fc_uri_set_prefix(&set, "", 0, &it);
+    CHECK(!fc_uri_set_next(&it, &uri));
+    fc_uri_set_free(&set);
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,137 @@
+// fc_uri_sitemap: loc values with character references, CDATA and comments around them, the same results for
+// every chunk split, values that are too long or don't parse, and random markup.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_SITEMAP_IMPLEMENTATION
+#include "../fc_uri_sitemap.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+// One line per URL: "U loc host" for pages, "I loc host" for sitemaps from an index
+static std::string extract(const std::string& text, size_t split, int* skipped)
+{
+    fc_sitemap* sitemap = (fc_sitemap*)malloc(sizeof(fc_sitemap));
+    fc_sitemap_begin(sitemap);
+
+    std::string result;
+    for (size_t at = 0; at < text.size(); at += split)
+    {
+        size_t count = text.size() - at < split ? text.size() - at : split;
+        fc_sitemap_feed(sitemap, text.data() + at, (int)count);
+
+        fc_sitemap_url url;
+        while (fc_sitemap_next(sitemap, &url))
+        {
+            result += url.index ? "I " : "U ";
+            result += std::string(url.loc.data, url.loc.count) + " ";
+            if (url.uri.host.data) result += std::string(url.uri.host.data, url.uri.host.count);
+            result += "\n";
+        }
+    }
+
+    *skipped = sitemap->skipped;
+    free(sitemap);
+    return result;
+}
+
+static void test_sitemap(void)
+{
+    const std::string text =
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE x>\n"
+        "<urlset xmlns=\"http://www.sitemaps.org/schemas/sitemap/0.9\">\n"
+        "<url><loc>  http://a.com/?x=1&amp;y=2&#38;z=&#x33; </loc><lastmod>2020</lastmod></url>\n"
+        "<!-- <loc>http://commented.com/</loc> -- - --->\n"
+        "<url><sm:loc><![CDATA[http://b.com/a]]]b]]></sm:loc></url>\n"
+        "<url><loc attr='>'>http://c.com/&bogus;&lt;</loc></url>\n"
+        "<url><location>http://nope.com/</location><loc>not a uri</loc></url>\n"
+        "</urlset>"
+        "<sitemapindex><sitemap><loc>https://d.com/s1.xml.gz</loc></sitemap></sitemapindex>";
+
+    const char* expected =
+        "U http://a.com/?x=1&y=2&z=3 a.com\n"
+        "U http://b.com/a]]]b b.com\n"
+        "U http://c.com/&bogus;< c.com\n"
+        "I https://d.com/s1.xml.gz d.com\n";
+
+    int skipped = 0;
+    CHECK(extract(text, text.size(), &skipped) == expected);
+    CHECK(skipped == 1);
+
+    // Chunks split tags, references, CDATA markers and values anywhere
+    int mismatches = 0;
+    for (size_t split = 1; split < 64; ++split)
+    {
+        int split_skipped = 0;
+        mismatches += extract(text, split, &split_skipped) != expected || split_skipped != skipped;
+    }
+    CHECK(mismatches == 0);
+}
+
+static void test_long_values(void)
+{
+    std::string longest = "http://e.com/" + std::string(FC_URI_MAX - 13, 'a');
+    std::string text = "<urlset><url><loc>" + longest + "</loc></url>"
+                       "<url><loc>" + longest + "b</loc></url>"
+                       "<url><loc>http://f.com/</loc></url></urlset>";
+
+    int skipped = 0;
+    std::string result = extract(text, 100, &skipped);
+    CHECK(result == "U " + longest + " e.com\nU http://f.com/ f.com\n");
+    CHECK(skipped == 1);
+}
+
+// Random pieces of markup only have to be survived, loc values that come out must parse
+static void test_random_markup(void)
+{
+    const char* pieces[] = {"<loc>", "</loc>", "<sm:loc>", "<sitemap>", "</sitemap>", "<url>", "<![CDATA[", "]]>", "<!--",
+                            "-->", "<!", "<?", "?>", "&amp;", "&#", "&#x", "ffffffff;", "&", ";", "<", ">", "'", "\"",
+                            "http://x.com/", "a", " ", "\0", "\xff", "/"};
+    const int piece_count = sizeof(pieces) / sizeof(pieces[0]);
+
+    srand(11);
+    int bad = 0;
+    for (int it = 0; it < 3000; ++it)
+    {
+        std::string text;
+        while (text.size() < 400)
+        {
+            const char* piece = pieces[rand() % piece_count];
+            text.append(piece, piece[0] ? strlen(piece) : 1);
+        }
+
+        fc_sitemap* sitemap = (fc_sitemap*)malloc(sizeof(fc_sitemap));
+        fc_sitemap_begin(sitemap);
+
+        size_t split = 1 + rand() % 50;
+        for (size_t at = 0; at < text.size(); at += split)
+        {
+            size_t count = text.size() - at < split ? text.size() - at : split;
+            fc_sitemap_feed(sitemap, text.data() + at, (int)count);
+
+            fc_sitemap_url url;
+            while (fc_sitemap_next(sitemap, &url))
+            {
+                fc_uri_view uri;
+                bad += url.loc.count > FC_URI_MAX || !fc_uri_parse_view(url.loc.data, url.loc.count, &uri);
+            }
+        }
+        free(sitemap);
+    }
+    CHECK(bad == 0);
+}
+
+int main(void)
+{
+    test_sitemap();
+    test_long_values();
+    test_random_markup();
+
+    return FC_TEST_RESULT();
+}
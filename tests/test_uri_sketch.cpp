@@ -0,0 +1,207 @@
+// fc_uri_sketch: heavy hitters of a skewed stream against exact counts, the Count-Min error bound, merges
+// against a single sketch of everything, and HyperLogLog estimates within a few standard errors.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_SKETCH_IMPLEMENTATION
+#include "../fc_uri_sketch.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#define URL_COUNT  200000
+#define TOP        20
+#define WIDTH_LOG2 12
+
+static uint64_t random_state = 1;
+
+static uint64_t next_random(void)
+{
+    random_state = random_state * 6364136223846793005ull + 1442695040888963407ull;
+    return random_state >> 11;
+}
+
+static std::string lowercase(std::string text)
+{
+    for (size_t i = 0; i < text.size(); ++i) text[i] = (char)tolower((unsigned char)text[i]);
+    return text;
+}
+
+static void test_topk_and_hll(void)
+{
+    // Roughly Zipfian: r = 200000^u, many repeats of the small ones
+    std::vector<std::string> urls;
+    for (int i = 0; i < URL_COUNT; ++i)
+    {
+        double u = (double)(next_random() % 1000000) / 1000000;
+        int r = (int)pow(200000.0, u);
+        urls.push_back("http://h" + std::to_string(r % 50) + ".Example.com/p/" + std::to_string(r) + "?q=" + std::to_string(next_random() % 3));
+    }
+
+    uint32_t components = (1u << FC_URI_HOST) | (1u << FC_URI_PATH);
+    fc_topk odd, even, all;
+    CHECK(fc_topk_init(&odd, TOP, WIDTH_LOG2, components));
+    CHECK(fc_topk_init(&even, TOP, WIDTH_LOG2, components));
+    CHECK(fc_topk_init(&all, TOP, WIDTH_LOG2, components));
+
+    fc_host_hll hosts_a, hosts_b;
+    CHECK(fc_host_hll_init(&hosts_a, 12, FC_SKETCH_ALL_COMPONENTS));
+    CHECK(fc_host_hll_init(&hosts_b, 12, FC_SKETCH_ALL_COMPONENTS));
+
+    std::map<std::string, uint64_t> exact;
+    std::map<std::string, std::set<std::string> > distinct;
+    for (size_t i = 0; i < urls.size(); ++i)
+    {
+        fc_uri_view uri;
+        fc_uri_parse_view(urls[i].data(), (int)urls[i].size(), &uri);
+
+        fc_topk_add(i % 2 ? &odd : &even, &uri, 1);
+        fc_topk_add(&all, &uri, 1);
+        fc_host_hll_add(i % 3 ? &hosts_a : &hosts_b, &uri);
+
+        std::string host = lowercase(std::string(uri.host.data, uri.host.count));
+        exact[host + " " + std::string(uri.path.data, uri.path.count)]++;
+        distinct[host].insert(urls[i]);
+    }
+
+    CHECK(fc_topk_merge(&odd, &even));
+    CHECK(fc_host_hll_merge(&hosts_a, &hosts_b));
+
+    std::vector<std::pair<uint64_t, std::string> > ranked;
+    for (std::map<std::string, uint64_t>::iterator it = exact.begin(); it != exact.end(); ++it) ranked.push_back(std::make_pair(it->second, it->first));
+    std::sort(ranked.rbegin(), ranked.rend());
+
+    fc_topk_item merged[TOP];
+    fc_topk_item single[TOP];
+    CHECK(fc_topk_sorted(&odd, merged) == TOP);
+    CHECK(fc_topk_sorted(&all, single) == TOP);
+
+    // Count-Min never undercounts and overcounts by at most e * total / width here
+    double bound = 2.718281828 * URL_COUNT / (1 << WIDTH_LOG2);
+    int wrong = 0;
+    int not_exact_top = 0;
+    for (int i = 0; i < TOP; ++i)
+    {
+        std::string key = lowercase(std::string(merged[i].key, merged[i].key_count));
+        uint64_t count = exact[key];
+        wrong += merged[i].count < count || merged[i].count > count + bound;
+
+        // The merge counts what a single sketch of the whole stream counts
+        wrong += merged[i].count != single[i].count || merged[i].hash != single[i].hash;
+        wrong += i > 0 && merged[i].count > merged[i - 1].count;
+
+        bool in_top = false;
+        for (int j = 0; j < TOP; ++j) in_top = in_top || ranked[j].second == key;
+        not_exact_top += !in_top;
+    }
+    CHECK(wrong == 0);
+    CHECK(not_exact_top == 0);
+
+    fc_uri_view uri;
+    fc_uri_parse_view("http://h1.Example.com/p/1?other", -1, &uri);
+    CHECK(fc_topk_estimate(&all, &uri) >= exact["h1.example.com /p/1"]);
+
+    // Distinct URLs per host, standard error 1.04 / 64 at precision 12
+    double worst = 0;
+    for (std::map<std::string, std::set<std::string> >::iterator it = distinct.begin(); it != distinct.end(); ++it)
+    {
+        int entry = fc_host_hll_find(&hosts_a, it->first.c_str(), (int)it->first.size());
+        double actual = (double)it->second.size();
+        double error = entry < 0 ? 1 : fabs(fc_host_hll_estimate(&hosts_a, entry) - actual) / actual;
+        worst = std::max(worst, error);
+    }
+    CHECK(hosts_a.entry_count == 50);
+    CHECK(worst < 0.06);
+    CHECK(fc_host_hll_find(&hosts_a, "H7.EXAMPLE.COM", 14) == fc_host_hll_find(&hosts_a, "h7.example.com", 14));
+    CHECK(fc_host_hll_find(&hosts_a, "h7.example.com", 14) >= 0);
+    CHECK(fc_host_hll_find(&hosts_a, "nowhere.com", 11) == -1);
+
+    fc_topk_free(&odd);
+    fc_topk_free(&even);
+    fc_topk_free(&all);
+    fc_host_hll_free(&hosts_a);
+    fc_host_hll_free(&hosts_b);
+}
+
+static void test_hll(void)
+{
+    fc_hll big, small, half;
+    CHECK(fc_hll_init(&big, 14));
+    CHECK(fc_hll_init(&small, 14));
+    CHECK(fc_hll_init(&half, 14));
+
+    // Standard error 1.04 / 128 at precision 14
+    for (int i = 0; i < 1000000; ++i)
+    {
+        uint64_t hash = fc_uri_hash((const char*)&i, sizeof(i), 7);
+        fc_hll_add(&big, hash);
+        if (i < 500000) fc_hll_add(&half, hash);
+    }
+    CHECK(fabs(fc_hll_estimate(&big) - 1e6) < 1e6 * 0.025);
+
+    // Small cardinalities use the linear counting correction
+    for (int i = 0; i < 100; ++i) fc_hll_add(&small, fc_uri_hash((const char*)&i, sizeof(i), 7));
+    CHECK(fabs(fc_hll_estimate(&small) - 100) < 5);
+
+    // A merge is the sketch of the union, adding the same values again changes nothing
+    double before = fc_hll_estimate(&big);
+    CHECK(fc_hll_merge(&half, &small));
+    CHECK(fc_hll_merge(&big, &half));
+    CHECK(fc_hll_estimate(&big) == before);
+
+    fc_hll other;
+    CHECK(fc_hll_init(&other, 10));
+    CHECK(!fc_hll_merge(&big, &other));
+    fc_hll_free(&other);
+
+    fc_hll_free(&big);
+    fc_hll_free(&small);
+    fc_hll_free(&half);
+}
+
+static void test_keys(void)
+{
+    // Absent and empty components hash differently, unselected components don't matter
+    fc_uri_view a, b, c;
+    fc_uri_parse_view("http://h/p", -1, &a);
+    fc_uri_parse_view("http://h/p?", -1, &b);
+    fc_uri_parse_view("https://h/p", -1, &c);
+    uint32_t with_query = (1u << FC_URI_HOST) | (1u << FC_URI_PATH) | (1u << FC_URI_QUERY);
+    CHECK(fc_sketch_hash(&a, with_query) != fc_sketch_hash(&b, with_query));
+    CHECK(fc_sketch_hash(&a, with_query) == fc_sketch_hash(&c, with_query));
+
+    // Keys are cut at FC_SKETCH_KEY_MAX
+    fc_topk topk;
+    CHECK(fc_topk_init(&topk, 2, 8, FC_SKETCH_ALL_COMPONENTS));
+    std::string url = "http://h/" + std::string(500, 'x');
+    fc_uri_parse_view(url.data(), (int)url.size(), &a);
+    fc_topk_add(&topk, &a, 3);
+
+    fc_topk_item items[2];
+    CHECK(fc_topk_sorted(&topk, items) == 1 && items[0].count == 3 && items[0].key_count <= FC_SKETCH_KEY_MAX);
+
+    fc_topk other;
+    CHECK(fc_topk_init(&other, 2, 9, FC_SKETCH_ALL_COMPONENTS));
+    CHECK(!fc_topk_merge(&topk, &other));
+
+    fc_topk_free(&topk);
+    fc_topk_free(&other);
+}
+
+int main(void)
+{
+    test_topk_and_hll();
+    test_hll();
+    test_keys();
+
+    return FC_TEST_RESULT();
+}
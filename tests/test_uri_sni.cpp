@@ -0,0 +1,195 @@
+// fc_uri_sni: RFC 6125 wildcard rules, random names and hosts against a map based reference, and lookups from
+// reader threads while the table is swapped and the old ones are freed.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_SNI_IMPLEMENTATION
+#include "../fc_uri_sni.h"
+
+#include "fc_test.h"
+
+#include <ctype.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+
+static bool lookup(const fc_sni_table* table, const char* host, uint32_t expected)
+{
+    uint32_t value = 0xFFFFFFFF;
+    return fc_sni_table_lookup(table, host, (int)strlen(host), &value) && value == expected;
+}
+
+static bool missing(const fc_sni_table* table, const char* host)
+{
+    uint32_t value;
+    return !fc_sni_table_lookup(table, host, (int)strlen(host), &value);
+}
+
+static void test_rules(void)
+{
+    fc_sni_builder builder;
+    fc_sni_builder_begin(&builder);
+    CHECK(fc_sni_builder_add(&builder, "Example.com", -1, 1));
+    CHECK(fc_sni_builder_add(&builder, "*.example.com.", -1, 2));
+    CHECK(fc_sni_builder_add(&builder, "api.example.net", -1, 3));
+    CHECK(fc_sni_builder_add(&builder, "example.com", -1, 99));
+
+    // Wildcards are only a whole leftmost label
+    CHECK(!fc_sni_builder_add(&builder, "w*.x.com", -1, 5));
+    CHECK(!fc_sni_builder_add(&builder, "a.*.x.com", -1, 5));
+    CHECK(!fc_sni_builder_add(&builder, "*", -1, 5));
+    CHECK(!fc_sni_builder_add(&builder, "", 0, 5));
+    CHECK(!fc_sni_builder_add(&builder, "a..com", -1, 5));
+
+    fc_sni_table* table = fc_sni_builder_build(&builder);
+    CHECK(table != NULL);
+
+    CHECK(lookup(table, "example.com", 1));       // The first value is kept
+    CHECK(lookup(table, "WWW.EXAMPLE.COM", 2));
+    CHECK(lookup(table, "www.example.com.", 2));
+    CHECK(lookup(table, "api.example.net", 3));
+    CHECK(missing(table, "a.b.example.com"));     // Exactly one label
+    CHECK(missing(table, "x.api.example.net"));
+    CHECK(missing(table, "com"));
+    CHECK(missing(table, ".example.com"));        // Not an empty one
+    CHECK(missing(table, "a..example.com"));
+    CHECK(missing(table, ""));
+
+    fc_sni_table_free(table);
+}
+
+static void test_random_names(void)
+{
+    const char* labels[] = {"a", "b", "www", "api", "x-1", "EXAMPLE", "com", "net"};
+
+    srand(6);
+    int mismatches = 0;
+    for (int it = 0; it < 300; ++it)
+    {
+        std::map<std::string, uint32_t> exact;
+        std::map<std::string, uint32_t> wildcard;
+
+        fc_sni_builder builder;
+        fc_sni_builder_begin(&builder);
+        for (uint32_t value = 0; value < 40; ++value)
+        {
+            std::string name;
+            int label_count = 1 + rand() % 3;
+            for (int l = 0; l < label_count; ++l) name += std::string(l ? "." : "") + labels[rand() % 8];
+
+            std::string lower = name;
+            for (size_t i = 0; i < lower.size(); ++i) lower[i] = (char)tolower((unsigned char)lower[i]);
+
+            if (rand() % 3 == 0) {
+                if (fc_sni_builder_add(&builder, ("*." + name).c_str(), -1, value)) wildcard.insert(std::make_pair(lower, value));
+            } else {
+                if (fc_sni_builder_add(&builder, name.c_str(), -1, value)) exact.insert(std::make_pair(lower, value));
+            }
+        }
+        fc_sni_table* table = fc_sni_builder_build(&builder);
+
+        for (int q = 0; q < 100; ++q)
+        {
+            std::string host;
+            int label_count = 1 + rand() % 4;
+            for (int l = 0; l < label_count; ++l) host += std::string(l ? "." : "") + labels[rand() % 8];
+
+            std::string lower = host;
+            for (size_t i = 0; i < lower.size(); ++i) lower[i] = (char)tolower((unsigned char)lower[i]);
+
+            bool expected_found = false;
+            uint32_t expected = 0;
+            size_t dot = lower.find('.');
+            if (exact.count(lower)) {
+                expected_found = true;
+                expected = exact[lower];
+            } else if (dot != std::string::npos && wildcard.count(lower.substr(dot + 1))) {
+                expected_found = true;
+                expected = wildcard[lower.substr(dot + 1)];
+            }
+
+            uint32_t value = 0;
+            bool found = fc_sni_table_lookup(table, host.data(), (int)host.size(), &value);
+            mismatches += found != expected_found || (found && value != expected);
+        }
+
+        fc_sni_table_free(table);
+    }
+    CHECK(mismatches == 0);
+}
+
+#define READER_COUNT 4
+#define NAME_COUNT   3000
+
+static fc_sni_index shared;
+static int stop;
+
+// Generation g maps "h<i>.test" to i + g * 100000
+static fc_sni_table* build_generation(int generation)
+{
+    fc_sni_builder builder;
+    fc_sni_builder_begin(&builder);
+    for (int i = 0; i < NAME_COUNT; ++i)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%sh%d.test", i % 3 ? "" : "*.", i);
+        fc_sni_builder_add(&builder, name, -1, (uint32_t)(i + generation * 100000));
+    }
+    return fc_sni_builder_build(&builder);
+}
+
+static void* reader(void* arg)
+{
+    (void)arg;
+    long wrong = 0;
+    while (!__atomic_load_n(&stop, __ATOMIC_ACQUIRE))
+    {
+        uint32_t value;
+        if (!fc_sni_index_lookup(&shared, "h4.test", 7, &value) || value % 100000 != 4) wrong++;
+        if (!fc_sni_index_lookup(&shared, "x.h3.test", 9, &value) || value % 100000 != 3) wrong++;
+        if (fc_sni_index_lookup(&shared, "h3.test", 7, &value)) wrong++;
+    }
+    return (void*)wrong;
+}
+
+static void test_swaps(void)
+{
+    fc_sni_index_init(&shared, build_generation(0));
+
+    pthread_t readers[READER_COUNT];
+    for (int t = 0; t < READER_COUNT; ++t) pthread_create(&readers[t], NULL, reader, NULL);
+
+    // Old tables are overwritten before they are freed, a reader still using one would see garbage
+    for (int generation = 1; generation < 30; ++generation)
+    {
+        fc_sni_table* old = fc_sni_index_swap(&shared, build_generation(generation));
+        memset(old->slots, 0xAB, (size_t)(old->slot_mask + 1) * sizeof(fc_sni_slot));
+        fc_sni_table_free(old);
+    }
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    long wrong = 0;
+    for (int t = 0; t < READER_COUNT; ++t)
+    {
+        void* result;
+        pthread_join(readers[t], &result);
+        wrong += (long)result;
+    }
+    CHECK(wrong == 0);
+
+    uint32_t value;
+    CHECK(fc_sni_index_lookup(&shared, "H10.TEST", 8, &value) && value == 29 * 100000 + 10);
+    fc_sni_table_free(fc_sni_index_swap(&shared, NULL));
+}
+
+int main(void)
+{
+    test_rules();
+    test_random_names();
+    test_swaps();
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,111 @@
+// fc_uri_parse with FC_URI_STATS: outcomes and length buckets of known inputs, counts of threads that exited,
+// snapshots taken while other threads parse, and partial parses left out.
+
+#define FC_URI_STATS
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+
+#include "fc_test.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <string>
+
+#define THREAD_COUNT 4
+#define ROUNDS       20000
+
+static std::string long_uri = "http://h/" + std::string(3000, 'a');
+
+static void* parser(void* arg)
+{
+    (void)arg;
+    fc_uri_view view;
+    for (int i = 0; i < ROUNDS; ++i)
+    {
+        fc_uri_parse_view("https://user:pw@example.com:8080/a/b?q=1#f", -1, &view);
+        fc_uri_parse_view("nope", -1, &view);
+        fc_uri_parse_view("http://[::1/x", -1, &view);
+        fc_uri_parse_view(long_uri.data(), (int)long_uri.size(), &view);
+    }
+    return NULL;
+}
+
+static uint64_t total(const fc_uri_stats* stats)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < FC_URI_OUTCOME_COUNT; ++i) sum += stats->outcomes[i];
+    return sum;
+}
+
+int main(void)
+{
+    // Buckets: 0 empty, i for lengths in [2^(i-1), 2^i), the last one for the rest
+    fc_uri_stats stats;
+    fc_uri_stats_snapshot(&stats);
+    CHECK(total(&stats) == 0);
+
+    pthread_t threads[THREAD_COUNT];
+    for (int t = 0; t < THREAD_COUNT; ++t) pthread_create(&threads[t], NULL, parser, NULL);
+
+    // Snapshots while the threads parse never go backwards
+    uint64_t previous = 0;
+    int backwards = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        fc_uri_stats_snapshot(&stats);
+        backwards += total(&stats) < previous;
+        previous = total(&stats);
+    }
+    CHECK(backwards == 0);
+
+    for (int t = 0; t < THREAD_COUNT; ++t) pthread_join(threads[t], NULL);
+
+    // The threads are gone, their counts are not
+    const uint64_t n = (uint64_t)THREAD_COUNT * ROUNDS;
+    fc_uri_stats_snapshot(&stats);
+    CHECK(stats.outcomes[FC_URI_OUTCOME_OK] == n);
+    CHECK(stats.outcomes[FC_URI_OUTCOME_NO_SCHEME] == n);
+    CHECK(stats.outcomes[FC_URI_OUTCOME_BAD_IPV6] == n);
+    CHECK(stats.outcomes[FC_URI_OUTCOME_TOO_LONG] == n);
+
+    // "https" and "http", "user", "8080" and "/a/b" are in [4, 8), "pw" and "q=1" in [2, 4), "f" and "h" in [1, 2)
+    CHECK(stats.lengths[FC_URI_SCHEME][3] == 2 * n);
+    CHECK(stats.lengths[FC_URI_USER][3] == n);
+    CHECK(stats.lengths[FC_URI_ACCESS_INFO][2] == n);
+    CHECK(stats.lengths[FC_URI_HOST][4] == n);
+    CHECK(stats.lengths[FC_URI_HOST][1] == n);
+    CHECK(stats.lengths[FC_URI_PORT][3] == n);
+    CHECK(stats.lengths[FC_URI_PATH][3] == n);
+    CHECK(stats.lengths[FC_URI_PATH][12] == n);
+    CHECK(stats.lengths[FC_URI_QUERY][2] == n);
+    CHECK(stats.lengths[FC_URI_FRAGMENT][1] == n);
+
+    uint64_t counted = 0;
+    for (int c = 0; c < FC_URI_COMPONENT_COUNT; ++c)
+    {
+        for (int b = 0; b < FC_URI_STATS_BUCKETS; ++b) counted += stats.lengths[c][b];
+    }
+    CHECK(counted == 11 * n);
+
+    // fc_uri_parse is counted, an empty path goes in bucket 0 and the last bucket takes anything longer
+    fc_uri uri;
+    fc_uri_parse("http://x.org", &uri);
+    fc_uri_view view;
+    std::string longer = "http://x/?" + std::string(40000, 'q');
+    fc_uri_parse_view(longer.data(), (int)longer.size(), &view);
+
+    fc_uri_stats after;
+    fc_uri_stats_snapshot(&after);
+    CHECK(after.outcomes[FC_URI_OUTCOME_OK] == n + 1);
+    CHECK(after.outcomes[FC_URI_OUTCOME_TOO_LONG] == n + 1);
+    CHECK(after.lengths[FC_URI_PATH][0] == stats.lengths[FC_URI_PATH][0] + 1);
+    CHECK(after.lengths[FC_URI_QUERY][FC_URI_STATS_BUCKETS - 1] == stats.lengths[FC_URI_QUERY][FC_URI_STATS_BUCKETS - 1] + 1);
+
+    // Partial parses are not counted
+    fc_uri_parse_partial("http://x.org/a", 1u << FC_URI_HOST, &uri);
+    fc_uri_stats_snapshot(&stats);
+    CHECK(memcmp(&stats, &after, sizeof(stats)) == 0);
+
+    return FC_TEST_RESULT();
+}
@@ -0,0 +1,270 @@
+// fc_uri_whatwg: the URL parsing tests of web-platform-tests (tests/data/urltestdata.json), href and every
+// component, except the few that need the UTS46 tables the header doesn't have.
+
+#define FC_URI_PARSE_IMPLEMENTATION
+#include "../fc_uri_parse.h"
+#define FC_URI_WHATWG_IMPLEMENTATION
+#include "../fc_uri_whatwg.h"
+
+#include "fc_test.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Just enough JSON for the test data: an array of strings and of objects whose values are strings, null or booleans
+typedef std::map<std::string, std::string> json_object;
+
+static const char* json_skip_space(const char* at)
+{
+    while (*at == ' ' || *at == '\n' || *at == '\r' || *at == '\t') ++at;
+    return at;
+}
+
+static void append_utf8(std::string* out, unsigned code_point)
+{
+    if (code_point < 0x80) {
+        *out += (char)code_point;
+    } else if (code_point < 0x800) {
+        *out += (char)(0xC0 | (code_point >> 6));
+        *out += (char)(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        *out += (char)(0xE0 | (code_point >> 12));
+        *out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+        *out += (char)(0x80 | (code_point & 0x3F));
+    } else {
+        *out += (char)(0xF0 | (code_point >> 18));
+        *out += (char)(0x80 | ((code_point >> 12) & 0x3F));
+        *out += (char)(0x80 | ((code_point >> 6) & 0x3F));
+        *out += (char)(0x80 | (code_point & 0x3F));
+    }
+}
+
+// at is on the opening quote, returns the position after the closing one or NULL
+static const char* json_string(const char* at, std::string* out)
+{
+    out->clear();
+    for (++at; *at != '"'; ++at)
+    {
+        if (*at == '\0') return NULL;
+        if (*at != '\\')
+        {
+            *out += *at;
+            continue;
+        }
+
+        char escape = *++at;
+        switch (escape)
+        {
+            case 'n': *out += '\n'; break;
+            case 'r': *out += '\r'; break;
+            case 't': *out += '\t'; break;
+            case 'b': *out += '\b'; break;
+            case 'f': *out += '\f'; break;
+            case 'u':
+            {
+                unsigned code_point = (unsigned)strtoul(std::string(at + 1, 4).c_str(), NULL, 16);
+                at += 4;
+
+                // Surrogate pairs, lone surrogates are kept as they are encoded (WTF-8)
+                if (code_point >= 0xD800 && code_point < 0xDC00 && at[1] == '\\' && at[2] == 'u')
+                {
+                    unsigned low = (unsigned)strtoul(std::string(at + 3, 4).c_str(), NULL, 16);
+                    if (low >= 0xDC00 && low < 0xE000)
+                    {
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                        at += 6;
+                    }
+                }
+                append_utf8(out, code_point);
+                break;
+            }
+            default:
+                if (escape == '\0') return NULL;
+                *out += escape;
+        }
+    }
+    return at + 1;
+}
+
+static bool json_read_tests(const char* text, std::vector<json_object>* tests)
+{
+    const char* at = json_skip_space(text);
+    if (*at++ != '[') return false;
+
+    for (;;)
+    {
+        at = json_skip_space(at);
+        if (*at == ']') return true;
+        if (*at == ',')
+        {
+            ++at;
+            continue;
+        }
+
+        std::string comment;
+        if (*at == '"')
+        {
+            at = json_string(at, &comment);
+            if (!at) return false;
+            continue;
+        }
+
+        if (*at++ != '{') return false;
+
+        json_object object;
+        for (;;)
+        {
+            at = json_skip_space(at);
+            if (*at == '}') break;
+            if (*at == ',')
+            {
+                ++at;
+                continue;
+            }
+
+            std::string key;
+            if (*at != '"' || !(at = json_string(at, &key))) return false;
+            at = json_skip_space(at);
+            if (*at++ != ':') return false;
+            at = json_skip_space(at);
+
+            // null and false are left out, true is "true"
+            if (*at == '"') {
+                if (!(at = json_string(at, &object[key]))) return false;
+            } else if (strncmp(at, "true", 4) == 0) {
+                object[key] = "true";
+                at += 4;
+            } else if (strncmp(at, "false", 5) == 0) {
+                at += 5;
+            } else if (strncmp(at, "null", 4) == 0) {
+                at += 4;
+            } else {
+                return false;
+            }
+        }
+        ++at;
+        tests->push_back(object);
+    }
+}
+
+static std::string read_file(const char* path)
+{
+    std::string text;
+    FILE* in = fopen(path, "rb");
+    if (!in) return text;
+
+    char chunk[65536];
+    size_t count;
+    while ((count = fread(chunk, 1, sizeof(chunk), in)) > 0) text.append(chunk, count);
+    fclose(in);
+
+    return text;
+}
+
+static std::string str(fc_uri_str value)
+{
+    return value.data ? std::string(value.data, value.count) : std::string();
+}
+
+// Where the test data expects the UTS46 mapping or the validity checks of decoded "xn--" labels
+static const char* uts46_inputs[] = {
+    "http://a.b.c.xn--pokxncvks",
+    "http://10.0.0.xn--pokxncvks",
+    "http://a.b.c.XN--pokxncvks",
+    "http://a.b.c.Xn--pokxncvks",
+    "http://10.0.0.XN--pokxncvks",
+    "http://10.0.0.xN--pokxncvks",
+    "file://loC\xF0\x9D\x90\x80\xF0\x9D\x90\x8B\xF0\x9D\x90\x87\xF0\x9D\x90\xA8\xF0\x9D\x90\xAC\xF0\x9D\x90\xAD/usr/bin",
+};
+
+static bool needs_uts46(const std::string& input)
+{
+    for (size_t i = 0; i < sizeof(uts46_inputs) / sizeof(uts46_inputs[0]); ++i)
+    {
+        if (input == uts46_inputs[i]) return true;
+    }
+    return false;
+}
+
+// The test's expected result against one parse, returns what differs or an empty string
+static std::string run_test(json_object& test)
+{
+    static char base_href[FC_URI_MAX + 1];
+    static char href[FC_URI_MAX + 1];
+
+    const std::string& input = test["input"];
+
+    fc_uri_view base;
+    const fc_uri_view* base_pointer = NULL;
+    if (test.count("base"))
+    {
+        const std::string& base_input = test["base"];
+        if (fc_url_parse(base_input.data(), (int)base_input.size(), NULL, base_href, sizeof(base_href), &base) < 0) return "base failed";
+        base_pointer = &base;
+    }
+
+    fc_uri_view url;
+    int count = fc_url_parse(input.data(), (int)input.size(), base_pointer, href, sizeof(href), &url);
+
+    if (test.count("failure")) return count < 0 ? "" : "parsed as " + std::string(href, count);
+    if (count < 0) return "failed";
+
+    std::string host = str(url.host);
+    if (url.ipv6_host) host = "[" + host + "]";
+
+    std::string port = str(url.port);
+
+    std::map<std::string, std::string> got;
+    got["href"]     = std::string(href, count);
+    got["protocol"] = str(url.scheme) + ":";
+    got["username"] = str(url.user);
+    got["password"] = str(url.access_info);
+    got["hostname"] = host;
+    got["host"]     = port.empty() ? host : host + ":" + port;
+    got["port"]     = port;
+    got["pathname"] = str(url.path);
+    got["search"]   = url.query.count ? "?" + str(url.query) : "";
+    got["hash"]     = url.fragment.count ? "#" + str(url.fragment) : "";
+
+    std::string differences;
+    for (std::map<std::string, std::string>::iterator it = got.begin(); it != got.end(); ++it)
+    {
+        if (test[it->first] != it->second) differences += " " + it->first + "=<" + it->second + ">";
+    }
+    return differences;
+}
+
+int main(void)
+{
+    std::string text = read_file("tests/data/urltestdata.json");
+    CHECK(!text.empty());
+
+    std::vector<json_object> tests;
+    CHECK(json_read_tests(text.c_str(), &tests));
+    CHECK(tests.size() > 800);
+
+    int failed = 0;
+    int skipped = 0;
+    for (size_t i = 0; i < tests.size(); ++i)
+    {
+        std::string differences = run_test(tests[i]);
+        if (differences.empty()) continue;
+
+        if (needs_uts46(tests[i]["input"]))
+        {
+            skipped++;
+            continue;
+        }
+
+        failed++;
+        fprintf(stderr, "input <%s> base <%s>: %s\n", tests[i]["input"].c_str(), tests[i]["base"].c_str(), differences.c_str());
+    }
+    CHECK(failed == 0);
+    CHECK(skipped <= (int)(sizeof(uts46_inputs) / sizeof(uts46_inputs[0])));
+
+    return FC_TEST_RESULT();
+}